@@ -0,0 +1,126 @@
+#ifndef ASLAM_BACKEND_ASYNC_OPTIMIZER_HPP
+#define ASLAM_BACKEND_ASYNC_OPTIMIZER_HPP
+
+#include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+#include <aslam/backend/util/CancellationToken.hpp>
+#include <aslam/Exceptions.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Core>
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    /**
+     * \class AsyncOptimizer
+     *
+     * \brief Runs an optimizer on a background thread with anytime results, deadlines and cancellation.
+     *
+     * After every iteration the runner publishes a snapshot of the design variable values. Other threads
+     * read the latest one with getLatestSnapshot() and never wait for the optimization: publishing and
+     * reading only exchange a shared pointer to an immutable snapshot (boost::atomic_store / atomic_load).
+     * While the runner is running, the design variables themselves must only be touched by the optimizer.
+     *
+     * Cancellation is cooperative. The optimizer's problem manager and linear system solver poll a
+     * CancellationToken in their threaded error and gradient loops, and the runner polls it at every
+     * iteration event. Once cancelled or past the deadline, the optimization is aborted and the design
+     * variables are reset to the latest snapshot, i.e. the last accepted state.
+     */
+    class AsyncOptimizer {
+    public:
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      typedef std::chrono::steady_clock Clock;
+
+      /// \brief The design variable values after an iteration
+      struct Snapshot {
+        /// \brief The number of iterations run when the snapshot was taken
+        std::size_t numIterations = 0;
+        /// \brief Seconds since start()
+        double time = 0.0;
+        /// \brief The parameters of the optimizer's design variables, in the order of getDesignVariables()
+        std::vector<Eigen::MatrixXd> parameters;
+      };
+
+      /// \brief How a run ended
+      enum class Outcome {
+        FINISHED,         //!< optimize() returned, see Result::status for the convergence status
+        CANCELLED,        //!< cancel() was called
+        DEADLINE_REACHED, //!< the time budget ran out
+        FAILED            //!< optimize() threw, see Result::errorMessage
+      };
+
+      /// \brief The outcome of a run
+      struct Result {
+        Outcome outcome = Outcome::FINISHED;
+        /// \brief The optimizer status when the run ended
+        OptimizerStatus status;
+        /// \brief The message of the exception ending a failed run
+        std::string errorMessage;
+        /// \brief Wall time of the run in seconds
+        double time = 0.0;
+      };
+
+      explicit AsyncOptimizer(const boost::shared_ptr<OptimizerProblemManagerBase>& optimizer);
+
+      /// \brief Cancels a running optimization and waits for it
+      ~AsyncOptimizer();
+
+      /// \brief Start optimizing on a background thread. The optimizer is initialized first if needed.
+      /// @param timeBudget Wall time in seconds after which the run is stopped (<= 0 means no limit)
+      void start(double timeBudget = 0.0);
+
+      /// \brief Ask the running optimization to stop. Returns immediately, use wait() to wait for it.
+      void cancel();
+
+      /// \brief Is an optimization running?
+      bool isRunning() const;
+
+      /// \brief Wait for the run started last and return how it ended
+      Result wait();
+
+      /// \brief The most recent snapshot, nullptr before the first start(). Can be called from any thread.
+      boost::shared_ptr<const Snapshot> getLatestSnapshot() const;
+
+      /// \brief The optimizer run by this runner
+      const boost::shared_ptr<OptimizerProblemManagerBase>& optimizer() const { return _optimizer; }
+
+    private:
+      /// \brief The body of the background thread
+      Result run();
+
+      /// \brief Register the iteration callbacks of a run with the optimizer
+      void attach();
+
+      /// \brief Remove the iteration callbacks and the cancellation token of a run from the optimizer.
+      ///        Afterwards direct calls to the optimizer neither publish snapshots nor see the token.
+      void detach();
+
+      /// \brief Copy the design variables into a new snapshot and publish it
+      void publishSnapshot();
+
+      /// \brief Set the design variables to the values of \p snapshot
+      void restoreSnapshot(const Snapshot& snapshot);
+
+      boost::shared_ptr<OptimizerProblemManagerBase> _optimizer;
+      util::CancellationToken _token;
+      /// \brief Only accessed with boost::atomic_load / boost::atomic_store
+      boost::shared_ptr<const Snapshot> _snapshot;
+      std::future<Result> _run;
+      Clock::time_point _start;
+      callback::OptimizerCallback _iterationEndCallback;
+      callback::OptimizerCallback _cancellationCallback;
+
+      AsyncOptimizer(const AsyncOptimizer&) = delete;
+      AsyncOptimizer& operator=(const AsyncOptimizer&) = delete;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_ASYNC_OPTIMIZER_HPP */
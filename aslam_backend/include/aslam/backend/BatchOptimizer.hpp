@@ -0,0 +1,79 @@
+#ifndef ASLAM_BACKEND_BATCH_OPTIMIZER_HPP
+#define ASLAM_BACKEND_BATCH_OPTIMIZER_HPP
+
+#include <aslam/backend/OptimizerBase.hpp>
+#include <aslam/backend/Optimizer2Options.hpp>
+#include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+#include <aslam/Exceptions.hpp>
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    /**
+     * \class BatchOptimizer
+     *
+     * \brief Optimizes many small, independent problems on a shared set of worker threads.
+     *
+     * Every worker owns one optimizer and optimizes one problem at a time with a single thread, so the machine is not
+     * oversubscribed by the inner threading of many optimizers. The optimizers are kept across problems and calls
+     * to optimize(). By default they are Optimizer2 instances with a SparseCholeskyLinearSystemSolver of their own,
+     * which keeps its symbolic analysis while consecutive problems have the same structure. The problems are handed
+     * out grouped by a structure key, so that a worker mostly sees problems of the same structure in a row.
+     */
+    class BatchOptimizer {
+    public:
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      /// \brief Creates the optimizer of a worker
+      typedef boost::function<boost::shared_ptr<OptimizerProblemManagerBase>()> OptimizerFactory;
+      typedef std::vector<boost::shared_ptr<OptimizationProblemBase> > Problems;
+
+      /// \brief Optimize the problems with Optimizer2. Every worker gets a SparseCholeskyLinearSystemSolver and a
+      ///        LevenbergMarquardtTrustRegionPolicy of its own, so \p options must not set them.
+      BatchOptimizer(const Optimizer2Options& options = Optimizer2Options(), std::size_t numThreads = 1);
+      /// \brief Optimize the problems with optimizers created by \p factory. \p options replace their base options.
+      BatchOptimizer(const OptimizerFactory& factory, const OptimizerOptionsBase& options, std::size_t numThreads = 1);
+      ~BatchOptimizer();
+
+      /// \brief Optimize all \p problems and return their statuses in the same order.
+      ///        A problem whose optimization throws gets the status FAILURE, the other problems are not affected.
+      std::vector<OptimizerStatus> optimize(const Problems& problems);
+
+      /// \brief The number of workers
+      void setNumThreads(std::size_t numThreads);
+      std::size_t numThreads() const { return _numThreads; }
+
+      /// \brief The base options of the worker optimizers. The thread counts are always 1.
+      const OptimizerOptionsBase& getOptions() const { return _options; }
+      void setOptions(const OptimizerOptionsBase& options);
+
+    private:
+      /// \brief Optimize the problems of _schedule, taking the next one until none is left
+      void work(std::size_t threadId, std::size_t startIdx, std::size_t endIdx);
+
+      OptimizerFactory _factory;
+      OptimizerOptionsBase _options;
+      std::size_t _numThreads;
+
+      /// \brief The optimizers of the workers, created on demand
+      std::vector<boost::shared_ptr<OptimizerProblemManagerBase> > _workers;
+
+      /// \brief State of the running optimize() call
+      const Problems* _problems = nullptr;
+      std::vector<OptimizerStatus>* _statuses = nullptr;
+      /// \brief Problem indices grouped by structure
+      std::vector<std::size_t> _schedule;
+      /// \brief The next entry of _schedule to optimize
+      std::atomic<std::size_t> _next;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_BATCH_OPTIMIZER_HPP */
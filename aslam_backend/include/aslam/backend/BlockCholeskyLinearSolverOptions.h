@@ -24,6 +24,10 @@
 #ifndef ASLAM_BACKEND_BLOCK_CHOLESKY_LINEAR_SOLVER_OPTIONS_H
 #define ASLAM_BACKEND_BLOCK_CHOLESKY_LINEAR_SOLVER_OPTIONS_H
 
+#include <vector>
+
+#include "aslam/backend/FillReducingOrdering.hpp"
+
 namespace aslam {
   namespace backend {
 
@@ -49,6 +53,20 @@ namespace aslam {
       /** @}
         */
 
+      /** \name Members
+        @{
+        */
+      /// Fill-reducing ordering used for the symbolic factorization
+      FillReducingOrdering ordering;
+      /// Design variables to eliminate last (constrained ordering only)
+      std::vector<const DesignVariable*> orderLast;
+      /// Number of trailing active design variables to eliminate last (constrained ordering only)
+      int numOrderLast;
+      /// Number of error terms a thread accumulates into its partial Hessian before taking the next chunk
+      int chunkSize;
+      /** @}
+        */
+
     };
 
   }
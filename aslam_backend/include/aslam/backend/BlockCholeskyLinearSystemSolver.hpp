@@ -4,6 +4,7 @@
 #include "LinearSystemSolver.hpp"
 #include <sparse_block_matrix/linear_solver.h>
 #include <boost/shared_ptr.hpp>
+#include <atomic>
 #include "SparseBlockMatrixWrapper.hpp"
 
 #include "aslam/backend/BlockCholeskyLinearSolverOptions.h"
@@ -27,6 +28,10 @@ namespace aslam {
 
 
       /// \brief build the system of equations.
+      ///
+      /// J is never stored: every error term adds J_i^T W J_i and J_i^T W e_i to the Hessian directly.
+      /// With more than one thread, the threads take chunks of error terms, accumulate them into
+      /// partial Hessians of their own and the partial Hessians are summed block column by block column.
       void buildSystem(size_t nThreads, bool useMEstimator) override;
 
       /// \brief solve the system storing the solution in outDx and returning true on success.
@@ -53,18 +58,41 @@ namespace aslam {
 
       /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
       double rhsJtJrhs() override;
+
+      /// \brief Memory of the Hessian, the partial Hessians of the build threads and the factor
+      LinearSolverStatistics getStatistics() const override;
+
+      /// \brief The fill-reducing permutation of the columns of the Hessian used by the last solve.
+      ///        Empty before the first solve and for the spqr solver.
+      std::vector<int> getOrdering() const;
         
     private:
 
       void initSolver();
+
+      /// \brief accumulate the chunks of error terms taken by one thread into its partial Hessian
+      void buildPartialHessian(size_t threadId, bool useMEstimator);
+
+      /// \brief add the partial Hessians of the block columns [startCol, endCol) to the Hessian
+      void reducePartialHessians(size_t startCol, size_t endCol);
       
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
 
+      /// \brief compute the block constraints for a constrained ordering.
+      void setOrdering(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors) override;
+
 
       /// \brief The full Hessian matrix.
       SparseBlockMatrixWrapper _H;
 
+      /// \brief The partial Hessians and right-hand sides of the build threads. Kept to reuse their blocks.
+      std::vector<SparseBlockMatrix> _threadHessians;
+      std::vector<Eigen::VectorXd> _threadRhs;
+
+      /// \brief The first error term of the next chunk to be taken by a build thread
+      std::atomic<size_t> _nextChunk;
+
       /// \brief the linear solver
       boost::shared_ptr<LinearSolver> _solver;
 
@@ -72,6 +100,9 @@ namespace aslam {
       BlockCholeskyLinearSolverOptions _options;
 
       std::string _solverType;
+
+      /// \brief The constraint set of every block column used by the constrained ordering
+      std::vector<int> _orderingConstraints;
     };
 
   } // namespace backend
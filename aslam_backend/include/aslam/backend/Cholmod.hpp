@@ -5,8 +5,12 @@
 #ifndef QRSOLVER_DISABLED
 #include <SuiteSparseQR.hpp>
 #endif
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include <sm/assert_macros.hpp>
 #include <Eigen/Core>
+#include <aslam/backend/FillReducingOrdering.hpp>
 
 namespace aslam {
   namespace backend {
@@ -36,16 +40,42 @@ namespace aslam {
        * \brief Wraps the cholmod_analyze function
        *
        * @param J the sparse matrix to analyze
+       * @param ordering the fill-reducing ordering to use
+       * @param rowConstraints the constraint set of every row of J (FillReducingOrdering::CONSTRAINED only).
+       *        Rows of set k are eliminated before the rows of set k+1.
        *
        * @return a cholmod factor for the matrix. This must be freed using Cholmod::free()
        */
-      cholmod_factor* analyze(cholmod_sparse* J);
+      cholmod_factor* analyze(cholmod_sparse* J, FillReducingOrdering ordering = FillReducingOrdering::AMD,
+                              const std::vector<index_t>& rowConstraints = std::vector<index_t>());
 
       /// \brief wraps the spqr analyze functions
+      ///
+      /// @param A J^T if transpose is true (the default), J otherwise
 #ifndef QRSOLVER_DISABLED
-      spqr_factor* analyzeQR(cholmod_sparse* J);
+      spqr_factor* analyzeQR(cholmod_sparse* A, int ordering = SPQR_ORDERING_BEST, bool transpose = true);
 #endif
 
+      /**
+       * \brief Selects the Cholesky factorization type used by analyze()
+       *
+       * @param supernodal CHOLMOD_SIMPLICIAL, CHOLMOD_AUTO or CHOLMOD_SUPERNODAL
+       * @param supernodalSwitch with CHOLMOD_AUTO, a supernodal factorization is used if flop/nnz(L) >= supernodalSwitch
+       */
+      void setSupernodal(int supernodal, double supernodalSwitch = 40.0);
+
+      /// \brief Sets the number of TBB threads used by SPQR (0: TBB default, -1: let TBB choose) and the task grain size
+      void setQrNumThreads(int numThreads, double grain = 12.0);
+
+      /**
+       * \brief Sets the number of threads of the BLAS used by the supernodal factorization
+       *
+       * Only OpenBLAS and MKL are supported, detected at runtime.
+       *
+       * @return false if the BLAS in use has no known thread control
+       */
+      static bool setNumBlasThreads(int numThreads);
+
       /// \brief Wraps the cholmod_factorize function. Returns true for success.
       bool factorize(cholmod_sparse* A, cholmod_factor* L);
 
@@ -82,12 +112,70 @@ namespace aslam {
                            cholmod_factor* L,
                            cholmod_dense* b);
 
+      /// \brief solve a linear system with the numeric factor L, without factorizing.
+      ///
+      /// The return value must be freed with Cholmod::free(), it is NULL if the solve failed.
+      cholmod_dense* solve(cholmod_factor* L, cholmod_dense* b);
+
+      /// \brief Update the factor L of A*A' to the factor of A*A' + C*C', C being the columns [beginColumn, endColumn) of A.
+      ///
+      /// Wraps cholmod_updown. L must be numeric, a supernodal or LL' factor is converted to a simplicial LDL' factor.
+      /// Returns true for success.
+      bool update(cholmod_sparse* A, size_t beginColumn, size_t endColumn, cholmod_factor* L);
+
+      /// \brief The number of non-zeros in the numeric factor L
+      static double factorNonZeros(const cholmod_factor* L);
+
+      /// \brief Can cholmod factorize single precision matrices? This needs CHOLMOD 5 or later.
+      static bool supportsSinglePrecision();
+
+      /// \brief Copy A with its values rounded to single precision.
+      ///
+      /// Factorizing the copy yields a single precision factor.
+      /// Returns NULL if single precision is not supported. The copy must be freed with Cholmod::free()
+      cholmod_sparse* copySingle(cholmod_sparse* A);
+
+      /// \brief Solve L*L'*x = b with a factorized single precision factor L.
+      ///
+      /// b is rounded to single precision and x is returned in double precision. Returns true for success.
+      bool solveSingle(cholmod_factor* L, const Eigen::VectorXd& b, Eigen::VectorXd& x);
+
 #ifndef QRSOLVER_DISABLED
       cholmod_dense* solve(cholmod_sparse* A, spqr_factor* L, cholmod_dense* b,
                            double tol = SPQR_DEFAULT_TOL, bool norm = true,
                            double normTol = 1e-8);
+
+      /// \brief Least squares solve of J*x = b with the symbolic analysis in L.
+      ///
+      /// Same as solve() but takes J instead of J^T. J is scaled in place if norm is true.
+      /// The return value must be freed with Cholmod::free()
+      cholmod_dense* solveQR(cholmod_sparse* J, spqr_factor* L, cholmod_dense* b,
+                             double tol = SPQR_DEFAULT_TOL, bool norm = true,
+                             double normTol = 1e-8);
+
+      /// \brief Least squares solve of J*x = b without storing Q.
+      ///
+      /// Q^T is applied to b while J is factorized and the Householder vectors are dropped,
+      /// so only R is held in memory. The symbolic analysis is part of every call.
+      /// The estimated rank and the tolerance used are returned by getQrRank() and getQrTol().
+      /// J is scaled in place if norm is true. The return value must be freed with Cholmod::free()
+      cholmod_dense* solveQless(cholmod_sparse* J, cholmod_dense* b, int ordering = SPQR_ORDERING_BEST,
+                                double tol = SPQR_DEFAULT_TOL, bool norm = true,
+                                double normTol = 1e-8);
+
+      /// \brief The rank estimated by the last solveQless()
+      index_t getQrRank() const;
+
+      /// \brief The rank tolerance used by the last solveQless()
+      double getQrTol() const;
 #endif
 
+      /// \brief Transposes A into At.
+      ///
+      /// At is reused if it has the size and capacity of A^T, otherwise it is freed and a new matrix is allocated.
+      /// Returns the transpose, which must be freed with Cholmod::free()
+      cholmod_sparse* transpose(cholmod_sparse* A, cholmod_sparse* At = NULL);
+
       cholmod_sparse* aat(cholmod_sparse* A);
 
       /// Scale a matrix by S
@@ -104,7 +192,21 @@ namespace aslam {
       /// Returns the current memory usage in bytes
       size_t getMemoryUsage() const;
 
+      /// Returns the peak memory usage in bytes
+      size_t getPeakMemoryUsage() const;
+
+      /// Returns the flop count of the last Cholesky analysis or QR factorization
+      double getFlops() const;
+
+      /// Returns the number of non-zeros in L of the last Cholesky analysis
+      double getFactorNonZeros() const;
+
     private:
+#ifndef QRSOLVER_DISABLED
+      /// \brief Scales the columns of J to unit norm (columns with a norm below normTol are zeroed).
+      /// Returns the scaling, which must be freed with Cholmod::free()
+      cholmod_dense* normalizeColumns(cholmod_sparse* J, double normTol);
+#endif
 
       cholmod_common _cholmod;
 
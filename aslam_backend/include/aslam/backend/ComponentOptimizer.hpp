@@ -0,0 +1,109 @@
+#ifndef ASLAM_BACKEND_COMPONENT_OPTIMIZER_HPP
+#define ASLAM_BACKEND_COMPONENT_OPTIMIZER_HPP
+
+#include <aslam/backend/OptimizerBase.hpp>
+#include <aslam/backend/Optimizer2Options.hpp>
+#include <aslam/backend/ProblemDecomposition.hpp>
+#include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    /**
+     * \class ComponentOptimizer
+     *
+     * \brief Optimizes the independent components of a problem separately and concurrently.
+     *
+     * The problem is split with findIndependentComponents() on initialization and every component gets an optimizer
+     * of its own. Instead of iterating all components in lockstep until the slowest one converges, each component
+     * stops on its own convergence criterion. The components are handed out to the threads largest first.
+     *
+     * The status merges the component statuses: the errors, evaluation counts and squared gradient norms add up,
+     * the iterations and state updates are the maximum over the components. The convergence is FAILURE if any
+     * component failed, otherwise it is the convergence of the component that ran the most iterations.
+     */
+    class ComponentOptimizer : public OptimizerBase {
+    public:
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      typedef boost::shared_ptr<ComponentOptimizer> Ptr;
+      typedef OptimizerOptionsBase Options;
+
+      /// \brief Creates the optimizer for a component
+      typedef boost::function<boost::shared_ptr<OptimizerProblemManagerBase>()> OptimizerFactory;
+
+      struct Status : public OptimizerStatus {
+        std::size_t numComponents = 0; /// \brief The number of independent components
+        std::size_t numComponentsConverged = 0; /// \brief The number of components that converged
+        std::size_t numComponentsFailed = 0; /// \brief The number of components that failed
+       private:
+        void resetImplementation() override;
+      };
+
+      /// \brief Optimize every component with an Optimizer2. The linear system solver and trust region policy
+      ///        of \p options must not be set, they cannot be shared by concurrently running optimizers.
+      ComponentOptimizer(const Optimizer2Options& options = Optimizer2Options(), std::size_t numThreads = 1);
+      /// \brief Optimize every component with an optimizer created by \p factory. \p options replace their base options.
+      ComponentOptimizer(const OptimizerFactory& factory, const OptimizerOptionsBase& options, std::size_t numThreads = 1);
+      ~ComponentOptimizer() override;
+
+      void setProblem(boost::shared_ptr<OptimizationProblemBase> problem) override;
+      void checkProblemSetup() override;
+      bool isInitialized() override { return _isInitialized; }
+
+      const Status& getStatus() const override { return _status; }
+      const Options& getOptions() const override { return _options; }
+      /// \brief Set the base options of all component optimizers
+      void setOptions(const OptimizerOptionsBase& options) override;
+
+      /// \brief The design variables of all components
+      const std::vector<DesignVariable*>& getDesignVariables() const override { return _designVariables; }
+
+      /// \brief The number of threads optimizing components concurrently
+      void setNumThreads(std::size_t numThreads);
+      std::size_t numThreads() const { return _numThreads; }
+
+      /// \brief The number of independent components, known after initialization
+      std::size_t numComponents() const { return _components.size(); }
+      /// \brief Component \p i
+      const ProblemComponent& component(std::size_t i) const;
+      /// \brief The optimizer of component \p i, e.g. to look at its status
+      const OptimizerProblemManagerBase& componentOptimizer(std::size_t i) const;
+
+    private:
+      void initializeImplementation() override;
+      void optimizeImplementation() override;
+
+      /// \brief Optimize the components in _schedule, taking the next one until none is left
+      void optimizeComponents(std::size_t threadId, std::size_t startIdx, std::size_t endIdx);
+
+      /// \brief Merge the component statuses into _status
+      void mergeStatus();
+
+      OptimizerFactory _factory;
+      Options _options;
+      std::size_t _numThreads;
+      boost::shared_ptr<OptimizationProblemBase> _problem;
+      bool _isInitialized = false;
+
+      std::vector<boost::shared_ptr<ProblemComponent> > _components;
+      std::vector<boost::shared_ptr<OptimizerProblemManagerBase> > _optimizers;
+      std::vector<DesignVariable*> _designVariables;
+      /// \brief Component indices, largest component first
+      std::vector<std::size_t> _schedule;
+      /// \brief The next entry of _schedule to optimize
+      std::atomic<std::size_t> _next;
+
+      Status _status;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_COMPONENT_OPTIMIZER_HPP */
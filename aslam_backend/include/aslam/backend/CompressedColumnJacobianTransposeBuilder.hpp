@@ -4,6 +4,8 @@
 #include "JacobianBuilder.hpp"
 #include "CompressedColumnMatrix.hpp"
 
+#include <atomic>
+
 namespace aslam {
   namespace backend {
 
@@ -12,6 +14,14 @@ namespace aslam {
      *
      * Multithreaded code for building \f$ \mathbf J^T \f$ from the list of errors.
      */
+    /// \brief Counters of the selective re-linearization since the last initMatrixStructure()
+    struct RelinearizationStatistics {
+      /// \brief Number of error term Jacobians evaluated
+      std::size_t numEvaluated = 0;
+      /// \brief Number of error term Jacobians kept from an earlier build
+      std::size_t numSkipped = 0;
+    };
+
     template<typename INDEX_T = int>
     class CompressedColumnJacobianTransposeBuilder {
     public:
@@ -27,11 +37,30 @@ namespace aslam {
       /// This function assumes that all the design variables in the DV container are active
       /// and that the container is sorted by order of block index such that dv[i]->blockIndex() == i
       ///
-      virtual void initMatrixStructure(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors);
+      /// With \p keepAppendedTo the Jacobians and the change tracking of the error terms of the last structure are kept
+      /// if \p errors only appends to them and the design variables and their columns did not change. Only the new
+      /// columns of J^T are set up then, and the next build evaluates the new error terms and the ones whose design
+      /// variables moved (see setRelinearizationThreshold()).
+      virtual void initMatrixStructure(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool keepAppendedTo = false);
 
       /// \brief build the large, sparse internal Jacobian matrix from the error terms.
       virtual void buildSystem(size_t nThreads, bool useMEstimator);
 
+      /// \brief Keep the Jacobian of an error term from the last build if none of its design variables moved more
+      ///        than \p threshold (in the max norm of the updates) since the Jacobian was evaluated. Negative disables.
+      ///
+      /// The movement is tracked with DesignVariable::accumulatedUpdateNorm(), a design variable set with
+      /// setParameters() counts as moved. Values changed in any other way, new noise models or changing M-estimators
+      /// are not noticed, the first build after initMatrixStructure() evaluates all Jacobians unless it kept them.
+      void setRelinearizationThreshold(double threshold) { _relinearizationThreshold = threshold; }
+      double relinearizationThreshold() const { return _relinearizationThreshold; }
+
+      /// \brief Counters of the skipped and evaluated Jacobians since the last initMatrixStructure()
+      const RelinearizationStatistics& getRelinearizationStatistics() const { return _relinearizationStatistics; }
+
+      /// \brief Bytes of the Jacobian containers alive at the same time in the last build, the largest one of every thread
+      std::size_t getJacobianContainerMemoryUsage() const { return _jacobianContainerMemory; }
+
       /// \brief Get a view of the transpose of the Jacobian as a cholmod sparse matrix.
       virtual cholmod_sparse getJacobianTransposeView();
 
@@ -45,6 +74,15 @@ namespace aslam {
       /// \brief a function to be run by a single thread.
       void evaluateJacobians(int threadId, int startIdx, int endIdx, bool useMEstimator);
 
+      /// \brief Did \p errors only append to the error terms of the current structure, with the same design variables?
+      bool isAppendedTo(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors) const;
+
+      /// \brief Collect the design variables of the error terms not tracked yet for the change tracking
+      void initChangeTracking();
+
+      /// \brief Has a design variable of error term \p i moved since its Jacobian was evaluated?
+      bool hasMoved(size_t i) const;
+
       /// \brief The transpose of the Jacobian matrix has better cache coherency.
       CompressedColumnMatrix<index_t> _J_transpose;
 
@@ -68,6 +106,46 @@ namespace aslam {
       /// \brief An array parallel to the error term array that maps error terms to parts of the Jacobian.
       std::vector<Evaluator> _jacobianPointers;
 
+      /// \brief The design variables of the current structure and their column bases
+      std::vector<DesignVariable*> _dvs;
+      std::vector<int> _columnBases;
+
+      /// \brief The number of leading error terms whose Jacobians are in J^T, the appended ones are evaluated in the next build
+      size_t _numBuiltErrorTerms = 0;
+
+      /// \brief The state of a design variable when the Jacobians depending on it were last evaluated
+      struct TrackedDesignVariable {
+        const DesignVariable* dv;
+        double accumulatedUpdateNorm;
+        std::size_t numParameterSets;
+        bool moved;
+      };
+
+      /// \brief The design variables of all error terms, active or not
+      std::vector<TrackedDesignVariable> _trackedDvs;
+
+      /// \brief The design variables of error term i are _trackedDvs[_termDvs[_termDvOffsets[i]..._termDvOffsets[i+1]]]
+      ///        for the error terms tracked so far
+      std::vector<size_t> _termDvOffsets;
+      std::vector<size_t> _termDvs;
+
+      double _relinearizationThreshold = -1.0;
+
+      /// \brief Do the values of J^T and the states in _trackedDvs belong to the last build?
+      bool _isChangeTrackingValid = false;
+
+      /// \brief The M-estimator setting of the last build
+      bool _lastUseMEstimator = false;
+
+      /// \brief Skip the error terms that did not move in the running build
+      bool _skipUnmoved = false;
+
+      std::atomic<std::size_t> _numSkipped;
+
+      std::atomic<std::size_t> _jacobianContainerMemory;
+
+      RelinearizationStatistics _relinearizationStatistics;
+
       /// \brief have we built the Jacobian from the transpose?
       bool _isJacobianBuiltFromJacobianTranspose;
 
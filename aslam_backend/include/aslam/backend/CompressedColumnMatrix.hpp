@@ -75,6 +75,9 @@ namespace aslam {
       /// \brief Get the number of non zeros
       size_t nnz() const;
 
+      /// \brief Bytes reserved for the values and the indices
+      size_t getMemoryUsage() const;
+
       /// \brief Get the underlying values
       const std::vector<double>& values() const;
 
@@ -0,0 +1,76 @@
+#ifndef ASLAM_DENSE_CHOLESKY_LINEAR_SYSTEM_SOLVER_HPP
+#define ASLAM_DENSE_CHOLESKY_LINEAR_SYSTEM_SOLVER_HPP
+
+#include "LinearSystemSolver.hpp"
+#include "DenseMatrix.hpp"
+
+#include <Eigen/Cholesky>
+
+namespace sm {
+
+  class PropertyTree;
+
+}
+namespace aslam {
+  namespace backend {
+
+    /**
+     * \class DenseCholeskyLinearSystemSolver
+     *
+     * \brief Solves the dense normal equations \f$ (\mathbf J^T \mathbf J + \mathbf D^2) \mathbf{dx} = \mathbf J^T \mathbf e \f$ with LDLT.
+     *
+     * Meant for problems with few parameters and many residuals. The Jacobian is never stored:
+     * every thread adds the weighted Jacobians of its error terms to an \f$ n \times n \f$ buffer of
+     * its own by rank-k updates, and the buffers are summed once all error terms are processed.
+     * The diagonal conditioner is only added to the small matrix, so trying another damping on the
+     * same system does not depend on the number of residuals.
+     */
+    class DenseCholeskyLinearSystemSolver : public LinearSystemSolver {
+    public:
+      DenseCholeskyLinearSystemSolver();
+      DenseCholeskyLinearSystemSolver(const sm::PropertyTree& config);
+      ~DenseCholeskyLinearSystemSolver() override;
+
+      /// \brief build the system of equations.
+      void buildSystem(size_t nThreads, bool useMEstimator) override;
+
+      /// \brief solve the system storing the solution in outDx and returning true on success.
+      bool solveSystem(Eigen::VectorXd& outDx) override;
+
+      /// \brief return the Hessian matrix \f$ \mathbf J^T \mathbf J \f$ (without the conditioner).
+      const Matrix* Hessian() const override {
+        return &_H;
+      }
+
+      std::string name() const override { return "dense_cholesky"; }
+
+      /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
+      double rhsJtJrhs() override;
+
+      /// \brief Memory of the Hessian, the partial Hessians of the build threads and the factorization
+      LinearSolverStatistics getStatistics() const override;
+
+    private:
+      /// \brief a method for a thread to add the error terms [startIdx, endIdx) to its buffers
+      void evaluateHessians(size_t threadId, size_t startIdx, size_t endIdx, bool useMEstimator);
+
+      /// \brief initialized the matrix structure for the problem with these error terms and errors.
+      void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
+
+      /// \brief the Hessian matrix
+      DenseMatrix _H;
+
+      /// \brief the upper triangles of the partial Hessians and the partial right hand sides of the threads
+      std::vector<Eigen::MatrixXd> _threadHessians;
+      std::vector<Eigen::VectorXd> _threadRhs;
+
+      /// \brief the damped Hessian (workspace) and its factorization
+      Eigen::MatrixXd _A;
+      Eigen::LDLT<Eigen::MatrixXd> _ldlt;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+
+#endif /* ASLAM_DENSE_CHOLESKY_LINEAR_SYSTEM_SOLVER_HPP */
@@ -6,6 +6,8 @@
 
 #include "aslam/backend/DenseQRLinearSolverOptions.h"
 
+#include <Eigen/QR>
+
 namespace sm {
 
   class PropertyTree;
@@ -14,6 +16,16 @@ namespace sm {
 namespace aslam {
   namespace backend {
 
+    /**
+     * \class DenseQrLinearSystemSolver
+     *
+     * \brief Solves the system with a column pivoting QR decomposition of the dense Jacobian.
+     *
+     * The Jacobian is factorized once per call to buildSystem(). A diagonal conditioner
+     * \f$ \mathbf D \f$ is applied to the \f$ n \times n \f$ factor R by Givens rotations
+     * (as in MINPACK's qrsolv), such that trying another damping on the same system does not
+     * depend on the number of residuals.
+     */
     class DenseQrLinearSystemSolver : public LinearSystemSolver {
     public:
       DenseQrLinearSystemSolver(const DenseQRLinearSolverOptions& options = DenseQRLinearSolverOptions());
@@ -43,11 +55,17 @@ namespace aslam {
 
       /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
       double rhsJtJrhs() override;
+
+      /// \brief Memory of the Jacobian and the factorization
+      LinearSolverStatistics getStatistics() const override;
     
     private:
       /// \brief a method for a thread to evaluate Jacobians
       void evaluateJacobians(size_t threadId, size_t startIdx, size_t endIdx, bool useMEstimator);
 
+      /// \brief factorize the Jacobian and store \f$ \mathbf Q^T \mathbf e \f$ of the current error
+      void factorize();
+
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
 
@@ -56,6 +74,22 @@ namespace aslam {
 
       Eigen::VectorXd _truncated_e;
 
+      /// \brief the QR decomposition of the Jacobian \f$ \mathbf J \mathbf P = \mathbf Q \mathbf R \f$
+      Eigen::ColPivHouseholderQR<Eigen::MatrixXd> _qr;
+
+      /// \brief is _qr up to date with the last call to buildSystem()?
+      bool _isFactorized = false;
+
+      /// \brief \f$ \mathbf Q^T \mathbf e \f$ (first n entries) at the time of the factorization
+      Eigen::VectorXd _qte;
+
+      /// \brief the triangular factor of the damped system and its right hand side (workspace)
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> _S;
+      Eigen::VectorXd _z;
+
+      /// \brief the row of the diagonal conditioner being rotated into _S (workspace)
+      Eigen::VectorXd _w;
+
       /// Options
       DenseQRLinearSolverOptions _options;
 
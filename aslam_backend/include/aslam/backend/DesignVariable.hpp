@@ -14,8 +14,10 @@
 namespace aslam {
   namespace backend {
     class CacheInterface;
+    class ParameterArena;
 
     class DesignVariable {
+      friend class ParameterArena;
     public:
 
       template <typename Expression>
@@ -61,6 +63,14 @@ namespace aslam {
       /// \brief Revert the last state update
       void revertUpdate();
 
+      /// \brief The sum of the max norms of all updates applied and reverted so far. It never decreases, the
+      ///        difference between two readings bounds how far the design variable moved in between.
+      double accumulatedUpdateNorm() const { return _accumulatedUpdateNorm; }
+
+      /// \brief The number of times the value was set with setParameters() or written in a ParameterArena,
+      ///        which is not tracked by accumulatedUpdateNorm()
+      std::size_t numParameterSets() const { return _numParameterSets; }
+
       /// \brief is this design variable active in the optimization.
       bool isActive() const { return _isActive; }
 
@@ -142,6 +152,12 @@ namespace aslam {
 
     private:
 
+      /// Called after the parameters were written directly, e.g. in a ParameterArena
+      void parametersWrittenExternally() {
+        invalidateCache();
+        ++_numParameterSets;
+      }
+
       /// Registers a cache expression that has to be reset each time the design variable changes its value
       void registerCacheExpressionNode(const boost::shared_ptr<CacheInterface>& cn);
 
@@ -164,6 +180,15 @@ namespace aslam {
       /// \brief The scaling of this design variable within the optimization.
       double _scaling;
 
+      /// \brief The sum of the max norms of the applied and reverted updates
+      double _accumulatedUpdateNorm;
+
+      /// \brief The max norm of the last update, added again by revertUpdate()
+      double _lastUpdateNorm;
+
+      /// \brief How often setParameters() was called
+      std::size_t _numParameterSets;
+
       /// \brief Cache expressions that have to be reseted
       std::vector< boost::weak_ptr<CacheInterface> > _cacheNodes;
     };
@@ -9,6 +9,7 @@
 #include <sm/eigen/NumericalDiff.hpp>
 #include <sm/timing/Timer.hpp>
 #include "MEstimatorPolicies.hpp"
+#include "SharedMemorySet.hpp"
 #include <sm/eigen/matrix_sqrt.hpp>
 #include <sm/timing/NsecTimeUtilities.hpp>
 
@@ -62,6 +63,12 @@ namespace aslam {
 
       virtual void getWeightedError(Eigen::VectorXd& e, bool useMEstimator) const = 0;
 
+      /// \brief add the vector-Jacobian product \f$ s \, \mathbf e_w^T \mathbf J_w \f$ of the weighted error and
+      ///        weighted Jacobians to \p outGradient, which must have a single row.
+      ///        The chain rule of \p outGradient is seeded with the row \f$ s \, \mathbf e_w^T \f$, so the Jacobians
+      ///        are never materialized and every chain rule product has a single row. The error has to be up to date.
+      void addWeightedGradient(JacobianContainer& outGradient, bool useMEstimator, double scale = 1.0);
+
       /// \brief get the current value of the error.
       /// This was put here to make the python interface easier to generate. It doesn't
       /// fit for quadratic integral terms so it may go away in future versions.
@@ -76,6 +83,9 @@ namespace aslam {
       template <typename MEstimatorType>
       boost::shared_ptr<MEstimatorType> getMEstimatorPolicy();
 
+      /// \brief returns the MEstimator used.
+      const boost::shared_ptr<MEstimator>& mEstimatorPolicy() const { return _mEstimatorPolicy; }
+
       /// \brief set the M-Estimator policy. This function takes a squared error
       ///        and returns a weight to apply to that error term.
       void setMEstimatorPolicy(const boost::shared_ptr<MEstimator> & mEstimator);
@@ -146,6 +156,14 @@ namespace aslam {
       void setTime(const sm::timing::NsecTime& t);
       sm::timing::NsecTime getTime() { return _timestamp; }
 
+      /// \brief Bytes held by the error term. The default counts the members of ErrorTerm, derived classes add their
+      ///        own members and the expressions they own. Used for the memory accounting of the optimizers.
+      virtual std::size_t getMemoryUsage() const;
+
+      /// \brief Like getMemoryUsage(), but parts shared with other error terms are only counted if they are not in
+      ///        \p counted yet, and are added to it. The default counts getMemoryUsage(), i.e. nothing is shared.
+      virtual std::size_t accountMemoryUsage(SharedMemorySet& /* counted */) const { return getMemoryUsage(); }
+
     protected:
 
       /// \brief evaluate the error term and return the weighted squared error e^T invR e
@@ -245,6 +263,8 @@ namespace aslam {
       void getWeightedJacobians(JacobianContainer& outJc, bool useMEstimator) override;
       void getWeightedError(Eigen::VectorXd& e, bool useMEstimator) const override;
 
+      std::size_t getMemoryUsage() const override;
+
       /// Check if Jacobians are finite
       void checkJacobiansFinite() const;
       /// Check if analytical and numerical Jacobians match
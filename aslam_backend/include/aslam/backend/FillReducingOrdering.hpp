@@ -0,0 +1,45 @@
+#ifndef ASLAM_BACKEND_FILL_REDUCING_ORDERING_HPP
+#define ASLAM_BACKEND_FILL_REDUCING_ORDERING_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace aslam {
+  namespace backend {
+
+    class DesignVariable;
+
+    /**
+     * \enum FillReducingOrdering
+     *
+     * \brief Fill-reducing orderings for the symbolic Cholesky factorization.
+     */
+    enum class FillReducingOrdering {
+      AMD,         /// \brief Approximate minimum degree on the normal equations (CHOLMOD default)
+      COLAMD,      /// \brief Column approximate minimum degree on the Jacobian
+      CONSTRAINED, /// \brief Constrained minimum degree (CCOLAMD/CAMD) keeping selected design variables last
+      NESDIS       /// \brief Nested dissection (requires CHOLMOD with the Partition module, falls back to AMD otherwise)
+    };
+
+    /// \brief Parses "amd", "colamd", "constrained" or "nesdis" (case sensitive)
+    FillReducingOrdering fillReducingOrderingFromString(const std::string& ordering);
+    std::ostream& operator<<(std::ostream& out, const FillReducingOrdering& ordering);
+
+    /**
+     * \brief Computes the constraint set of every design variable for a constrained ordering.
+     *
+     * Design variable i is assigned to set 1 (eliminated last) if it is contained in \p orderLast
+     * or if it is one of the last \p numLast design variables in \p dvs. All others are assigned to set 0.
+     *
+     * @return true if at least one design variable is constrained.
+     */
+    bool computeOrderingConstraints(const std::vector<DesignVariable*>& dvs,
+                                    const std::vector<const DesignVariable*>& orderLast,
+                                    int numLast,
+                                    std::vector<int>& outConstraints);
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_FILL_REDUCING_ORDERING_HPP */
@@ -0,0 +1,132 @@
+#ifndef ASLAM_BACKEND_JACOBIAN_CHECKER_HPP
+#define ASLAM_BACKEND_JACOBIAN_CHECKER_HPP
+
+#include <aslam/Exceptions.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    class ErrorTerm;
+
+    struct JacobianCheckerOptions {
+      /// \brief The fraction of error terms checked per run, chosen at random (1.0 checks all of them)
+      double sampleFraction = 1.0;
+
+      /// \brief The maximum number of error terms checked per run (0 means no limit)
+      size_t maxErrorTerms = 0;
+
+      /// \brief Wall time in seconds after which no further error terms are started (<= 0 means no limit)
+      double timeBudget = 0.0;
+
+      /// \brief The number of threads checking error terms concurrently. Error terms sharing an active design variable
+      ///        are never checked concurrently, see JacobianChecker.
+      size_t numThreads = 1;
+
+      /// \brief The step of the central differences in the minimal coordinates of the design variables
+      double stepSize = 1e-6;
+
+      /// \brief An error term fails the check if the relative error of any Jacobian entry exceeds this value
+      double tolerance = 1e-4;
+
+      /// \brief The number of worst offenders kept in the report
+      size_t numWorstOffenders = 10;
+
+      /// \brief The seed of the random error term selection
+      std::uint32_t seed = 0;
+    };
+
+    std::ostream& operator<<(std::ostream& out, const JacobianCheckerOptions& options);
+
+    /**
+     * \class JacobianChecker
+     *
+     * \brief Compares the analytic Jacobians of error terms with central differences.
+     *
+     * Every run checks a random subset of the error terms. Error terms are scheduled in rounds
+     * in which no two error terms share an active design variable, such that the error terms of one
+     * round can perturb their design variables concurrently without seeing each other's perturbations.
+     * Evaluating error terms that share no design variable in parallel is what ProblemManager does anyway,
+     * so no additional thread safety is required from the error terms. The price is that error terms sharing a
+     * design variable are checked one after the other: if every error term depends on one common design variable
+     * (e.g. a calibration parameter), all rounds hold a single error term and numThreads has no effect.
+     *
+     * The errors are measured relative to \f$ \max(1, |J_{ij}|) \f$ and only the worst offenders are reported.
+     * Successive runs of the same checker draw different subsets, so a cheap check (small sample fraction
+     * or time budget) can be run regularly, e.g. from an optimizer callback, and still cover the whole problem over time.
+     */
+    class JacobianChecker {
+    public:
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      /// \brief The largest deviation found in one error term
+      struct Offender {
+        /// \brief The index of the error term in the checked list
+        size_t errorTermIndex = 0;
+        /// \brief The error term
+        const ErrorTerm* errorTerm = nullptr;
+        /// \brief The dynamic type of the error term
+        std::string typeName;
+        /// \brief The index of the design variable within the error term
+        size_t designVariableIndex = 0;
+        /// \brief The row (error dimension) of the worst entry
+        size_t row = 0;
+        /// \brief The column (minimal dimension of the design variable) of the worst entry
+        size_t col = 0;
+        /// \brief The analytic Jacobian entry
+        double analytic = 0.0;
+        /// \brief The central difference estimate of the entry
+        double numerical = 0.0;
+        /// \brief \f$ |J^a_{ij} - J^n_{ij}| \f$
+        double absoluteError = 0.0;
+        /// \brief \f$ |J^a_{ij} - J^n_{ij}| / \max(1, |J^a_{ij}|) \f$
+        double relativeError = 0.0;
+      };
+
+      /// \brief The outcome of one run
+      struct Report {
+        /// \brief The number of error terms the sample was drawn from
+        size_t numErrorTerms = 0;
+        /// \brief The number of error terms selected for this run
+        size_t numSampled = 0;
+        /// \brief The number of error terms actually checked (less than numSampled if the time budget ran out)
+        size_t numChecked = 0;
+        /// \brief The number of checked error terms exceeding the tolerance
+        size_t numFailed = 0;
+        /// \brief Did the time budget run out before all sampled error terms were checked?
+        bool timeBudgetExceeded = false;
+        /// \brief Wall time of the run in seconds
+        double time = 0.0;
+        /// \brief The worst checked error terms, sorted by decreasing relative error
+        std::vector<Offender> worstOffenders;
+
+        /// \brief True if no checked error term exceeded the tolerance
+        bool passed() const { return numFailed == 0; }
+      };
+
+      JacobianChecker();
+      explicit JacobianChecker(const JacobianCheckerOptions& options);
+
+      /// \brief Check a random subset of \p errorTerms. The design variables are unchanged afterwards
+      ///        and every checked error term has been re-evaluated at the current state.
+      Report check(const std::vector<ErrorTerm*>& errorTerms);
+
+      const JacobianCheckerOptions& options() const { return _options; }
+      JacobianCheckerOptions& options() { return _options; }
+
+    private:
+      JacobianCheckerOptions _options;
+      std::mt19937 _rng;
+    };
+
+    std::ostream& operator<<(std::ostream& out, const JacobianChecker::Report& report);
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_JACOBIAN_CHECKER_HPP */
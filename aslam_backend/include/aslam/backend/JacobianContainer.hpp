@@ -70,6 +70,9 @@ namespace aslam {
       /// \brief How many rows does this set of Jacobians have?
       int rows() const { return _rows; }
 
+      /// \brief Bytes held by the container, including the reserve of the chain rule stack
+      virtual std::size_t getMemoryUsage() const { return MatrixStack::getMemoryUsage(); }
+
       /// \brief How many rows does this set of Jacobians currently expect for a newly added matrix?
       int expectedRows() const { return chainRuleEmpty() ? rows() : numTopCols(); }
 
@@ -114,6 +114,9 @@ namespace aslam {
 
       /// The number of columns in the compressed Jacobian. Warning: this is expensive.
       int cols() const;
+
+      /// \brief Bytes held by the container, including the Jacobian blocks
+      std::size_t getMemoryUsage() const override;
     private:
 
       void buildCorrelatedHessianBlock(const Eigen::VectorXd& e,
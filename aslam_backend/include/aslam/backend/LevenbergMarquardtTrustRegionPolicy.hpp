@@ -12,6 +12,17 @@ class ConstPropertyTree;
 namespace aslam {
     namespace backend {
         
+        /**
+         * \class LevenbergMarquardtTrustRegionPolicy
+         *
+         * \brief Levenberg-Marquardt damping with Nielsen's update rule.
+         *
+         * With speculation enabled (setNumSpeculativeSteps() > 1) a rejected damping does not cost an iteration:
+         * the policy solves for the current damping and then for the next dampings it would try after rejections,
+         * evaluating the cost after each step, until a step decreases the cost. The damping state continues from
+         * the proposed step. This needs an optimizer providing a step evaluator (Optimizer2 does, and reuses the
+         * cost of the proposed step).
+         */
         class LevenbergMarquardtTrustRegionPolicy : public TrustRegionPolicy
         {
         public:
@@ -33,8 +44,19 @@ namespace aslam {
           std::ostream & printState(std::ostream & out) const override;
           bool requiresAugmentedDiagonal() const override;
           std::string name() const override { return "levenberg_marquardt"; }
+
+          /// \brief The number of dampings tried per iteration. Values below 2 disable speculation (the default).
+          void setNumSpeculativeSteps(size_t numSpeculativeSteps) { _numSpeculativeSteps = numSpeculativeSteps; }
+          size_t getNumSpeculativeSteps() const { return _numSpeculativeSteps; }
         private:
           double getLmRho(const Eigen::VectorXd & dx);
+
+          /// \brief Solve for and evaluate up to _numSpeculativeSteps dampings, stopping at the first accepted one
+          bool solveSpeculatively(Eigen::VectorXd& outDx);
+
+          size_t _numSpeculativeSteps = 0;
+          /// \brief the cost at the current linearization point
+          double _linearizationCost = 0.0;
           double _lambdaInit;
           double _gammaInit;
           double _betaInit;
@@ -188,6 +188,14 @@ namespace aslam {
       std::size_t nMaxIterWolfe1 = 30; /// \brief Maximum number of iterations for method wolfe1
       std::size_t nMaxIterWolfe2 = 10; /// \brief Maximum number of iterations for method wolfe2
       std::size_t nMaxIterZoom = 10;   /// \brief Maximum number of iterations for the internal zoom method
+      /**
+       * \brief Number of step lengths tried before wolfe1 starts its bracketing (values below 2 disable this, the default).
+       * The initial step length is scaled by powers of two around the usual guess, largest first, until a candidate
+       * satisfies the sufficient decrease condition, and that one (or else the one with the lowest error) is handed to
+       * dcsrch as its initial step. This trades error evaluations for gradient evaluations and dcsrch iterations when
+       * the initial guess is poor.
+       */
+      std::size_t numSpeculativeSteps = 0;
 
       template<class Archive>
       inline void serialize(Archive & ar, const unsigned int version);
@@ -324,6 +332,13 @@ namespace aslam {
 
     private: // private methods
 
+      /**
+       * Evaluates the error at up to options().numSpeculativeSteps step lengths around \p stepLength, largest first, and stops at the
+       * first one satisfying the sufficient decrease condition. Without such a candidate it moves the state to the one with the lowest error.
+       * @return The chosen step length, the error there is up to date.
+       */
+      double speculateInitialStepLength(double stepLength);
+
       /**
        * Part of the optimization algorithm in scalarSearchWolfe2.
        */
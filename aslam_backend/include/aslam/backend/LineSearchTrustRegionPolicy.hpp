@@ -6,6 +6,16 @@
 namespace aslam {
 namespace backend {
 
+/**
+ * \class LineSearchTrustRegionPolicy
+ *
+ * \brief Gauss-Newton steps that are scaled down by scaleStep after every rejected step.
+ *
+ * With speculation enabled (setNumSpeculativeSteps() > 1) a rejected step does not cost an iteration: the
+ * policy evaluates the cost after the step and then after the next scaled down steps it would try after
+ * rejections, until a step decreases the cost, and proposes that one. This needs an optimizer providing a
+ * step evaluator (Optimizer2 does, and reuses the cost of the proposed step).
+ */
 class LineSearchTrustRegionPolicy : public TrustRegionPolicy {
  public:
   /// \brief Construct LineSearchTrustRegionPolicy
@@ -31,10 +41,20 @@ class LineSearchTrustRegionPolicy : public TrustRegionPolicy {
 
   bool isResetScaleAfterSuccess() const { return _resetScaleAfterSuccess; }
   void setResetScaleAfterSuccess(bool resetScaleAfterSuccess) { _resetScaleAfterSuccess = resetScaleAfterSuccess; }
+
+  /// \brief The number of scales tried per iteration. Values below 2 disable speculation (the default).
+  void setNumSpeculativeSteps(size_t numSpeculativeSteps) { _numSpeculativeSteps = numSpeculativeSteps; }
+  size_t getNumSpeculativeSteps() const { return _numSpeculativeSteps; }
  private:
+  /// \brief Evaluate \p outDx scaled by up to _numSpeculativeSteps powers of the scale step, starting at \p firstScale, and keep the first accepted one
+  void solveSpeculatively(double firstScale, Eigen::VectorXd& outDx);
+
   double _scaleStep;
   bool _resetScaleAfterSuccess;
   double _currentScale = 1.0;
+  size_t _numSpeculativeSteps = 0;
+  /// \brief the cost at the current linearization point
+  double _linearizationCost = 0.0;
 };
 
 }  // namespace backend
@@ -0,0 +1,156 @@
+#ifndef ASLAM_BACKEND_LINEAR_SYSTEM_CAPTURE_HPP
+#define ASLAM_BACKEND_LINEAR_SYSTEM_CAPTURE_HPP
+
+#include <aslam/backend/LinearSystemSolver.hpp>
+#include <aslam/Exceptions.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    class TrustRegionPolicy;
+
+    /**
+     * \class CapturingLinearSystemSolver
+     *
+     * \brief Records the linearised systems seen by a linear system solver for offline replay.
+     *
+     * The capturing solver wraps another solver and forwards all calls to it. On every
+     * initMatrixStructure() it records the block structure of the Jacobian (design variable
+     * dimensions and which design variables each error term depends on), on every buildSystem()
+     * the weighted Jacobian blocks and weighted errors of all error terms, and on every
+     * solveSystem() the conditioner (damping) in effect, the solution and the solve time.
+     * The recorded file can be fed to any solver or trust region policy with LinearSystemReplay,
+     * without the error terms that produced it.
+     *
+     * Capturing evaluates the Jacobians a second time on every buildSystem() and is meant
+     * for diagnostics only.
+     */
+    class CapturingLinearSystemSolver : public LinearSystemSolver {
+    public:
+      CapturingLinearSystemSolver(const boost::shared_ptr<LinearSystemSolver>& solver, const std::string& fileName);
+      ~CapturingLinearSystemSolver() override;
+
+      double evaluateError(size_t nThreads, bool useMEstimator, callback::Manager * callback = nullptr) override;
+      double evaluateTrialError(size_t nThreads, bool useMEstimator) override;
+      void acceptTrialError() override;
+      void buildSystem(size_t nThreads, bool useMEstimator) override;
+      void setConditioner(const Eigen::VectorXd& diag) override;
+      void setConstantConditioner(double diag) override;
+      bool solveSystem(Eigen::VectorXd& outDx) override;
+      void setCancellationToken(const util::CancellationToken* token) override { _solver->setCancellationToken(token); }
+      const util::CancellationToken* getCancellationToken() const override { return _solver->getCancellationToken(); }
+
+      /// \brief The name of the wrapped solver, such that solver specific behavior of the optimizer is unchanged
+      std::string name() const override { return _solver->name(); }
+
+      const Eigen::VectorXd& rhs() const override { return _solver->rhs(); }
+      const Matrix* Jacobian() const override { return _solver->Jacobian(); }
+      const Matrix* Hessian() const override { return _solver->Hessian(); }
+      const Eigen::VectorXd& e() const override { return _solver->e(); }
+      double rhsJtJrhs() override { return _solver->rhsJtJrhs(); }
+      LinearSolverStatistics getStatistics() const override { return _solver->getStatistics(); }
+
+      /// \brief The wrapped solver
+      const boost::shared_ptr<LinearSystemSolver>& solver() const { return _solver; }
+
+      /// \brief The number of linearised systems (calls to buildSystem()) written so far
+      size_t numCapturedSystems() const { return _numCapturedSystems; }
+
+    private:
+      void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
+      void handleNewAcceptConstantErrorTerms() override;
+
+      /// \brief The solver doing the actual work
+      boost::shared_ptr<LinearSystemSolver> _solver;
+      /// \brief The capture file
+      std::ofstream _out;
+      /// \brief The index of every design variable in the current structure
+      std::unordered_map<const DesignVariable*, size_t> _designVariableIndices;
+      /// \brief The design variables of every error term in the current structure
+      std::vector< std::vector<DesignVariable*> > _errorTermDesignVariables;
+      /// \brief The number of linearised systems written so far
+      size_t _numCapturedSystems;
+    };
+
+    /**
+     * \class LinearSystemReplay
+     *
+     * \brief Replays linearised systems recorded by CapturingLinearSystemSolver.
+     *
+     * Every recorded system is rebuilt from simple vector design variables and linear error terms
+     * \f$ \mathbf e(\mathbf x) = \mathbf e_0 + \sum_k \mathbf J_k \mathbf x_k \f$ with the recorded
+     * (already weighted) Jacobian blocks, such that the solvers see exactly the recorded Jacobian
+     * and right hand side while the cost of evaluating error terms is negligible.
+     */
+    class LinearSystemReplay {
+    public:
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      /// \brief Timing and accuracy of one replayed solve
+      struct SolveResult {
+        /// \brief The index of the replayed system
+        size_t system = 0;
+        /// \brief Time spent in buildSystem() in seconds (only set for the first solve of a system)
+        double buildTime = 0.0;
+        /// \brief Time spent in solveSystem() in seconds
+        double solveTime = 0.0;
+        /// \brief Did the solver report success?
+        bool success = false;
+        /// \brief \f$ \|(\mathbf J^T \mathbf J + \mathbf D^2) \delta\mathbf x + \mathbf J^T \mathbf e\| / \|\mathbf J^T \mathbf e\| \f$
+        double relativeResidual = 0.0;
+        /// \brief Relative difference to the recorded solution
+        double relativeDifference = 0.0;
+      };
+
+      /// \brief Outcome of running a trust region policy on one replayed system
+      struct PolicyResult {
+        /// \brief The index of the replayed system
+        size_t system = 0;
+        /// \brief Time spent in the trust region policy (including the linear solver) in seconds
+        double time = 0.0;
+        /// \brief The cost at the linearisation point
+        double initialCost = 0.0;
+        /// \brief The cost of the linear model after the last accepted step
+        double finalCost = 0.0;
+        /// \brief Number of iterations run
+        size_t numIterations = 0;
+        /// \brief Number of iterations that were rejected or where the solver failed
+        size_t numFailedIterations = 0;
+      };
+
+      explicit LinearSystemReplay(const std::string& fileName);
+      ~LinearSystemReplay();
+
+      /// \brief The number of recorded linearised systems
+      size_t numSystems() const;
+
+      /// \brief The number of recorded solves (one per conditioner / damping value tried)
+      size_t numSolves() const;
+
+      /// \brief Build and solve every recorded system with \p solver, once for every recorded conditioner.
+      std::vector<SolveResult> replay(const boost::shared_ptr<LinearSystemSolver>& solver, size_t nThreads = 1);
+
+      /// \brief Run up to \p maxIterations iterations of \p policy with \p solver on every recorded system.
+      ///        Steps that increase the cost of the linear model are reverted as in Optimizer2.
+      std::vector<PolicyResult> replay(TrustRegionPolicy& policy, const boost::shared_ptr<LinearSystemSolver>& solver,
+                                       size_t maxIterations, size_t nThreads = 1);
+
+    private:
+      class Implementation;
+      Implementation* _impl;
+
+      LinearSystemReplay(const LinearSystemReplay&) = delete;
+      LinearSystemReplay& operator=(const LinearSystemReplay&) = delete;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_LINEAR_SYSTEM_CAPTURE_HPP */
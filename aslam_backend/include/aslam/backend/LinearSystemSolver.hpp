@@ -17,6 +17,28 @@ namespace aslam {
       class Manager;
     }
 
+    namespace util {
+      class CancellationToken;
+    }
+
+    /// \brief Memory and work statistics of the last factorization of a linear system solver
+    struct LinearSolverStatistics {
+      /// \brief Memory currently held by the factorization library in bytes
+      std::size_t memoryInUse = 0;
+      /// \brief Peak memory used by the factorization library in bytes
+      std::size_t peakMemoryUsage = 0;
+      /// \brief Floating point operations of the last factorization
+      double flops = 0.0;
+      /// \brief Number of non-zeros in the factor
+      double factorNonZeros = 0.0;
+      /// \brief Memory of the assembled Jacobian in bytes
+      std::size_t jacobianMemory = 0;
+      /// \brief Memory of the assembled Hessian in bytes
+      std::size_t hessianMemory = 0;
+      /// \brief Memory of the Jacobian containers alive at the same time in the last build in bytes
+      std::size_t jacobianContainerMemory = 0;
+    };
+
     class LinearSystemSolver {
     public:
       SM_DEFINE_EXCEPTION(Exception, std::runtime_error);
@@ -26,7 +48,15 @@ namespace aslam {
       virtual ~LinearSystemSolver();
 
       /// \brief Evaluate the error using nThreads.
-      double evaluateError(size_t nThreads, bool useMEstimator, callback::Manager * callback = nullptr);
+      virtual double evaluateError(size_t nThreads, bool useMEstimator, callback::Manager * callback = nullptr);
+
+      /// \brief Evaluate the error at a trial point using nThreads. Unlike evaluateError() the error vector e() keeps
+      ///        the error of the linearization point, which some solvers use as right-hand side of the next solve.
+      virtual double evaluateTrialError(size_t nThreads, bool useMEstimator);
+
+      /// \brief Make the error of the last evaluateTrialError() the error vector e(). Call it only after moving the
+      ///        state to that trial point, instead of evaluating the error there again.
+      virtual void acceptTrialError();
 
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       void initMatrixStructure(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner);
@@ -72,11 +102,21 @@ namespace aslam {
       // helper function for dog leg implementation / steepest descent solution
       virtual double rhsJtJrhs() = 0;
 
+      /// \brief Memory and flop statistics of the last build and factorization. Solvers that don't track them return zeros.
+      virtual LinearSolverStatistics getStatistics() const {
+        return LinearSolverStatistics();
+      }
+
       /// \brief If enabled the system builder must not throw on constant error terms (:= not depending on any active design variable)
       bool isAcceptConstantErrorTerms() const {
         return _acceptConstantErrorTerms;
       }
       void setAcceptConstantErrorTerms(bool acceptConstantErrorTerms);
+
+      /// \brief Poll \p token in the threaded error loops and throw CancellationToken::Cancelled once it is cancelled.
+      ///        The token is not owned, pass nullptr to stop polling.
+      virtual void setCancellationToken(const util::CancellationToken* token) { _cancellationToken = token; }
+      virtual const util::CancellationToken* getCancellationToken() const { return _cancellationToken; }
     protected:
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       virtual void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) = 0;
@@ -103,6 +143,9 @@ namespace aslam {
       /// \brief the error vector;
       Eigen::VectorXd _e;
 
+      /// \brief the error vector of the last trial point, swapped with _e during evaluateTrialError()
+      Eigen::VectorXd _trialE;
+
       /// \brief the linear system rhs.
       Eigen::VectorXd _rhs;
 
@@ -120,6 +163,9 @@ namespace aslam {
 
       /// \brief The number of columns in the Jacobian matrix
       size_t _JCols;
+
+      /// \brief Polled in the threaded error loops, not owned
+      const util::CancellationToken* _cancellationToken = nullptr;
     };
 
   } // namespace backend
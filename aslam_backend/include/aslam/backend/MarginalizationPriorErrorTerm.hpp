@@ -33,11 +33,21 @@ public:
                                 const Eigen::VectorXd& d,
                                 const Eigen::MatrixXd& R);
 
+  // creates the marginalization error term with explicitly given values of the design variables at marginalization
+  MarginalizationPriorErrorTerm(const std::vector<DesignVariable*>& designVariables,
+                                const Eigen::VectorXd& d,
+                                const Eigen::MatrixXd& R,
+                                const std::vector<Eigen::MatrixXd>& designVariableValuesAtMarginalization);
+
   ~MarginalizationPriorErrorTerm() override;
 
   int numDesignVariables() { return _designVariables.size(); }
   aslam::backend::DesignVariable* getDesignVariable(int i);
 
+  const Eigen::VectorXd& d() const { return _d; }
+  const Eigen::MatrixXd& R() const { return _R; }
+  const std::vector<Eigen::MatrixXd>& designVariableValuesAtMarginalization() const { return _designVariableValuesAtMarginalization; }
+
 private:
   MarginalizationPriorErrorTerm();
 
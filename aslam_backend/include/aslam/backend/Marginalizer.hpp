@@ -16,6 +16,16 @@
 namespace aslam {
 namespace backend {
 
+/// \brief How marginalize() eliminates the design variables to remove
+enum class MarginalizationMethod {
+  /// \brief Householder QR of the dense Jacobian of all input error terms
+  DenseQr,
+  /// \brief Schur complement of the removed block in the Hessian, which is assembled from the Jacobian blocks of the
+  ///        error terms without forming the dense Jacobian. Only dense matrices of the size of the Markov blanket are
+  ///        factorized (rank revealing LDLT), which is much cheaper when there are many more residuals than parameters.
+  SchurComplement
+};
+
 /// \brief Marginalizes out the given design variables
 ///
 ///	\param[IN] inDesignVariables list of input design variables to be marginalized
@@ -26,6 +36,11 @@ namespace backend {
 ///												input desing variables list matters!
 /// \param[IN] useMEstimator					Wheter or not to use an M-Estimator in the QR sovler.
 /// \param[OUT] outPriorErrorTermPtr			Shared pointer to the resulting marginalized prior error term.
+/// \param[OUT] outRtop						The top left numTopRowsInRtop x numTopRowsInRtop block of the covariance of all input design variables.
+/// \param[OUT] designVariablesInvolvedInRtop	The input design variables covered by outRtop.
+/// \param[IN] numTopRowsInRtop				The size of outRtop. No covariance is computed if this is zero.
+/// \param[IN] numThreads						The number of threads used to evaluate the error terms and build the system.
+/// \param[IN] method							How the design variables are eliminated.
 ///
 void marginalize(
 			std::vector<aslam::backend::DesignVariable*>& inDesignVariables,
@@ -36,7 +51,8 @@ void marginalize(
 			Eigen::MatrixXd& outRtop,
 			std::vector<aslam::backend::DesignVariable*>& designVariablesInvolvedInRtop,
 			size_t numTopRowsInRtop = 0,
-			size_t numThreads = 1
+			size_t numThreads = 1,
+			MarginalizationMethod method = MarginalizationMethod::DenseQr
 		);
 } /* namespace backend */
 } /* namespace aslam */
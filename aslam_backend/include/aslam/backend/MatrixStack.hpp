@@ -126,6 +126,9 @@ namespace backend {
     /// \brief Number of matrix elements stored
     std::size_t numElements() const { return _dataSize; }
 
+    /// \brief Bytes reserved for the matrices and their headers
+    std::size_t getMemoryUsage() const { return _data.capacity()*sizeof(Scalar) + _headers.capacity()*sizeof(Header); }
+
     /// \brief Push a matrix \p mat to the top of the stack
     template <typename DERIVED>
     EIGEN_ALWAYS_INLINE void push(const Eigen::MatrixBase<DERIVED>& mat)
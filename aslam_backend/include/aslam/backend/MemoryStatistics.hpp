@@ -0,0 +1,107 @@
+#ifndef ASLAM_BACKEND_MEMORY_STATISTICS_HPP
+#define ASLAM_BACKEND_MEMORY_STATISTICS_HPP
+
+#include <Eigen/Core>
+#include <sparse_block_matrix/sparse_block_matrix.h>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    class DesignVariable;
+    class ErrorTerm;
+    class OptimizationProblemBase;
+
+    /// \brief Current and peak bytes of one part of the optimization
+    struct MemoryUsage {
+      std::size_t current = 0; /// \brief Bytes held at the last update
+      std::size_t peak = 0; /// \brief Largest number of bytes seen since the last reset
+
+      /// \brief Set the current bytes and raise the peak to \p peakBytes if it is larger
+      void set(std::size_t bytes, std::size_t peakBytes = 0);
+    };
+
+    /**
+     * \struct MemoryStatistics
+     *
+     * \brief Bytes held by the parts of the optimization, to find out which one dominates on large problems.
+     *
+     * The numbers are computed from the sizes of the data structures, allocator overhead is not included.
+     * Linear system solvers that don't hold a part report zero for it.
+     */
+    struct MemoryStatistics {
+      MemoryUsage errorTerms; /// \brief The error terms and the expressions they own, see ErrorTerm::getMemoryUsage()
+      MemoryUsage jacobianContainers; /// \brief The JacobianContainer temporaries alive at the same time while building the system
+      MemoryUsage jacobian; /// \brief The assembled Jacobian, e.g. the CompressedColumnMatrix of the sparse solvers
+      MemoryUsage hessian; /// \brief The assembled Hessian, e.g. the SparseBlockMatrix of the block Cholesky solver
+      MemoryUsage factor; /// \brief The factorization, including the workspace of CHOLMOD
+
+      /// \brief The sum of the current bytes
+      std::size_t current() const;
+      /// \brief The sum of the peaks. An upper bound of the joint peak, as the parts peak at different times.
+      std::size_t peak() const;
+    };
+
+    /// \brief Stream operator for MemoryStatistics, in the layout of the timing output
+    std::ostream& operator<<(std::ostream& out, const MemoryStatistics& statistics);
+
+    /**
+     * \struct MemoryEstimate
+     *
+     * \brief Memory needed to optimize a problem, estimated from its structure before anything is allocated.
+     *
+     * The fill-in of sparse factorizations depends on the ordering, which is not known before the symbolic
+     * analysis. The sparse estimates therefore count the factor with the non-zeros of the Hessian, which is a
+     * lower bound. The dense estimates are exact up to small workspaces.
+     */
+    struct MemoryEstimate {
+      std::size_t jacobianRows = 0; /// \brief Rows of the Jacobian
+      std::size_t jacobianCols = 0; /// \brief Columns of the Jacobian, the number of active parameters
+      std::size_t jacobianNonZeros = 0; /// \brief Structural non-zeros of the Jacobian
+      std::size_t hessianNonZeros = 0; /// \brief Structural non-zeros of the upper triangle of the Hessian, including the diagonal
+      std::size_t hessianBlocks = 0; /// \brief Non-zero blocks of the upper triangle of the Hessian
+      std::size_t errorTerms = 0; /// \brief Bytes of the error terms, see ErrorTerm::getMemoryUsage()
+      std::size_t jacobianContainers = 0; /// \brief Bytes of the Jacobian container temporaries of all build threads
+
+      /// \brief Bytes needed by the sparse_cholesky solver
+      std::size_t sparseCholesky() const;
+      /// \brief Bytes needed by the sparse_qr solver
+      std::size_t sparseQr() const;
+      /// \brief Bytes needed by the block_cholesky solver
+      std::size_t blockCholesky() const;
+      /// \brief Bytes needed by the dense_cholesky solver
+      std::size_t denseCholesky() const;
+      /// \brief Bytes needed by the dense_qr solver
+      std::size_t denseQr() const;
+      /// \brief Bytes needed by the solver called \p solverName, see LinearSystemSolver::name(). Throws for unknown solvers.
+      std::size_t forSolver(const std::string& solverName) const;
+    };
+
+    /// \brief Stream operator for MemoryEstimate
+    std::ostream& operator<<(std::ostream& out, const MemoryEstimate& estimate);
+
+    /// \brief Estimate the memory needed to optimize the active design variables \p dvs with the error terms \p errors,
+    ///        building the system with \p numThreads threads. Only the structure is inspected, nothing is evaluated.
+    MemoryEstimate estimateMemoryUsage(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, std::size_t numThreads = 1);
+
+    /// \brief Estimate the memory needed to optimize \p problem, see above
+    MemoryEstimate estimateMemoryUsage(OptimizationProblemBase& problem, std::size_t numThreads = 1);
+
+    /// \brief Bytes held by the blocks of \p M
+    std::size_t getMemoryUsage(const sparse_block_matrix::SparseBlockMatrix<Eigen::MatrixXd>& M);
+
+    /// \brief Bytes of a node of a std::map or std::set holding values of type \p Value
+    template <typename Value>
+    constexpr std::size_t mapNodeMemoryUsage() {
+      // The red-black tree nodes of the common standard libraries hold a color and three pointers
+      return sizeof(Value) + 4 * sizeof(void*);
+    }
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_MEMORY_STATISTICS_HPP */
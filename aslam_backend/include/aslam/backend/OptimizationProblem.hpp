@@ -4,6 +4,7 @@
 #include "OptimizationProblemBase.hpp"
 #include <boost/shared_ptr.hpp>
 #include <vector>
+#include <string>
 
 #include <unordered_map>
 
@@ -61,6 +62,16 @@ namespace aslam {
 
       size_t countActiveDesignVariables();
 
+      /// \brief Write a binary snapshot of this problem (see ProblemSnapshot).
+      void save(const std::string& fileName) const;
+
+      /// \brief Replace the content of this problem by the snapshot in \p fileName (see ProblemSnapshot).
+      void load(const std::string& fileName);
+
+      /// \brief Restore the design variable parameters from the snapshot in \p fileName.
+      ///        The snapshot has to be taken from a problem with the same structure.
+      void loadParameters(const std::string& fileName);
+
     protected:
       size_t numDesignVariablesImplementation() const override;
       DesignVariable* designVariableImplementation(size_t i) override;
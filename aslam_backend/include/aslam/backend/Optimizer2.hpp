@@ -20,6 +20,7 @@
 #include <aslam/backend/GaussNewtonTrustRegionPolicy.hpp>
 #include <aslam/backend/DogLegTrustRegionPolicy.hpp>
 #include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+#include <aslam/backend/MemoryStatistics.hpp>
 
 namespace sm {
 
@@ -58,6 +59,8 @@ namespace aslam {
       typedef Optimizer2Options Options;
       struct Status : public OptimizerStatus {
         SolutionReturnValue srv;
+        LinearSolverStatistics linearSolverStatistics; /// \brief Memory usage and flop count of the last linear system solution
+        MemoryStatistics memory; /// \brief Bytes held by the parts of the optimization, updated after each linear system solution
        private:
         void resetImplementation() override;
       };
@@ -120,6 +123,13 @@ namespace aslam {
       /// \brief print the internal timing information.
       void printTiming() const;
 
+      /// \brief print the memory held by the parts of the optimization, see Status::memory.
+      void printMemoryUsage() const;
+
+      /// \brief Estimate the memory needed to optimize the problem from its structure, before anything is allocated.
+      ///        The problem has to be set, the estimate of the configured linear solver is MemoryEstimate::forSolver().
+      MemoryEstimate estimateMemoryUsage();
+
       /// \brief Do a bunch of checks to see if the problem is well-defined. This includes checking that every error term is
       ///        hooked up to design variables and running finite differences on error terms where this is possible.
       void checkProblemSetup() override;
@@ -157,6 +167,18 @@ namespace aslam {
       /// \brief Apply a state update.
       double applyStateUpdate();
 
+      /// \brief Apply the update dx to the design variables.
+      void applyStateUpdate(const Eigen::VectorXd& dx);
+
+      /// \brief The M-estimator weighted cost after the update dx. The design variables are reverted afterwards.
+      double evaluateTentativeStep(const Eigen::VectorXd& dx);
+
+      /// \brief Sets the error after applying _dx. Reuses the cost of the last tentative step if that was _dx.
+      void evaluateErrorAfterStep();
+
+      /// \brief Update the memory statistics from the linear system solver
+      void updateMemoryStatistics();
+
       /// \brief issue callback for given event
       template<typename Event>
       void issueCallback();
@@ -171,6 +193,11 @@ namespace aslam {
       /// \brief The previous value of the cost function.
       double _p_J;
 
+      /// \brief The last step evaluated by evaluateTentativeStep() in the current iteration and its cost
+      Eigen::VectorXd _tentativeStep;
+      double _tentativeStepCost = 0.0;
+      bool _hasTentativeStep = false;
+
       boost::shared_ptr<LinearSystemSolver> _solver;
 
       boost::shared_ptr<TrustRegionPolicy> _trustRegionPolicy;
@@ -181,6 +208,9 @@ namespace aslam {
       /// \brief the current status
       Status _status;
 
+      /// \brief Bytes of the error terms, computed when the problem is initialized
+      std::size_t _errorTermMemory = 0;
+
       /// \brief A class that manages the optimizer callbacks
       callback::Manager _callbackManager;
     };
@@ -2,6 +2,7 @@
 #define ASLAM_BACKEND_OPTIMIZER_RPROP_HPP
 
 #include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+#include <aslam/backend/util/MiniBatchSampler.hpp>
 
 namespace sm {
   class PropertyTree;
@@ -32,6 +33,10 @@ namespace aslam {
       bool useDenseJacobianContainer = true; /// \brief Whether or not to use a dense Jacobian container
       boost::shared_ptr<ScalarNonSquaredErrorTerm> regularizer = NULL; /// \brief Regularizer
       Method method = RPROP_PLUS; /// \brief the RProp method used
+      std::size_t miniBatchSize = 0; /// \brief Number of error terms sampled for the gradient in the first iteration, 0 to always use all error terms
+      double miniBatchGrowth = 1.1; /// \brief Factor the mini-batch grows by in every iteration, the full gradient is used once it covers all error terms
+      MiniBatchSampler::Sampling miniBatchSampling = MiniBatchSampler::Sampling::UNIFORM; /// \brief How the error terms of a mini-batch are sampled
+      double miniBatchUniformMixing = 0.1; /// \brief Share of the uniform distribution in the importance sampling distribution
 
       void check() const override;
 
@@ -91,6 +96,9 @@ namespace aslam {
       /// \brief Reset information
       void resetImplementation() override;
 
+      /// \brief Compute the full gradient or the gradient of a mini-batch of error terms. Returns true for a mini-batch.
+      bool computeGradient(RowVectorType& outGradient);
+
       /// \brief branchless signum method
       static inline int sign(const double& val) {
         return (0.0 < val) - (val < 0.0);
@@ -110,6 +118,15 @@ namespace aslam {
       /// \brief error in the previous iteration (only used for IRPROP_PLUS version)
       double _prev_error = std::numeric_limits<double>::max();
 
+      /// \brief number of error terms in the next mini-batch, 0 if the full gradient is used
+      double _miniBatchSize = 0.0;
+
+      /// \brief draws the mini-batches
+      MiniBatchSampler _sampler;
+
+      /// \brief the current mini-batch
+      MiniBatch _miniBatch;
+
       /// \brief the current set of options
       Options _options;
 
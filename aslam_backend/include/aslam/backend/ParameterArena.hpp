@@ -0,0 +1,143 @@
+#ifndef ASLAM_BACKEND_PARAMETER_ARENA_HPP
+#define ASLAM_BACKEND_PARAMETER_ARENA_HPP
+
+#include <aslam/Exceptions.hpp>
+
+#include <Eigen/Core>
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    class DesignVariable;
+    class ParameterArena;
+
+    /**
+     * \class ArenaParameters
+     *
+     * \brief Base of the design variables whose parameters can live in a ParameterArena.
+     *
+     * The design variable accesses its parameters and the copy kept for revertUpdate() through Eigen::Map members.
+     * They point to storage of the design variable itself until relocateParameters() moves them into an arena.
+     * A design variable leaves its arena when it is destroyed, copies start outside of any arena.
+     */
+    class ArenaParameters {
+    public:
+      ArenaParameters() { }
+      ArenaParameters(const ArenaParameters& /* other */) { }
+      ArenaParameters& operator=(const ArenaParameters& /* other */) { return *this; }
+      virtual ~ArenaParameters();
+
+      /// \brief The number of doubles of the parameters
+      virtual int numArenaParameters() const = 0;
+
+      /// \brief The arena holding the parameters, nullptr while the design variable holds them itself
+      const ParameterArena* arena() const { return _arena; }
+
+    protected:
+      /// \brief Point the parameters to \p values and the previous parameters to \p previousValues, both of size
+      ///        numArenaParameters(), and copy the current contents there. nullptr points them back to the own storage.
+      virtual void relocateParameters(double* values, double* previousValues) = 0;
+
+      /// \brief Called after the parameters were written through the arena, to update values derived from them
+      virtual void arenaParametersChanged() { }
+
+      /// \brief Copy the contents of \p map to \p target and let \p map point there
+      template <typename Map_>
+      static void relocateMap(Map_& map, double* target) {
+        if (target == map.data())
+          return;
+        Map_(target, map.rows(), map.cols()) = map;
+        new (&map) Map_(target, map.rows(), map.cols());
+      }
+
+    private:
+      friend class ParameterArena;
+      ParameterArena* _arena = nullptr;
+      std::size_t _arenaSlot = 0;
+    };
+
+    /**
+     * \class ParameterArena
+     *
+     * \brief Holds the parameters and the previous parameters of many design variables in two contiguous arrays.
+     *
+     * The parameters are ordered by block index, so that evaluating the error terms of a problem walks through
+     * memory instead of visiting small heap blocks scattered by the allocation order. The whole state is available
+     * as one flat vector for bulk copies, vectorized operations and snapshots. The arena is not thread safe.
+     *
+     * The parameters move back into their design variables when the arena is cleared or destroyed.
+     */
+    class ParameterArena {
+    public:
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      ParameterArena();
+      /// \brief Move the parameters of \p dvs into the arena, see assign()
+      explicit ParameterArena(const std::vector<DesignVariable*>& dvs);
+      ParameterArena(const ParameterArena&) = delete;
+      ParameterArena& operator=(const ParameterArena&) = delete;
+      ~ParameterArena();
+
+      /// \brief Move the parameters of \p dvs into the arena, ordered by block index. Design variables without a block
+      ///        index follow in the given order. The design variables held so far are released first. Throws if a
+      ///        design variable does not derive from ArenaParameters, appears twice or is held by another arena.
+      void assign(const std::vector<DesignVariable*>& dvs);
+
+      /// \brief Move all parameters back into their design variables
+      void clear();
+
+      /// \brief The number of design variables held
+      std::size_t numDesignVariables() const { return _slots.size(); }
+      /// \brief Design variable \p i in arena order, nullptr if it was destroyed
+      DesignVariable* designVariable(std::size_t i) const;
+      /// \brief The offset of the parameters of design variable \p i in values()
+      std::size_t offset(std::size_t i) const;
+      /// \brief The number of parameters of design variable \p i
+      std::size_t numParameters(std::size_t i) const;
+
+      /// \brief The total number of parameters
+      std::size_t size() const { return static_cast<std::size_t>(_values.size()); }
+
+      /// \brief The parameters of all design variables
+      const Eigen::VectorXd& values() const { return _values; }
+      /// \brief The previous parameters of all design variables, restored by DesignVariable::revertUpdate()
+      const Eigen::VectorXd& previousValues() const { return _previousValues; }
+
+      /// \brief Writable parameters of all design variables. Call valuesChanged() after writing.
+      Eigen::Map<Eigen::VectorXd> mutableValues() { return Eigen::Map<Eigen::VectorXd>(_values.data(), _values.size()); }
+      /// \brief Notify the design variables that their parameters were written through mutableValues()
+      void valuesChanged();
+
+      /// \brief Copy all parameters to \p out
+      void snapshot(Eigen::VectorXd& out) const { out = _values; }
+      /// \brief Set all parameters to a snapshot taken from this arena
+      void restore(const Eigen::VectorXd& snapshot);
+      /// \brief Copy the parameters to the previous parameters, so that DesignVariable::revertUpdate() returns to them
+      void savePreviousValues() { _previousValues = _values; }
+
+    private:
+      friend class ArenaParameters;
+
+      /// \brief Forget design variable \p parameters, which is being destroyed
+      void release(ArenaParameters* parameters);
+
+      struct Slot {
+        DesignVariable* dv;
+        ArenaParameters* parameters;
+        std::size_t offset;
+        std::size_t size;
+      };
+      std::vector<Slot> _slots;
+
+      Eigen::VectorXd _values;
+      Eigen::VectorXd _previousValues;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_PARAMETER_ARENA_HPP */
@@ -17,19 +17,60 @@ namespace backend {
 // i.e: exp(-lambda/2*(y -f(x))^2)
 // The matrix of error terms contains, in each row, the error terms whose
 // weights must be normalized together
+//
+// The groups are stored flat: group g holds the error terms
+// [group_offsets[g], group_offsets[g + 1]). The weights are computed from the
+// squared errors cached by the last error evaluation, the error terms are not
+// evaluated again. The flat layout and the M-estimators are cached. The groups
+// passed as ErrorTermGroups stay shared with the caller: after adding error
+// terms or groups to them, or replacing M-estimators, call markGroupsChanged()
+// and the next update picks the changes up.
 class ProbDataAssocPolicy : public PerIterationCallback {
  public:
   typedef boost::shared_ptr<ErrorTerm> ErrorTermPtr;
   typedef boost::shared_ptr<std::vector<ErrorTermPtr>> ErrorTermGroup;
   typedef boost::shared_ptr<std::vector<ErrorTermGroup>> ErrorTermGroups;
 
-  ProbDataAssocPolicy(ErrorTermGroups error_terms, double lambda);
+  ProbDataAssocPolicy(ErrorTermGroups error_terms, double lambda,
+                      std::size_t num_threads = 1);
+  // group_offsets has one entry more than there are groups, starts with 0 and
+  // ends with error_terms.size().
+  ProbDataAssocPolicy(std::vector<ErrorTermPtr> error_terms,
+                      std::vector<std::size_t> group_offsets, double lambda,
+                      std::size_t num_threads = 1);
   // The optimizer will call this function before each iteration.
   void callback() override;
 
+  // The groups are split among this many threads, e.g. the optimizer's
+  // numThreadsError.
+  void setNumThreads(std::size_t num_threads) { num_threads_ = num_threads; }
+  std::size_t numThreads() const { return num_threads_; }
+
+  std::size_t numGroups() const { return group_offsets_.size() - 1; }
+
+  // Flatten the groups and look up the M-estimators again before the next
+  // update.
+  void markGroupsChanged() { groups_changed_ = true; }
+
  private:
-  ErrorTermGroups error_terms_;
+  // Flatten the shared groups into error_terms_ and group_offsets_.
+  void flattenGroups();
+  // Check the group offsets and look up the M-estimators.
+  void init();
+  // Normalize the weights of the groups [start_group, end_group).
+  void normalizeGroups(std::size_t thread_id, std::size_t start_group,
+                       std::size_t end_group);
+
+  // The groups of the first constructor, null for the flat layout.
+  ErrorTermGroups groups_;
+  std::vector<ErrorTermPtr> error_terms_;
+  std::vector<std::size_t> group_offsets_;
+  // The M-estimators of error_terms_.
+  std::vector<boost::shared_ptr<FixedWeightMEstimator>> m_estimators_;
+  // Set by markGroupsChanged().
+  bool groups_changed_ = false;
   double scaling_factor_;
+  std::size_t num_threads_;
 };
 }  // namespace backend
 }  // namespace aslam
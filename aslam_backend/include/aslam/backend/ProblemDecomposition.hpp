@@ -0,0 +1,75 @@
+#ifndef ASLAM_BACKEND_PROBLEM_DECOMPOSITION_HPP
+#define ASLAM_BACKEND_PROBLEM_DECOMPOSITION_HPP
+
+#include <aslam/backend/OptimizationProblemBase.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    /**
+     * \class ProblemComponent
+     *
+     * \brief A connected component of an optimization problem.
+     *
+     * Holds the active design variables of the component and the error terms acting on them. It is a view
+     * on the original problem: it owns nothing, so the original problem has to outlive it.
+     */
+    class ProblemComponent : public OptimizationProblemBase {
+    public:
+      ProblemComponent();
+      ~ProblemComponent() override;
+
+      /// \brief The design variables of the component
+      const std::vector<DesignVariable*>& designVariables() const { return _designVariables; }
+      /// \brief The squared error terms of the component
+      const std::vector<ErrorTerm*>& errorTerms() const { return _errorTerms; }
+      /// \brief The non-squared error terms of the component
+      const std::vector<ScalarNonSquaredErrorTerm*>& nonSquaredErrorTerms() const { return _nonSquaredErrorTerms; }
+
+    protected:
+      size_t numDesignVariablesImplementation() const override { return _designVariables.size(); }
+      DesignVariable* designVariableImplementation(size_t i) override { return _designVariables[i]; }
+      const DesignVariable* designVariableImplementation(size_t i) const override { return _designVariables[i]; }
+
+      size_t numErrorTermsImplementation() const override { return _errorTerms.size(); }
+      size_t numNonSquaredErrorTermsImplementation() const override { return _nonSquaredErrorTerms.size(); }
+      ErrorTerm* errorTermImplementation(size_t i) override { return _errorTerms[i]; }
+      ScalarNonSquaredErrorTerm* nonSquaredErrorTermImplementation(size_t i) override { return _nonSquaredErrorTerms[i]; }
+      const ErrorTerm* errorTermImplementation(size_t i) const override { return _errorTerms[i]; }
+      const ScalarNonSquaredErrorTerm* nonSquaredErrorTermImplementation(size_t i) const override { return _nonSquaredErrorTerms[i]; }
+
+      /// \brief Linear in the number of error terms of the component
+      void getErrorsImplementation(const DesignVariable* dv, std::set<ErrorTerm*>& outErrorSet) override;
+      /// \brief Linear in the number of non-squared error terms of the component
+      void getNonSquaredErrorsImplementation(const DesignVariable* dv, std::set<ScalarNonSquaredErrorTerm*>& outErrorSet) override;
+
+    private:
+      friend std::vector<boost::shared_ptr<ProblemComponent> > findIndependentComponents(OptimizationProblemBase& problem);
+
+      std::vector<DesignVariable*> _designVariables;
+      std::vector<ErrorTerm*> _errorTerms;
+      std::vector<ScalarNonSquaredErrorTerm*> _nonSquaredErrorTerms;
+    };
+
+    /**
+     * \brief Split \p problem into independent sub-problems.
+     *
+     * Two active design variables are connected if an error term acts on both of them, a component is a maximal set
+     * of connected design variables together with all error terms acting on them. Components can be optimized
+     * independently of each other. Inactive design variables connect nothing, they are constants.
+     * Error terms acting on no active design variable and active design variables without error terms
+     * are not part of any component.
+     *
+     * The components are ordered by their first design variable, design variables and error terms keep the order of
+     * \p problem within each component.
+     */
+    std::vector<boost::shared_ptr<ProblemComponent> > findIndependentComponents(OptimizationProblemBase& problem);
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_PROBLEM_DECOMPOSITION_HPP */
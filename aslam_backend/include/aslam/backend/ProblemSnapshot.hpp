@@ -0,0 +1,150 @@
+#ifndef ASLAM_BACKEND_PROBLEM_SNAPSHOT_HPP
+#define ASLAM_BACKEND_PROBLEM_SNAPSHOT_HPP
+
+#include <aslam/Exceptions.hpp>
+#include <aslam/backend/OptimizerCallback.hpp>
+
+#include <Eigen/Core>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <type_traits>
+#include <vector>
+
+namespace aslam {
+  namespace backend {
+
+    class DesignVariable;
+    class ErrorTerm;
+    class OptimizationProblem;
+
+    namespace callback {
+      class Registry;
+    }
+
+    /**
+     * \class ProblemSnapshot
+     *
+     * \brief Versioned binary snapshots of an OptimizationProblem.
+     *
+     * A snapshot stores a fixed-size record for every design variable, followed by all design
+     * variable parameters in one contiguous, 64 byte aligned array of doubles, followed by the
+     * error terms and a table of type names. Loading maps the file into memory, so restoring the
+     * parameters of a problem with known structure (loadParameters()) is a single pass over the
+     * mapped array.
+     *
+     * Design variable and error term types are not known to the backend and have to be registered
+     * by name. A design variable is recreated from its parameters by a factory. An error term is
+     * written and read by a user supplied writer/reader pair which only deals with the term specific
+     * data. The inverse covariance and the built-in M-estimators are stored by the framework.
+     * The snapshot uses the native byte order and is checked against it when loading.
+     * Scalar non-squared error terms are not supported.
+     */
+    class ProblemSnapshot {
+    public:
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      /// \brief The version of the snapshot format written by save()
+      static constexpr std::uint32_t Version = 1;
+
+      /// \brief Creates a design variable from its parameters
+      typedef boost::function<boost::shared_ptr<DesignVariable>(const Eigen::MatrixXd&)> DesignVariableFactory;
+      /// \brief Writes the type specific data of an error term
+      typedef boost::function<void(const ErrorTerm&, std::ostream&)> ErrorTermWriter;
+      /// \brief Creates an error term from its type specific data and its design variables
+      typedef boost::function<boost::shared_ptr<ErrorTerm>(std::istream&, const std::vector<DesignVariable*>&)> ErrorTermReader;
+
+      /// \brief Register the design variable type DV under \p name
+      template <typename DV>
+      static void registerDesignVariable(const std::string& name, const DesignVariableFactory& factory) {
+        static_assert(std::is_base_of<DesignVariable, DV>::value, "DV has to be derived from DesignVariable");
+        registerDesignVariable(std::type_index(typeid(DV)), name, factory);
+      }
+
+      /// \brief Register the error term type E under \p name
+      template <typename E>
+      static void registerErrorTerm(const std::string& name,
+                                    const boost::function<void(const E&, std::ostream&)>& writer,
+                                    const ErrorTermReader& reader) {
+        static_assert(std::is_base_of<ErrorTerm, E>::value, "E has to be derived from ErrorTerm");
+        registerErrorTerm(std::type_index(typeid(E)), name,
+                          [writer](const ErrorTerm& et, std::ostream& out) { writer(static_cast<const E&>(et), out); },
+                          reader);
+      }
+
+      /// \brief Write all design variables and error terms of \p problem to \p fileName.
+      ///        The file is written to a temporary file first and renamed afterwards, an existing
+      ///        snapshot is therefore never left half written.
+      static void save(const OptimizationProblem& problem, const std::string& fileName);
+
+      /// \brief Clear \p problem and fill it with the design variables and error terms stored in \p fileName.
+      ///        The problem owns all loaded objects.
+      static void load(const std::string& fileName, OptimizationProblem& problem);
+
+      /// \brief Restore only the design variable parameters (and flags) stored in \p fileName.
+      ///        The problem has to contain the same design variables, in the same order, as the saved one.
+      static void loadParameters(const std::string& fileName, OptimizationProblem& problem);
+
+      /// \brief Register an ITERATION_END callback that saves \p problem to \p fileName every
+      ///        \p everyNIterations iterations. The problem has to outlive the optimizer.
+      /// \return the callback, to be able to remove it from the registry again
+      static callback::OptimizerCallback addCheckpointCallback(callback::Registry& registry,
+                                                                const OptimizationProblem& problem,
+                                                                const std::string& fileName,
+                                                                std::size_t everyNIterations);
+
+    private:
+      static void registerDesignVariable(std::type_index type, const std::string& name, const DesignVariableFactory& factory);
+      static void registerErrorTerm(std::type_index type, const std::string& name, const ErrorTermWriter& writer, const ErrorTermReader& reader);
+    };
+
+    /// \brief Binary I/O helpers for error term writers and readers
+    namespace snapshot {
+
+      template <typename T>
+      inline void writeValue(std::ostream& out, const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written directly");
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+      }
+
+      template <typename T>
+      inline void readValue(std::istream& in, T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read directly");
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        SM_ASSERT_TRUE(ProblemSnapshot::Exception, static_cast<bool>(in), "Unexpected end of snapshot data");
+      }
+
+      template <typename Derived>
+      inline void writeMatrix(std::ostream& out, const Eigen::MatrixBase<Derived>& value) {
+        const typename Derived::PlainObject plain = value;
+        writeValue(out, static_cast<std::int32_t>(plain.rows()));
+        writeValue(out, static_cast<std::int32_t>(plain.cols()));
+        out.write(reinterpret_cast<const char*>(plain.data()), sizeof(typename Derived::Scalar) * plain.size());
+      }
+
+      template <typename Derived>
+      inline void readMatrix(std::istream& in, Eigen::PlainObjectBase<Derived>& value) {
+        std::int32_t rows = 0, cols = 0;
+        readValue(in, rows);
+        readValue(in, cols);
+        SM_ASSERT_TRUE(ProblemSnapshot::Exception,
+                       rows >= 0 && cols >= 0 &&
+                       (Derived::RowsAtCompileTime == Eigen::Dynamic || Derived::RowsAtCompileTime == rows) &&
+                       (Derived::ColsAtCompileTime == Eigen::Dynamic || Derived::ColsAtCompileTime == cols),
+                       "Stored matrix of size " << rows << "x" << cols << " does not fit the target matrix");
+        value.resize(rows, cols);
+        in.read(reinterpret_cast<char*>(value.data()), sizeof(typename Derived::Scalar) * value.size());
+        SM_ASSERT_TRUE(ProblemSnapshot::Exception, static_cast<bool>(in), "Unexpected end of snapshot data");
+      }
+
+    } // namespace snapshot
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_PROBLEM_SNAPSHOT_HPP */
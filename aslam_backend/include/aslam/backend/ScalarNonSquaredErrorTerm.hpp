@@ -66,6 +66,13 @@ namespace aslam {
         else evaluateRawJacobians(outJc);
       }
 
+      /// \brief add \p scale times the Jacobians of evaluateJacobians(outJc, useMEstimator) to \p outGradient.
+      ///        Counterpart of ErrorTerm::addWeightedGradient(), the Jacobians of a scalar error term are gradients already.
+      void addWeightedGradient(JacobianContainer& outGradient, bool useMEstimator, double scale = 1.0) {
+        if (scale == 1.0) evaluateJacobians(outGradient, useMEstimator);
+        else evaluateJacobians(outGradient.apply(scale), useMEstimator);
+      }
+
       /// \brief Get the error (before weighting by the M-estimator policy)
       double getRawError() const { return _error; }
       /// \brief Get the current, weighted error, i.e. with the M-estimator weight already applied.
@@ -0,0 +1,16 @@
+#ifndef ASLAM_BACKEND_SHARED_MEMORY_SET_HPP
+#define ASLAM_BACKEND_SHARED_MEMORY_SET_HPP
+
+#include <unordered_set>
+
+namespace aslam {
+  namespace backend {
+
+    /// \brief The addresses of objects shared between error terms, e.g. the nodes of common sub-expressions, whose
+    ///        memory has already been counted. Passing one set to all error terms counts every shared object once.
+    typedef std::unordered_set<const void*> SharedMemorySet;
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_SHARED_MEMORY_SET_HPP */
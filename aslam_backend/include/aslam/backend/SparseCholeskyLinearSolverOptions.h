@@ -24,6 +24,10 @@
 #ifndef ASLAM_BACKEND_SPARSE_CHOLESKY_LINEAR_SOLVER_OPTIONS_H
 #define ASLAM_BACKEND_SPARSE_CHOLESKY_LINEAR_SOLVER_OPTIONS_H
 
+#include <vector>
+
+#include "aslam/backend/FillReducingOrdering.hpp"
+
 namespace aslam {
   namespace backend {
 
@@ -49,6 +53,44 @@ namespace aslam {
       /** @}
         */
 
+      /** \name Members
+        @{
+        */
+      /// Fill-reducing ordering used for the symbolic factorization
+      FillReducingOrdering ordering;
+      /// Design variables to eliminate last (constrained ordering only)
+      std::vector<const DesignVariable*> orderLast;
+      /// Number of trailing active design variables to eliminate last (constrained ordering only)
+      int numOrderLast;
+      /// Factorization type (CHOLMOD_SIMPLICIAL, CHOLMOD_AUTO or CHOLMOD_SUPERNODAL)
+      int supernodal;
+      /// With CHOLMOD_AUTO, use a supernodal factorization if flop/nnz(L) >= supernodalSwitch
+      double supernodalSwitch;
+      /// Number of BLAS threads for the supernodal factorization (0 keeps the BLAS default)
+      int numBlasThreads;
+      /// Factorize in single precision and refine the solution in double precision (needs CHOLMOD 5).
+      /// Falls back to the double precision factorization if the refinement does not converge.
+      bool mixedPrecision;
+      /// Maximum number of refinement steps after the single precision solve
+      int maxRefinementIterations;
+      /// The refinement has converged once ||rhs - (J^T J + D^2) dx|| <= refinementTolerance * ||rhs||
+      double refinementTolerance;
+      /// Keep the Jacobians of error terms whose design variables moved at most this much (max norm of the
+      /// accumulated updates) since their last evaluation. Negative re-evaluates all Jacobians in every build.
+      double relinearizationThreshold;
+      /// Apply the rows of J of error terms appended since the last solve as rank updates to the factor instead of
+      /// refactorizing. The factorization is simplicial in this mode. An initMatrixStructure() that only appends error
+      /// terms keeps J^T, so with a non-negative relinearizationThreshold the next build evaluates only the Jacobians
+      /// of the new error terms and of the ones whose design variables moved.
+      bool incremental;
+      /// Refactorize in incremental mode once a design variable moved more than this (max norm of the accumulated
+      /// updates) since the last factorization, as the factor still holds the old Jacobians
+      double incrementalLinearizationThreshold;
+      /// Refactorize in incremental mode once the updates grew the non-zeros of the factor by more than this fraction
+      double incrementalMaxFillGrowth;
+      /** @}
+        */
+
     };
 
   }
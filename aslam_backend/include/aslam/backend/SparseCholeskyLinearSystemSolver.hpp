@@ -16,6 +16,28 @@ namespace aslam {
 
     class SparseCholeskyLinearSystemSolver : public LinearSystemSolver {
     public:
+      /// \brief Counters of the mixed precision solves (SparseCholeskyLinearSolverOptions::mixedPrecision)
+      struct MixedPrecisionStatistics {
+        /// \brief Number of solves attempted in single precision
+        std::size_t numSolves = 0;
+        /// \brief Total number of double precision refinement steps
+        std::size_t numRefinementSteps = 0;
+        /// \brief Number of solves redone in double precision
+        std::size_t numFallbacks = 0;
+      };
+
+      /// \brief Counters of the incremental mode (SparseCholeskyLinearSolverOptions::incremental)
+      struct IncrementalStatistics {
+        /// \brief Number of full numeric factorizations
+        std::size_t numFactorizations = 0;
+        /// \brief Number of solves with a factor updated by the appended rows of J
+        std::size_t numUpdates = 0;
+        /// \brief Number of solves with the factor of an earlier solve
+        std::size_t numReuses = 0;
+        /// \brief Number of rows of J added to the factor by updates
+        std::size_t numRowsAdded = 0;
+      };
+
       SparseCholeskyLinearSystemSolver(const SparseCholeskyLinearSolverOptions& options = SparseCholeskyLinearSolverOptions());
       SparseCholeskyLinearSystemSolver(const sm::PropertyTree& config);
       ~SparseCholeskyLinearSystemSolver() override;
@@ -34,18 +56,93 @@ namespace aslam {
       std::string name() const override {  return "sparse_cholesky"; };        
       /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
       double rhsJtJrhs() override;
+
+      /// \brief Memory usage and flop count of the last factorization
+      LinearSolverStatistics getStatistics() const override;
+
+      /// \brief Counters of the mixed precision solves since the last initMatrixStructure()
+      const MixedPrecisionStatistics& getMixedPrecisionStatistics() const { return _mixedPrecisionStatistics; }
+
+      /// \brief Counters of the Jacobians kept by SparseCholeskyLinearSolverOptions::relinearizationThreshold
+      ///        since the last initMatrixStructure()
+      const RelinearizationStatistics& getRelinearizationStatistics() const { return _jacobianBuilder.getRelinearizationStatistics(); }
+
+      /// \brief The number of symbolic analyses since construction. The analysis is kept across initMatrixStructure()
+      ///        calls as long as the pattern of J^T and the ordering stay the same, e.g. for problems of identical structure.
+      std::size_t numSymbolicAnalyses() const { return _numSymbolicAnalyses; }
+
+      /// \brief Counters of the incremental mode since construction
+      const IncrementalStatistics& getIncrementalStatistics() const { return _incrementalStatistics; }
+
+      /// \brief The fill-reducing permutation of the rows of J^T (the columns of J^T J) of the current factor.
+      ///        Empty before the first solve.
+      std::vector<int> getOrdering() const;
    
     
     private:
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
+      void setOrdering(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors) override;
       void handleNewAcceptConstantErrorTerms() override;
 
+      /// \brief Symbolic analysis of \p lhs with the configured ordering and factorization type
+      cholmod_factor* analyze(cholmod_sparse* lhs);
+      /// \brief Was the analysis of the current factors done for the pattern of \p lhs and the current ordering?
+      bool isAnalyzedFor(const cholmod_sparse& lhs) const;
+      /// \brief Free the factors
+      void freeFactors();
+      /// \brief Solve in single precision with double precision iterative refinement. False if it did not converge.
+      bool solveMixedPrecision(Eigen::VectorXd& outDx);
+      /// \brief Refine the single precision solution \p inOutDx against the double precision J^T
+      bool refine(Eigen::VectorXd& inOutDx);
+      /// \brief Add the rows of J appended since the last solve to the factor. False if the factor has to be recomputed.
+      bool updateFactor();
+      /// \brief Remember what the factor was computed from, for the updates of the incremental mode
+      void recordFactorization();
+
       CompressedColumnJacobianTransposeBuilder<int> _jacobianBuilder;
 
       Cholmod<> _cholmod;
       cholmod_sparse _cholmodLhs;
       cholmod_dense  _cholmodRhs;
       cholmod_factor* _factor;
+      /// \brief The single precision factor of the mixed precision solves
+      cholmod_factor* _singleFactor;
+      MixedPrecisionStatistics _mixedPrecisionStatistics;
+
+      /// \brief The pattern of J^T and the ordering the factors were analyzed for
+      std::size_t _analyzedRows = 0;
+      std::vector<int> _analyzedColumnPointers;
+      std::vector<int> _analyzedRowIndices;
+      std::vector<int> _analyzedOrderingConstraints;
+      SparseCholeskyLinearSolverOptions _analyzedOptions;
+      /// \brief Set by initMatrixStructure() to check the analysis against the new pattern on the next solve
+      bool _checkAnalysis = false;
+      std::size_t _numSymbolicAnalyses = 0;
+
+      /// \brief What the numeric factor was computed from in incremental mode
+      struct FactorState {
+        bool isValid = false;
+        /// \brief The error terms in the factor, a prefix of _errorTerms while the factor is valid
+        std::vector<ErrorTerm*> errorTerms;
+        /// \brief The number of rows of J in the factor
+        std::size_t numRows = 0;
+        std::vector<DesignVariable*> dvs;
+        std::vector<int> columnBases;
+        /// \brief The movement trackers of the design variables at the factorization
+        std::vector<double> accumulatedUpdateNorms;
+        std::vector<std::size_t> numParameterSets;
+        bool useDiagonalConditioner = false;
+        Eigen::VectorXd diagonalConditioner;
+        /// \brief The non-zeros of the factor after the factorization
+        double factorNonZeros = 0.0;
+      };
+      FactorState _factorState;
+      IncrementalStatistics _incrementalStatistics;
+      /// \brief The design variables of the current matrix structure
+      std::vector<DesignVariable*> _dvs;
+
+      /// \brief The constraint set of every row of J^T used by the constrained ordering
+      std::vector<int> _orderingConstraints;
 
       /// Options
       SparseCholeskyLinearSolverOptions _options;
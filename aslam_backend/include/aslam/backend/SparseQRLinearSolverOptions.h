@@ -57,8 +57,16 @@ namespace aslam {
       double qrTol;
       /// Tolerance for a zero 2-norm column
       double normTol;
+      /// Fill-reducing ordering of the symbolic QR analysis (SPQR_ORDERING_*)
+      int qrOrdering;
+      /// Number of TBB threads used by SPQR (0: TBB default, -1: let TBB choose)
+      int qrNumThreads;
       /// Verbose mode
       bool verbose;
+      /// Keep only R: Q^T is applied to the right-hand side during the factorization.
+      /// Saves the memory of the Householder vectors, but the symbolic analysis is
+      /// redone in every solve and the fill-reducing permutation is not available.
+      bool qLess;
       /** @}
         */
 
@@ -36,14 +36,16 @@ namespace aslam {
       index_t getRank() const;
       /// Returns the current tolerance
       double getTol() const;
-      /// Returns the current permutation vector
+      /// Returns the current permutation vector (not available with SparseQRLinearSolverOptions::qLess)
       std::vector<index_t> getPermutationVector() const;
-      /// Returns the current permutation vector
+      /// Returns the current permutation vector (not available with SparseQRLinearSolverOptions::qLess)
       Eigen::Matrix<index_t, Eigen::Dynamic, 1> getPermutationVectorEigen() const;
       /// Performs QR decomposition and returns the R matrix
       const CompressedColumnMatrix<index_t>& getR();
       /// Returns the current memory usage in bytes
       size_t getMemoryUsage() const;
+      /// Returns the memory usage and flop count of the last factorization
+      LinearSolverStatistics getStatistics() const override;
       /// Performs symbolic and numeric analysis
       void analyzeSystem();
 
@@ -60,6 +62,8 @@ namespace aslam {
     private:
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
       void handleNewAcceptConstantErrorTerms() override;
+      /// Frees the factor and the transposed Jacobian
+      void freeFactorization();
 
       CompressedColumnJacobianTransposeBuilder<index_t> _jacobianBuilder;
 
@@ -70,6 +74,11 @@ namespace aslam {
       SuiteSparseQR_factorization<double>* _factor;
       CompressedColumnMatrix<index_t> _R;
 #endif
+      /// J as factorized by SPQR. Its memory is reused by every solve.
+      cholmod_sparse* _J;
+      /// Rank and tolerance of the last Q-less solve (rank < 0 before the first one)
+      index_t _qLessRank;
+      double _qLessTol;
       SparseQRLinearSolverOptions _options;
     };
 
@@ -3,6 +3,7 @@
 
 #include <aslam/backend/LinearSystemSolver.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
 #include "Optimizer2Options.hpp"
 #include <sm/eigen/assert_macros.hpp>
 #include <aslam/Exceptions.hpp>
@@ -13,6 +14,25 @@ namespace aslam {
         class TrustRegionPolicy
         {
         public:
+            /// \brief Returns the (M-estimator weighted) cost after applying the tentative step dx to the design variables.
+            ///        The design variables are unchanged afterwards.
+            typedef boost::function<double(const Eigen::VectorXd& dx)> StepEvaluator;
+
+            /// \brief How speculation worked out so far in the current optimization. Speculative policies try several
+            ///        steps per iteration, from the one of their current state (damping, scale) to more conservative ones.
+            struct SpeculationStatistics {
+              /// \brief Number of iterations in which several steps were tried
+              size_t numRounds = 0;
+              /// \brief Number of tentative steps evaluated
+              size_t numEvaluatedSteps = 0;
+              /// \brief Number of rounds in which the step of the current state would have been rejected but a more conservative one was accepted
+              size_t numPaidOff = 0;
+              /// \brief Number of rounds in which another step than the one of the current state was proposed
+              size_t numOtherStepChosen = 0;
+              /// \brief Number of rounds in which no tried step decreased the cost
+              size_t numAllRejected = 0;
+            };
+
             TrustRegionPolicy();
             virtual ~TrustRegionPolicy();
             
@@ -35,10 +55,22 @@ namespace aslam {
             virtual std::ostream & printState(std::ostream & out) const = 0;
             virtual std::string name() const = 0;
             virtual bool requiresAugmentedDiagonal() const = 0;
+
+            /// \brief set by the optimizer to allow policies to try steps before proposing one. Pass an empty function to unset.
+            void setStepEvaluator(const StepEvaluator& stepEvaluator) { _stepEvaluator = stepEvaluator; }
+
+            /// \brief Statistics of the speculative steps since the optimization started, all zero for policies that do not speculate
+            const SpeculationStatistics& getSpeculationStatistics() const { return _speculationStatistics; }
         protected:
             double get_dJ();
             bool isFirstIteration(){ return _isFirstIteration; }
 
+            /// \brief can tentative steps be evaluated with evaluateStep()?
+            bool canEvaluateSteps() const { return !_stepEvaluator.empty(); }
+
+            /// \brief the cost after the tentative step dx, see StepEvaluator
+            double evaluateStep(const Eigen::VectorXd& dx) { return _stepEvaluator(dx); }
+
             /// \brief called by the optimizer when an optimization is starting
             virtual void optimizationStartingImplementation(double J) = 0;
             
@@ -46,12 +78,16 @@ namespace aslam {
             virtual bool solveSystemImplementation(double J, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx) = 0;
 
             boost::shared_ptr<LinearSystemSolver> _solver;
+
+            /// \brief updated by speculative policies, reset when an optimization is starting
+            SpeculationStatistics _speculationStatistics;
             
         private:
             /// \brief the linear system solver.
             double _J;
             double _p_J;
             bool _isFirstIteration;
+            StepEvaluator _stepEvaluator;
         };
 
     } // namespace backend
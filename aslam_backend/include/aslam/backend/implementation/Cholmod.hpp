@@ -2,6 +2,13 @@
 #define SuiteSparse_long UF_long
 #endif
 
+#if defined(__GNUC__)
+// Thread controls of the common BLAS implementations. They are weak so that
+// linking does not depend on the BLAS cholmod was built against.
+extern "C" void openblas_set_num_threads(int) __attribute__((weak));
+extern "C" void MKL_Set_Num_Threads(int) __attribute__((weak));
+#endif
+
 namespace aslam {
   namespace backend {
 
@@ -51,6 +58,12 @@ namespace aslam {
       static cholmod_factor* analyze(cholmod_sparse* A, cholmod_common* c) {
         return cholmod_analyze(A, c);
       }
+      static cholmod_factor* analyze_p(cholmod_sparse* A, int* Perm, int* fset, size_t fsize, cholmod_common* c) {
+        return cholmod_analyze_p(A, Perm, fset, fsize, c);
+      }
+      static int ccolamd(cholmod_sparse* A, int* fset, size_t fsize, int* Cmember, int* Perm, cholmod_common* c) {
+        return cholmod_ccolamd(A, fset, fsize, Cmember, Perm, c);
+      }
       static int free_sparse(cholmod_sparse** A, cholmod_common* c) {
         return cholmod_free_sparse(A, c);
       }
@@ -80,6 +93,26 @@ namespace aslam {
           int xtype, cholmod_common* c) {
         return cholmod_allocate_dense(nrow, ncol, d, xtype, c);
       }
+      static cholmod_sparse* copy_sparse(cholmod_sparse* A, cholmod_common* c) {
+        return cholmod_copy_sparse(A, c);
+      }
+      static int sparse_xtype(int to_xtype, cholmod_sparse* A, cholmod_common* c) {
+        return cholmod_sparse_xtype(to_xtype, A, c);
+      }
+      static cholmod_sparse* allocate_sparse(size_t nrow, size_t ncol, size_t nzmax, int sorted, int packed,
+          int stype, int xtype, cholmod_common* c) {
+        return cholmod_allocate_sparse(nrow, ncol, nzmax, sorted, packed, stype, xtype, c);
+      }
+      static int transpose_unsym(cholmod_sparse* A, int values, cholmod_sparse* F, cholmod_common* c) {
+        return cholmod_transpose_unsym(A, values, NULL, NULL, 0, F, c);
+      }
+      static int updown(int update, cholmod_sparse* C, cholmod_factor* L, cholmod_common* c) {
+        return cholmod_updown(update, C, L, c);
+      }
+      static int change_factor(int to_xtype, int to_ll, int to_super, int to_packed, int to_monotonic, cholmod_factor* L,
+          cholmod_common* c) {
+        return cholmod_change_factor(to_xtype, to_ll, to_super, to_packed, to_monotonic, L, c);
+      }
     };
 
     template<>
@@ -98,6 +131,12 @@ namespace aslam {
       static cholmod_factor* analyze(cholmod_sparse* A, cholmod_common* c) {
         return cholmod_l_analyze(A, c);
       }
+      static cholmod_factor* analyze_p(cholmod_sparse* A, SuiteSparse_long* Perm, SuiteSparse_long* fset, size_t fsize, cholmod_common* c) {
+        return cholmod_l_analyze_p(A, Perm, fset, fsize, c);
+      }
+      static int ccolamd(cholmod_sparse* A, SuiteSparse_long* fset, size_t fsize, SuiteSparse_long* Cmember, SuiteSparse_long* Perm, cholmod_common* c) {
+        return cholmod_l_ccolamd(A, fset, fsize, Cmember, Perm, c);
+      }
       static int free_sparse(cholmod_sparse** A, cholmod_common* c) {
         return cholmod_l_free_sparse(A, c);
       }
@@ -127,6 +166,26 @@ namespace aslam {
           int xtype, cholmod_common* c) {
         return cholmod_l_allocate_dense(nrow, ncol, d, xtype, c);
       }
+      static cholmod_sparse* copy_sparse(cholmod_sparse* A, cholmod_common* c) {
+        return cholmod_l_copy_sparse(A, c);
+      }
+      static int sparse_xtype(int to_xtype, cholmod_sparse* A, cholmod_common* c) {
+        return cholmod_l_sparse_xtype(to_xtype, A, c);
+      }
+      static cholmod_sparse* allocate_sparse(size_t nrow, size_t ncol, size_t nzmax, int sorted, int packed,
+          int stype, int xtype, cholmod_common* c) {
+        return cholmod_l_allocate_sparse(nrow, ncol, nzmax, sorted, packed, stype, xtype, c);
+      }
+      static int transpose_unsym(cholmod_sparse* A, int values, cholmod_sparse* F, cholmod_common* c) {
+        return cholmod_l_transpose_unsym(A, values, NULL, NULL, 0, F, c);
+      }
+      static int updown(int update, cholmod_sparse* C, cholmod_factor* L, cholmod_common* c) {
+        return cholmod_l_updown(update, C, L, c);
+      }
+      static int change_factor(int to_xtype, int to_ll, int to_super, int to_packed, int to_monotonic, cholmod_factor* L,
+          cholmod_common* c) {
+        return cholmod_l_change_factor(to_xtype, to_ll, to_super, to_packed, to_monotonic, L, c);
+      }
     };
 
 
@@ -168,6 +227,8 @@ namespace aslam {
     Cholmod<I>::Cholmod()
     {
       CholmodIndexTraits<index_t>::start(&_cholmod);
+      _cholmod.SPQR_nthreads = -1;  // let tbb choose whats best
+      _cholmod.SPQR_grain = 12;   // +/-2* number of cores
     }
 
     template<typename I>
@@ -177,7 +238,8 @@ namespace aslam {
     }
 
     template<typename I>
-    cholmod_factor* Cholmod<I>::analyze(cholmod_sparse* J)
+    cholmod_factor* Cholmod<I>::analyze(cholmod_sparse* J, FillReducingOrdering ordering,
+                                        const std::vector<index_t>& rowConstraints)
     {
       //std::cout << "Cholmod:" << std::endl;
       //CholmodIndexTraits<index_t>::print_sparse(J, "J", &_cholmod);
@@ -199,6 +261,7 @@ namespace aslam {
       _cholmod.nmethods = 1;
       //  AMD may be used with both J or J*J'
       _cholmod.method[0].ordering = CHOLMOD_AMD;
+      _cholmod.postorder = 1;
       // From the cholmod header:
       // CHOLMOD_SIMPLICIAL   always do simplicial
       // CHOLMOD_AUTO         select simpl/super depending on matrix
@@ -210,9 +273,42 @@ namespace aslam {
       //  * flop/nnz(L) < Common->supernodal_switch, then a simplicial analysis
       //  * is done.  A supernodal analysis done otherwise.
       //  * Default:  CHOLMOD_AUTO.  Default supernodal_switch = 40
-      _cholmod.supernodal = CHOLMOD_AUTO;
+      // Both are set through setSupernodal().
       cholmod_factor* factor = NULL;
-      factor = CholmodIndexTraits<index_t>::analyze(J, &_cholmod);
+      switch (ordering) {
+        case FillReducingOrdering::AMD:
+          factor = CholmodIndexTraits<index_t>::analyze(J, &_cholmod);
+          break;
+        case FillReducingOrdering::COLAMD:
+          // COLAMD orders J*J' without forming it. It is ignored by cholmod for symmetric input.
+          _cholmod.method[0].ordering = CHOLMOD_COLAMD;
+          factor = CholmodIndexTraits<index_t>::analyze(J, &_cholmod);
+          break;
+        case FillReducingOrdering::NESDIS:
+          _cholmod.method[0].ordering = CHOLMOD_NESDIS;
+          factor = CholmodIndexTraits<index_t>::analyze(J, &_cholmod);
+          if (!factor && _cholmod.status == CHOLMOD_NOT_INSTALLED) {
+            // cholmod was compiled without the Partition module (METIS).
+            _cholmod.status = CHOLMOD_OK;
+            _cholmod.method[0].ordering = CHOLMOD_AMD;
+            factor = CholmodIndexTraits<index_t>::analyze(J, &_cholmod);
+          }
+          break;
+        case FillReducingOrdering::CONSTRAINED: {
+          SM_ASSERT_EQ(Exception, rowConstraints.size(), J->nrow, "A constrained ordering needs one constraint set per row of J");
+          // CCOLAMD orders J*J' such that all rows of constraint set k come before the rows of set k+1.
+          std::vector<index_t> cmember(rowConstraints);
+          std::vector<index_t> permutation(J->nrow);
+          int success = CholmodIndexTraits<index_t>::ccolamd(J, NULL, 0, cmember.data(), permutation.data(), &_cholmod);
+          SM_ASSERT_TRUE(Exception, success, "The constrained ordering failed.");
+          _cholmod.method[0].ordering = CHOLMOD_GIVEN;
+          // Postordering the elimination tree may move constrained rows away from the end.
+          _cholmod.postorder = 0;
+          factor = CholmodIndexTraits<index_t>::analyze_p(J, permutation.data(), NULL, 0, &_cholmod);
+          _cholmod.postorder = 1;
+          break;
+        }
+      }
       SM_ASSERT_EQ(Exception, _cholmod.status, CHOLMOD_OK, "The symbolic Cholesky factorization failed.");
       SM_ASSERT_FALSE(Exception, factor == NULL, "cholmod_analyze returned a null factor");
       return factor;
@@ -220,7 +316,7 @@ namespace aslam {
 
 #ifndef QRSOLVER_DISABLED
     template<typename I>
-    spqr_factor* Cholmod<I>::analyzeQR(cholmod_sparse* J)
+    spqr_factor* Cholmod<I>::analyzeQR(cholmod_sparse* A, int ordering, bool transpose)
     {
       // From the cholmod header:
       //
@@ -232,12 +328,12 @@ namespace aslam {
       // same properties apply as cholmod_factor analyze
       //_cholmod.method[0].ordering = CHOLMOD_AMD;
       //_cholmod.supernodal = CHOLMOD_AUTO;
-      _cholmod.SPQR_nthreads = -1;  // let tbb choose whats best
-      _cholmod.SPQR_grain = 12;   // +/-2* number of cores
+      // The thread count and grain size are set through setQrNumThreads().
       spqr_factor* factor = NULL;
-      cholmod_sparse* qrJ = cholmod_l_transpose(J, 1, &_cholmod) ;
-      factor = SuiteSparseQR_symbolic <double>(SPQR_ORDERING_BEST, SPQR_DEFAULT_TOL, qrJ, &_cholmod) ;
-      CholmodIndexTraits<index_t>::free_sparse(&qrJ, &_cholmod);
+      cholmod_sparse* qrJ = transpose ? cholmod_l_transpose(A, 1, &_cholmod) : A;
+      factor = SuiteSparseQR_symbolic <double>(ordering, SPQR_DEFAULT_TOL, qrJ, &_cholmod) ;
+      if (transpose)
+        CholmodIndexTraits<index_t>::free_sparse(&qrJ, &_cholmod);
       SM_ASSERT_EQ(Exception, _cholmod.status, CHOLMOD_OK, "The symbolic qr factorization failed.");
       SM_ASSERT_FALSE(Exception, factor == NULL, "SuiteSparseQR_symbolic returned a null factor");
       return factor;
@@ -398,31 +494,157 @@ namespace aslam {
       return NULL;
     }
 
+    template<typename I>
+    cholmod_dense* Cholmod<I>::solve(cholmod_factor* L, cholmod_dense* b)
+    {
+      SM_ASSERT_TRUE(Exception, L != NULL && L->xtype != CHOLMOD_PATTERN, "The factor is not numeric");
+      return CholmodIndexTraits<index_t>::solve(CHOLMOD_A, L, b, &_cholmod);
+    }
+
+    template<typename I>
+    bool Cholmod<I>::update(cholmod_sparse* A, size_t beginColumn, size_t endColumn, cholmod_factor* L)
+    {
+      SM_ASSERT_TRUE(Exception, A != NULL && L != NULL, "Null input");
+      SM_ASSERT_EQ(Exception, A->nrow, L->n, "A and L do not match");
+      SM_ASSERT_TRUE(Exception, beginColumn <= endColumn && endColumn <= A->ncol, "Column range out of bounds");
+      SM_ASSERT_TRUE(Exception, A->packed, "A must be packed");
+      if (beginColumn == endColumn)
+        return true;
+      if (L->is_super || L->is_ll) {
+        if (!CholmodIndexTraits<index_t>::change_factor(CHOLMOD_REAL, false, false, false, true, L, &_cholmod))
+          return false;
+      }
+      // cholmod_updown expects the rows of C in the order of the factor: C = P * A(:, range)
+      const index_t* Ap = static_cast<const index_t*>(A->p);
+      const index_t* Ai = static_cast<const index_t*>(A->i);
+      const double* Ax = static_cast<const double*>(A->x);
+      const index_t* perm = static_cast<const index_t*>(L->Perm);
+      std::vector<index_t> inversePerm(L->n);
+      for (size_t k = 0; k < L->n; ++k)
+        inversePerm[perm ? perm[k] : k] = k;
+      const size_t nnz = Ap[endColumn] - Ap[beginColumn];
+      cholmod_sparse* C = CholmodIndexTraits<index_t>::allocate_sparse(A->nrow, endColumn - beginColumn, nnz, true, true, 0,
+                                                                       CHOLMOD_REAL, &_cholmod);
+      if (!C)
+        return false;
+      index_t* Cp = static_cast<index_t*>(C->p);
+      index_t* Ci = static_cast<index_t*>(C->i);
+      double* Cx = static_cast<double*>(C->x);
+      std::vector<std::pair<index_t, double> > column;
+      index_t n = 0;
+      for (size_t c = beginColumn; c < endColumn; ++c) {
+        Cp[c - beginColumn] = n;
+        column.clear();
+        for (index_t k = Ap[c]; k < Ap[c + 1]; ++k)
+          column.emplace_back(inversePerm[Ai[k]], Ax[k]);
+        std::sort(column.begin(), column.end());
+        for (const auto& entry : column) {
+          Ci[n] = entry.first;
+          Cx[n++] = entry.second;
+        }
+      }
+      Cp[endColumn - beginColumn] = n;
+      const int status = CholmodIndexTraits<index_t>::updown(true, C, L, &_cholmod);
+      CholmodIndexTraits<index_t>::free_sparse(&C, &_cholmod);
+      return status && _cholmod.status == CHOLMOD_OK && L->minor == L->n;
+    }
+
+    template<typename I>
+    double Cholmod<I>::factorNonZeros(const cholmod_factor* L)
+    {
+      SM_ASSERT_TRUE(Exception, L != NULL, "Null input");
+      if (L->is_super)
+        return static_cast<double>(L->xsize);
+      if (!L->nz)
+        return 0.0;
+      const index_t* nz = static_cast<const index_t*>(L->nz);
+      double count = 0.0;
+      for (size_t j = 0; j < L->n; ++j)
+        count += nz[j];
+      return count;
+    }
+
+    template<typename I>
+    bool Cholmod<I>::supportsSinglePrecision()
+    {
+      // Before CHOLMOD 5 the dtype field existed but only double was implemented.
+#if defined(CHOLMOD_MAIN_VERSION) && CHOLMOD_MAIN_VERSION >= 5
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    template<typename I>
+    cholmod_sparse* Cholmod<I>::copySingle(cholmod_sparse* A)
+    {
+      SM_ASSERT_TRUE(Exception, A != NULL, "Null input");
+      if (!supportsSinglePrecision())
+        return NULL;
+      cholmod_sparse* copy = CholmodIndexTraits<index_t>::copy_sparse(A, &_cholmod);
+      // Since CHOLMOD 5 the target type is xtype + dtype.
+      if (copy && !CholmodIndexTraits<index_t>::sparse_xtype(CHOLMOD_REAL + CHOLMOD_SINGLE, copy, &_cholmod))
+        CholmodIndexTraits<index_t>::free_sparse(&copy, &_cholmod);
+      return copy;
+    }
+
+    template<typename I>
+    bool Cholmod<I>::solveSingle(cholmod_factor* L, const Eigen::VectorXd& b, Eigen::VectorXd& x)
+    {
+      SM_ASSERT_TRUE(Exception, L != NULL, "Null input");
+      SM_ASSERT_EQ(Exception, L->dtype, (int)CholmodValueTraits<float>::DType, "The factor is not single precision");
+      cholmod_dense* B = CholmodIndexTraits<index_t>::allocate_dense(b.size(), 1, b.size(),
+                                                                     CHOLMOD_REAL + CHOLMOD_SINGLE, &_cholmod);
+      if (!B)
+        return false;
+      Eigen::Map<Eigen::VectorXf>(reinterpret_cast<float*>(B->x), b.size()) = b.cast<float>();
+      cholmod_dense* X = CholmodIndexTraits<index_t>::solve(CHOLMOD_A, L, B, &_cholmod);
+      CholmodIndexTraits<index_t>::free_dense(&B, &_cholmod);
+      if (!X)
+        return false;
+      x = Eigen::Map<const Eigen::VectorXf>(reinterpret_cast<const float*>(X->x), X->nrow).cast<double>();
+      CholmodIndexTraits<index_t>::free_dense(&X, &_cholmod);
+      return true;
+    }
+
 
 #ifndef QRSOLVER_DISABLED
     template<typename I>
     cholmod_dense* Cholmod<I>::solve(cholmod_sparse* A, spqr_factor* L,
         cholmod_dense* b, double tol, bool norm, double normTol) {
       cholmod_sparse* qrJ = cholmod_l_transpose(A, 1, &_cholmod);
+      cholmod_dense* res = solveQR(qrJ, L, b, tol, norm, normTol);
+      CholmodIndexTraits<index_t>::free_sparse(&qrJ, &_cholmod);
+      return res;
+    }
+
+    template<typename I>
+    cholmod_dense* Cholmod<I>::normalizeColumns(cholmod_sparse* J, double normTol) {
+      cholmod_dense* scaling =
+        CholmodIndexTraits<index_t>::allocate_dense(J->ncol, 1, J->ncol,
+        CHOLMOD_REAL, &_cholmod);
+      double* values =
+        reinterpret_cast<double*>(scaling->x);
+      for (size_t i = 0; i < J->ncol; ++i) {
+        const double normCol = colNorm(J, i);
+        if (normCol < normTol)
+          values[i] = 0.0;
+        else
+          values[i] = 1.0 / normCol;
+      }
+      SM_ASSERT_TRUE(Exception, scale(scaling, CHOLMOD_COL, J),
+        "Scaling failed");
+      return scaling;
+    }
+
+    template<typename I>
+    cholmod_dense* Cholmod<I>::solveQR(cholmod_sparse* J, spqr_factor* L,
+        cholmod_dense* b, double tol, bool norm, double normTol) {
       cholmod_dense* scaling = NULL;
-      if (norm) {
-        scaling =
-          CholmodIndexTraits<index_t>::allocate_dense(qrJ->ncol, 1, qrJ->ncol,
-          CHOLMOD_REAL, &_cholmod);
-        double* values =
-          reinterpret_cast<double*>(scaling->x);
-        for (size_t i = 0; i < qrJ->ncol; ++i) {
-          const double normCol = colNorm(qrJ, i);
-          if (normCol < normTol)
-            values[i] = 0.0;
-          else
-            values[i] = 1.0 / normCol;
-        }
-        SM_ASSERT_TRUE(Exception, scale(scaling, CHOLMOD_COL, qrJ),
-          "Scaling failed");
-      }
+      if (norm)
+        scaling = normalizeColumns(J, normTol);
       cholmod_dense* res = NULL;
-      if (factorize(qrJ, L, tol)) {
+      if (factorize(J, L, tol)) {
         cholmod_dense* qrY = SuiteSparseQR_qmult(SPQR_QTX, L, b, &_cholmod);
         res = SuiteSparseQR_solve(SPQR_RETX_EQUALS_B, L, qrY, &_cholmod);
         CholmodIndexTraits<index_t>::free_dense(&qrY, &_cholmod);
@@ -430,17 +652,71 @@ namespace aslam {
       if (norm) {
         const double* svalues =
           reinterpret_cast<const double*>(scaling->x);
-        double* rvalues =
-          reinterpret_cast<double*>(res->x);
-        for (size_t i = 0; i < qrJ->ncol; ++i)
-          rvalues[i] = svalues[i] * rvalues[i];
+        if (res) {
+          double* rvalues =
+            reinterpret_cast<double*>(res->x);
+          for (size_t i = 0; i < J->ncol; ++i)
+            rvalues[i] = svalues[i] * rvalues[i];
+        }
         CholmodIndexTraits<index_t>::free_dense(&scaling, &_cholmod);
       }
-      CholmodIndexTraits<index_t>::free_sparse(&qrJ, &_cholmod);
       return res;
     }
+
+    template<typename I>
+    cholmod_dense* Cholmod<I>::solveQless(cholmod_sparse* J, cholmod_dense* b,
+        int ordering, double tol, bool norm, double normTol) {
+      SM_ASSERT_TRUE(Exception, J != NULL, "Null input");
+      SM_ASSERT_TRUE(Exception, b != NULL, "Null input");
+      cholmod_dense* scaling = NULL;
+      if (norm)
+        scaling = normalizeColumns(J, normTol);
+      // X = E*(R\(Q'*b)), Q'*b is formed during the factorization and H is not kept.
+      cholmod_dense* res = SuiteSparseQR<double>(ordering, tol, J, b, &_cholmod);
+      if (_cholmod.status != CHOLMOD_OK && res) {
+        CholmodIndexTraits<index_t>::free_dense(&res, &_cholmod);
+      }
+      if (norm) {
+        const double* svalues =
+          reinterpret_cast<const double*>(scaling->x);
+        if (res) {
+          double* rvalues =
+            reinterpret_cast<double*>(res->x);
+          for (size_t i = 0; i < J->ncol; ++i)
+            rvalues[i] = svalues[i] * rvalues[i];
+        }
+        CholmodIndexTraits<index_t>::free_dense(&scaling, &_cholmod);
+      }
+      return res;
+    }
+
+    template<typename I>
+    typename Cholmod<I>::index_t Cholmod<I>::getQrRank() const {
+      // SPQR_istat[4] holds the rank estimate of the last factorization
+      return _cholmod.SPQR_istat[4];
+    }
+
+    template<typename I>
+    double Cholmod<I>::getQrTol() const {
+      return _cholmod.SPQR_tol_used;
+    }
 #endif
 
+    template<typename I>
+    cholmod_sparse* Cholmod<I>::transpose(cholmod_sparse* A, cholmod_sparse* At) {
+      SM_ASSERT_TRUE(Exception, A != NULL, "Null input");
+      const size_t nnz = static_cast<size_t>(reinterpret_cast<const I*>(A->p)[A->ncol]);
+      if (At && (At->nrow != A->ncol || At->ncol != A->nrow || At->nzmax < nnz))
+        CholmodIndexTraits<index_t>::free_sparse(&At, &_cholmod);
+      if (!At) {
+        At = CholmodIndexTraits<index_t>::allocate_sparse(A->ncol, A->nrow, nnz, 1, 1, 0, CHOLMOD_REAL, &_cholmod);
+        SM_ASSERT_FALSE(Exception, At == NULL, "Unable to allocate the transpose");
+      }
+      SM_ASSERT_TRUE(Exception, CholmodIndexTraits<index_t>::transpose_unsym(A, 1, At, &_cholmod),
+        "The transpose failed");
+      return At;
+    }
+
 #ifndef QRSOLVER_DISABLED
     template<typename I>
     void Cholmod<I>::getR(cholmod_sparse* A, cholmod_sparse** R) {
@@ -509,5 +785,55 @@ namespace aslam {
       return _cholmod.memory_inuse;
     }
 
+    template<typename I>
+    size_t Cholmod<I>::getPeakMemoryUsage() const {
+      return _cholmod.memory_usage;
+    }
+
+    template<typename I>
+    double Cholmod<I>::getFlops() const {
+#ifndef QRSOLVER_DISABLED
+      if (_cholmod.SPQR_flopcount > 0)
+        return _cholmod.SPQR_flopcount;
+#endif
+      return _cholmod.fl;
+    }
+
+    template<typename I>
+    double Cholmod<I>::getFactorNonZeros() const {
+      return _cholmod.lnz;
+    }
+
+    template<typename I>
+    void Cholmod<I>::setSupernodal(int supernodal, double supernodalSwitch) {
+      SM_ASSERT_TRUE(Exception, supernodal == CHOLMOD_SIMPLICIAL || supernodal == CHOLMOD_AUTO || supernodal == CHOLMOD_SUPERNODAL,
+                     "Unknown factorization type " << supernodal);
+      SM_ASSERT_GT(Exception, supernodalSwitch, 0.0, "The supernodal switch has to be positive");
+      _cholmod.supernodal = supernodal;
+      _cholmod.supernodal_switch = supernodalSwitch;
+    }
+
+    template<typename I>
+    void Cholmod<I>::setQrNumThreads(int numThreads, double grain) {
+      _cholmod.SPQR_nthreads = numThreads;
+      _cholmod.SPQR_grain = grain;
+    }
+
+    template<typename I>
+    bool Cholmod<I>::setNumBlasThreads(int numThreads) {
+      SM_ASSERT_GT(Exception, numThreads, 0, "The number of BLAS threads has to be positive");
+#if defined(__GNUC__)
+      if (openblas_set_num_threads) {
+        openblas_set_num_threads(numThreads);
+        return true;
+      }
+      if (MKL_Set_Num_Threads) {
+        MKL_Set_Num_Threads(numThreads);
+        return true;
+      }
+#endif
+      return false;
+    }
+
   } // namespace backend
 } // namespace aslam
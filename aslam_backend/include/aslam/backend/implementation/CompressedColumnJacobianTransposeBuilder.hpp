@@ -1,12 +1,14 @@
 #include <aslam/backend/CompressedColumnJacobianTransposeBuilder.hpp>
 
+#include <algorithm>
 #include <future>
+#include <unordered_map>
 
 namespace aslam {
   namespace backend {
 
     template<typename I>
-    CompressedColumnJacobianTransposeBuilder<I>::CompressedColumnJacobianTransposeBuilder() : _isInitialized(false)
+    CompressedColumnJacobianTransposeBuilder<I>::CompressedColumnJacobianTransposeBuilder() : _isInitialized(false), _numSkipped(0), _jacobianContainerMemory(0)
     {
     }
 
@@ -17,12 +19,33 @@ namespace aslam {
 
 
     template<typename I>
-    void CompressedColumnJacobianTransposeBuilder<I>::initMatrixStructure(const std::vector<DesignVariable*> & dvs, const std::vector<ErrorTerm*> & errors)
+    void CompressedColumnJacobianTransposeBuilder<I>::initMatrixStructure(const std::vector<DesignVariable*> & dvs, const std::vector<ErrorTerm*> & errors, bool keepAppendedTo)
     {
+      _relinearizationStatistics = RelinearizationStatistics();
+      if (keepAppendedTo && isAppendedTo(dvs, errors)) {
+        size_t eRow = _jacobianPointers.empty() ? 0 : _jacobianPointers.back().eRow + _jacobianPointers.back().errorTerm->dimension();
+        for (size_t i = _jacobianPointers.size(); i < errors.size(); ++i) {
+          _jacobianPointers.push_back(Evaluator());
+          _jacobianPointers.back().set(_J_transpose.appendErrorJacobiansSymbolic(*errors[i]), errors[i], eRow);
+          eRow += errors[i]->dimension();
+        }
+        _J.reset();
+        return;
+      }
       _jacobianPointers.clear();
       _jacobianPointers.resize(errors.size());
       _J_transpose.clear();
       _J.reset();
+      _trackedDvs.clear();
+      _termDvOffsets.clear();
+      _termDvs.clear();
+      _isChangeTrackingValid = false;
+      _numBuiltErrorTerms = 0;
+      _dvs = dvs;
+      _columnBases.resize(dvs.size());
+      for (size_t i = 0; i < dvs.size(); ++i) {
+        _columnBases[i] = dvs[i]->columnBase();
+      }
       size_t nnz = 0;
       size_t num_cols = 0;
       std::vector<ErrorTerm*>::const_iterator eit = errors.begin();
@@ -55,6 +78,26 @@ namespace aslam {
 
 
 
+    template<typename I>
+    bool CompressedColumnJacobianTransposeBuilder<I>::isAppendedTo(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors) const
+    {
+      if (!_isInitialized || dvs != _dvs || errors.size() < _jacobianPointers.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < dvs.size(); ++i) {
+        if (dvs[i]->columnBase() != _columnBases[i]) {
+          return false;
+        }
+      }
+      for (size_t i = 0; i < _jacobianPointers.size(); ++i) {
+        if (errors[i] != _jacobianPointers[i].errorTerm) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+
     template<typename I>
     template<typename MEMBER_FUNCTION_PTR>
     void CompressedColumnJacobianTransposeBuilder<I>::setupThreadedJob(MEMBER_FUNCTION_PTR ptr, size_t nThreads, bool useMEstimator)
@@ -91,7 +134,69 @@ namespace aslam {
     void CompressedColumnJacobianTransposeBuilder<I>::buildSystem(size_t nThreads, bool useMEstimator)
     {
       _isJacobianBuiltFromJacobianTranspose = false;
+      const bool trackChanges = _relinearizationThreshold >= 0.0;
+      if (trackChanges && _termDvOffsets.size() != _jacobianPointers.size() + 1) {
+        initChangeTracking();
+      }
+      // The weights of the M-estimators are part of the Jacobians
+      _skipUnmoved = trackChanges && _isChangeTrackingValid && useMEstimator == _lastUseMEstimator;
+      for (TrackedDesignVariable& t : _trackedDvs) {
+        t.moved = !_skipUnmoved || t.numParameterSets != t.dv->numParameterSets() ||
+            !(t.dv->accumulatedUpdateNorm() - t.accumulatedUpdateNorm <= _relinearizationThreshold);
+      }
+
+      _numSkipped = 0;
+      _jacobianContainerMemory = 0;
       setupThreadedJob(&CompressedColumnJacobianTransposeBuilder::evaluateJacobians, nThreads, useMEstimator);
+      _relinearizationStatistics.numSkipped += _numSkipped;
+      _relinearizationStatistics.numEvaluated += _jacobianPointers.size() - _numSkipped;
+
+      // All Jacobians depending on a moved design variable were evaluated at its current state
+      for (TrackedDesignVariable& t : _trackedDvs) {
+        if (t.moved) {
+          t.accumulatedUpdateNorm = t.dv->accumulatedUpdateNorm();
+          t.numParameterSets = t.dv->numParameterSets();
+        }
+      }
+      _isChangeTrackingValid = trackChanges;
+      _lastUseMEstimator = useMEstimator;
+      _numBuiltErrorTerms = _jacobianPointers.size();
+    }
+
+
+    template<typename I>
+    void CompressedColumnJacobianTransposeBuilder<I>::initChangeTracking()
+    {
+      std::unordered_map<const DesignVariable*, size_t> index;
+      for (size_t k = 0; k < _trackedDvs.size(); ++k) {
+        index.emplace(_trackedDvs[k].dv, k);
+      }
+      _termDvOffsets.reserve(_jacobianPointers.size() + 1);
+      if (_termDvOffsets.empty()) {
+        _termDvOffsets.push_back(0);
+      }
+      for (size_t i = _termDvOffsets.size() - 1; i < _jacobianPointers.size(); ++i) {
+        for (const DesignVariable* dv : _jacobianPointers[i].errorTerm->designVariables()) {
+          auto it = index.emplace(dv, _trackedDvs.size());
+          if (it.second) {
+            _trackedDvs.push_back(TrackedDesignVariable{dv, dv->accumulatedUpdateNorm(), dv->numParameterSets(), true});
+          }
+          _termDvs.push_back(it.first->second);
+        }
+        _termDvOffsets.push_back(_termDvs.size());
+      }
+    }
+
+
+    template<typename I>
+    bool CompressedColumnJacobianTransposeBuilder<I>::hasMoved(size_t i) const
+    {
+      for (size_t k = _termDvOffsets[i]; k < _termDvOffsets[i + 1]; ++k) {
+        if (_trackedDvs[_termDvs[k]].moved) {
+          return true;
+        }
+      }
+      return false;
     }
 
 
@@ -100,11 +205,20 @@ namespace aslam {
     void CompressedColumnJacobianTransposeBuilder<I>::evaluateJacobians(int /* threadId */, int startIdx, int endIdx, bool useMEstimator)
     {
       Eigen::VectorXd ee;
+      std::size_t numSkipped = 0;
+      std::size_t containerMemory = 0;
       for (int i = startIdx; i < endIdx; ++i) {
+        if (_skipUnmoved && static_cast<size_t>(i) < _numBuiltErrorTerms && !hasMoved(i)) {
+          ++numSkipped;
+          continue;
+        }
         JacobianContainerSparse<Eigen::Dynamic> jc(_jacobianPointers[i].errorTerm->dimension());
         _jacobianPointers[i].errorTerm->getWeightedJacobians(jc, useMEstimator);
+        containerMemory = std::max(containerMemory, jc.getMemoryUsage());
         _J_transpose.writeJacobians(jc, _jacobianPointers[i].jcp);
       }
+      _numSkipped += numSkipped;
+      _jacobianContainerMemory += containerMemory;
     }
 
 
@@ -192,6 +192,12 @@ namespace aslam {
       return _values.size();
     }
 
+    template<typename I>
+    size_t CompressedColumnMatrix<I>::getMemoryUsage() const
+    {
+      return _values.capacity() * sizeof(double) + (_row_ind.capacity() + _col_ptr.capacity()) * sizeof(index_t);
+    }
+
     /// \brief Get the underlying values
     template<typename I>
     const std::vector<double>& CompressedColumnMatrix<I>::values() const
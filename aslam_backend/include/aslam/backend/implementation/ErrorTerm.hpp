@@ -189,6 +189,14 @@ namespace aslam {
       e = _sqrtInvR.transpose() * _error * sqrtWeight;
     }
 
+    template<int C>
+    std::size_t ErrorTermFs<C>::getMemoryUsage() const
+    {
+      // Dynamic sizes keep the error and the uncertainty on the heap
+      const std::size_t heapBytes = C == Eigen::Dynamic ? (_error.size() + _sqrtInvR.size()) * sizeof(double) : 0;
+      return ErrorTerm::getMemoryUsage() + sizeof(ErrorTermFs<C>) - sizeof(ErrorTerm) + heapBytes;
+    }
+
     template<int C>
     void ErrorTermFs<C>::checkJacobiansFinite() const {
       JacobianContainerSparse<Dimension> J(C);
@@ -2,6 +2,7 @@
 #define ASLAM_JACOBIAN_CONTAINER_SPARSE_IMPL_HPP
 
 #include <sm/assert_macros.hpp>
+#include <aslam/backend/MemoryStatistics.hpp>
 
 #include "JacobianContainerImpl.hpp"
 
@@ -256,6 +257,16 @@ namespace aslam {
       return sum;
     }
 
+    JACOBIAN_CONTAINER_SPARSE_TEMPLATE
+    std::size_t JACOBIAN_CONTAINER_SPARSE_CLASS_TEMPLATE::getMemoryUsage() const
+    {
+      std::size_t bytes = JacobianContainer::getMemoryUsage() + _jacobianMap.size() * mapNodeMemoryUsage<typename map_t::value_type>();
+      for (const auto& block : _jacobianMap) {
+        bytes += block.second.size() * sizeof(double);
+      }
+      return bytes;
+    }
+
     JACOBIAN_CONTAINER_SPARSE_TEMPLATE
     template <typename MATRIX>
     EIGEN_ALWAYS_INLINE void JACOBIAN_CONTAINER_SPARSE_CLASS_TEMPLATE::addJacobian(DesignVariable* dv, const MATRIX& jacobian)
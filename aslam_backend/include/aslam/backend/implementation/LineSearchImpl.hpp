@@ -24,6 +24,7 @@ inline void LineSearchOptions::serialize(Archive & ar, const unsigned int /*vers
   ar & BOOST_SERIALIZATION_NVP(nMaxIterWolfe1);
   ar & BOOST_SERIALIZATION_NVP(nMaxIterWolfe2);
   ar & BOOST_SERIALIZATION_NVP(nMaxIterZoom);
+  ar & BOOST_SERIALIZATION_NVP(numSpeculativeSteps);
 }
 
 } /* namespace aslam */
@@ -24,6 +24,10 @@ inline void OptimizerOptionsRprop::serialize(Archive & ar, const unsigned int /*
   ar & BOOST_SERIALIZATION_NVP(useDenseJacobianContainer);
   ar & BOOST_SERIALIZATION_NVP(regularizer);
   ar & BOOST_SERIALIZATION_NVP(method);
+  ar & BOOST_SERIALIZATION_NVP(miniBatchSize);
+  ar & BOOST_SERIALIZATION_NVP(miniBatchGrowth);
+  ar & BOOST_SERIALIZATION_NVP(miniBatchSampling);
+  ar & BOOST_SERIALIZATION_NVP(miniBatchUniformMixing);
 }
 
 } /* namespace aslam */
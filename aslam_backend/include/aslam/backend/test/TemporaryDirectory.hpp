@@ -0,0 +1,42 @@
+#ifndef ASLAM_BACKEND_TEST_TEMPORARY_DIRECTORY_HPP
+#define ASLAM_BACKEND_TEST_TEMPORARY_DIRECTORY_HPP
+
+#include <sm/assert_macros.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <ftw.h>
+
+namespace aslam {
+  namespace backend {
+    namespace test {
+
+      /// \brief A fresh directory below $TMPDIR (or /tmp), removed with its content on destruction
+      class TemporaryDirectory {
+       public:
+        TemporaryDirectory() {
+          const char* tmp = std::getenv("TMPDIR");
+          std::string pattern = std::string(tmp && *tmp ? tmp : "/tmp") + "/aslam_backend_test_XXXXXX";
+          SM_ASSERT_TRUE(std::runtime_error, ::mkdtemp(&pattern[0]) != nullptr, "Unable to create a temporary directory from " << pattern);
+          _path = pattern;
+        }
+        ~TemporaryDirectory() {
+          ::nftw(_path.c_str(), [](const char* path, const struct stat*, int, struct FTW*) { return std::remove(path); },
+                 16, FTW_DEPTH | FTW_PHYS);
+        }
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+        const std::string& path() const { return _path; }
+        std::string file(const std::string& name) const { return _path + "/" + name; }
+       private:
+        std::string _path;
+      };
+
+    } // namespace test
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_TEST_TEMPORARY_DIRECTORY_HPP */
@@ -0,0 +1,79 @@
+#ifndef INCLUDE_ASLAM_BACKEND_UTIL_CANCELLATIONTOKEN_HPP_
+#define INCLUDE_ASLAM_BACKEND_UTIL_CANCELLATIONTOKEN_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+#include <aslam/Exceptions.hpp>
+
+namespace aslam {
+namespace backend {
+namespace util {
+
+/**
+ * \class CancellationToken
+ * Cooperative stop request for long running computations. The controlling thread requests
+ * cancellation or sets a deadline, the working threads poll isCancelled() or call
+ * throwIfCancelled() at points where stopping is safe. All methods are thread-safe.
+ */
+class CancellationToken {
+ public:
+  SM_DEFINE_EXCEPTION(Cancelled, aslam::Exception);
+
+  typedef std::chrono::steady_clock Clock;
+
+  CancellationToken() : _cancelRequested(false), _deadline(noDeadline()) { }
+
+  /// \brief Ask the working threads to stop
+  void requestCancel() { _cancelRequested.store(true, std::memory_order_relaxed); }
+
+  /// \brief Stop once \p deadline has passed
+  void setDeadline(const Clock::time_point& deadline) { _deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed); }
+
+  /// \brief Stop once \p seconds have passed from now. Values <= 0 remove the deadline.
+  void setTimeBudget(double seconds) {
+    if (seconds > 0.0)
+      setDeadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+    else
+      _deadline.store(noDeadline(), std::memory_order_relaxed);
+  }
+
+  /// \brief Withdraw the cancel request and the deadline
+  void reset() {
+    _cancelRequested.store(false, std::memory_order_relaxed);
+    _deadline.store(noDeadline(), std::memory_order_relaxed);
+  }
+
+  /// \brief Has cancellation been requested explicitly?
+  bool isCancelRequested() const { return _cancelRequested.load(std::memory_order_relaxed); }
+
+  /// \brief Has the deadline passed?
+  bool isDeadlineReached() const {
+    const Clock::rep deadline = _deadline.load(std::memory_order_relaxed);
+    return deadline != noDeadline() && Clock::now().time_since_epoch().count() >= deadline;
+  }
+
+  /// \brief Should the work stop?
+  bool isCancelled() const { return isCancelRequested() || isDeadlineReached(); }
+
+  /// \brief Throw Cancelled if the work should stop
+  void throwIfCancelled() const {
+    if (isCancelRequested())
+      SM_THROW(Cancelled, "Cancellation requested");
+    if (isDeadlineReached())
+      SM_THROW(Cancelled, "Deadline reached");
+  }
+
+ private:
+  static constexpr Clock::rep noDeadline() { return std::numeric_limits<Clock::rep>::max(); }
+
+  std::atomic<bool> _cancelRequested;
+  std::atomic<Clock::rep> _deadline; /// \brief Ticks of Clock since its epoch, noDeadline() if unset
+};
+
+} // namespace util
+} // namespace backend
+} // namespace aslam
+
+#endif /* INCLUDE_ASLAM_BACKEND_UTIL_CANCELLATIONTOKEN_HPP_ */
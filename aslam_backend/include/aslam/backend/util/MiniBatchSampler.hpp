@@ -0,0 +1,79 @@
+#ifndef INCLUDE_ASLAM_BACKEND_MINIBATCHSAMPLER_HPP_
+#define INCLUDE_ASLAM_BACKEND_MINIBATCHSAMPLER_HPP_
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace aslam {
+namespace backend {
+
+class ProblemManager;
+
+/**
+ * \struct MiniBatch
+ * A weighted subset of the error terms of a ProblemManager. Error term i is the i-th error term in the
+ * ProblemManager's order, i.e. the non-squared error terms first, then the squared ones.
+ * The weighted sum of the gradients of the batch is an unbiased estimate of the full gradient.
+ */
+struct MiniBatch {
+  /// \brief Indices of the sampled error terms, sorted and unique
+  std::vector<std::size_t> errorTermIndices;
+  /// \brief The gradient of error term errorTermIndices[k] is scaled by weights[k]
+  std::vector<double> weights;
+
+  std::size_t size() const { return errorTermIndices.size(); }
+  void clear() { errorTermIndices.clear(); weights.clear(); }
+};
+
+/**
+ * \class MiniBatchSampler
+ * Draws mini-batches of error terms with replacement. Each draw of error term i with probability p_i
+ * contributes the weight 1/(n p_i) for a batch of n draws, duplicates are merged.
+ *
+ * With importance sampling, p_i is proportional to the cost of error term i cached by its last evaluation
+ * (see ProblemManager::getCachedErrorTermCost()), mixed with the uniform distribution such that every error term keeps
+ * a non-zero probability. Error terms that were never sampled get the mean cost of the sampled ones.
+ */
+class MiniBatchSampler {
+ public:
+  enum class Sampling { UNIFORM, IMPORTANCE };
+
+  /// \brief Constructor. \p uniformMixing in (0, 1] is the share of the uniform distribution in the importance distribution.
+  MiniBatchSampler(Sampling sampling = Sampling::UNIFORM, double uniformMixing = 0.1);
+
+  /// \brief Forget the importance of all error terms and sample from \p numErrorTerms error terms.
+  void reset(std::size_t numErrorTerms);
+
+  /// \brief Seed the random number generator
+  void seed(unsigned int seed) { _rng.seed(seed); }
+
+  /// \brief Draw \p batchSize error terms into \p outBatch.
+  void sample(std::size_t batchSize, MiniBatch& outBatch);
+
+  /// \brief Read the importance of the error terms in \p batch from \p problemManager after their gradients were evaluated.
+  ///        Does nothing for uniform sampling.
+  void updateImportance(const MiniBatch& batch, const ProblemManager& problemManager);
+
+  Sampling getSampling() const { return _sampling; }
+  std::size_t numErrorTerms() const { return _numErrorTerms; }
+
+ private:
+  Sampling _sampling;
+  double _uniformMixing;
+  std::size_t _numErrorTerms = 0;
+
+  /// \brief Importance of each error term, negative if not known yet
+  std::vector<double> _importance;
+  /// \brief Buffer for the cumulative distribution
+  std::vector<double> _cumulative;
+  /// \brief Buffer for the raw draws
+  std::vector<std::pair<std::size_t, double> > _draws;
+
+  std::mt19937 _rng;
+};
+
+} // namespace backend
+} // namespace aslam
+
+#endif /* INCLUDE_ASLAM_BACKEND_MINIBATCHSAMPLER_HPP_ */
@@ -26,6 +26,14 @@ class OptimizerProblemManagerBase : public OptimizerBase
   ~OptimizerProblemManagerBase() override { }
   void setProblem(boost::shared_ptr<OptimizationProblemBase> problem) override { _problemManager.setProblem(problem); }
   void checkProblemSetup() override { _problemManager.checkProblemSetup(); }
+
+  /// \brief Compare the analytic Jacobians of a random subset of the error terms with central differences
+  JacobianChecker::Report checkJacobians(const JacobianCheckerOptions& options = JacobianCheckerOptions()) const { return _problemManager.checkJacobians(options); }
+
+  /// \brief Poll \p token in the threaded error and gradient loops and abort the optimization with
+  ///        CancellationToken::Cancelled once it is cancelled. The token is not owned, pass nullptr to stop polling.
+  void setCancellationToken(const util::CancellationToken* token) { _problemManager.setCancellationToken(token); }
+
   bool isInitialized() override { return _problemManager.isInitialized(); }
   const std::vector<DesignVariable*>& getDesignVariables() const override { return _problemManager.designVariables(); }
 
@@ -14,10 +14,13 @@
 
 #include "CommonDefinitions.hpp"
 #include "CostFunctionInterface.hpp"
+#include "CancellationToken.hpp"
+#include "MiniBatchSampler.hpp"
 
 #include "../../Exceptions.hpp"
 #include "../JacobianContainerDense.hpp"
 #include "../JacobianContainerSparse.hpp"
+#include "../JacobianChecker.hpp"
 
 namespace aslam {
 namespace backend {
@@ -83,6 +86,11 @@ class ProblemManager {
   ///        hooked up to design variables and running finite differences on error terms where this is possible.
   void checkProblemSetup() const;
 
+  /// \brief Compare the analytic Jacobians of a random subset of the squared error terms with central differences.
+  ///        The problem has to be initialized. Successive calls draw different subsets, call k uses the seed options.seed + k.
+  ///        See JacobianChecker for details.
+  JacobianChecker::Report checkJacobians(const JacobianCheckerOptions& options = JacobianCheckerOptions()) const;
+
   /// \brief Evaluate the value of the objective function
   double evaluateError(const size_t nThreads = 1) const;
 
@@ -106,17 +114,37 @@ class ProblemManager {
   /// \brief compute the current gradient of the objective function
   void computeGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer);
 
+  /// \brief compute the weighted sum of the gradients of the error terms in \p batch, an unbiased estimate
+  ///        of the gradient of the objective function (see MiniBatchSampler).
+  void computeGradient(RowVectorType& outGrad, const MiniBatch& batch, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer);
+
+  /// \brief The cost of error term \p i cached by its last evaluation, i.e. the raw squared error of a squared
+  ///        error term or the absolute raw error of a non-squared one. Error terms are ordered as in MiniBatch.
+  double getCachedErrorTermCost(size_t i) const;
+
   /// \brief Apply the scaling of the design variables to \p outGrad
   void applyDesignVariableScaling(RowVectorType& outGrad) const;
 
-  /// \brief computes the gradient of a specific error term
+  /// \brief computes the gradient of a specific error term.
+  ///        The gradients of squared error terms are vector-Jacobian products (see ErrorTerm::addWeightedGradient()),
+  ///        their Jacobians are never materialized. The sparse overloads do not clear \p jc.
+  ///        The gradient is multiplied by \p scale before it is added.
   void addGradientForErrorTerm(RowVectorType& J, ErrorTerm* e, bool useMEstimator, bool useDenseJacobianContainer);
-  void addGradientForErrorTerm(JacobianContainerSparse<1>& jc, RowVectorType& J, ScalarNonSquaredErrorTerm* e, bool useMEstimator);
-  void addGradientForErrorTerm(JacobianContainerDense<RowVectorType&, 1>& jc, ScalarNonSquaredErrorTerm* e, bool useMEstimator);
+  void addGradientForErrorTerm(JacobianContainerSparse<1>& jc, RowVectorType& J, ErrorTerm* e, bool useMEstimator, double scale = 1.0);
+  void addGradientForErrorTerm(JacobianContainerDense<RowVectorType&, 1>& jc, ErrorTerm* e, bool useMEstimator, double scale = 1.0);
+  void addGradientForErrorTerm(JacobianContainerSparse<1>& jc, RowVectorType& J, ScalarNonSquaredErrorTerm* e, bool useMEstimator, double scale = 1.0);
+  void addGradientForErrorTerm(JacobianContainerDense<RowVectorType&, 1>& jc, ScalarNonSquaredErrorTerm* e, bool useMEstimator, double scale = 1.0);
 
   const std::vector<ErrorTerm*>& getErrorTerms() const {
     return _errorTermsS;
   }
+
+  /// \brief Poll \p token in the error and gradient loops and throw CancellationToken::Cancelled once it is cancelled.
+  ///        The token is not owned, pass nullptr to stop polling.
+  void setCancellationToken(const util::CancellationToken* token) { _cancellationToken = token; }
+
+  /// \brief The token polled in the error and gradient loops, nullptr if none
+  const util::CancellationToken* getCancellationToken() const { return _cancellationToken; }
  protected:
   /// \brief Set the initialized status
   void setInitialized(bool isInitialized) { _isInitialized = isInitialized; }
@@ -125,9 +153,16 @@ class ProblemManager {
   /// \brief Evaluate the gradient of the objective function
   void evaluateGradients(size_t threadId, size_t startIdx, size_t endIdx, RowVectorType& grad, bool useMEstimator, bool useDenseJacobianContainer);
 
+  /// \brief Evaluate the weighted gradients of the batch entries [startIdx, endIdx)
+  void evaluateMiniBatchGradients(size_t threadId, size_t startIdx, size_t endIdx, RowVectorType& grad, const MiniBatch& batch,
+                                  bool useMEstimator, bool useDenseJacobianContainer);
+
   /// \brief Evaluate the objective function
   void sumErrorTerms(size_t /* threadId */, size_t startIdx, size_t endIdx, double& err) const;
 
+  /// \brief Throw if the cancellation token asks to stop
+  void checkCancelled() const { if (_cancellationToken) _cancellationToken->throwIfCancelled(); }
+
  private:
 
   /// \brief The current optimization problem.
@@ -155,6 +190,12 @@ class ProblemManager {
   /// \brief Whether the optimizer is correctly initialized
   bool _isInitialized = false;
 
+  /// \brief Polled in the error and gradient loops, not owned
+  const util::CancellationToken* _cancellationToken = nullptr;
+
+  /// \brief The number of calls to checkJacobians(), offsets the seed of the sample
+  mutable std::uint32_t _numJacobianChecks = 0;
+
 };
 
 namespace details
@@ -0,0 +1,138 @@
+#include <aslam/backend/AsyncOptimizer.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+
+#include <sm/assert_macros.hpp>
+
+#include <typeindex>
+
+namespace aslam {
+  namespace backend {
+
+    namespace {
+      double secondsSince(const AsyncOptimizer::Clock::time_point& start)
+      {
+        return std::chrono::duration<double>(AsyncOptimizer::Clock::now() - start).count();
+      }
+    } // namespace
+
+    AsyncOptimizer::AsyncOptimizer(const boost::shared_ptr<OptimizerProblemManagerBase>& optimizer) :
+        _optimizer(optimizer),
+        _iterationEndCallback([this]() {
+          // The state at the end of an iteration has been accepted (rejected steps are reverted before)
+          publishSnapshot();
+          _token.throwIfCancelled();
+        }),
+        _cancellationCallback([this]() { _token.throwIfCancelled(); })
+    {
+      SM_ASSERT_TRUE(Exception, _optimizer != nullptr, "The optimizer is null");
+    }
+
+    AsyncOptimizer::~AsyncOptimizer()
+    {
+      // The run removes its callbacks and detaches the token itself
+      if (_run.valid()) {
+        cancel();
+        _run.wait();
+      }
+    }
+
+    void AsyncOptimizer::start(double timeBudget)
+    {
+      SM_ASSERT_FALSE(Exception, isRunning(), "The optimization is already running");
+      if (!_optimizer->isInitialized())
+        _optimizer->initialize();
+
+      _token.reset();
+      _start = Clock::now();
+      _token.setTimeBudget(timeBudget);
+      _optimizer->setCancellationToken(&_token);
+      publishSnapshot();
+      attach();
+      try {
+        _run = std::async(std::launch::async, [this]() { return run(); });
+      } catch (...) {
+        detach();
+        throw;
+      }
+    }
+
+    void AsyncOptimizer::cancel()
+    {
+      _token.requestCancel();
+    }
+
+    bool AsyncOptimizer::isRunning() const
+    {
+      return _run.valid() && _run.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    }
+
+    AsyncOptimizer::Result AsyncOptimizer::wait()
+    {
+      SM_ASSERT_TRUE(Exception, _run.valid(), "No optimization has been started since the last wait()");
+      return _run.get();
+    }
+
+    boost::shared_ptr<const AsyncOptimizer::Snapshot> AsyncOptimizer::getLatestSnapshot() const
+    {
+      return boost::atomic_load(&_snapshot);
+    }
+
+    AsyncOptimizer::Result AsyncOptimizer::run()
+    {
+      Result result;
+      try {
+        _optimizer->optimize();
+        publishSnapshot();
+        result.outcome = Outcome::FINISHED;
+      } catch (const util::CancellationToken::Cancelled&) {
+        restoreSnapshot(*getLatestSnapshot());
+        result.outcome = _token.isCancelRequested() ? Outcome::CANCELLED : Outcome::DEADLINE_REACHED;
+      } catch (const std::exception& e) {
+        restoreSnapshot(*getLatestSnapshot());
+        result.outcome = Outcome::FAILED;
+        result.errorMessage = e.what();
+      }
+      // Direct calls to optimize() must not see this run's deadline
+      detach();
+      result.status = _optimizer->getStatus();
+      result.time = secondsSince(_start);
+      return result;
+    }
+
+    void AsyncOptimizer::attach()
+    {
+      _optimizer->callback().add({typeid(callback::event::ITERATION_END)}, _iterationEndCallback);
+      _optimizer->callback().add({typeid(callback::event::ITERATION_START), typeid(callback::event::LINEAR_SYSTEM_SOLVED),
+                                  typeid(callback::event::DESIGN_VARIABLES_UPDATED)}, _cancellationCallback);
+    }
+
+    void AsyncOptimizer::detach()
+    {
+      _optimizer->callback().remove({typeid(callback::event::ITERATION_END)}, _iterationEndCallback);
+      _optimizer->callback().remove({typeid(callback::event::ITERATION_START), typeid(callback::event::LINEAR_SYSTEM_SOLVED),
+                                     typeid(callback::event::DESIGN_VARIABLES_UPDATED)}, _cancellationCallback);
+      _optimizer->setCancellationToken(nullptr);
+    }
+
+    void AsyncOptimizer::publishSnapshot()
+    {
+      boost::shared_ptr<Snapshot> snapshot(new Snapshot());
+      snapshot->numIterations = _optimizer->getStatus().numIterations;
+      snapshot->time = secondsSince(_start);
+      const std::vector<DesignVariable*>& dvs = _optimizer->getDesignVariables();
+      snapshot->parameters.resize(dvs.size());
+      for (size_t i = 0; i < dvs.size(); ++i)
+        dvs[i]->getParameters(snapshot->parameters[i]);
+      boost::atomic_store(&_snapshot, boost::shared_ptr<const Snapshot>(snapshot));
+    }
+
+    void AsyncOptimizer::restoreSnapshot(const Snapshot& snapshot)
+    {
+      const std::vector<DesignVariable*>& dvs = _optimizer->getDesignVariables();
+      SM_ASSERT_EQ(Exception, dvs.size(), snapshot.parameters.size(), "The design variables changed during the optimization");
+      for (size_t i = 0; i < dvs.size(); ++i)
+        dvs[i]->setParameters(snapshot.parameters[i]);
+    }
+
+  } // namespace backend
+} // namespace aslam
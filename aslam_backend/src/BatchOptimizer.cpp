@@ -0,0 +1,144 @@
+#include <aslam/backend/BatchOptimizer.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
+#include <aslam/backend/OptimizationProblemBase.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/ScalarNonSquaredErrorTerm.hpp>
+#include <aslam/backend/util/ThreadedRangeProcessor.hpp>
+
+#include <sm/assert_macros.hpp>
+#include <sm/logging.hpp>
+
+#include <algorithm>
+
+namespace aslam {
+  namespace backend {
+
+    namespace {
+
+      /// \brief A cheap summary of the structure of \p problem. Problems with the same structure have the same key.
+      std::vector<std::size_t> structureKey(OptimizationProblemBase& problem)
+      {
+        std::vector<std::size_t> key;
+        key.push_back(problem.numDesignVariables());
+        for (std::size_t i = 0; i < problem.numDesignVariables(); ++i) {
+          const DesignVariable* dv = problem.designVariable(i);
+          key.push_back(dv->isActive() ? dv->minimalDimensions() : 0);
+        }
+        key.push_back(problem.numErrorTerms());
+        for (std::size_t i = 0; i < problem.numErrorTerms(); ++i) {
+          const ErrorTerm* e = problem.errorTerm(i);
+          key.push_back(e->dimension());
+          for (const DesignVariable* dv : e->designVariables())
+            key.push_back(dv->isActive() ? dv->minimalDimensions() : 0);
+        }
+        key.push_back(problem.numNonSquaredErrorTerms());
+        for (std::size_t i = 0; i < problem.numNonSquaredErrorTerms(); ++i)
+          key.push_back(problem.nonSquaredErrorTerm(i)->numDesignVariables());
+        return key;
+      }
+
+    } // namespace
+
+    BatchOptimizer::BatchOptimizer(const Optimizer2Options& options, std::size_t numThreads)
+        : BatchOptimizer([options]() {
+            Optimizer2Options workerOptions = options;
+            workerOptions.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+            workerOptions.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy());
+            return boost::shared_ptr<OptimizerProblemManagerBase>(new Optimizer2(workerOptions));
+          }, options, numThreads)
+    {
+      SM_ASSERT_TRUE(Exception, !options.linearSystemSolver && !options.trustRegionPolicy,
+                     "Every worker needs a linear system solver and trust region policy of its own, use an OptimizerFactory to set them");
+    }
+
+    BatchOptimizer::BatchOptimizer(const OptimizerFactory& factory, const OptimizerOptionsBase& options, std::size_t numThreads)
+        : _factory(factory), _numThreads(numThreads), _next(0)
+    {
+      SM_ASSERT_TRUE(Exception, static_cast<bool>(_factory), "");
+      SM_ASSERT_GT(Exception, _numThreads, 0u, "");
+      setOptions(options);
+    }
+
+    BatchOptimizer::~BatchOptimizer()
+    {
+    }
+
+    void BatchOptimizer::setNumThreads(std::size_t numThreads)
+    {
+      SM_ASSERT_GT(Exception, numThreads, 0u, "");
+      _numThreads = numThreads;
+    }
+
+    void BatchOptimizer::setOptions(const OptimizerOptionsBase& options)
+    {
+      options.check();
+      _options = options;
+      // The problems run concurrently, so every single one is optimized with one thread
+      _options.numThreadsJacobian = 1;
+      _options.numThreadsError = 1;
+      for (auto& worker : _workers) {
+        if (worker)
+          worker->setOptions(_options);
+      }
+    }
+
+    std::vector<OptimizerStatus> BatchOptimizer::optimize(const Problems& problems)
+    {
+      std::vector<OptimizerStatus> statuses(problems.size());
+      if (problems.empty())
+        return statuses;
+      for (auto& problem : problems)
+        SM_ASSERT_TRUE(Exception, problem != nullptr, "The batch contains no problem");
+
+      std::vector<std::vector<std::size_t> > keys;
+      keys.reserve(problems.size());
+      for (auto& problem : problems)
+        keys.push_back(structureKey(*problem));
+      _schedule.resize(problems.size());
+      for (std::size_t i = 0; i < _schedule.size(); ++i)
+        _schedule[i] = i;
+      std::stable_sort(_schedule.begin(), _schedule.end(), [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+
+      _problems = &problems;
+      _statuses = &statuses;
+      _next = 0;
+      const std::size_t numThreads = std::min(_numThreads, problems.size());
+      if (_workers.size() < numThreads)
+        _workers.resize(numThreads);
+      util::runThreadedJob(boost::bind(&BatchOptimizer::work, this, _1, _2, _3), numThreads, numThreads);
+      _problems = nullptr;
+      _statuses = nullptr;
+
+      SM_DEBUG_STREAM_NAMED("optimization", "BatchOptimizer: " <<
+                            std::count_if(statuses.begin(), statuses.end(), [](const OptimizerStatus& s) { return s.success(); }) <<
+                            " of " << statuses.size() << " problems converged");
+      return statuses;
+    }
+
+    void BatchOptimizer::work(std::size_t threadId, std::size_t /* startIdx */, std::size_t /* endIdx */)
+    {
+      boost::shared_ptr<OptimizerProblemManagerBase>& optimizer = _workers[threadId];
+      for (std::size_t k = _next++; k < _schedule.size(); k = _next++) {
+        const std::size_t i = _schedule[k];
+        OptimizerStatus& status = (*_statuses)[i];
+        try {
+          if (!optimizer) {
+            optimizer = _factory();
+            SM_ASSERT_TRUE(Exception, optimizer != nullptr, "The optimizer factory returned no optimizer");
+            optimizer->setOptions(_options);
+          }
+          optimizer->setProblem((*_problems)[i]);
+          optimizer->optimize();
+          status = optimizer->getStatus();
+        } catch (const std::exception& e) {
+          SM_ERROR_STREAM("BatchOptimizer: Optimizing problem " << i << " failed: " << e.what());
+          status.convergence = FAILURE;
+        }
+      }
+    }
+
+  } // namespace backend
+} // namespace aslam
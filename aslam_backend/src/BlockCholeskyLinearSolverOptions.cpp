@@ -25,16 +25,28 @@ namespace aslam {
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-      BlockCholeskyLinearSolverOptions::BlockCholeskyLinearSolverOptions() {}
+    BlockCholeskyLinearSolverOptions::BlockCholeskyLinearSolverOptions() :
+        ordering(FillReducingOrdering::AMD),
+        numOrderLast(0),
+        chunkSize(1024) {
+    }
       
     BlockCholeskyLinearSolverOptions::BlockCholeskyLinearSolverOptions(
-        const BlockCholeskyLinearSolverOptions& /* other */) {
+        const BlockCholeskyLinearSolverOptions& other) :
+        ordering(other.ordering),
+        orderLast(other.orderLast),
+        numOrderLast(other.numOrderLast),
+        chunkSize(other.chunkSize) {
     }
 
     BlockCholeskyLinearSolverOptions&
     BlockCholeskyLinearSolverOptions::operator =
         (const BlockCholeskyLinearSolverOptions& other) {
       if (this != &other) {
+        ordering = other.ordering;
+        orderLast = other.orderLast;
+        numOrderLast = other.numOrderLast;
+        chunkSize = other.chunkSize;
       }
       return *this;
     }
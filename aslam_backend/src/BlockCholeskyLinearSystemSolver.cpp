@@ -4,6 +4,9 @@
 #include <sparse_block_matrix/linear_solver_cholmod.h>
 #include <sparse_block_matrix/linear_solver_spqr.h>
 #include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/MemoryStatistics.hpp>
+#include <aslam/backend/util/CancellationToken.hpp>
+#include <aslam/backend/util/ThreadedRangeProcessor.hpp>
 #include <sm/PropertyTree.hpp>
 
 namespace aslam {
@@ -16,16 +19,11 @@ namespace aslam {
 
     BlockCholeskyLinearSystemSolver::BlockCholeskyLinearSystemSolver(const sm::PropertyTree& config) {
       _solverType = config.getString("solverType", "cholesky");
-      // NO OPTIONS CURRENTLY IMPLEMENTED
+      _options.ordering = fillReducingOrderingFromString(config.getString("ordering", "amd"));
+      _options.numOrderLast = config.getInt("numOrderLast", _options.numOrderLast);
+      _options.chunkSize = config.getInt("chunkSize", _options.chunkSize);
       // USING C++11 would allow to do constructor delegation and more elegant code
-      if(_solverType == "cholesky") {
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      } else if(_solverType == "spqr") {
-        _solver.reset(new sparse_block_matrix::LinearSolverQr<Eigen::MatrixXd>());
-      } else {
-        std::cout << "Unknown block solver type " << _solverType << ". Try \"cholesky\" or \"spqr\"\nDefaulting to cholesky.\n";
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      }
+      initSolver();
     }
 
     BlockCholeskyLinearSystemSolver::~BlockCholeskyLinearSystemSolver()
@@ -35,14 +33,7 @@ namespace aslam {
 
     void BlockCholeskyLinearSystemSolver::initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner)
     {
-      if(_solverType == "cholesky") {
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      } else if(_solverType == "spqr") {
-        _solver.reset(new sparse_block_matrix::LinearSolverQr<Eigen::MatrixXd>());
-      } else {
-        std::cout << "Unknown block solver type " << _solverType << ". Try \"cholesky\" or \"spqr\"\nDefaulting to cholesky.\n";
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      }
+      initSolver();
       _solver->init();
       _useDiagonalConditioner = useDiagonalConditioner;
       _errorTerms = errors;
@@ -54,22 +45,75 @@ namespace aslam {
       std::partial_sum(blocks.begin(), blocks.end(), blocks.begin());
       // Now we can initialized the sparse Hessian matrix.
       _H._M = SparseBlockMatrix(blocks, blocks);
+      _threadHessians.clear();
+      _threadRhs.clear();
     }
 
 
-  void BlockCholeskyLinearSystemSolver::buildSystem(size_t /* nThreads */, bool useMEstimator)
+  void BlockCholeskyLinearSystemSolver::buildSystem(size_t nThreads, bool useMEstimator)
     {
-      // \todo make multithreaded. This is complicated as it requires synchronized access to the block matrix.
-      //       A little bit of effort should make this possible by initializing the structure and adding
-      //       a mutex for each block and having writers for each jacobian that have a list of mutexes.
-      //       Save it for later.
       _H._M.clear(false);
       _rhs.setZero();
-      std::vector<ErrorTerm*>::iterator it, it_end;
-      it = _errorTerms.begin();
-      it_end = _errorTerms.end();
-      for (; it != it_end; ++it) {
-        (*it)->buildHessian(_H._M, _rhs, useMEstimator);
+      const size_t chunkSize = std::max(1, _options.chunkSize);
+      nThreads = std::min(nThreads, (_errorTerms.size() + chunkSize - 1) / chunkSize);
+      if (nThreads <= 1) {
+        std::vector<ErrorTerm*>::iterator it, it_end;
+        it = _errorTerms.begin();
+        it_end = _errorTerms.end();
+        for (; it != it_end; ++it) {
+          if (_cancellationToken)
+            _cancellationToken->throwIfCancelled();
+          (*it)->buildHessian(_H._M, _rhs, useMEstimator);
+        }
+        return;
+      }
+
+      // Every thread owns a partial Hessian, so no block is written concurrently.
+      if (_threadHessians.size() > nThreads)
+        _threadHessians.erase(_threadHessians.begin() + nThreads, _threadHessians.end());
+      _threadHessians.reserve(nThreads);
+      while (_threadHessians.size() < nThreads)
+        _threadHessians.emplace_back(_H._M.rowBlockIndices(), _H._M.colBlockIndices());
+      _threadRhs.resize(nThreads);
+      for (size_t t = 0; t < nThreads; ++t) {
+        _threadHessians[t].clear(false);
+        _threadRhs[t].setZero(_rhs.size());
+      }
+      _nextChunk = 0;
+      util::runThreadedJob([this, useMEstimator](size_t threadId, size_t, size_t) {
+        buildPartialHessian(threadId, useMEstimator);
+      }, nThreads, nThreads);
+
+      // Allocating blocks only touches their own block column, so the columns can be summed in parallel.
+      util::runThreadedJob([this](size_t, size_t startCol, size_t endCol) {
+        reducePartialHessians(startCol, endCol);
+      }, _H._M.bCols(), nThreads);
+      for (size_t t = 0; t < nThreads; ++t)
+        _rhs += _threadRhs[t];
+    }
+
+    void BlockCholeskyLinearSystemSolver::buildPartialHessian(size_t threadId, bool useMEstimator)
+    {
+      SparseBlockMatrix& H = _threadHessians[threadId];
+      Eigen::VectorXd& rhs = _threadRhs[threadId];
+      const size_t chunkSize = std::max(1, _options.chunkSize);
+      for (size_t start = _nextChunk.fetch_add(chunkSize); start < _errorTerms.size(); start = _nextChunk.fetch_add(chunkSize)) {
+        if (_cancellationToken)
+          _cancellationToken->throwIfCancelled();
+        const size_t end = std::min(start + chunkSize, _errorTerms.size());
+        for (size_t i = start; i < end; ++i)
+          _errorTerms[i]->buildHessian(H, rhs, useMEstimator);
+      }
+    }
+
+    void BlockCholeskyLinearSystemSolver::reducePartialHessians(size_t startCol, size_t endCol)
+    {
+      for (size_t t = 0; t < _threadHessians.size(); ++t) {
+        for (size_t c = startCol; c < endCol; ++c) {
+          for (const auto& rowBlock : _threadHessians[t].blockCols()[c]) {
+            *_H._M.block(rowBlock.first, c, true) += *rowBlock.second;
+          }
+        }
       }
     }
 
@@ -109,17 +153,41 @@ namespace aslam {
 
 
   void BlockCholeskyLinearSystemSolver::initSolver() {
-      if(_solverType == "cholesky") {
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      } else if(_solverType == "spqr") {
+      if(_solverType == "spqr") {
         _solver.reset(new sparse_block_matrix::LinearSolverQr<Eigen::MatrixXd>());
-      } else {
+        return;
+      }
+      if(_solverType != "cholesky") {
         std::cout << "Unknown block solver type " << _solverType << ". Try \"cholesky\" or \"spqr\"\nDefaulting to cholesky.\n";
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
       }
-
+      boost::shared_ptr<sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd> > solver(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
+      switch (_options.ordering) {
+        case FillReducingOrdering::AMD:
+          solver->setOrdering(CHOLMOD_AMD);
+          break;
+        case FillReducingOrdering::COLAMD:
+          // The Hessian is symmetric, cholmod uses AMD for it.
+          solver->setOrdering(CHOLMOD_COLAMD);
+          break;
+        case FillReducingOrdering::NESDIS:
+          solver->setOrdering(CHOLMOD_NESDIS);
+          break;
+        case FillReducingOrdering::CONSTRAINED:
+          solver->setBlockConstraints(_orderingConstraints);
+          break;
+      }
+      _solver = solver;
   }
 
+    void BlockCholeskyLinearSystemSolver::setOrdering(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& /* errors */)
+    {
+      _orderingConstraints.clear();
+      if (_options.ordering == FillReducingOrdering::CONSTRAINED) {
+        // The block columns of the Hessian follow the order of dvs.
+        computeOrderingConstraints(dvs, _options.orderLast, _options.numOrderLast, _orderingConstraints);
+      }
+    }
+
     /// \brief compute only the covariance blocks associated with the block indices passed as an argument
     void BlockCholeskyLinearSystemSolver::computeCovarianceBlocks(const std::vector<std::pair<int, int> >& blockIndices, SparseBlockMatrix& outP)
     {
@@ -177,6 +245,26 @@ namespace aslam {
         return _rhs.dot(JtJrhs);
     }
 
+    LinearSolverStatistics BlockCholeskyLinearSystemSolver::getStatistics() const {
+      LinearSolverStatistics statistics;
+      statistics.hessianMemory = getMemoryUsage(_H._M);
+      for (const SparseBlockMatrix& H : _threadHessians)
+        statistics.hessianMemory += getMemoryUsage(H);
+      for (const Eigen::VectorXd& rhs : _threadRhs)
+        statistics.hessianMemory += rhs.size() * sizeof(double);
+      if (_solver) {
+        statistics.memoryInUse = _solver->memoryInUse();
+        statistics.peakMemoryUsage = _solver->peakMemoryUsage();
+      }
+      return statistics;
+    }
+
+    std::vector<int> BlockCholeskyLinearSystemSolver::getOrdering() const {
+      boost::shared_ptr<const sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd> > solver =
+          boost::dynamic_pointer_cast<const sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd> >(_solver);
+      return solver ? solver->permutation() : std::vector<int>();
+    }
+
 
   } // namespace backend
 } // namespace aslam
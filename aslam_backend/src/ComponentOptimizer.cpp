@@ -0,0 +1,166 @@
+#include <aslam/backend/ComponentOptimizer.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/util/ThreadedRangeProcessor.hpp>
+
+#include <sm/assert_macros.hpp>
+#include <sm/logging.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aslam {
+  namespace backend {
+
+    void ComponentOptimizer::Status::resetImplementation()
+    {
+      numComponents = 0;
+      numComponentsConverged = 0;
+      numComponentsFailed = 0;
+    }
+
+    ComponentOptimizer::ComponentOptimizer(const Optimizer2Options& options, std::size_t numThreads)
+        : ComponentOptimizer([options]() { return boost::shared_ptr<OptimizerProblemManagerBase>(new Optimizer2(options)); },
+                             options, numThreads)
+    {
+      SM_ASSERT_TRUE(Exception, !options.linearSystemSolver && !options.trustRegionPolicy,
+                     "Every component needs a linear system solver and trust region policy of its own, use an OptimizerFactory to set them");
+    }
+
+    ComponentOptimizer::ComponentOptimizer(const OptimizerFactory& factory, const OptimizerOptionsBase& options, std::size_t numThreads)
+        : _factory(factory), _options(options), _numThreads(numThreads), _next(0)
+    {
+      SM_ASSERT_TRUE(Exception, static_cast<bool>(_factory), "");
+      SM_ASSERT_GT(Exception, _numThreads, 0u, "");
+      _options.check();
+    }
+
+    ComponentOptimizer::~ComponentOptimizer()
+    {
+    }
+
+    void ComponentOptimizer::setProblem(boost::shared_ptr<OptimizationProblemBase> problem)
+    {
+      _problem = problem;
+      _isInitialized = false;
+    }
+
+    void ComponentOptimizer::checkProblemSetup()
+    {
+      if (!isInitialized())
+        initialize();
+      for (auto& optimizer : _optimizers)
+        optimizer->checkProblemSetup();
+    }
+
+    void ComponentOptimizer::setOptions(const OptimizerOptionsBase& options)
+    {
+      options.check();
+      _options = options;
+      for (auto& optimizer : _optimizers)
+        optimizer->setOptions(_options);
+    }
+
+    void ComponentOptimizer::setNumThreads(std::size_t numThreads)
+    {
+      SM_ASSERT_GT(Exception, numThreads, 0u, "");
+      _numThreads = numThreads;
+    }
+
+    const ProblemComponent& ComponentOptimizer::component(std::size_t i) const
+    {
+      SM_ASSERT_LT(Exception, i, _components.size(), "index out of bounds");
+      return *_components[i];
+    }
+
+    const OptimizerProblemManagerBase& ComponentOptimizer::componentOptimizer(std::size_t i) const
+    {
+      SM_ASSERT_LT(Exception, i, _optimizers.size(), "index out of bounds");
+      return *_optimizers[i];
+    }
+
+    void ComponentOptimizer::initializeImplementation()
+    {
+      SM_ASSERT_FALSE(Exception, _problem == nullptr, "No optimization problem has been set");
+      _components = findIndependentComponents(*_problem);
+      SM_ASSERT_FALSE(Exception, _components.empty(), "The problem has no design variable with error terms");
+
+      _optimizers.clear();
+      _designVariables.clear();
+      for (auto& component : _components) {
+        boost::shared_ptr<OptimizerProblemManagerBase> optimizer = _factory();
+        SM_ASSERT_TRUE(Exception, optimizer != nullptr, "The optimizer factory returned no optimizer");
+        optimizer->setOptions(_options);
+        optimizer->setProblem(component);
+        optimizer->initialize();
+        _optimizers.push_back(optimizer);
+        _designVariables.insert(_designVariables.end(), component->designVariables().begin(), component->designVariables().end());
+      }
+
+      _schedule.resize(_components.size());
+      for (std::size_t i = 0; i < _schedule.size(); ++i)
+        _schedule[i] = i;
+      std::stable_sort(_schedule.begin(), _schedule.end(), [this](std::size_t a, std::size_t b) {
+        return _components[a]->numTotalErrorTerms() > _components[b]->numTotalErrorTerms();
+      });
+
+      _isInitialized = true;
+      SM_DEBUG_STREAM_NAMED("optimization", "ComponentOptimizer: Split the problem into " << _components.size() << " independent components");
+    }
+
+    void ComponentOptimizer::optimizeImplementation()
+    {
+      _next = 0;
+      const std::size_t numThreads = std::min(_numThreads, _optimizers.size());
+      util::runThreadedJob(boost::bind(&ComponentOptimizer::optimizeComponents, this, _1, _2, _3), numThreads, numThreads);
+      mergeStatus();
+      SM_DEBUG_STREAM_NAMED("optimization", "ComponentOptimizer: " << _status.numComponentsConverged << " of " << _status.numComponents <<
+                            " components converged, " << _status.numComponentsFailed << " failed");
+    }
+
+    void ComponentOptimizer::optimizeComponents(std::size_t /* threadId */, std::size_t /* startIdx */, std::size_t /* endIdx */)
+    {
+      for (std::size_t k = _next++; k < _schedule.size(); k = _next++)
+        _optimizers[_schedule[k]]->optimize();
+    }
+
+    void ComponentOptimizer::mergeStatus()
+    {
+      _status = Status();
+      _status.numComponents = _optimizers.size();
+      _status.error = 0.0;
+      _status.deltaError = 0.0;
+      _status.maxDeltaX = 0.0;
+      double squaredGradientNorm = 0.0;
+      std::size_t maxIterations = 0;
+      bool first = true;
+      for (auto& optimizer : _optimizers) {
+        const OptimizerStatus& status = optimizer->getStatus();
+        if (status.success())
+          _status.numComponentsConverged++;
+        if (status.failure())
+          _status.numComponentsFailed++;
+        if (first || status.numIterations > maxIterations) {
+          maxIterations = status.numIterations;
+          _status.convergence = status.convergence;
+          first = false;
+        }
+        _status.numJacobianEvaluations += status.numJacobianEvaluations;
+        _status.numErrorEvaluations += status.numErrorEvaluations;
+        // numeric_limits<double>::max() marks an error that was not evaluated
+        if (status.error == std::numeric_limits<double>::max() || _status.error == std::numeric_limits<double>::max())
+          _status.error = std::numeric_limits<double>::max();
+        else
+          _status.error += status.error;
+        _status.deltaError += status.deltaError;
+        _status.maxDeltaX = std::max(_status.maxDeltaX, status.maxDeltaX);
+        squaredGradientNorm += status.gradientNorm * status.gradientNorm;
+      }
+      _status.numIterations = maxIterations;
+      _status.gradientNorm = std::sqrt(squaredGradientNorm);
+      if (_status.numComponentsFailed > 0)
+        _status.convergence = FAILURE;
+    }
+
+  } // namespace backend
+} // namespace aslam
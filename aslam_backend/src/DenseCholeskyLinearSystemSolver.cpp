@@ -0,0 +1,118 @@
+#include <aslam/backend/DenseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/util/CancellationToken.hpp>
+
+#include <sm/PropertyTree.hpp>
+
+namespace aslam {
+  namespace backend {
+
+    DenseCholeskyLinearSystemSolver::DenseCholeskyLinearSystemSolver()
+    {
+    }
+
+    DenseCholeskyLinearSystemSolver::DenseCholeskyLinearSystemSolver(const sm::PropertyTree& /* config */)
+    {
+      // NO OPTIONS CURRENTLY IMPLEMENTED
+    }
+
+    DenseCholeskyLinearSystemSolver::~DenseCholeskyLinearSystemSolver()
+    {
+    }
+
+    void DenseCholeskyLinearSystemSolver::initMatrixStructureImplementation(const std::vector<DesignVariable*>& /* dvs */, const std::vector<ErrorTerm*>& /* errors */, bool useDiagonalConditioner)
+    {
+      _useDiagonalConditioner = useDiagonalConditioner;
+      _H._M.setZero(_JCols, _JCols);
+      _threadHessians.clear();
+      _threadRhs.clear();
+    }
+
+    void DenseCholeskyLinearSystemSolver::buildSystem(size_t nThreads, bool useMEstimator)
+    {
+      nThreads = std::max<size_t>(1, std::min(nThreads, _errorTerms.size()));
+      _threadHessians.resize(nThreads);
+      _threadRhs.resize(nThreads);
+      for (size_t t = 0; t < nThreads; ++t) {
+        _threadHessians[t].setZero(_JCols, _JCols);
+        _threadRhs[t].setZero(_JCols);
+      }
+      setupThreadedJob(boost::bind(&DenseCholeskyLinearSystemSolver::evaluateHessians, this, _1, _2, _3, _4), nThreads, useMEstimator);
+
+      // Reduce the thread buffers. Only their upper triangles are filled.
+      _H._M = _threadHessians[0];
+      _rhs = _threadRhs[0];
+      for (size_t t = 1; t < nThreads; ++t) {
+        _H._M += _threadHessians[t];
+        _rhs += _threadRhs[t];
+      }
+      _H._M.triangularView<Eigen::StrictlyLower>() = _H._M.transpose();
+    }
+
+    void DenseCholeskyLinearSystemSolver::evaluateHessians(size_t threadId, size_t startIdx, size_t endIdx, bool useMEstimator)
+    {
+      Eigen::MatrixXd& H = _threadHessians[threadId];
+      Eigen::VectorXd& rhs = _threadRhs[threadId];
+      std::vector<std::pair<int, const Eigen::MatrixXd*> > blocks;
+      for (size_t i = startIdx; i < endIdx; ++i) {
+        if (_cancellationToken)
+          _cancellationToken->throwIfCancelled();
+        ErrorTerm* e = _errorTerms[i];
+        JacobianContainerSparse<Eigen::Dynamic> jc(e->dimension());
+        e->getWeightedJacobians(jc, useMEstimator);
+        blocks.clear();
+        for (auto it = jc.begin(); it != jc.end(); ++it)
+          blocks.emplace_back(it->first->columnBase(), &it->second);
+
+        // _e holds the negative weighted error of the last evaluateError()
+        const auto error = _e.segment(e->rowBase(), e->dimension());
+        for (size_t a = 0; a < blocks.size(); ++a) {
+          const int ca = blocks[a].first;
+          const Eigen::MatrixXd& Ja = *blocks[a].second;
+          rhs.segment(ca, Ja.cols()).noalias() += Ja.transpose() * error;
+          H.block(ca, ca, Ja.cols(), Ja.cols()).selfadjointView<Eigen::Upper>().rankUpdate(Ja.transpose());
+          for (size_t b = 0; b < blocks.size(); ++b) {
+            const int cb = blocks[b].first;
+            if (ca < cb) {
+              const Eigen::MatrixXd& Jb = *blocks[b].second;
+              H.block(ca, cb, Ja.cols(), Jb.cols()).noalias() += Ja.transpose() * Jb;
+            }
+          }
+        }
+      }
+    }
+
+    bool DenseCholeskyLinearSystemSolver::solveSystem(Eigen::VectorXd& outDx)
+    {
+      _A = _H._M;
+      if (_useDiagonalConditioner)
+        _A.diagonal() += _diagonalConditioner.cwiseAbs2();
+      _ldlt.compute(_A);
+      if (_ldlt.info() != Eigen::Success)
+        return false;
+      outDx = _ldlt.solve(_rhs);
+      return outDx.allFinite();
+    }
+
+    double DenseCholeskyLinearSystemSolver::rhsJtJrhs()
+    {
+      Eigen::VectorXd JtJrhs;
+      _H.rightMultiply(_rhs, JtJrhs);
+      return _rhs.dot(JtJrhs);
+    }
+
+    LinearSolverStatistics DenseCholeskyLinearSystemSolver::getStatistics() const
+    {
+      LinearSolverStatistics statistics;
+      statistics.hessianMemory = _H._M.size() * sizeof(double);
+      for (const Eigen::MatrixXd& H : _threadHessians)
+        statistics.hessianMemory += H.size() * sizeof(double);
+      for (const Eigen::VectorXd& rhs : _threadRhs)
+        statistics.hessianMemory += rhs.size() * sizeof(double);
+      statistics.memoryInUse = (_A.size() + _ldlt.rows() * _ldlt.cols()) * sizeof(double);
+      statistics.peakMemoryUsage = statistics.memoryInUse;
+      return statistics;
+    }
+
+  } // namespace backend
+} // namespace aslam
@@ -1,6 +1,8 @@
 #include <aslam/backend/DenseQrLinearSystemSolver.hpp>
 #include <aslam/backend/ErrorTerm.hpp>
 #include <Eigen/Dense> // householderQr.solve
+
+#include <cmath>
 #include <sm/PropertyTree.hpp>
 
 namespace aslam {
@@ -35,25 +37,80 @@ namespace aslam {
       _J._M.setZero();
       setupThreadedJob(boost::bind(&DenseQrLinearSystemSolver::evaluateJacobians, this, _1, _2, _3, _4), nThreads, useMEstimator);
       _rhs = _J._M.transpose() * _e;
+      _isFactorized = false;
     }
 
 
+    void DenseQrLinearSystemSolver::factorize()
+    {
+      const int n = _JCols;
+      const int k = std::min<int>(_JRows, _JCols);
+      _qr.compute(_J._M);
+      // The error of the linearization point. Optimizers may evaluate the error at trial points before
+      // asking for another damping of the same system.
+      const Eigen::VectorXd qte = _qr.householderQ().adjoint() * _e;
+      _qte = Eigen::VectorXd::Zero(n);
+      _qte.head(k) = qte.head(k);
+      _isFactorized = true;
+    }
+
     bool DenseQrLinearSystemSolver::solveSystem(Eigen::VectorXd& outDx)
     {
+      if (!_isFactorized)
+        factorize();
+
+      const int n = _JCols;
+      const int k = std::min<int>(_JRows, _JCols);
+      _S.setZero(n, n);
+      _S.topRows(k) = _qr.matrixR().topRows(k).triangularView<Eigen::Upper>();
+      _z = _qte;
+
       if (_useDiagonalConditioner) {
-        // Append the diagonal. Thanks to the ceres developers for this trick.
-        _J._M.conservativeResize(_JRows + _JCols, Eigen::NoChange);
-        _J._M.bottomRows(_JCols) = _diagonalConditioner.asDiagonal();
-        // Append zeros to make the sizes match.
-        _e.conservativeResize(_JRows + _JCols);
-        _e.tail(_JCols) = Eigen::VectorXd::Zero(_JCols);
-      }
-      outDx = _J._M.colPivHouseholderQr().solve(_e);
-      if (_useDiagonalConditioner) {
-        // Remove the diagonal
-        _J._M.conservativeResize(_JRows, Eigen::NoChange);
-        _e.conservativeResize(_JRows);
+        // Rotate the rows of the (permuted) diagonal conditioner into R one after the other
+        // such that [R; D P] = Q' S. Each row only fills in to the right of its diagonal entry.
+        const Eigen::VectorXi& permutation = _qr.colsPermutation().indices();
+        _w.resize(n);
+        for (int j = 0; j < n; ++j) {
+          const double d = _diagonalConditioner[permutation[j]];
+          if (d == 0.0)
+            continue;
+          _w.tail(n - j).setZero();
+          _w[j] = d;
+          double wz = 0.0;
+          for (int l = j; l < n; ++l) {
+            if (_w[l] == 0.0)
+              continue;
+            double c, s;
+            if (std::abs(_S(l, l)) < std::abs(_w[l])) {
+              const double cot = _S(l, l) / _w[l];
+              s = 0.5 / std::sqrt(0.25 + 0.25 * cot * cot);
+              c = s * cot;
+            } else {
+              const double tan = _w[l] / _S(l, l);
+              c = 0.5 / std::sqrt(0.25 + 0.25 * tan * tan);
+              s = c * tan;
+            }
+            _S(l, l) = c * _S(l, l) + s * _w[l];
+            const double z = c * _z[l] + s * wz;
+            wz = -s * _z[l] + c * wz;
+            _z[l] = z;
+            for (int i = l + 1; i < n; ++i) {
+              const double t = c * _S(l, i) + s * _w[i];
+              _w[i] = -s * _S(l, i) + c * _w[i];
+              _S(l, i) = t;
+            }
+          }
+        }
       }
+
+      // Back substitution, zeroing the components beyond the numerical rank as ColPivHouseholderQR::solve() does
+      const double threshold = _qr.threshold() * (n > 0 ? _S.diagonal().cwiseAbs().maxCoeff() : 0.0);
+      int rank = 0;
+      while (rank < n && std::abs(_S(rank, rank)) > threshold)
+        ++rank;
+      _z.tail(n - rank).setZero();
+      _S.topLeftCorner(rank, rank).triangularView<Eigen::Upper>().solveInPlace(_z.head(rank));
+      outDx = _qr.colsPermutation() * _z;
       return true;
     }
 
@@ -92,6 +149,14 @@ namespace aslam {
         _J.rightMultiply(_rhs, Jrhs);
         return Jrhs.squaredNorm();
     }
+
+    LinearSolverStatistics DenseQrLinearSystemSolver::getStatistics() const {
+      LinearSolverStatistics statistics;
+      statistics.jacobianMemory = _J._M.size() * sizeof(double);
+      statistics.memoryInUse = (_qr.rows() * _qr.cols() + _S.size()) * sizeof(double);
+      statistics.peakMemoryUsage = statistics.memoryInUse;
+      return statistics;
+    }
       
       
 
@@ -5,7 +5,8 @@ namespace aslam {
   namespace backend {
 
     DesignVariable::DesignVariable() :
-      _blockIndex(-1), _columnBase(-1), _isMarginalized(false), _isActive(false), _scaling(1.0)
+      _blockIndex(-1), _columnBase(-1), _isMarginalized(false), _isActive(false), _scaling(1.0),
+      _accumulatedUpdateNorm(0.0), _lastUpdateNorm(0.0), _numParameterSets(0)
     {
     }
 
@@ -22,6 +23,9 @@ namespace aslam {
 
       // update the design variable:
       updateImplementation(dp, size);
+
+      _lastUpdateNorm = size > 0 ? Eigen::Map<const Eigen::VectorXd>(dp, size).lpNorm<Eigen::Infinity>() : 0.0;
+      _accumulatedUpdateNorm += _lastUpdateNorm;
     }
 
 
@@ -30,6 +34,9 @@ namespace aslam {
     {
       invalidateCache();
       revertUpdateImplementation();
+      // Moving back is movement as well, the sum never decreases
+      _accumulatedUpdateNorm += _lastUpdateNorm;
+      _lastUpdateNorm = 0.0;
     }
 
     /// \brief what is the number of dimensions of the perturbation variable.
@@ -45,6 +52,7 @@ namespace aslam {
     void DesignVariable::setParameters(const Eigen::MatrixXd& value) {
       invalidateCache();
       setParametersImplementation(value);
+      ++_numParameterSets;
     }
 
     /// \brief Computes the minimal distance in tangent space between the current value of the DV and xHat
@@ -86,6 +86,13 @@ namespace aslam {
     }
 
 
+    void ErrorTerm::addWeightedGradient(JacobianContainer& outGradient, bool useMEstimator, double scale)
+    {
+      Eigen::VectorXd e;
+      getWeightedError(e, useMEstimator);
+      getWeightedJacobians(outGradient.apply(scale * e.transpose()), useMEstimator);
+    }
+
     std::string ErrorTerm::getMEstimatorName()
     {
       return _mEstimatorPolicy->name();
@@ -112,6 +119,11 @@ namespace aslam {
     	_timestamp = t;
     }
 
+    std::size_t ErrorTerm::getMemoryUsage() const
+    {
+      return sizeof(ErrorTerm) + _designVariables.capacity() * sizeof(DesignVariable*);
+    }
+
 
 
     namespace detail {
@@ -0,0 +1,60 @@
+#include <aslam/backend/FillReducingOrdering.hpp>
+
+#include <algorithm>
+#include <sm/assert_macros.hpp>
+
+namespace aslam {
+  namespace backend {
+
+    FillReducingOrdering fillReducingOrderingFromString(const std::string& ordering)
+    {
+      if (ordering == "amd") {
+        return FillReducingOrdering::AMD;
+      } else if (ordering == "colamd") {
+        return FillReducingOrdering::COLAMD;
+      } else if (ordering == "constrained") {
+        return FillReducingOrdering::CONSTRAINED;
+      } else if (ordering == "nesdis") {
+        return FillReducingOrdering::NESDIS;
+      }
+      SM_THROW(std::runtime_error, "Unknown fill-reducing ordering " << ordering << ". Try \"amd\", \"colamd\", \"constrained\" or \"nesdis\".");
+    }
+
+    std::ostream& operator<<(std::ostream& out, const FillReducingOrdering& ordering)
+    {
+      switch (ordering) {
+        case FillReducingOrdering::AMD:
+          out << "amd";
+          break;
+        case FillReducingOrdering::COLAMD:
+          out << "colamd";
+          break;
+        case FillReducingOrdering::CONSTRAINED:
+          out << "constrained";
+          break;
+        case FillReducingOrdering::NESDIS:
+          out << "nesdis";
+          break;
+      }
+      return out;
+    }
+
+    bool computeOrderingConstraints(const std::vector<DesignVariable*>& dvs,
+                                    const std::vector<const DesignVariable*>& orderLast,
+                                    int numLast,
+                                    std::vector<int>& outConstraints)
+    {
+      outConstraints.assign(dvs.size(), 0);
+      bool constrained = false;
+      const int firstLast = static_cast<int>(dvs.size()) - std::max(0, numLast);
+      for (size_t i = 0; i < dvs.size(); ++i) {
+        if ((int)i >= firstLast || std::find(orderLast.begin(), orderLast.end(), dvs[i]) != orderLast.end()) {
+          outConstraints[i] = 1;
+          constrained = true;
+        }
+      }
+      return constrained;
+    }
+
+  } // namespace backend
+} // namespace aslam
@@ -0,0 +1,239 @@
+#include <aslam/backend/JacobianChecker.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/JacobianContainerSparse.hpp>
+#include <aslam/backend/util/ThreadedRangeProcessor.hpp>
+
+#include <sm/assert_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace aslam {
+  namespace backend {
+
+    namespace {
+
+      typedef std::chrono::steady_clock Clock;
+
+      double secondsSince(const Clock::time_point& start)
+      {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+      }
+
+      /// \brief The outcome of checking a single error term
+      struct ErrorTermResult {
+        bool checked = false;
+        JacobianChecker::Offender worst;
+      };
+
+      /// \brief Compare the analytic Jacobians of \p et with central differences and store the worst entry in \p worst.
+      ///        Only the design variables of \p et are perturbed and every perturbation is reverted.
+      void checkErrorTerm(ErrorTerm& et, double stepSize, JacobianChecker::Offender& worst)
+      {
+        const int dim = static_cast<int>(et.dimension());
+        et.evaluateError();
+        JacobianContainerSparse<> analytic(dim);
+        et.evaluateJacobians(analytic);
+
+        worst.typeName = typeid(et).name();
+        worst.relativeError = -1.0;
+        for (size_t i = 0; i < et.numDesignVariables(); ++i) {
+          DesignVariable* dv = et.designVariable(i);
+          if (!dv->isActive())
+            continue;
+          SM_ASSERT_GE(JacobianChecker::Exception, dv->blockIndex(), 0, "Design variable " << i << " of an error term of type " << worst.typeName
+                       << " has no block index. Initialize the problem before checking the Jacobians.");
+          const int n = dv->minimalDimensions();
+
+          Eigen::VectorXd dx = Eigen::VectorXd::Zero(n);
+          Eigen::MatrixXd numerical(dim, n);
+          for (int c = 0; c < n; ++c) {
+            dx[c] = stepSize;
+            dv->update(dx.data(), n);
+            et.evaluateError();
+            const Eigen::VectorXd ePlus = et.vsError();
+            dv->revertUpdate();
+
+            dx[c] = -stepSize;
+            dv->update(dx.data(), n);
+            et.evaluateError();
+            const Eigen::VectorXd eMinus = et.vsError();
+            dv->revertUpdate();
+
+            dx[c] = 0.0;
+            numerical.col(c) = (ePlus - eMinus) / (2.0 * stepSize);
+          }
+
+          // Error terms may skip design variables they do not depend on at the current state.
+          bool hasJacobian = false;
+          for (auto it = analytic.begin(); it != analytic.end() && !hasJacobian; ++it)
+            hasJacobian = it->first == dv;
+          const Eigen::MatrixXd J = hasJacobian ? analytic.Jacobian(dv) : Eigen::MatrixXd::Zero(dim, n);
+          SM_ASSERT_TRUE(JacobianChecker::Exception, J.rows() == dim && J.cols() == n, "The analytic Jacobian of design variable " << i
+                         << " of an error term of type " << worst.typeName << " has size " << J.rows() << "x" << J.cols()
+                         << " but " << dim << "x" << n << " was expected");
+
+          for (int c = 0; c < n; ++c) {
+            for (int r = 0; r < dim; ++r) {
+              const double absoluteError = std::abs(J(r, c) - numerical(r, c));
+              // Non-finite entries always count as the worst possible deviation.
+              const double relativeError = std::isfinite(absoluteError) ? absoluteError / std::max(1.0, std::abs(J(r, c)))
+                                                                        : std::numeric_limits<double>::infinity();
+              if (relativeError > worst.relativeError) {
+                worst.designVariableIndex = i;
+                worst.row = r;
+                worst.col = c;
+                worst.analytic = J(r, c);
+                worst.numerical = numerical(r, c);
+                worst.absoluteError = absoluteError;
+                worst.relativeError = relativeError;
+              }
+            }
+          }
+        }
+        worst.relativeError = std::max(worst.relativeError, 0.0);
+
+        // Leave the error term evaluated at the current state.
+        et.evaluateError();
+      }
+
+      /// \brief Assign every sampled error term to a round such that error terms of one round share no active design variable.
+      std::vector< std::vector<size_t> > scheduleRounds(const std::vector<ErrorTerm*>& errorTerms, const std::vector<size_t>& sample)
+      {
+        std::vector< std::vector<size_t> > rounds;
+        std::unordered_map<const DesignVariable*, size_t> nextFreeRound;
+        for (size_t idx : sample) {
+          const ErrorTerm& et = *errorTerms[idx];
+          size_t first = 0;
+          for (size_t i = 0; i < et.numDesignVariables(); ++i) {
+            const DesignVariable* dv = et.designVariable(i);
+            if (!dv->isActive())
+              continue;
+            auto it = nextFreeRound.find(dv);
+            if (it != nextFreeRound.end())
+              first = std::max(first, it->second);
+          }
+          for (size_t i = 0; i < et.numDesignVariables(); ++i) {
+            const DesignVariable* dv = et.designVariable(i);
+            if (dv->isActive())
+              nextFreeRound[dv] = first + 1;
+          }
+          if (first >= rounds.size())
+            rounds.resize(first + 1);
+          rounds[first].push_back(idx);
+        }
+        return rounds;
+      }
+
+    } // namespace
+
+    std::ostream& operator<<(std::ostream& out, const JacobianCheckerOptions& options)
+    {
+      out << "JacobianCheckerOptions:\n";
+      out << "\tsampleFraction: " << options.sampleFraction << std::endl;
+      out << "\tmaxErrorTerms: " << options.maxErrorTerms << std::endl;
+      out << "\ttimeBudget: " << options.timeBudget << std::endl;
+      out << "\tnumThreads: " << options.numThreads << std::endl;
+      out << "\tstepSize: " << options.stepSize << std::endl;
+      out << "\ttolerance: " << options.tolerance << std::endl;
+      out << "\tnumWorstOffenders: " << options.numWorstOffenders << std::endl;
+      out << "\tseed: " << options.seed << std::endl;
+      return out;
+    }
+
+    JacobianChecker::JacobianChecker() : JacobianChecker(JacobianCheckerOptions())
+    {
+    }
+
+    JacobianChecker::JacobianChecker(const JacobianCheckerOptions& options) : _options(options), _rng(options.seed)
+    {
+    }
+
+    JacobianChecker::Report JacobianChecker::check(const std::vector<ErrorTerm*>& errorTerms)
+    {
+      SM_ASSERT_GT(Exception, _options.numThreads, 0u, "");
+      SM_ASSERT_GT(Exception, _options.stepSize, 0.0, "");
+      SM_ASSERT_GE_LE(Exception, _options.sampleFraction, 0.0, 1.0, "");
+
+      const Clock::time_point start = Clock::now();
+      Report report;
+      report.numErrorTerms = errorTerms.size();
+
+      // Draw the sample
+      size_t numSamples = static_cast<size_t>(std::ceil(_options.sampleFraction * errorTerms.size()));
+      if (_options.maxErrorTerms > 0)
+        numSamples = std::min(numSamples, _options.maxErrorTerms);
+      std::vector<size_t> sample(errorTerms.size());
+      std::iota(sample.begin(), sample.end(), 0);
+      if (numSamples < sample.size()) {
+        std::shuffle(sample.begin(), sample.end(), _rng);
+        sample.resize(numSamples);
+        std::sort(sample.begin(), sample.end());
+      }
+      report.numSampled = sample.size();
+
+      // Check the rounds one after the other, the error terms of one round in parallel
+      std::vector<ErrorTermResult> results(errorTerms.size());
+      std::atomic<bool> timeBudgetExceeded(false);
+      for (const std::vector<size_t>& roundTerms : scheduleRounds(errorTerms, sample)) {
+        if (timeBudgetExceeded)
+          break;
+        util::runThreadedJob([&](size_t /* thread */, size_t begin, size_t end) {
+          for (size_t k = begin; k < end; ++k) {
+            if (timeBudgetExceeded || (_options.timeBudget > 0.0 && secondsSince(start) > _options.timeBudget)) {
+              timeBudgetExceeded = true;
+              return;
+            }
+            ErrorTermResult& result = results[roundTerms[k]];
+            checkErrorTerm(*errorTerms[roundTerms[k]], _options.stepSize, result.worst);
+            result.worst.errorTermIndex = roundTerms[k];
+            result.worst.errorTerm = errorTerms[roundTerms[k]];
+            result.checked = true;
+          }
+        }, roundTerms.size(), std::min(_options.numThreads, roundTerms.size()));
+      }
+
+      // Collect the worst offenders
+      for (const ErrorTermResult& result : results) {
+        if (!result.checked)
+          continue;
+        ++report.numChecked;
+        if (result.worst.relativeError > _options.tolerance)
+          ++report.numFailed;
+        report.worstOffenders.push_back(result.worst);
+      }
+      std::sort(report.worstOffenders.begin(), report.worstOffenders.end(), [](const Offender& a, const Offender& b) {
+        return a.relativeError > b.relativeError;
+      });
+      if (report.worstOffenders.size() > _options.numWorstOffenders)
+        report.worstOffenders.resize(_options.numWorstOffenders);
+
+      report.timeBudgetExceeded = timeBudgetExceeded;
+      report.time = secondsSince(start);
+      return report;
+    }
+
+    std::ostream& operator<<(std::ostream& out, const JacobianChecker::Report& report)
+    {
+      out << "Jacobian check: " << report.numChecked << " of " << report.numSampled << " sampled error terms checked ("
+          << report.numErrorTerms << " total), " << report.numFailed << " failed, " << report.time << " s";
+      if (report.timeBudgetExceeded)
+        out << ", time budget exceeded";
+      out << std::endl;
+      for (const JacobianChecker::Offender& o : report.worstOffenders) {
+        out << "\terror term " << o.errorTermIndex << " (" << o.typeName << "), design variable " << o.designVariableIndex
+            << ", entry (" << o.row << ", " << o.col << "): analytic " << o.analytic << ", numerical " << o.numerical
+            << ", abs. error " << o.absoluteError << ", rel. error " << o.relativeError << std::endl;
+      }
+      return out;
+    }
+
+  } // namespace backend
+} // namespace aslam
@@ -29,6 +29,7 @@ namespace aslam {
       _betaInit   = config.getDouble("betaInit", 2.0); 
       _pInit      = config.getInt("pInit", 3);
       _muInit     = config.getDouble("muInit", 2.0);
+      _numSpeculativeSteps = config.getInt("numSpeculativeSteps", 0);
     }
     
         LevenbergMarquardtTrustRegionPolicy::~LevenbergMarquardtTrustRegionPolicy() {}
@@ -47,9 +48,13 @@ namespace aslam {
         }
         
         // Returns true if the solution was successful
-    bool LevenbergMarquardtTrustRegionPolicy::solveSystemImplementation(double /* J */, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx)
+    bool LevenbergMarquardtTrustRegionPolicy::solveSystemImplementation(double J, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx)
         {
             SM_ASSERT_TRUE(Exception, _solver.get() != NULL, "The solver is null");
+
+            // After a rejected step the state is back at the linearization point
+            if (isFirstIteration() || !previousIterationFailed)
+                _linearizationCost = J;
             
             if (isFirstIteration()) {
                 // This is the first step.
@@ -84,9 +89,54 @@ namespace aslam {
                 }
             }
             
+            if (_numSpeculativeSteps > 1 && canEvaluateSteps())
+                return solveSpeculatively(outDx);
+
             _solver->setConstantConditioner(_lambda);
             return _solver->solveSystem(outDx);
         }
+
+        bool LevenbergMarquardtTrustRegionPolicy::solveSpeculatively(Eigen::VectorXd& outDx)
+        {
+            ++_speculationStatistics.numRounds;
+            double lambda = _lambda, mu = _mu;
+            double lastLambda = _lambda, lastMu = _mu;
+            bool accepted = false;
+            size_t numTried = 0;
+            Eigen::VectorXd dx;
+            // Stops at the first accepted damping, so the proposed step is always the one evaluated last and
+            // the optimizer can reuse its cost.
+            for (size_t k = 0; k < _numSpeculativeSteps && !accepted; ++k) {
+                if (k > 0) {
+                    // The damping this policy would try after the previous step got rejected
+                    mu *= 2;
+                    lambda *= mu;
+                }
+                _solver->setConstantConditioner(lambda);
+                if (!_solver->solveSystem(dx)) {
+                    if (k == 0)
+                        return false;
+                    break;
+                }
+                lastLambda = lambda;
+                lastMu = mu;
+                outDx = dx;
+                ++numTried;
+                ++_speculationStatistics.numEvaluatedSteps;
+                accepted = evaluateStep(dx) <= _linearizationCost;
+            }
+
+            _speculationStatistics.numPaidOff += accepted && numTried > 1;
+            _speculationStatistics.numOtherStepChosen += numTried > 1;
+            _speculationStatistics.numAllRejected += !accepted;
+
+            // Continue from the chosen damping. If all steps got rejected the optimizer rejects this one
+            // as well and the next round starts from the most damped one tried.
+            _lambda = lastLambda;
+            _mu = lastMu;
+            _solver->setConstantConditioner(_lambda);
+            return true;
+        }
         
         /// \brief print the current state to a stream (no newlines).
         std::ostream & LevenbergMarquardtTrustRegionPolicy::printState(std::ostream & out) const
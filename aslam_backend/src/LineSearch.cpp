@@ -400,6 +400,7 @@ LineSearchOptions::LineSearchOptions(const sm::PropertyTree& config)
   nMaxIterWolfe1 = config.getInt("nMaxIterWolfe1", nMaxIterWolfe1);
   nMaxIterWolfe2 = config.getInt("nMaxIterWolfe2", nMaxIterWolfe2);
   nMaxIterZoom = config.getInt("nMaxIterZoom", nMaxIterZoom);
+  numSpeculativeSteps = config.getInt("numSpeculativeSteps", numSpeculativeSteps);
   check();
 }
 
@@ -427,7 +428,8 @@ ostream& operator<<(ostream& out, const aslam::backend::LineSearchOptions& optio
   out << "\tinitialStepLength: " << options.initialStepLength << endl;
   out << "\tnMaxIterWolfe1: " << options.nMaxIterWolfe1 << endl;
   out << "\tnMaxIterWolfe2: " << options.nMaxIterWolfe2 << endl;
-  out << "\tnMaxIterZoom: " << options.nMaxIterZoom;
+  out << "\tnMaxIterZoom: " << options.nMaxIterZoom << endl;
+  out << "\tnumSpeculativeSteps: " << options.numSpeculativeSteps;
   return out;
 }
 
@@ -646,6 +648,56 @@ bool LineSearch::zoom(double minStepSize, double maxStepSize, double error_lo, d
   return true;
 }
 
+double LineSearch::speculateInitialStepLength(const double stepLength) {
+
+  const double error0 = _error;
+  const double derror0 = _derror;
+  const int nLarger = static_cast<int>((_options.numSpeculativeSteps - 1)/2);
+  utils::DesignVariableState dvstate(_costFunction->getDesignVariables());
+
+  double bestStepLength = stepLength;
+  double bestError = numeric_limits<double>::infinity();
+  double previousStepLength = numeric_limits<double>::quiet_NaN();
+  for (std::size_t k = 0; k < _options.numSpeculativeSteps; ++k) {
+
+    // Powers of two around the initial guess, largest first
+    const double s = min(max(ldexp(stepLength, nLarger - static_cast<int>(k)), _options.minStepLength), _options.maxStepLength);
+    if (s == previousStepLength)
+      continue;
+    previousStepLength = s;
+
+    // Always step from the start point to not accumulate the increments
+    dvstate.restore();
+    _stepLength = 0.0;
+    this->applyStateUpdate(s);
+    this->updateError();
+
+    const bool sufficientDecrease = _error <= error0 + _options.c1WolfeCondition*s*derror0;
+    SM_ALL_STREAM_NAMED("optimization.linesearch", setprecision(20) << "LineSearch: speculation -- step length " << s << ", error " << _error <<
+                        (sufficientDecrease ? " (sufficient decrease)" : ""));
+    if (sufficientDecrease || _error < bestError) {
+      bestStepLength = s;
+      bestError = _error;
+    }
+    // The largest step length with sufficient decrease, the smaller ones need not be tried
+    if (sufficientDecrease)
+      break;
+  }
+
+  // The state is still at the last candidate if that is the chosen one
+  if (_stepLength != bestStepLength) {
+    dvstate.restore();
+    _stepLength = 0.0;
+    this->applyStateUpdate(bestStepLength);
+    _error = bestError;
+    _errorOutdated = false;
+  }
+  this->updateErrorDerivative();
+
+  SM_FINE_STREAM_NAMED("optimization.linesearch", setprecision(20) << "LineSearch: speculation -- initial step length " << stepLength << " -> " << bestStepLength);
+  return bestStepLength;
+}
+
 double LineSearch::computeErrorDerivative() const {
   return _gradient*_searchDirection.transpose();
 }
@@ -678,7 +730,15 @@ bool LineSearch::lineSearchWolfe1() {
 
   bool success = false;
   bool terminate = false;
-  Dcsrch dcsrch(stepLength, getError(), getErrorDerivative(), _options.minStepLength,
+  const double error0 = getError();
+  const double derror0 = getErrorDerivative();
+
+  // Move to the best of a few candidates, dcsrch then starts its first stage from there with
+  // error and derivative already known.
+  if (_options.numSpeculativeSteps > 1)
+    stepLength = speculateInitialStepLength(stepLength);
+
+  Dcsrch dcsrch(stepLength, error0, derror0, _options.minStepLength,
                 _options.maxStepLength, _options.c1WolfeCondition, _options.xtol, _options.c2WolfeCondition);
 
   size_t cnt = 0;
@@ -13,13 +13,15 @@ LineSearchTrustRegionPolicy::~LineSearchTrustRegionPolicy() {}
 
 /// \brief called by the optimizer when an optimization is starting
 void LineSearchTrustRegionPolicy::optimizationStartingImplementation(double /* J */) {
-
 }
 
 // Returns true if the solution was successful
-bool LineSearchTrustRegionPolicy::solveSystemImplementation(double /* J */, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx) {
+bool LineSearchTrustRegionPolicy::solveSystemImplementation(double J, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx) {
   bool success = true;
+  const bool speculate = _numSpeculativeSteps > 1 && canEvaluateSteps();
   if(isFirstIteration() || !previousIterationFailed) {
+    // After a rejected step the state is back at the linearization point
+    _linearizationCost = J;
     Timer timeBuild("LsGnTrustRegionPolicy: Build linear system", false);
     _solver->buildSystem(nThreads, true);
     timeBuild.stop();
@@ -31,6 +33,10 @@ bool LineSearchTrustRegionPolicy::solveSystemImplementation(double /* J */, bool
     } else {
       _currentScale = std::min(1.0, _currentScale / _scaleStep);
     }
+    if (success && speculate)
+      solveSpeculatively(1.0, outDx);
+  } else if (speculate) {
+    solveSpeculatively(_scaleStep, outDx);
   } else {
     _currentScale *= _scaleStep;
     outDx*= _scaleStep;
@@ -39,6 +45,31 @@ bool LineSearchTrustRegionPolicy::solveSystemImplementation(double /* J */, bool
   return success;
 }
 
+void LineSearchTrustRegionPolicy::solveSpeculatively(double firstScale, Eigen::VectorXd& outDx) {
+  ++_speculationStatistics.numRounds;
+  const Eigen::VectorXd dx = outDx;
+  double lastScale = firstScale, scale = firstScale;
+  bool accepted = false;
+  size_t numTried = 0;
+  // Stops at the first accepted scale, so the proposed step is always the one
+  // evaluated last and the optimizer can reuse its cost.
+  for (size_t k = 0; k < _numSpeculativeSteps && !accepted; ++k, scale *= _scaleStep) {
+    lastScale = scale;
+    ++numTried;
+    ++_speculationStatistics.numEvaluatedSteps;
+    accepted = evaluateStep(scale * dx) <= _linearizationCost;
+  }
+
+  _speculationStatistics.numPaidOff += accepted && numTried > 1;
+  _speculationStatistics.numOtherStepChosen += numTried > 1;
+  _speculationStatistics.numAllRejected += !accepted;
+
+  // If all steps got rejected the optimizer rejects this one as well and
+  // the next round continues below the smallest scale tried.
+  _currentScale *= lastScale;
+  outDx = lastScale * dx;
+}
+
 /// \brief print the current state to a stream (no newlines).
 std::ostream & LineSearchTrustRegionPolicy::printState(std::ostream & out) const {
   out << "LS (" << _currentScale << ")" << std::endl;
@@ -0,0 +1,536 @@
+#include <aslam/backend/LinearSystemCapture.hpp>
+#include <aslam/backend/ProblemSnapshot.hpp>
+#include <aslam/backend/TrustRegionPolicy.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ErrorTermDs.hpp>
+#include <aslam/backend/JacobianContainerSparse.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace aslam {
+  namespace backend {
+
+    namespace {
+
+      const char kMagic[8] = { 'A', 'S', 'L', 'M', 'L', 'S', 'Y', 'S' };
+      const std::uint32_t kVersion = 1;
+
+      /// \brief Record tags of the capture file
+      enum RecordTag : std::uint32_t {
+        STRUCTURE = 1,
+        SYSTEM = 2,
+        CONDITIONER = 3,
+        SOLUTION = 4
+      };
+
+      double secondsSince(const std::chrono::steady_clock::time_point& start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+
+      /// \brief A plain vector valued design variable
+      class ReplayDesignVariable : public DesignVariable {
+      public:
+        explicit ReplayDesignVariable(int dimension) : _v(Eigen::VectorXd::Zero(dimension)), _p_v(_v) {
+          setActive(true);
+        }
+        ~ReplayDesignVariable() override {}
+
+        const Eigen::VectorXd& value() const { return _v; }
+        void reset() { _v.setZero(); _p_v.setZero(); }
+
+      protected:
+        void revertUpdateImplementation() override { _v = _p_v; }
+        void updateImplementation(const double* dp, int size) override {
+          _p_v = _v;
+          _v += Eigen::Map<const Eigen::VectorXd>(dp, size);
+        }
+        int minimalDimensionsImplementation() const override { return _v.size(); }
+        void getParametersImplementation(Eigen::MatrixXd& value) const override { value = _v; }
+        void setParametersImplementation(const Eigen::MatrixXd& value) override {
+          _p_v = _v;
+          _v = value;
+        }
+
+      private:
+        Eigen::VectorXd _v;
+        Eigen::VectorXd _p_v;
+      };
+
+      /// \brief The recorded linear model of one error term: e(x) = e0 + sum_k J_k x_k
+      class ReplayErrorTerm : public ErrorTermDs {
+      public:
+        ReplayErrorTerm(int dimension, const std::vector<ReplayDesignVariable*>& dvs) :
+          ErrorTermDs(dimension), _dvs(dvs), _e0(nullptr), _J(nullptr) {
+          setDesignVariables(std::vector<DesignVariable*>(dvs.begin(), dvs.end()));
+          setInvR(Eigen::MatrixXd::Identity(dimension, dimension));
+        }
+        ~ReplayErrorTerm() override {}
+
+        void setLinearization(const Eigen::VectorXd* e0, const std::vector<Eigen::MatrixXd>* J) {
+          _e0 = e0;
+          _J = J;
+        }
+
+      protected:
+        double evaluateErrorImplementation() override {
+          Eigen::VectorXd e = *_e0;
+          for (size_t k = 0; k < _dvs.size(); ++k)
+            e.noalias() += (*_J)[k] * _dvs[k]->value();
+          setError(e);
+          return evaluateChiSquaredError();
+        }
+        void evaluateJacobiansImplementation(JacobianContainer& outJ) override {
+          for (size_t k = 0; k < _dvs.size(); ++k)
+            outJ.add(_dvs[k], (*_J)[k]);
+        }
+
+      private:
+        std::vector<ReplayDesignVariable*> _dvs;
+        const Eigen::VectorXd* _e0;
+        const std::vector<Eigen::MatrixXd>* _J;
+      };
+
+    } // namespace
+
+
+    CapturingLinearSystemSolver::CapturingLinearSystemSolver(const boost::shared_ptr<LinearSystemSolver>& solver, const std::string& fileName) :
+      _solver(solver), _out(fileName.c_str(), std::ios::binary | std::ios::trunc), _numCapturedSystems(0)
+    {
+      SM_ASSERT_TRUE(Exception, _solver.get() != NULL, "The solver is null");
+      SM_ASSERT_TRUE(Exception, _out.good(), "Unable to open " << fileName << " for writing");
+      _out.write(kMagic, sizeof(kMagic));
+      snapshot::writeValue(_out, kVersion);
+    }
+
+    CapturingLinearSystemSolver::~CapturingLinearSystemSolver()
+    {
+    }
+
+    void CapturingLinearSystemSolver::initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner)
+    {
+      _solver->initMatrixStructure(dvs, errors, useDiagonalConditioner);
+      _useDiagonalConditioner = useDiagonalConditioner;
+
+      snapshot::writeValue(_out, STRUCTURE);
+      snapshot::writeValue(_out, static_cast<std::uint8_t>(useDiagonalConditioner));
+      snapshot::writeValue(_out, static_cast<std::uint64_t>(dvs.size()));
+      _designVariableIndices.clear();
+      for (size_t i = 0; i < dvs.size(); ++i) {
+        _designVariableIndices[dvs[i]] = i;
+        snapshot::writeValue(_out, static_cast<std::int32_t>(dvs[i]->minimalDimensions()));
+      }
+      snapshot::writeValue(_out, static_cast<std::uint64_t>(errors.size()));
+      _errorTermDesignVariables.assign(errors.size(), std::vector<DesignVariable*>());
+      for (size_t i = 0; i < errors.size(); ++i) {
+        for (DesignVariable* dv : errors[i]->designVariables()) {
+          if (_designVariableIndices.count(dv))
+            _errorTermDesignVariables[i].push_back(dv);
+        }
+        snapshot::writeValue(_out, static_cast<std::int32_t>(errors[i]->dimension()));
+        snapshot::writeValue(_out, static_cast<std::uint32_t>(_errorTermDesignVariables[i].size()));
+        for (DesignVariable* dv : _errorTermDesignVariables[i])
+          snapshot::writeValue(_out, static_cast<std::uint64_t>(_designVariableIndices[dv]));
+      }
+    }
+
+    void CapturingLinearSystemSolver::handleNewAcceptConstantErrorTerms()
+    {
+      _solver->setAcceptConstantErrorTerms(isAcceptConstantErrorTerms());
+    }
+
+    double CapturingLinearSystemSolver::evaluateError(size_t nThreads, bool useMEstimator, callback::Manager * callback)
+    {
+      return _solver->evaluateError(nThreads, useMEstimator, callback);
+    }
+
+    double CapturingLinearSystemSolver::evaluateTrialError(size_t nThreads, bool useMEstimator)
+    {
+      return _solver->evaluateTrialError(nThreads, useMEstimator);
+    }
+
+    void CapturingLinearSystemSolver::acceptTrialError()
+    {
+      _solver->acceptTrialError();
+    }
+
+    void CapturingLinearSystemSolver::buildSystem(size_t nThreads, bool useMEstimator)
+    {
+      _solver->buildSystem(nThreads, useMEstimator);
+
+      snapshot::writeValue(_out, SYSTEM);
+      snapshot::writeValue(_out, static_cast<std::uint8_t>(useMEstimator));
+      Eigen::VectorXd e;
+      for (size_t i = 0; i < _errorTerms.size(); ++i) {
+        ErrorTerm* et = _errorTerms[i];
+        et->getWeightedError(e, useMEstimator);
+        _out.write(reinterpret_cast<const char*>(e.data()), sizeof(double) * e.size());
+
+        JacobianContainerSparse<Eigen::Dynamic> jc(et->dimension());
+        et->getWeightedJacobians(jc, useMEstimator);
+        for (DesignVariable* dv : _errorTermDesignVariables[i]) {
+          // Design variables without a block in the container have a zero Jacobian
+          auto it = std::find_if(jc.begin(), jc.end(), [dv](const JacobianContainerSparse<Eigen::Dynamic>::map_t::value_type& b) { return b.first == dv; });
+          const Eigen::MatrixXd J = it != jc.end() ? it->second : Eigen::MatrixXd::Zero(et->dimension(), dv->minimalDimensions());
+          _out.write(reinterpret_cast<const char*>(J.data()), sizeof(double) * J.size());
+        }
+      }
+      _numCapturedSystems++;
+    }
+
+    void CapturingLinearSystemSolver::setConditioner(const Eigen::VectorXd& diag)
+    {
+      _solver->setConditioner(diag);
+      LinearSystemSolver::setConditioner(diag);
+    }
+
+    void CapturingLinearSystemSolver::setConstantConditioner(double diag)
+    {
+      _solver->setConstantConditioner(diag);
+      LinearSystemSolver::setConstantConditioner(diag);
+    }
+
+    bool CapturingLinearSystemSolver::solveSystem(Eigen::VectorXd& outDx)
+    {
+      snapshot::writeValue(_out, CONDITIONER);
+      snapshot::writeMatrix(_out, _diagonalConditioner);
+
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      const bool success = _solver->solveSystem(outDx);
+      const double time = secondsSince(start);
+
+      snapshot::writeValue(_out, SOLUTION);
+      snapshot::writeValue(_out, static_cast<std::uint8_t>(success));
+      snapshot::writeValue(_out, time);
+      snapshot::writeMatrix(_out, success ? outDx : Eigen::VectorXd());
+      _out.flush();
+      return success;
+    }
+
+
+    class LinearSystemReplay::Implementation {
+    public:
+      struct Structure {
+        bool useDiagonalConditioner = false;
+        std::vector<int> designVariableDimensions;
+        std::vector<int> errorTermDimensions;
+        std::vector< std::vector<size_t> > errorTermDesignVariables;
+      };
+
+      struct Solve {
+        Eigen::VectorXd conditioner;
+        bool success = false;
+        double time = 0.0;
+        Eigen::VectorXd dx;
+      };
+
+      struct System {
+        size_t structure = 0;
+        bool useMEstimator = false;
+        std::vector<Eigen::VectorXd> errors;
+        std::vector< std::vector<Eigen::MatrixXd> > jacobians;
+        std::vector<Solve> solves;
+      };
+
+      /// \brief The replay problem of one structure
+      struct Problem {
+        std::vector< boost::shared_ptr<ReplayDesignVariable> > designVariables;
+        std::vector< boost::shared_ptr<ReplayErrorTerm> > errorTerms;
+        std::vector<DesignVariable*> dvs;
+        std::vector<ErrorTerm*> errors;
+        size_t numColumns = 0;
+      };
+
+      std::vector<Structure> structures;
+      std::vector<System> systems;
+
+      explicit Implementation(const std::string& fileName) {
+        std::ifstream in(fileName.c_str(), std::ios::binary);
+        SM_ASSERT_TRUE(Exception, in.good(), "Unable to open capture " << fileName);
+        char magic[8];
+        in.read(magic, sizeof(magic));
+        SM_ASSERT_TRUE(Exception, in && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0, fileName << " is not a linear system capture");
+        std::uint32_t version = 0;
+        snapshot::readValue(in, version);
+        SM_ASSERT_EQ(Exception, version, kVersion, "Unsupported capture version");
+
+        // A capture cut off in the middle of a record (e.g. of a crashed run) is used up to the last complete record
+        std::uint32_t tag = 0;
+        bool pendingSolution = false;
+        try {
+          while (in.read(reinterpret_cast<char*>(&tag), sizeof(tag))) {
+            switch (tag) {
+              case STRUCTURE:
+                readStructure(in);
+                break;
+              case SYSTEM:
+                readSystem(in);
+                break;
+              case CONDITIONER:
+                SM_ASSERT_FALSE(Exception, systems.empty(), "Corrupt capture");
+                systems.back().solves.push_back(Solve());
+                pendingSolution = true;
+                snapshot::readMatrix(in, systems.back().solves.back().conditioner);
+                break;
+              case SOLUTION: {
+                SM_ASSERT_TRUE(Exception, pendingSolution, "Corrupt capture");
+                Solve& solve = systems.back().solves.back();
+                std::uint8_t success = 0;
+                snapshot::readValue(in, success);
+                solve.success = success;
+                snapshot::readValue(in, solve.time);
+                snapshot::readMatrix(in, solve.dx);
+                pendingSolution = false;
+                break;
+              }
+              default:
+                SM_THROW(Exception, "Unknown record " << tag << " in capture " << fileName);
+            }
+          }
+        } catch (const aslam::Exception&) {
+          if (!in.eof())
+            throw;
+        }
+        if (pendingSolution)
+          systems.back().solves.pop_back();
+        if (!systems.empty() && systems.back().errors.size() != structures[systems.back().structure].errorTermDimensions.size())
+          systems.pop_back();
+      }
+
+      void readStructure(std::istream& in) {
+        Structure s;
+        std::uint8_t useDiagonalConditioner = 0;
+        std::uint64_t numDesignVariables = 0, numErrorTerms = 0;
+        snapshot::readValue(in, useDiagonalConditioner);
+        s.useDiagonalConditioner = useDiagonalConditioner;
+        snapshot::readValue(in, numDesignVariables);
+        s.designVariableDimensions.resize(numDesignVariables);
+        for (int& d : s.designVariableDimensions)
+          snapshot::readValue(in, d);
+        snapshot::readValue(in, numErrorTerms);
+        s.errorTermDimensions.resize(numErrorTerms);
+        s.errorTermDesignVariables.resize(numErrorTerms);
+        for (size_t i = 0; i < numErrorTerms; ++i) {
+          std::uint32_t numDvs = 0;
+          snapshot::readValue(in, s.errorTermDimensions[i]);
+          snapshot::readValue(in, numDvs);
+          s.errorTermDesignVariables[i].resize(numDvs);
+          for (size_t& dv : s.errorTermDesignVariables[i]) {
+            std::uint64_t index = 0;
+            snapshot::readValue(in, index);
+            SM_ASSERT_LT(Exception, index, numDesignVariables, "Corrupt capture");
+            dv = index;
+          }
+        }
+        structures.push_back(s);
+      }
+
+      void readSystem(std::istream& in) {
+        SM_ASSERT_FALSE(Exception, structures.empty(), "Corrupt capture");
+        systems.push_back(System());
+        System& system = systems.back();
+        system.structure = structures.size() - 1;
+        const Structure& s = structures.back();
+        std::uint8_t useMEstimator = 0;
+        snapshot::readValue(in, useMEstimator);
+        system.useMEstimator = useMEstimator;
+        system.errors.reserve(s.errorTermDimensions.size());
+        system.jacobians.reserve(s.errorTermDimensions.size());
+        for (size_t i = 0; i < s.errorTermDimensions.size(); ++i) {
+          const int rows = s.errorTermDimensions[i];
+          Eigen::VectorXd e(rows);
+          if (!in.read(reinterpret_cast<char*>(e.data()), sizeof(double) * rows))
+            return;
+          std::vector<Eigen::MatrixXd> J;
+          for (size_t dv : s.errorTermDesignVariables[i]) {
+            J.push_back(Eigen::MatrixXd(rows, s.designVariableDimensions[dv]));
+            if (!in.read(reinterpret_cast<char*>(J.back().data()), sizeof(double) * J.back().size()))
+              return;
+          }
+          system.errors.push_back(e);
+          system.jacobians.push_back(J);
+        }
+      }
+
+      void buildProblem(const Structure& s, Problem& p) const {
+        p.numColumns = 0;
+        for (size_t i = 0; i < s.designVariableDimensions.size(); ++i) {
+          p.designVariables.push_back(boost::shared_ptr<ReplayDesignVariable>(new ReplayDesignVariable(s.designVariableDimensions[i])));
+          p.designVariables.back()->setBlockIndex(i);
+          p.designVariables.back()->setColumnBase(p.numColumns);
+          p.numColumns += s.designVariableDimensions[i];
+          p.dvs.push_back(p.designVariables.back().get());
+        }
+        size_t rowBase = 0;
+        for (size_t i = 0; i < s.errorTermDimensions.size(); ++i) {
+          std::vector<ReplayDesignVariable*> dvs;
+          for (size_t dv : s.errorTermDesignVariables[i])
+            dvs.push_back(p.designVariables[dv].get());
+          p.errorTerms.push_back(boost::shared_ptr<ReplayErrorTerm>(new ReplayErrorTerm(s.errorTermDimensions[i], dvs)));
+          p.errorTerms.back()->setRowBase(rowBase);
+          rowBase += s.errorTermDimensions[i];
+          p.errors.push_back(p.errorTerms.back().get());
+        }
+      }
+
+      void setLinearization(const System& system, Problem& p) const {
+        for (size_t i = 0; i < p.errorTerms.size(); ++i)
+          p.errorTerms[i]->setLinearization(&system.errors[i], &system.jacobians[i]);
+        for (const boost::shared_ptr<ReplayDesignVariable>& dv : p.designVariables)
+          dv->reset();
+      }
+
+      /// \brief ||(J^T J + D^2) dx + J^T e|| / ||J^T e|| evaluated on the recorded blocks
+      double relativeResidual(const System& system, const Problem& p, const Eigen::VectorXd& conditioner, const Eigen::VectorXd& dx) const {
+        const Structure& s = structures[system.structure];
+        Eigen::VectorXd r = Eigen::VectorXd::Zero(p.numColumns);
+        Eigen::VectorXd g = Eigen::VectorXd::Zero(p.numColumns);
+        if (s.useDiagonalConditioner && conditioner.size() == dx.size())
+          r = conditioner.cwiseProduct(conditioner).cwiseProduct(dx);
+        for (size_t i = 0; i < system.errors.size(); ++i) {
+          const std::vector<size_t>& dvs = s.errorTermDesignVariables[i];
+          Eigen::VectorXd Jdx = Eigen::VectorXd::Zero(system.errors[i].size());
+          for (size_t k = 0; k < dvs.size(); ++k)
+            Jdx.noalias() += system.jacobians[i][k] * dx.segment(p.dvs[dvs[k]]->columnBase(), s.designVariableDimensions[dvs[k]]);
+          for (size_t k = 0; k < dvs.size(); ++k) {
+            const int base = p.dvs[dvs[k]]->columnBase();
+            const int dim = s.designVariableDimensions[dvs[k]];
+            r.segment(base, dim).noalias() += system.jacobians[i][k].transpose() * (Jdx + system.errors[i]);
+            g.segment(base, dim).noalias() += system.jacobians[i][k].transpose() * system.errors[i];
+          }
+        }
+        const double gNorm = g.norm();
+        return gNorm > 0.0 ? r.norm() / gNorm : r.norm();
+      }
+    };
+
+
+    LinearSystemReplay::LinearSystemReplay(const std::string& fileName) :
+      _impl(new Implementation(fileName))
+    {
+    }
+
+    LinearSystemReplay::~LinearSystemReplay()
+    {
+      delete _impl;
+    }
+
+    size_t LinearSystemReplay::numSystems() const
+    {
+      return _impl->systems.size();
+    }
+
+    size_t LinearSystemReplay::numSolves() const
+    {
+      size_t n = 0;
+      for (const Implementation::System& system : _impl->systems)
+        n += system.solves.size();
+      return n;
+    }
+
+    std::vector<LinearSystemReplay::SolveResult> LinearSystemReplay::replay(const boost::shared_ptr<LinearSystemSolver>& solver, size_t nThreads)
+    {
+      SM_ASSERT_TRUE(Exception, solver.get() != NULL, "The solver is null");
+      std::vector<SolveResult> results;
+      Implementation::Problem problem;
+      size_t structure = _impl->structures.size();
+      Eigen::VectorXd dx;
+      for (size_t i = 0; i < _impl->systems.size(); ++i) {
+        const Implementation::System& system = _impl->systems[i];
+        if (system.structure != structure) {
+          structure = system.structure;
+          problem = Implementation::Problem();
+          _impl->buildProblem(_impl->structures[structure], problem);
+          solver->initMatrixStructure(problem.dvs, problem.errors, _impl->structures[structure].useDiagonalConditioner);
+        }
+        _impl->setLinearization(system, problem);
+
+        solver->evaluateError(nThreads, system.useMEstimator);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        solver->buildSystem(nThreads, system.useMEstimator);
+        const double buildTime = secondsSince(start);
+
+        std::vector<Implementation::Solve> solves = system.solves;
+        if (solves.empty())
+          solves.push_back(Implementation::Solve());
+        for (size_t j = 0; j < solves.size(); ++j) {
+          const Implementation::Solve& recorded = solves[j];
+          if (recorded.conditioner.size() == (int)problem.numColumns)
+            solver->setConditioner(recorded.conditioner);
+          SolveResult result;
+          result.system = i;
+          result.buildTime = j == 0 ? buildTime : 0.0;
+          start = std::chrono::steady_clock::now();
+          result.success = solver->solveSystem(dx);
+          result.solveTime = secondsSince(start);
+          if (result.success) {
+            result.relativeResidual = _impl->relativeResidual(system, problem, recorded.conditioner, dx);
+            if (recorded.success && recorded.dx.size() == dx.size()) {
+              const double norm = recorded.dx.norm();
+              result.relativeDifference = (dx - recorded.dx).norm() / (norm > 0.0 ? norm : 1.0);
+            }
+          }
+          results.push_back(result);
+        }
+      }
+      return results;
+    }
+
+    std::vector<LinearSystemReplay::PolicyResult> LinearSystemReplay::replay(TrustRegionPolicy& policy, const boost::shared_ptr<LinearSystemSolver>& solver,
+                                                                             size_t maxIterations, size_t nThreads)
+    {
+      SM_ASSERT_TRUE(Exception, solver.get() != NULL, "The solver is null");
+      policy.setSolver(solver);
+      std::vector<PolicyResult> results;
+      Implementation::Problem problem;
+      size_t structure = _impl->structures.size();
+      Eigen::VectorXd dx;
+      for (size_t i = 0; i < _impl->systems.size(); ++i) {
+        const Implementation::System& system = _impl->systems[i];
+        if (system.structure != structure) {
+          structure = system.structure;
+          problem = Implementation::Problem();
+          _impl->buildProblem(_impl->structures[structure], problem);
+          solver->initMatrixStructure(problem.dvs, problem.errors, policy.requiresAugmentedDiagonal());
+        }
+        _impl->setLinearization(system, problem);
+
+        PolicyResult result;
+        result.system = i;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        double cost = result.initialCost = solver->evaluateError(nThreads, system.useMEstimator);
+        policy.optimizationStarting(cost);
+        bool previousIterationFailed = false;
+        for (; result.numIterations < maxIterations; ++result.numIterations) {
+          if (!policy.solveSystem(cost, previousIterationFailed, nThreads, dx)) {
+            previousIterationFailed = true;
+            result.numFailedIterations++;
+            continue;
+          }
+          size_t base = 0;
+          for (DesignVariable* dv : problem.dvs) {
+            dv->update(&dx[base], dv->minimalDimensions());
+            base += dv->minimalDimensions();
+          }
+          const double newCost = solver->evaluateError(nThreads, system.useMEstimator);
+          if (newCost > cost && policy.revertOnFailure()) {
+            for (DesignVariable* dv : problem.dvs)
+              dv->revertUpdate();
+            solver->evaluateError(nThreads, system.useMEstimator);
+            previousIterationFailed = true;
+            result.numFailedIterations++;
+          } else {
+            cost = newCost;
+            previousIterationFailed = false;
+          }
+        }
+        result.time = secondsSince(start);
+        result.finalCost = cost;
+        results.push_back(result);
+      }
+      return results;
+    }
+
+  } // namespace backend
+} // namespace aslam
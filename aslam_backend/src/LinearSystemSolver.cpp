@@ -4,6 +4,7 @@
 
 #include <aslam/backend/ErrorTerm.hpp>
 #include <aslam/backend/OptimizerCallbackManager.hpp>
+#include <aslam/backend/util/CancellationToken.hpp>
 
 namespace aslam {
   namespace backend {
@@ -20,6 +21,8 @@ namespace aslam {
       SM_ASSERT_LE_DBG(Exception, endIdx, _errorTerms.size(), "Index out of bounds in thread " << threadId);
       Eigen::VectorXd e;
       for (size_t i = startIdx; i < endIdx; ++i) {
+        if (_cancellationToken)
+          _cancellationToken->throwIfCancelled();
         SM_ASSERT_TRUE_DBG(Exception, _errorTerms[i] != NULL, "Null error term " << i);
         _threadLocalErrors[threadId] += _errorTerms[i]->evaluateError();
         _errorTerms[i]->getWeightedError(e, useMEstimator);
@@ -29,6 +32,8 @@ namespace aslam {
 
     void LinearSystemSolver::setupThreadedJob(boost::function<void(size_t, size_t, size_t, bool)> job, size_t nThreads, bool useMEstimator)
     {
+      if (_cancellationToken)
+        _cancellationToken->throwIfCancelled();
       if (nThreads <= 1) {
         job(0, 0, _errorTerms.size(), useMEstimator);
       } else {
@@ -71,6 +76,26 @@ namespace aslam {
       return error;
     }
 
+    double LinearSystemSolver::evaluateTrialError(size_t nThreads, bool useMEstimator)
+    {
+      _trialE.resize(_e.size());
+      _e.swap(_trialE);
+      try {
+        const double error = evaluateError(nThreads, useMEstimator);
+        _e.swap(_trialE);
+        return error;
+      } catch (...) {
+        _e.swap(_trialE);
+        throw;
+      }
+    }
+
+    void LinearSystemSolver::acceptTrialError()
+    {
+      SM_ASSERT_EQ(Exception, _trialE.size(), _e.size(), "There is no trial error to accept");
+      _e.swap(_trialE);
+    }
+
     const Eigen::VectorXd& LinearSystemSolver::e() const
     {
       return _e;
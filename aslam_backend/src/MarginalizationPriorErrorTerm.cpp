@@ -37,6 +37,17 @@ MarginalizationPriorErrorTerm::MarginalizationPriorErrorTerm(const std::vector<a
 
 }
 
+MarginalizationPriorErrorTerm::MarginalizationPriorErrorTerm(const std::vector<aslam::backend::DesignVariable*>& designVariables,
+    const Eigen::VectorXd& d, const Eigen::MatrixXd& R, const std::vector<Eigen::MatrixXd>& designVariableValuesAtMarginalization)
+: aslam::backend::ErrorTermDs(R.rows()), _designVariables(designVariables), _d(d), _R(R), _dimensionDesignVariables(R.cols()),
+  _designVariableValuesAtMarginalization(designVariableValuesAtMarginalization)
+{
+  SM_ASSERT_GT(aslam::InvalidArgumentException, designVariables.size(), 0, "The prior error term doesn't make much sense with zero design variables.");
+  SM_ASSERT_EQ(aslam::InvalidArgumentException, designVariables.size(), designVariableValuesAtMarginalization.size(), "There has to be one value at marginalization per design variable.");
+  setInvR(Eigen::MatrixXd::Identity(R.rows(), R.rows()));
+  setDesignVariables(designVariables);
+}
+
 MarginalizationPriorErrorTerm::~MarginalizationPriorErrorTerm() {
   // TODO Auto-generated destructor stub
 }
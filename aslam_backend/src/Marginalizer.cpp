@@ -11,8 +11,12 @@
 #include <Eigen/QR>
 #include <Eigen/Dense>
 #include <aslam/backend/DenseMatrix.hpp>
+#include <aslam/backend/JacobianContainerSparse.hpp>
+#include <aslam/backend/util/ThreadedRangeProcessor.hpp>
 
 #include <iostream>
+#include <limits>
+#include <unordered_set>
 
 #include <sm/logging.hpp>
 #include <sm/timing/Timer.hpp>
@@ -20,6 +24,96 @@
 namespace aslam {
 namespace backend {
 
+namespace {
+
+/// \brief The normal equations \f$ \mathbf H = \mathbf J^T \mathbf J \f$ and \f$ \mathbf g = -\mathbf J^T \mathbf e \f$
+struct NormalEquations {
+  Eigen::MatrixXd H;
+  Eigen::VectorXd g;
+};
+
+/// \brief Accumulate the normal equations of the error terms startIdx .. endIdx - 1 block by block.
+///        Only the upper triangle of H is filled in. The design variables are expected to have their column bases set.
+void accumulateNormalEquations(const std::vector<aslam::backend::ErrorTerm*>& errorTerms,
+                               const std::unordered_set<aslam::backend::DesignVariable*>& designVariables,
+                               bool useMEstimator, size_t /* threadId */, size_t startIdx, size_t endIdx, NormalEquations& out)
+{
+  Eigen::VectorXd e;
+  for (size_t i = startIdx; i < endIdx; ++i) {
+    aslam::backend::ErrorTerm* et = errorTerms[i];
+    et->evaluateError();
+    et->getWeightedError(e, useMEstimator);
+    JacobianContainerSparse<> jc(et->dimension());
+    et->getWeightedJacobians(jc, useMEstimator);
+    // The container is sorted by block index, hence b is never left of a.
+    for (auto a = jc.begin(); a != jc.end(); ++a) {
+      SM_ASSERT_TRUE(aslam::Exception, designVariables.count(a->first) > 0, "Error term " << i << " depends on an active design variable that is not in the list of input design variables!");
+      const int ca = a->first->columnBase();
+      out.g.segment(ca, a->second.cols()).noalias() -= a->second.transpose() * e;
+      for (auto b = a; b != jc.end(); ++b) {
+        out.H.block(ca, b->first->columnBase(), a->second.cols(), b->second.cols()).noalias() += a->second.transpose() * b->second;
+      }
+    }
+  }
+}
+
+/// \brief The pseudo inverse of the non-negative diagonal \p D of an LDLT decomposition. Returns the numerical rank.
+int pseudoInverse(const Eigen::VectorXd& D, Eigen::VectorXd& outDinv)
+{
+  const double threshold = D.size() == 0 ? 0.0 : D.size() * std::numeric_limits<double>::epsilon() * std::max(D.maxCoeff(), 0.0);
+  int rank = 0;
+  outDinv.resize(D.size());
+  for (int i = 0; i < D.size(); ++i) {
+    if (D[i] > threshold) {
+      outDinv[i] = 1.0 / D[i];
+      ++rank;
+    } else {
+      outDinv[i] = 0.0;
+    }
+  }
+  return rank;
+}
+
+/// \brief Eliminate the first \p dimOfDesignVariablesToRemove parameters from the normal equations by a Schur complement.
+///        Returns \p outR and \p outD with \f$ \mathbf R^T \mathbf R \f$ being the marginal information matrix
+///        and \f$ \mathbf R^T \mathbf d \f$ the marginal right hand side of the remaining parameters.
+void eliminateSchurComplement(const Eigen::MatrixXd& H, const Eigen::VectorXd& g, int dimOfDesignVariablesToRemove, Eigen::MatrixXd& outR, Eigen::VectorXd& outD)
+{
+  const int m = dimOfDesignVariablesToRemove;
+  const int r = H.cols() - m;
+
+  // Hmm = P^T L D L^T P, hence Hrm Hmm^+ Hmr = Y^T D^+ Y with Y = L^{-1} P Hmr.
+  Eigen::LDLT<Eigen::MatrixXd> ldltMM(H.topLeftCorner(m, m));
+  Eigen::MatrixXd Y = ldltMM.transpositionsP() * H.topRightCorner(m, r);
+  ldltMM.matrixL().solveInPlace(Y);
+  Eigen::VectorXd z = ldltMM.transpositionsP() * g.head(m);
+  ldltMM.matrixL().solveInPlace(z);
+  Eigen::VectorXd Dinv;
+  const int rankMM = pseudoInverse(ldltMM.vectorD(), Dinv);
+  if (rankMM < m) {
+    SM_WARN_STREAM("Marginalization: the removed block of the Hessian is rank deficient (rank " << rankMM << " of " << m << ")!");
+  }
+  const Eigen::MatrixXd DinvY = Dinv.asDiagonal() * Y;
+  Eigen::MatrixXd lambda = H.bottomRightCorner(r, r);
+  lambda.noalias() -= Y.transpose() * DinvY;
+  const Eigen::VectorXd b = g.tail(r) - DinvY.transpose() * z;
+
+  // Lambda = P^T L D L^T P = R^T R with R = D^{1/2} L^T P and R^T d = b for d = D^{+1/2} L^{-1} P b.
+  Eigen::LDLT<Eigen::MatrixXd> ldlt(lambda);
+  const int rank = pseudoInverse(ldlt.vectorD(), Dinv);
+  if (rank < r) {
+    SM_WARN_STREAM("Marginalization: the marginal information matrix is rank deficient (rank " << rank << " of " << r << ")!");
+  }
+  const Eigen::VectorXd sqrtD = ldlt.vectorD().cwiseMax(0.0).cwiseSqrt();
+  outR = sqrtD.asDiagonal() * Eigen::MatrixXd(ldlt.matrixU());
+  outR = outR * ldlt.transpositionsP().transpose();
+  outD = ldlt.transpositionsP() * b;
+  ldlt.matrixL().solveInPlace(outD);
+  outD = Dinv.cwiseSqrt().asDiagonal() * outD;
+}
+
+} // namespace
+
 void marginalize(
 			std::vector<aslam::backend::DesignVariable*>& inDesignVariables,
 			std::vector<aslam::backend::ErrorTerm*>& inErrorTerms,
@@ -29,7 +123,8 @@ void marginalize(
 			Eigen::MatrixXd& outCov,
 			std::vector<aslam::backend::DesignVariable*>& outDesignVariablesInRTop,
 			size_t numTopRowsInCov,
-			size_t numThreads)
+			size_t numThreads,
+			MarginalizationMethod method)
 {
       sm::timing::Timer t0("aslam::backend::marginalize");
 		  SM_WARN_STREAM_COND(inDesignVariables.size() == 0, "Zero input design variables in the marginalizer!");
@@ -95,12 +190,45 @@ void marginalize(
 				dim += (*it)->dimension();
 			}
 
+      SM_INFO_STREAM("Marginalization optimization problem initialized with " << inDesignVariables.size() << " design variables and " << inErrorTerms.size() << " error terrms");
+      SM_INFO_STREAM("The Jacobian matrix is " << dim << " x " << columnBase);
+
+      const int dimOfRemainingDesignVariables = columnBase - dimOfDesignVariablesToRemove;
+      Eigen::MatrixXd R_reduced;
+      Eigen::VectorXd d_reduced;
+      if (method == MarginalizationMethod::SchurComplement)
+      {
+        SM_ASSERT_LE(aslam::Exception, numTopRowsInCov, static_cast<size_t>(columnBase), "Cannot extract " << numTopRowsInCov << " rows of the covariance because there are only " << columnBase << " parameters.");
+
+        sm::timing::Timer t1("Build Hessian");
+        numThreads = std::max<size_t>(1, std::min(numThreads, inErrorTerms.size()));
+        std::vector<NormalEquations> threadNormalEquations(numThreads, NormalEquations{Eigen::MatrixXd::Zero(columnBase, columnBase), Eigen::VectorXd::Zero(columnBase)});
+        boost::function<void(size_t, size_t, size_t, NormalEquations&)> job(boost::bind(&accumulateNormalEquations, boost::cref(inErrorTerms), boost::cref(inDvSetHT), useMEstimator, _1, _2, _3, _4));
+        util::runThreadedFunction(job, inErrorTerms.size(), threadNormalEquations);
+        NormalEquations& normalEquations = threadNormalEquations[0];
+        for (size_t i = 1; i < threadNormalEquations.size(); ++i) {
+          normalEquations.H += threadNormalEquations[i].H;
+          normalEquations.g += threadNormalEquations[i].g;
+        }
+        normalEquations.H.triangularView<Eigen::StrictlyLower>() = normalEquations.H.transpose();
+        t1.stop();
+
+        sm::timing::Timer t2("Schur Complement");
+        eliminateSchurComplement(normalEquations.H, normalEquations.g, dimOfDesignVariablesToRemove, R_reduced, d_reduced);
+        t2.stop();
+
+        if(numTopRowsInCov > 0)
+        {
+          sm::timing::Timer myTimer("Covariance computation");
+          Eigen::LDLT<Eigen::MatrixXd> ldlt(normalEquations.H);
+          outCov = ldlt.solve(Eigen::MatrixXd::Identity(columnBase, numTopRowsInCov)).topRows(numTopRowsInCov);
+          myTimer.stop();
+        }
+      } else
+      {
 		  aslam::backend::DenseQrLinearSystemSolver qrSolver;
       qrSolver.initMatrixStructure(inDesignVariables, inErrorTerms, false);
 
-		  SM_INFO_STREAM("Marginalization optimization problem initialized with " << inDesignVariables.size() << " design variables and " << inErrorTerms.size() << " error terrms");
-		  SM_INFO_STREAM("The Jacobian matrix is " << dim << " x " << columnBase);
-
 		  qrSolver.evaluateError(numThreads, useMEstimator);
 		  qrSolver.buildSystem(numThreads, useMEstimator);
 
@@ -112,7 +240,6 @@ void marginalize(
 		  int jrows = jacobian.rows();
 		  int jcols = jacobian.cols();
 
-		  int dimOfRemainingDesignVariables = jcols - dimOfDesignVariablesToRemove;
 		  //int dimOfPriorErrorTerm = jrows;
 
 		  sm::timing::Timer t1("Rank Computation");
@@ -131,8 +258,6 @@ void marginalize(
 		  t1.stop();
 		  //SM_ASSERT_FALSE(aslam::Exception, rankDeficient, "Right now, we don't want the jacobian to be rank deficient - ever...");
 
-		  Eigen::MatrixXd R_reduced;
-		  Eigen::VectorXd d_reduced;
 		  if (jrows < jcols)
 		  {
 			  SM_THROW(aslam::Exception, "underdetermined LSE!");
@@ -144,21 +269,20 @@ void marginalize(
 			  // PTF: Do we know what will happen when the jacobian matrix is rank deficient?
 			  // MB: yes, bad things!
 
-              // do QR decomposition
+              // do QR decomposition, applying the Householder reflections to b instead of forming Q
 			  sm::timing::Timer myTimer("QR Decomposition");
         Eigen::HouseholderQR<Eigen::MatrixXd> qr(jacobian);
-			  Eigen::MatrixXd Q = qr.householderQ();
-			  Eigen::MatrixXd R = qr.matrixQR().triangularView<Eigen::Upper>();
-			  Eigen::VectorXd d = Q.transpose()*b;
+			  Eigen::MatrixXd R = qr.matrixQR().topRows(jcols).triangularView<Eigen::Upper>();
+			  Eigen::VectorXd d = qr.householderQ().transpose()*b;
 			  myTimer.stop();
 
 			  if(numTopRowsInCov > 0)
 			  {
           sm::timing::Timer myTimer("Covariance computation");
-          Eigen::FullPivLU<Eigen::MatrixXd> lu_decomp(R);
-          Eigen::MatrixXd Rinv = lu_decomp.inverse();
-          Eigen::MatrixXd covariance = Rinv * Rinv.transpose();
-          outCov = covariance.block(0, 0, numTopRowsInCov, numTopRowsInCov);
+          // the top rows of R^-1 by triangular solves, the covariance is R^-1 R^-T
+          SM_ASSERT_LE(aslam::Exception, numTopRowsInCov, static_cast<size_t>(jcols), "Cannot extract " << numTopRowsInCov << " rows of the covariance because there are only " << jcols << " parameters.");
+          Eigen::MatrixXd RinvTop = R.transpose().triangularView<Eigen::Lower>().solve(Eigen::MatrixXd::Identity(jcols, numTopRowsInCov)).transpose();
+          outCov = RinvTop * RinvTop.transpose();
           myTimer.stop();
 			  }
 
@@ -178,6 +302,7 @@ void marginalize(
         //d_reduced = d.segment(dimOfDesignVariablesToRemove, numRowsToKeep);
         //dimOfPriorErrorTerm = dimOfRemainingDesignVariables;
 		  }
+      }
 
 		  // now create the new error term
 		  boost::shared_ptr<aslam::backend::MarginalizationPriorErrorTerm> err(new aslam::backend::MarginalizationPriorErrorTerm(remainingDesignVariables, d_reduced, R_reduced));
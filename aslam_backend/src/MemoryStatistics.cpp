@@ -0,0 +1,191 @@
+#include <aslam/backend/MemoryStatistics.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/JacobianContainerSparse.hpp>
+#include <aslam/backend/MatrixStack.hpp>
+#include <aslam/backend/OptimizationProblemBase.hpp>
+
+#include <sm/assert_macros.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <set>
+#include <utility>
+
+namespace aslam {
+  namespace backend {
+
+    void MemoryUsage::set(std::size_t bytes, std::size_t peakBytes)
+    {
+      current = bytes;
+      peak = std::max(peak, std::max(bytes, peakBytes));
+    }
+
+    std::size_t MemoryStatistics::current() const
+    {
+      return errorTerms.current + jacobianContainers.current + jacobian.current + hessian.current + factor.current;
+    }
+
+    std::size_t MemoryStatistics::peak() const
+    {
+      return errorTerms.peak + jacobianContainers.peak + jacobian.peak + hessian.peak + factor.peak;
+    }
+
+    namespace {
+      void printMemoryUsage(std::ostream& out, const std::string& name, std::size_t current, std::size_t peak)
+      {
+        out << std::setw(30) << std::left << name << std::right
+            << "current: " << std::setw(12) << current << " B, peak: " << std::setw(12) << peak << " B" << std::endl;
+      }
+    }
+
+    std::ostream& operator<<(std::ostream& out, const MemoryStatistics& statistics)
+    {
+      out << "Memory usage" << std::endl;
+      out << "-----------" << std::endl;
+      printMemoryUsage(out, "error terms", statistics.errorTerms.current, statistics.errorTerms.peak);
+      printMemoryUsage(out, "jacobian containers", statistics.jacobianContainers.current, statistics.jacobianContainers.peak);
+      printMemoryUsage(out, "jacobian", statistics.jacobian.current, statistics.jacobian.peak);
+      printMemoryUsage(out, "hessian", statistics.hessian.current, statistics.hessian.peak);
+      printMemoryUsage(out, "factor", statistics.factor.current, statistics.factor.peak);
+      printMemoryUsage(out, "total", statistics.current(), statistics.peak());
+      return out;
+    }
+
+    namespace {
+      /// \brief Bytes of a CompressedColumnMatrix with \p cols columns and \p nonZeros entries
+      std::size_t compressedColumnMemoryUsage(std::size_t cols, std::size_t nonZeros)
+      {
+        return nonZeros * (sizeof(double) + sizeof(int)) + (cols + 1) * sizeof(int);
+      }
+    }
+
+    std::size_t MemoryEstimate::sparseCholesky() const
+    {
+      // J^T in compressed columns plus a factor of at least the size of the Hessian
+      return errorTerms + jacobianContainers + compressedColumnMemoryUsage(jacobianRows, jacobianNonZeros)
+          + compressedColumnMemoryUsage(jacobianCols, hessianNonZeros);
+    }
+
+    std::size_t MemoryEstimate::sparseQr() const
+    {
+      // SuiteSparseQR copies the Jacobian before factorizing it
+      return sparseCholesky() + compressedColumnMemoryUsage(jacobianCols, jacobianNonZeros);
+    }
+
+    std::size_t MemoryEstimate::blockCholesky() const
+    {
+      const std::size_t blocks = hessianNonZeros * sizeof(double)
+          + hessianBlocks * (mapNodeMemoryUsage<std::pair<const int, Eigen::MatrixXd*> >() + sizeof(Eigen::MatrixXd));
+      return errorTerms + jacobianContainers + blocks + compressedColumnMemoryUsage(jacobianCols, hessianNonZeros);
+    }
+
+    std::size_t MemoryEstimate::denseCholesky() const
+    {
+      // The Hessian and its LDLT factorization
+      return errorTerms + jacobianContainers + 2 * jacobianCols * jacobianCols * sizeof(double);
+    }
+
+    std::size_t MemoryEstimate::denseQr() const
+    {
+      // The Jacobian and its QR factorization
+      return errorTerms + jacobianContainers + 2 * jacobianRows * jacobianCols * sizeof(double);
+    }
+
+    std::size_t MemoryEstimate::forSolver(const std::string& solverName) const
+    {
+      if (solverName == "sparse_cholesky")
+        return sparseCholesky();
+      if (solverName == "sparse_qr")
+        return sparseQr();
+      if (solverName == "block_cholesky")
+        return blockCholesky();
+      if (solverName == "dense_cholesky")
+        return denseCholesky();
+      if (solverName == "dense_qr")
+        return denseQr();
+      SM_THROW(aslam::Exception, "No memory estimate for the linear system solver " << solverName);
+    }
+
+    std::ostream& operator<<(std::ostream& out, const MemoryEstimate& estimate)
+    {
+      out << "Jacobian: " << estimate.jacobianRows << " x " << estimate.jacobianCols << ", " << estimate.jacobianNonZeros << " non-zeros" << std::endl;
+      out << "Hessian: " << estimate.hessianNonZeros << " non-zeros in " << estimate.hessianBlocks << " blocks" << std::endl;
+      out << "error terms: " << estimate.errorTerms << " B, jacobian containers: " << estimate.jacobianContainers << " B" << std::endl;
+      out << "sparse_cholesky: " << estimate.sparseCholesky() << " B" << std::endl;
+      out << "sparse_qr: " << estimate.sparseQr() << " B" << std::endl;
+      out << "block_cholesky: " << estimate.blockCholesky() << " B" << std::endl;
+      out << "dense_cholesky: " << estimate.denseCholesky() << " B" << std::endl;
+      out << "dense_qr: " << estimate.denseQr() << " B" << std::endl;
+      return out;
+    }
+
+    MemoryEstimate estimateMemoryUsage(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, std::size_t numThreads)
+    {
+      MemoryEstimate estimate;
+      for (const DesignVariable* dv : dvs) {
+        if (dv->isActive())
+          estimate.jacobianCols += dv->minimalDimensions();
+      }
+
+      // The base reserve of the chain rule stack, see JacobianContainer
+      const std::size_t containerBase = 100 * 9 * sizeof(MatrixStack::Scalar) + 100 * sizeof(MatrixStack::Header);
+      std::size_t largestContainer = 0;
+      std::set< std::pair<const DesignVariable*, const DesignVariable*> > hessianBlocks;
+      SharedMemorySet countedMemory;
+      for (const ErrorTerm* e : errors) {
+        const std::size_t rows = e->dimension();
+        estimate.jacobianRows += rows;
+        estimate.errorTerms += e->accountMemoryUsage(countedMemory);
+
+        std::vector<const DesignVariable*> active;
+        std::size_t cols = 0;
+        for (std::size_t i = 0; i < e->numDesignVariables(); ++i) {
+          const DesignVariable* dv = e->designVariable(i);
+          if (dv->isActive() && std::find(active.begin(), active.end(), dv) == active.end()) {
+            active.push_back(dv);
+            cols += dv->minimalDimensions();
+          }
+        }
+        estimate.jacobianNonZeros += rows * cols;
+        largestContainer = std::max(largestContainer, containerBase + rows * cols * sizeof(double)
+            + active.size() * mapNodeMemoryUsage<JacobianContainerSparse<>::map_t::value_type>());
+
+        // Count every pair once, in pointer order: the block indices are not assigned before the solver is initialized
+        for (const DesignVariable* a : active) {
+          for (const DesignVariable* b : active) {
+            if (!std::less<const DesignVariable*>()(b, a) && hessianBlocks.insert(std::make_pair(a, b)).second) {
+              const std::size_t n = a->minimalDimensions();
+              // Diagonal blocks contribute their upper triangle
+              estimate.hessianNonZeros += (a == b) ? n * (n + 1) / 2 : n * b->minimalDimensions();
+            }
+          }
+        }
+      }
+      estimate.hessianBlocks = hessianBlocks.size();
+      estimate.jacobianContainers = std::max<std::size_t>(numThreads, 1) * largestContainer;
+      return estimate;
+    }
+
+    MemoryEstimate estimateMemoryUsage(OptimizationProblemBase& problem, std::size_t numThreads)
+    {
+      std::vector<DesignVariable*> dvs;
+      dvs.reserve(problem.numDesignVariables());
+      for (std::size_t i = 0; i < problem.numDesignVariables(); ++i)
+        dvs.push_back(problem.designVariable(i));
+      std::vector<ErrorTerm*> errors;
+      errors.reserve(problem.numErrorTerms());
+      for (std::size_t i = 0; i < problem.numErrorTerms(); ++i)
+        errors.push_back(problem.errorTerm(i));
+      return estimateMemoryUsage(dvs, errors, numThreads);
+    }
+
+    std::size_t getMemoryUsage(const sparse_block_matrix::SparseBlockMatrix<Eigen::MatrixXd>& M)
+    {
+      return M.nonZeros() * sizeof(double)
+          + M.nonZeroBlocks() * (mapNodeMemoryUsage<std::pair<const int, Eigen::MatrixXd*> >() + sizeof(Eigen::MatrixXd));
+    }
+
+  } // namespace backend
+} // namespace aslam
@@ -1,6 +1,7 @@
 #include <aslam/backend/OptimizationProblem.hpp>
 #include <aslam/backend/DesignVariable.hpp>
 #include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/ProblemSnapshot.hpp>
 #include <sm/boost/null_deleter.hpp>
 #include "../include/aslam/backend/ScalarNonSquaredErrorTerm.hpp"
 
@@ -238,6 +239,21 @@ namespace aslam {
       }
       return c;
     }
+
+    void OptimizationProblem::save(const std::string& fileName) const
+    {
+      ProblemSnapshot::save(*this, fileName);
+    }
+
+    void OptimizationProblem::load(const std::string& fileName)
+    {
+      ProblemSnapshot::load(fileName, *this);
+    }
+
+    void OptimizationProblem::loadParameters(const std::string& fileName)
+    {
+      ProblemSnapshot::loadParameters(fileName, *this);
+    }
   } // namespace backend
 }  // namespace aslam
 
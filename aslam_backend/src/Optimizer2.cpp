@@ -37,6 +37,8 @@ namespace aslam {
 
         void Optimizer2::Status::resetImplementation() {
           srv = SolutionReturnValue();
+          linearSolverStatistics = LinearSolverStatistics();
+          memory = MemoryStatistics();
         }
 
         Optimizer2::Optimizer2(const Options& options) :
@@ -66,6 +68,8 @@ namespace aslam {
 
         Optimizer2::~Optimizer2()
         {
+          if (_trustRegionPolicy)
+            _trustRegionPolicy->setStepEvaluator(TrustRegionPolicy::StepEvaluator());
         }
 
         void Optimizer2::initializeTrustRegionPolicy()
@@ -85,6 +89,8 @@ namespace aslam {
           }
 
           _options.verbose && std::cout << "Using the " << _trustRegionPolicy->name() << " trust region policy\n";
+          // Allows the policy to try steps, e.g. for speculative damping
+          _trustRegionPolicy->setStepEvaluator(boost::bind(&Optimizer2::evaluateTentativeStep, this, _1));
 
         }
 
@@ -111,6 +117,10 @@ namespace aslam {
             // Set up the block matrix structure.
             _solver->initMatrixStructure(getDesignVariables(), problemManager().getErrorTerms(), _trustRegionPolicy->requiresAugmentedDiagonal());
             initMx.stop();
+            _errorTermMemory = 0;
+            SharedMemorySet countedMemory;
+            for (const ErrorTerm* e : problemManager().getErrorTerms())
+              _errorTermMemory += e->accountMemoryUsage(countedMemory);
             _options.verbose && std::cout << "Optimization problem initialized with " << problemManager().numDesignVariables() << " design variables and " << problemManager().getErrorTerms().size() << " error terms\n";
             _options.verbose && std::cout << "The Jacobian matrix is " << problemManager().getTotalDimSquaredErrorTerms() << " x " << problemManager().numOptParameters() << std::endl;
         }
@@ -161,6 +171,20 @@ namespace aslam {
 
             _p_J = -1.0;
 
+            // Let the threaded error loops poll the same cancellation token as the problem manager, only while optimizing.
+            // The token may not outlive this call, e.g. the one of an AsyncOptimizer run.
+            struct SolverCancellationScope {
+                explicit SolverCancellationScope(const boost::shared_ptr<LinearSystemSolver>& solver, const util::CancellationToken* token) : solver(solver) {
+                    if (solver)
+                        solver->setCancellationToken(token);
+                }
+                ~SolverCancellationScope() {
+                    if (solver)
+                        solver->setCancellationToken(nullptr);
+                }
+                boost::shared_ptr<LinearSystemSolver> solver;
+            } solverCancellationScope(_solver, problemManager().getCancellationToken());
+
             // This sets _J
             timeErr.start();
             evaluateError(true);
@@ -190,9 +214,14 @@ namespace aslam {
                      fabs(deltaJ) > _options.convergenceDeltaError) ||
                     linearSolverFailure)) {
 
+                issueCallback<callback::event::ITERATION_START>();
+
                 timeSolve.start();
+                _hasTentativeStep = false;
                 bool solutionSuccess = _trustRegionPolicy->solveSystem(_status.error, previousIterationFailed, _options.numThreadsError, _dx);
                 _status.numJacobianEvaluations++;
+                _status.linearSolverStatistics = _solver->getStatistics();
+                updateMemoryStatistics();
                 SM_ASSERT_EQ(Exception, problemManager().numOptParameters(), size_t(_dx.size()), "_trustRegionPolicy->solveSystem yielded dx with wrong size!");
                 timeSolve.stop();
                 issueCallback<callback::event::LINEAR_SYSTEM_SOLVED>();
@@ -210,7 +239,7 @@ namespace aslam {
                     issueCallback<callback::event::DESIGN_VARIABLES_UPDATED>();
                     // This sets _J
                     timeErr.start();
-                    evaluateError(true);
+                    evaluateErrorAfterStep();
                     timeErr.stop();
                     deltaJ = _p_J - _status.error;
                     // This was a regression.
@@ -240,6 +269,7 @@ namespace aslam {
                     _options.verbose && _trustRegionPolicy->printState(std::cout);
                     _options.verbose && std::cout << std::endl;
                 }
+                issueCallback<callback::event::ITERATION_END>();
             } // if the linear solver failed / else
             srv.JFinal = _status.error = _p_J;
             srv.dXFinal = deltaX;
@@ -273,17 +303,50 @@ namespace aslam {
             }
 
 
-            double Optimizer2::applyStateUpdate()
+            void Optimizer2::applyStateUpdate(const Eigen::VectorXd& dx)
             {
                 // Apply the update to the dense state.
                 int startIdx = 0;
                 for (DesignVariable* d : getDesignVariables()) {
                     const int dbd = d->minimalDimensions();
-                    Eigen::VectorXd dxS = _dx.segment(startIdx, dbd);
+                    Eigen::VectorXd dxS = dx.segment(startIdx, dbd);
                     dxS *= d->scaling();
                     d->update(&dxS[0], dbd);
                     startIdx += dbd;
                 }
+            }
+
+
+            double Optimizer2::evaluateTentativeStep(const Eigen::VectorXd& dx)
+            {
+                applyStateUpdate(dx);
+                const double error = _solver->evaluateTrialError(_options.numThreadsError, true);
+                _status.numErrorEvaluations++;
+                revertLastStateUpdate();
+                _tentativeStep = dx;
+                _tentativeStepCost = error;
+                _hasTentativeStep = true;
+                return error;
+            }
+
+            void Optimizer2::evaluateErrorAfterStep()
+            {
+                // Speculative policies usually propose the step they evaluated last. The error terms and the
+                // solver's trial error vector still hold its errors then.
+                if (!_hasTentativeStep || _tentativeStep.size() != _dx.size() || _tentativeStep != _dx) {
+                    evaluateError(true);
+                    return;
+                }
+                _solver->acceptTrialError();
+                _status.error = _tentativeStepCost;
+                _callbackManager.issueCallback(callback::event::RESIDUALS_UPDATED{0, 0});
+                _callbackManager.issueCallback(callback::event::COST_UPDATED{_status.error, _p_J});
+            }
+
+
+            double Optimizer2::applyStateUpdate()
+            {
+                applyStateUpdate(_dx);
                 // Track the maximum delta
                 // \todo: should this be some other metric?
                 double deltaX = _dx.array().abs().maxCoeff();
@@ -328,6 +391,28 @@ namespace aslam {
                 sm::timing::Timing::print(std::cout);
             }
 
+            void Optimizer2::printMemoryUsage() const
+            {
+                std::cout << _status.memory;
+            }
+
+            MemoryEstimate Optimizer2::estimateMemoryUsage()
+            {
+                boost::shared_ptr<OptimizationProblemBase> problem = problemManager().getProblem();
+                SM_ASSERT_TRUE(Exception, problem, "No optimization problem set");
+                return aslam::backend::estimateMemoryUsage(*problem, _options.numThreadsJacobian);
+            }
+
+            void Optimizer2::updateMemoryStatistics()
+            {
+                const LinearSolverStatistics& statistics = _status.linearSolverStatistics;
+                _status.memory.errorTerms.set(_errorTermMemory);
+                _status.memory.jacobianContainers.set(statistics.jacobianContainerMemory);
+                _status.memory.jacobian.set(statistics.jacobianMemory);
+                _status.memory.hessian.set(statistics.hessianMemory);
+                _status.memory.factor.set(statistics.memoryInUse, statistics.peakMemoryUsage);
+            }
+
 
 
 
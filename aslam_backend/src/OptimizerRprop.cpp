@@ -7,6 +7,8 @@
 #include <sm/PropertyTree.hpp>
 #include <sm/logging.hpp>
 
+#include <cmath>
+
 namespace aslam {
 namespace backend {
 
@@ -23,6 +25,11 @@ OptimizerOptionsRprop::OptimizerOptionsRprop(const sm::PropertyTree& config)
   initialDelta = config.getDouble("initialDelta", initialDelta);
   minDelta = config.getDouble("minDelta", minDelta);
   maxDelta = config.getDouble("maxDelta", maxDelta);
+  miniBatchSize = config.getInt("miniBatchSize", miniBatchSize);
+  miniBatchGrowth = config.getDouble("miniBatchGrowth", miniBatchGrowth);
+  if (config.getBool("miniBatchImportanceSampling", false))
+    miniBatchSampling = MiniBatchSampler::Sampling::IMPORTANCE;
+  miniBatchUniformMixing = config.getDouble("miniBatchUniformMixing", miniBatchUniformMixing);
   check();
 }
 
@@ -33,6 +40,8 @@ void OptimizerOptionsRprop::check() const
   SM_ASSERT_GT( Exception, initialDelta, 0.0, "");
   SM_ASSERT_GT( Exception, minDelta, 0.0, "");
   SM_ASSERT_GT( Exception, maxDelta, minDelta, "");
+  SM_ASSERT_GE( Exception, miniBatchGrowth, 1.0, "");
+  SM_ASSERT_GT_LE( Exception, miniBatchUniformMixing, 0.0, 1.0, "");
   OptimizerOptionsBase::check();
 }
 
@@ -67,7 +76,11 @@ std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptio
   out << "\tmaxDelta: " << options.maxDelta << std::endl;
   out << "\tmethod: " << options.method << std::endl;
   out << "\tuseDenseJacobianContainer: " << (options.useDenseJacobianContainer ? "TRUE" : "FALSE") << std::endl;
-  out << "\thasRegularizer: " << ((options.regularizer != nullptr) ? "TRUE" : "FALSE");
+  out << "\thasRegularizer: " << ((options.regularizer != nullptr) ? "TRUE" : "FALSE") << std::endl;
+  out << "\tminiBatchSize: " << options.miniBatchSize << std::endl;
+  out << "\tminiBatchGrowth: " << options.miniBatchGrowth << std::endl;
+  out << "\tminiBatchSampling: " << (options.miniBatchSampling == MiniBatchSampler::Sampling::IMPORTANCE ? "IMPORTANCE" : "UNIFORM") << std::endl;
+  out << "\tminiBatchUniformMixing: " << options.miniBatchUniformMixing;
   return out;
 }
 
@@ -98,6 +111,25 @@ void OptimizerRprop::resetImplementation() {
   _prev_gradient = ColumnVectorType::Constant(problemManager().numOptParameters(), 0.0);
   _prev_error = std::numeric_limits<double>::max();
   _delta = ColumnVectorType::Constant(problemManager().numOptParameters(), _options.initialDelta);
+  _miniBatchSize = _options.miniBatchSize;
+  _sampler = MiniBatchSampler(_options.miniBatchSampling, _options.miniBatchUniformMixing);
+  _sampler.reset(problemManager().numErrorTerms());
+}
+
+bool OptimizerRprop::computeGradient(RowVectorType& outGradient)
+{
+  const std::size_t batchSize = static_cast<std::size_t>(std::ceil(_miniBatchSize));
+  if (batchSize == 0 || batchSize >= problemManager().numErrorTerms()) {
+    _miniBatchSize = 0.0;
+    problemManager().computeGradient(outGradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer /*useDenseJacobianContainer*/);
+    return false;
+  }
+
+  _sampler.sample(batchSize, _miniBatch);
+  problemManager().computeGradient(outGradient, _miniBatch, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer /*useDenseJacobianContainer*/);
+  _sampler.updateImportance(_miniBatch, problemManager());
+  _miniBatchSize *= _options.miniBatchGrowth;
+  return true;
 }
 
 void OptimizerRprop::optimizeImplementation()
@@ -119,7 +151,7 @@ void OptimizerRprop::optimizeImplementation()
 
     RowVectorType gradient;
     timeGrad.start();
-    problemManager().computeGradient(gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer /*useDenseJacobianContainer*/);
+    const bool isMiniBatch = computeGradient(gradient);
 
     // optionally add regularizer
     if (_options.regularizer) {
@@ -136,7 +168,16 @@ void OptimizerRprop::optimizeImplementation()
     timeStep.start();
     _status.gradientNorm = gradient.norm();
 
-    if (_status.gradientNorm < _options.convergenceGradientNorm) {
+    // A mini-batch gradient is too noisy to decide on convergence, the full gradient has to confirm it
+    auto continueWithFullGradient = [&](const char* criterion) {
+      SM_DEBUG_STREAM_NAMED("optimization", "RPROP: " << criterion << " met with a mini-batch of " << _miniBatch.size() <<
+                            " error terms -> switching to the full gradient");
+      _miniBatchSize = 0.0;
+    };
+
+    if (_status.gradientNorm < _options.convergenceGradientNorm && isMiniBatch) {
+      continueWithFullGradient("convergenceGradientNorm");
+    } else if (_status.gradientNorm < _options.convergenceGradientNorm) {
       _status.convergence = ConvergenceStatus::GRADIENT_NORM;
       SM_DEBUG_STREAM_NAMED("optimization", "RPROP: Current gradient norm " << _status.gradientNorm <<
                             " is smaller than convergenceGradientNorm option -> terminating");
@@ -240,7 +281,9 @@ void OptimizerRprop::optimizeImplementation()
     _callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} );
 
     _status.maxDeltaX = _dx.cwiseAbs().maxCoeff();
-    if (_status.maxDeltaX < _options.convergenceDeltaX) {
+    if (_status.maxDeltaX < _options.convergenceDeltaX && isMiniBatch) {
+      continueWithFullGradient("convergenceDx");
+    } else if (_status.maxDeltaX < _options.convergenceDeltaX) {
       _status.convergence = ConvergenceStatus::DX;
       SM_DEBUG_STREAM_NAMED("optimization", "RPROP: Maximum dx coefficient " << _status.maxDeltaX <<
                             " is smaller than convergenceDx option -> terminating");
@@ -249,7 +292,9 @@ void OptimizerRprop::optimizeImplementation()
 
     if (_options.method == OptimizerOptionsRprop::IRPROP_PLUS) {
       _status.deltaError = problemManager().evaluateError(_options.numThreadsError) - _status.error;
-      if (fabs(_status.deltaError) < _options.convergenceDeltaError) {
+      if (fabs(_status.deltaError) < _options.convergenceDeltaError && isMiniBatch) {
+        continueWithFullGradient("convergenceDObjective");
+      } else if (fabs(_status.deltaError) < _options.convergenceDeltaError) {
         _status.convergence = ConvergenceStatus::DOBJECTIVE;
         SM_DEBUG_STREAM_NAMED("optimization", "RPROP: Change in error " << _status.deltaError <<
                               " is smaller than convergenceDObjective option -> terminating");
@@ -258,6 +303,7 @@ void OptimizerRprop::optimizeImplementation()
     }
 
     SM_FINE_STREAM_NAMED("optimization", _status << std::endl <<
+                         "\tmini-batch: " << (isMiniBatch ? _miniBatch.size() : problemManager().numErrorTerms()) << " error terms" << std::endl <<
                          "\tgradient: " << gradient << std::endl <<
                          "\tdx: " << _dx.transpose() << std::endl <<
                          "\tdelta: " << _delta.transpose());
@@ -0,0 +1,129 @@
+#include <aslam/backend/ParameterArena.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+
+#include <sm/assert_macros.hpp>
+
+#include <algorithm>
+
+namespace aslam {
+  namespace backend {
+
+    ArenaParameters::~ArenaParameters()
+    {
+      if (_arena)
+        _arena->release(this);
+    }
+
+    ParameterArena::ParameterArena()
+    {
+    }
+
+    ParameterArena::ParameterArena(const std::vector<DesignVariable*>& dvs)
+    {
+      assign(dvs);
+    }
+
+    ParameterArena::~ParameterArena()
+    {
+      clear();
+    }
+
+    void ParameterArena::assign(const std::vector<DesignVariable*>& dvs)
+    {
+      clear();
+
+      std::vector<Slot> slots;
+      slots.reserve(dvs.size());
+      for (DesignVariable* dv : dvs) {
+        SM_ASSERT_TRUE(Exception, dv != nullptr, "");
+        ArenaParameters* parameters = dynamic_cast<ArenaParameters*>(dv);
+        SM_ASSERT_TRUE(Exception, parameters != nullptr, "The design variable does not support a ParameterArena");
+        SM_ASSERT_TRUE(Exception, parameters->_arena == nullptr, "The design variable is already held by a ParameterArena");
+        SM_ASSERT_GE(Exception, parameters->numArenaParameters(), 0, "");
+        slots.push_back(Slot{dv, parameters, 0, static_cast<std::size_t>(parameters->numArenaParameters())});
+      }
+      std::stable_sort(slots.begin(), slots.end(), [](const Slot& a, const Slot& b) {
+        if (a.dv->blockIndex() < 0 || b.dv->blockIndex() < 0)
+          return a.dv->blockIndex() >= 0 && b.dv->blockIndex() < 0;
+        return a.dv->blockIndex() < b.dv->blockIndex();
+      });
+      for (std::size_t i = 1; i < slots.size(); ++i) {
+        SM_ASSERT_TRUE(Exception, std::none_of(slots.begin(), slots.begin() + i, [&](const Slot& s) { return s.dv == slots[i].dv; }),
+                       "The design variable appears twice");
+      }
+
+      std::size_t size = 0;
+      for (Slot& slot : slots) {
+        slot.offset = size;
+        size += slot.size;
+      }
+      _values.resize(size);
+      _previousValues.resize(size);
+      _slots.swap(slots);
+      for (std::size_t i = 0; i < _slots.size(); ++i) {
+        Slot& slot = _slots[i];
+        slot.parameters->relocateParameters(_values.data() + slot.offset, _previousValues.data() + slot.offset);
+        slot.parameters->_arena = this;
+        slot.parameters->_arenaSlot = i;
+      }
+    }
+
+    void ParameterArena::clear()
+    {
+      for (Slot& slot : _slots) {
+        if (slot.parameters) {
+          slot.parameters->relocateParameters(nullptr, nullptr);
+          slot.parameters->_arena = nullptr;
+        }
+      }
+      _slots.clear();
+      _values.resize(0);
+      _previousValues.resize(0);
+    }
+
+    DesignVariable* ParameterArena::designVariable(std::size_t i) const
+    {
+      SM_ASSERT_LT(Exception, i, _slots.size(), "");
+      return _slots[i].dv;
+    }
+
+    std::size_t ParameterArena::offset(std::size_t i) const
+    {
+      SM_ASSERT_LT(Exception, i, _slots.size(), "");
+      return _slots[i].offset;
+    }
+
+    std::size_t ParameterArena::numParameters(std::size_t i) const
+    {
+      SM_ASSERT_LT(Exception, i, _slots.size(), "");
+      return _slots[i].size;
+    }
+
+    void ParameterArena::valuesChanged()
+    {
+      for (Slot& slot : _slots) {
+        if (slot.parameters) {
+          slot.parameters->arenaParametersChanged();
+          slot.dv->parametersWrittenExternally();
+        }
+      }
+    }
+
+    void ParameterArena::restore(const Eigen::VectorXd& snapshot)
+    {
+      SM_ASSERT_EQ(Exception, static_cast<std::size_t>(snapshot.size()), size(), "The snapshot was not taken from this arena");
+      _values = snapshot;
+      valuesChanged();
+    }
+
+    void ParameterArena::release(ArenaParameters* parameters)
+    {
+      SM_ASSERT_LT_DBG(Exception, parameters->_arenaSlot, _slots.size(), "");
+      Slot& slot = _slots[parameters->_arenaSlot];
+      SM_ASSERT_TRUE_DBG(Exception, slot.parameters == parameters, "");
+      slot.dv = nullptr;
+      slot.parameters = nullptr;
+    }
+
+  } // namespace backend
+} // namespace aslam
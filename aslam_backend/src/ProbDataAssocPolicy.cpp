@@ -1,31 +1,101 @@
 #include <aslam/backend/ProbDataAssocPolicy.hpp>
+#include <aslam/backend/util/ThreadedRangeProcessor.hpp>
 
+#include <boost/bind.hpp>
+#include <sm/assert_macros.hpp>
+
+#include <algorithm>
 #include <vector>
 
 namespace aslam {
 namespace backend {
 ProbDataAssocPolicy::ProbDataAssocPolicy(ErrorTermGroups error_terms,
-                                         double lambda) {
-  error_terms_ = error_terms;
-  scaling_factor_ = -lambda / 2;
+                                         double lambda,
+                                         std::size_t num_threads)
+    : groups_(error_terms),
+      scaling_factor_(-lambda / 2),
+      num_threads_(num_threads) {
+  SM_ASSERT_TRUE(aslam::InvalidArgumentException, groups_,
+                 "The error term groups must not be null");
+  flattenGroups();
+  init();
+}
+
+ProbDataAssocPolicy::ProbDataAssocPolicy(
+    std::vector<ErrorTermPtr> error_terms,
+    std::vector<std::size_t> group_offsets, double lambda,
+    std::size_t num_threads)
+    : error_terms_(std::move(error_terms)),
+      group_offsets_(std::move(group_offsets)),
+      scaling_factor_(-lambda / 2),
+      num_threads_(num_threads) {
+  init();
+}
+
+void ProbDataAssocPolicy::flattenGroups() {
+  error_terms_.clear();
+  group_offsets_.assign(1, 0);
+  group_offsets_.reserve(groups_->size() + 1);
+  for (const ErrorTermGroup& group : *groups_) {
+    error_terms_.insert(error_terms_.end(), group->begin(), group->end());
+    group_offsets_.push_back(error_terms_.size());
+  }
+}
+
+void ProbDataAssocPolicy::init() {
+  SM_ASSERT_FALSE(aslam::InvalidArgumentException, group_offsets_.empty(),
+                  "The group offsets need at least one entry");
+  SM_ASSERT_EQ(aslam::InvalidArgumentException, group_offsets_.front(), 0u,
+               "The first group must start at 0");
+  SM_ASSERT_EQ(aslam::InvalidArgumentException, group_offsets_.back(),
+               error_terms_.size(),
+               "The last group must end with the last error term");
+  SM_ASSERT_TRUE(aslam::InvalidArgumentException,
+                 std::is_sorted(group_offsets_.begin(), group_offsets_.end()),
+                 "The group offsets must not decrease");
+
+  m_estimators_.resize(error_terms_.size());
+  for (std::size_t i = 0; i < error_terms_.size(); i++) {
+    m_estimators_[i] =
+        error_terms_[i]->getMEstimatorPolicy<FixedWeightMEstimator>();
+    SM_ASSERT_TRUE(aslam::InvalidArgumentException, m_estimators_[i],
+                   "Error term " << i
+                                 << " does not use a FixedWeightMEstimator");
+  }
 }
 
 void ProbDataAssocPolicy::callback() {
-  for (ErrorTermGroup vect : *error_terms_) {
-    bool init_max = false;
+  if (groups_changed_) {
+    if (groups_) {
+      flattenGroups();
+    }
+    init();
+    groups_changed_ = false;
+  }
+  util::runThreadedJob(boost::bind(&ProbDataAssocPolicy::normalizeGroups, this,
+                                   _1, _2, _3),
+                       numGroups(),
+                       std::max<std::size_t>(1, num_threads_));
+}
+
+void ProbDataAssocPolicy::normalizeGroups(std::size_t /* thread_id */,
+                                          std::size_t start_group,
+                                          std::size_t end_group) {
+  std::vector<double> log_weights;
+  for (std::size_t g = start_group; g < end_group; g++) {
+    const std::size_t begin = group_offsets_[g];
+    const std::size_t end = group_offsets_[g + 1];
+    if (begin == end) continue;
+
     double max_log_weight = 0;
-    std::vector<double> log_weights;
-    log_weights.reserve(vect->size());
-    for (ErrorTermPtr error_term : *vect) {
+    log_weights.resize(end - begin);
+    for (std::size_t i = begin; i < end; i++) {
       // Update log_weights
-      double log_weight = scaling_factor_ * (error_term->getRawSquaredError());
-      if (!init_max) {
-        max_log_weight = log_weight;
-        init_max = true;
-      } else if (log_weight > max_log_weight) {
+      double log_weight = scaling_factor_ * error_terms_[i]->getRawSquaredError();
+      if (i == begin || log_weight > max_log_weight) {
         max_log_weight = log_weight;
       }
-      log_weights.push_back(log_weight);
+      log_weights[i - begin] = log_weight;
     }
 
     double log_norm_constant = 0;
@@ -34,11 +104,8 @@ void ProbDataAssocPolicy::callback() {
     }
     log_norm_constant = log(log_norm_constant) + max_log_weight;
 
-    for (std::size_t i = 0; i < vect->size(); i++) {
-      boost::shared_ptr<FixedWeightMEstimator> m_estimator(
-          (*vect)[i]->getMEstimatorPolicy<FixedWeightMEstimator>());
-      assert(m_estimator);
-      m_estimator->setWeight(log_weights[i] - log_norm_constant);
+    for (std::size_t i = begin; i < end; i++) {
+      m_estimators_[i]->setWeight(log_weights[i - begin] - log_norm_constant);
     }
   }
 }
@@ -0,0 +1,144 @@
+#include <aslam/backend/ProblemDecomposition.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/ScalarNonSquaredErrorTerm.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace aslam {
+  namespace backend {
+
+    namespace {
+
+      const size_t kNone = std::numeric_limits<size_t>::max();
+
+      /// \brief Union-find over the active design variables
+      class DisjointSets {
+      public:
+        explicit DisjointSets(size_t n) : _parent(n) { std::iota(_parent.begin(), _parent.end(), 0); }
+
+        size_t find(size_t i) {
+          while (_parent[i] != i) {
+            _parent[i] = _parent[_parent[i]]; // path halving
+            i = _parent[i];
+          }
+          return i;
+        }
+
+        /// \brief The smaller index becomes the root, so a root is the first design variable of its set
+        void join(size_t a, size_t b) {
+          a = find(a);
+          b = find(b);
+          if (a < b)
+            _parent[b] = a;
+          else if (b < a)
+            _parent[a] = b;
+        }
+
+      private:
+        std::vector<size_t> _parent;
+      };
+
+      /// \brief The index of the first active design variable of \p dvs, kNone if there is none. Connects all of them in \p sets.
+      size_t connect(const std::vector<DesignVariable*>& dvs, const std::unordered_map<const DesignVariable*, size_t>& index, DisjointSets& sets)
+      {
+        size_t first = kNone;
+        for (const DesignVariable* dv : dvs) {
+          auto it = index.find(dv);
+          if (it == index.end())
+            continue;
+          if (first == kNone)
+            first = it->second;
+          else
+            sets.join(first, it->second);
+        }
+        return first;
+      }
+
+    } // namespace
+
+    ProblemComponent::ProblemComponent()
+    {
+    }
+
+    ProblemComponent::~ProblemComponent()
+    {
+    }
+
+    void ProblemComponent::getErrorsImplementation(const DesignVariable* dv, std::set<ErrorTerm*>& outErrorSet)
+    {
+      for (ErrorTerm* e : _errorTerms) {
+        const std::vector<DesignVariable*>& dvs = e->designVariables();
+        if (std::find(dvs.begin(), dvs.end(), dv) != dvs.end())
+          outErrorSet.insert(e);
+      }
+    }
+
+    void ProblemComponent::getNonSquaredErrorsImplementation(const DesignVariable* dv, std::set<ScalarNonSquaredErrorTerm*>& outErrorSet)
+    {
+      for (ScalarNonSquaredErrorTerm* e : _nonSquaredErrorTerms) {
+        const std::vector<DesignVariable*>& dvs = e->designVariables();
+        if (std::find(dvs.begin(), dvs.end(), dv) != dvs.end())
+          outErrorSet.insert(e);
+      }
+    }
+
+    std::vector<boost::shared_ptr<ProblemComponent> > findIndependentComponents(OptimizationProblemBase& problem)
+    {
+      std::vector<DesignVariable*> dvs;
+      std::unordered_map<const DesignVariable*, size_t> index;
+      dvs.reserve(problem.numDesignVariables());
+      index.reserve(problem.numDesignVariables());
+      for (size_t i = 0; i < problem.numDesignVariables(); ++i) {
+        DesignVariable* dv = problem.designVariable(i);
+        if (dv->isActive() && index.emplace(dv, dvs.size()).second)
+          dvs.push_back(dv);
+      }
+
+      // Connect the design variables of every error term and remember one of them to find its component later
+      DisjointSets sets(dvs.size());
+      std::vector<size_t> anchorNS(problem.numNonSquaredErrorTerms());
+      for (size_t i = 0; i < anchorNS.size(); ++i)
+        anchorNS[i] = connect(problem.nonSquaredErrorTerm(i)->designVariables(), index, sets);
+      std::vector<size_t> anchorS(problem.numErrorTerms());
+      for (size_t i = 0; i < anchorS.size(); ++i)
+        anchorS[i] = connect(problem.errorTerm(i)->designVariables(), index, sets);
+
+      // Distribute the error terms, components are created in the order of their roots, i.e. their first design variable
+      std::vector<size_t> componentOfRoot(dvs.size(), kNone);
+      std::vector<boost::shared_ptr<ProblemComponent> > components;
+      auto componentOf = [&](size_t anchor) -> ProblemComponent& {
+        const size_t root = sets.find(anchor);
+        if (componentOfRoot[root] == kNone) {
+          componentOfRoot[root] = components.size();
+          components.emplace_back(new ProblemComponent());
+        }
+        return *components[componentOfRoot[root]];
+      };
+      for (size_t i = 0; i < dvs.size(); ++i) {
+        if (sets.find(i) == i)
+          componentOf(i);
+      }
+      for (size_t i = 0; i < anchorNS.size(); ++i) {
+        if (anchorNS[i] != kNone)
+          componentOf(anchorNS[i])._nonSquaredErrorTerms.push_back(problem.nonSquaredErrorTerm(i));
+      }
+      for (size_t i = 0; i < anchorS.size(); ++i) {
+        if (anchorS[i] != kNone)
+          componentOf(anchorS[i])._errorTerms.push_back(problem.errorTerm(i));
+      }
+      for (size_t i = 0; i < dvs.size(); ++i)
+        componentOf(i)._designVariables.push_back(dvs[i]);
+
+      // Design variables without error terms have nothing to optimize
+      components.erase(std::remove_if(components.begin(), components.end(), [](const boost::shared_ptr<ProblemComponent>& c) {
+        return c->errorTerms().empty() && c->nonSquaredErrorTerms().empty();
+      }), components.end());
+      return components;
+    }
+
+  } // namespace backend
+} // namespace aslam
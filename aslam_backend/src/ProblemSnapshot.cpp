@@ -0,0 +1,495 @@
+#include <aslam/backend/ProblemSnapshot.hpp>
+#include <aslam/backend/OptimizationProblem.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/MEstimatorPolicies.hpp>
+#include <aslam/backend/MarginalizationPriorErrorTerm.hpp>
+#include <aslam/backend/OptimizerCallbackManager.hpp>
+
+#include <boost/make_shared.hpp>
+#include <sm/assert_macros.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aslam {
+  namespace backend {
+
+    namespace {
+
+      const char kMagic[8] = { 'A', 'S', 'L', 'M', 'S', 'N', 'A', 'P' };
+      const std::uint32_t kByteOrderMark = 0x01020304;
+      const std::uint64_t kParameterAlignment = 64;
+
+      struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrderMark;
+        std::uint64_t fileSize;
+        std::uint64_t numDesignVariables;
+        std::uint64_t designVariableOffset;
+        std::uint64_t numParameters;
+        std::uint64_t parameterOffset;
+        std::uint64_t numErrorTerms;
+        std::uint64_t errorTermOffset;
+        std::uint64_t numTypes;
+        std::uint64_t typeTableOffset;
+      };
+
+      struct DesignVariableRecord {
+        std::uint32_t type;
+        std::int32_t rows;
+        std::int32_t cols;
+        std::uint8_t active;
+        std::uint8_t marginalized;
+        std::uint16_t reserved;
+        std::uint64_t parameterIndex;
+        double scaling;
+      };
+      static_assert(sizeof(DesignVariableRecord) == 32, "Unexpected padding in DesignVariableRecord");
+
+      /// \brief Tags of the M-estimators stored by the framework
+      enum MEstimatorTag : std::uint32_t {
+        NO_MESTIMATOR = 0,
+        GEMAN_MCCLURE = 1,
+        CAUCHY = 2,
+        FIXED_WEIGHT = 3,
+        HUBER = 4,
+        BLAKE_ZISSERMAN = 5
+      };
+
+      struct ErrorTermType {
+        std::string name;
+        ProblemSnapshot::ErrorTermWriter writer;
+        ProblemSnapshot::ErrorTermReader reader;
+      };
+
+      struct TypeRegistry {
+        std::mutex mutex;
+        std::unordered_map<std::type_index, std::string> designVariableNames;
+        std::unordered_map<std::string, ProblemSnapshot::DesignVariableFactory> designVariableFactories;
+        std::unordered_map<std::type_index, std::string> errorTermNames;
+        std::unordered_map<std::string, ErrorTermType> errorTermTypes;
+
+        TypeRegistry() {
+          ErrorTermType prior;
+          prior.name = "aslam::backend::MarginalizationPriorErrorTerm";
+          prior.writer = [](const ErrorTerm& et, std::ostream& out) {
+            const MarginalizationPriorErrorTerm& e = static_cast<const MarginalizationPriorErrorTerm&>(et);
+            snapshot::writeMatrix(out, e.d());
+            snapshot::writeMatrix(out, e.R());
+            for (const Eigen::MatrixXd& value : e.designVariableValuesAtMarginalization())
+              snapshot::writeMatrix(out, value);
+          };
+          prior.reader = [](std::istream& in, const std::vector<DesignVariable*>& dvs) {
+            Eigen::VectorXd d;
+            Eigen::MatrixXd R;
+            snapshot::readMatrix(in, d);
+            snapshot::readMatrix(in, R);
+            std::vector<Eigen::MatrixXd> values(dvs.size());
+            for (Eigen::MatrixXd& value : values)
+              snapshot::readMatrix(in, value);
+            return boost::shared_ptr<ErrorTerm>(new MarginalizationPriorErrorTerm(dvs, d, R, values));
+          };
+          errorTermNames[std::type_index(typeid(MarginalizationPriorErrorTerm))] = prior.name;
+          errorTermTypes[prior.name] = prior;
+        }
+      };
+
+      TypeRegistry& typeRegistry() {
+        static TypeRegistry registry;
+        return registry;
+      }
+
+      /// \brief Read-only stream buffer on a memory range
+      class MemoryStreamBuffer : public std::streambuf {
+      public:
+        MemoryStreamBuffer(const char* begin, const char* end) {
+          char* b = const_cast<char*>(begin);
+          setg(b, b, const_cast<char*>(end));
+        }
+      protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode /* which */) override {
+          char* target = (dir == std::ios_base::beg ? eback() : dir == std::ios_base::cur ? gptr() : egptr()) + off;
+          if (target < eback() || target > egptr())
+            return pos_type(off_type(-1));
+          setg(eback(), target, egptr());
+          return pos_type(target - eback());
+        }
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+          return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+      };
+
+      /// \brief Read-only memory mapping of a snapshot file
+      class MappedFile {
+      public:
+        explicit MappedFile(const std::string& fileName) : _data(nullptr), _size(0) {
+          const int fd = ::open(fileName.c_str(), O_RDONLY);
+          SM_ASSERT_GE(ProblemSnapshot::Exception, fd, 0, "Unable to open snapshot " << fileName);
+          struct stat st;
+          if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+            ::close(fd);
+            SM_THROW(ProblemSnapshot::Exception, "The file " << fileName << " is not a problem snapshot");
+          }
+          _size = static_cast<std::size_t>(st.st_size);
+          void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+          ::close(fd);
+          SM_ASSERT_TRUE(ProblemSnapshot::Exception, data != MAP_FAILED, "Unable to map snapshot " << fileName);
+          _data = static_cast<const char*>(data);
+        }
+        ~MappedFile() {
+          if (_data)
+            ::munmap(const_cast<char*>(_data), _size);
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return _data; }
+        std::size_t size() const { return _size; }
+      private:
+        const char* _data;
+        std::size_t _size;
+      };
+
+      /// \brief Validated view on the sections of a mapped snapshot
+      struct SnapshotView {
+        FileHeader header;
+        const DesignVariableRecord* designVariables;
+        const double* parameters;
+        std::vector<std::string> typeNames;
+
+        explicit SnapshotView(const MappedFile& file) {
+          std::memcpy(&header, file.data(), sizeof(FileHeader));
+          SM_ASSERT_TRUE(ProblemSnapshot::Exception, std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0, "Not a problem snapshot");
+          SM_ASSERT_EQ(ProblemSnapshot::Exception, header.byteOrderMark, kByteOrderMark, "The snapshot was written on a machine with a different byte order");
+          SM_ASSERT_EQ(ProblemSnapshot::Exception, header.version, ProblemSnapshot::Version, "Unsupported snapshot version");
+          SM_ASSERT_EQ(ProblemSnapshot::Exception, header.fileSize, file.size(), "The snapshot is truncated");
+          SM_ASSERT_LE(ProblemSnapshot::Exception, header.designVariableOffset + header.numDesignVariables * sizeof(DesignVariableRecord), header.fileSize, "Corrupt snapshot");
+          SM_ASSERT_LE(ProblemSnapshot::Exception, header.parameterOffset + header.numParameters * sizeof(double), header.fileSize, "Corrupt snapshot");
+          SM_ASSERT_LE(ProblemSnapshot::Exception, header.typeTableOffset, header.fileSize, "Corrupt snapshot");
+          designVariables = reinterpret_cast<const DesignVariableRecord*>(file.data() + header.designVariableOffset);
+          parameters = reinterpret_cast<const double*>(file.data() + header.parameterOffset);
+
+          MemoryStreamBuffer buffer(file.data() + header.typeTableOffset, file.data() + header.fileSize);
+          std::istream in(&buffer);
+          typeNames.resize(header.numTypes);
+          for (std::string& name : typeNames) {
+            std::uint32_t length = 0;
+            snapshot::readValue(in, length);
+            name.resize(length);
+            in.read(&name[0], length);
+            SM_ASSERT_TRUE(ProblemSnapshot::Exception, static_cast<bool>(in), "Corrupt snapshot type table");
+          }
+          for (std::uint64_t i = 0; i < header.numDesignVariables; ++i) {
+            const DesignVariableRecord& r = designVariables[i];
+            SM_ASSERT_LT(ProblemSnapshot::Exception, r.type, typeNames.size(), "Corrupt snapshot");
+            SM_ASSERT_LE(ProblemSnapshot::Exception, r.parameterIndex + std::uint64_t(r.rows) * r.cols, header.numParameters, "Corrupt snapshot");
+          }
+        }
+
+        Eigen::Map<const Eigen::MatrixXd> parametersOf(std::uint64_t i) const {
+          const DesignVariableRecord& r = designVariables[i];
+          return Eigen::Map<const Eigen::MatrixXd>(parameters + r.parameterIndex, r.rows, r.cols);
+        }
+      };
+
+      void writeMEstimator(const boost::shared_ptr<MEstimator>& mEstimator, std::ostream& out) {
+        std::uint32_t tag = NO_MESTIMATOR;
+        double params[3] = { 0.0, 0.0, 0.0 };
+        const MEstimator* m = mEstimator.get();
+        if (m == nullptr || dynamic_cast<const NoMEstimator*>(m)) {
+          tag = NO_MESTIMATOR;
+        } else if (const GemanMcClureMEstimator* g = dynamic_cast<const GemanMcClureMEstimator*>(m)) {
+          tag = GEMAN_MCCLURE;
+          params[0] = g->_sigma2;
+        } else if (const CauchyMEstimator* c = dynamic_cast<const CauchyMEstimator*>(m)) {
+          tag = CAUCHY;
+          params[0] = c->_sigma2;
+        } else if (const FixedWeightMEstimator* f = dynamic_cast<const FixedWeightMEstimator*>(m)) {
+          tag = FIXED_WEIGHT;
+          params[0] = f->_weight;
+        } else if (const HuberMEstimator* h = dynamic_cast<const HuberMEstimator*>(m)) {
+          tag = HUBER;
+          params[0] = h->_k;
+        } else if (const BlakeZissermanMEstimator* b = dynamic_cast<const BlakeZissermanMEstimator*>(m)) {
+          tag = BLAKE_ZISSERMAN;
+          params[0] = static_cast<double>(b->_df);
+          params[1] = b->_pCut;
+          params[2] = b->_wCut;
+        } else {
+          SM_THROW(ProblemSnapshot::Exception, "The M-estimator " << m->name() << " can not be stored in a snapshot");
+        }
+        snapshot::writeValue(out, tag);
+        out.write(reinterpret_cast<const char*>(params), sizeof(params));
+      }
+
+      boost::shared_ptr<MEstimator> readMEstimator(std::istream& in) {
+        std::uint32_t tag = NO_MESTIMATOR;
+        double params[3];
+        snapshot::readValue(in, tag);
+        snapshot::readValue(in, params);
+        switch (tag) {
+          case NO_MESTIMATOR:
+            return boost::make_shared<NoMEstimator>();
+          case GEMAN_MCCLURE:
+            return boost::make_shared<GemanMcClureMEstimator>(params[0]);
+          case CAUCHY:
+            return boost::make_shared<CauchyMEstimator>(params[0]);
+          case FIXED_WEIGHT:
+            return boost::make_shared<FixedWeightMEstimator>(params[0]);
+          case HUBER:
+            return boost::make_shared<HuberMEstimator>(params[0]);
+          case BLAKE_ZISSERMAN:
+            return boost::make_shared<BlakeZissermanMEstimator>(static_cast<std::size_t>(params[0]), params[1], params[2]);
+        }
+        SM_THROW(ProblemSnapshot::Exception, "Unknown M-estimator in snapshot: " << tag);
+      }
+
+      void padTo(std::ostream& out, std::uint64_t alignment) {
+        const std::uint64_t position = static_cast<std::uint64_t>(out.tellp());
+        static const char zeros[kParameterAlignment] = {};
+        out.write(zeros, (alignment - position % alignment) % alignment);
+      }
+
+    } // namespace
+
+    constexpr std::uint32_t ProblemSnapshot::Version;
+
+    void ProblemSnapshot::registerDesignVariable(std::type_index type, const std::string& name, const DesignVariableFactory& factory)
+    {
+      TypeRegistry& registry = typeRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.designVariableNames[type] = name;
+      registry.designVariableFactories[name] = factory;
+    }
+
+    void ProblemSnapshot::registerErrorTerm(std::type_index type, const std::string& name, const ErrorTermWriter& writer, const ErrorTermReader& reader)
+    {
+      TypeRegistry& registry = typeRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.errorTermNames[type] = name;
+      ErrorTermType& et = registry.errorTermTypes[name];
+      et.name = name;
+      et.writer = writer;
+      et.reader = reader;
+    }
+
+    void ProblemSnapshot::save(const OptimizationProblem& problem, const std::string& fileName)
+    {
+      SM_ASSERT_EQ(Exception, problem.numNonSquaredErrorTerms(), 0u, "Scalar non-squared error terms can not be stored in a snapshot");
+
+      TypeRegistry& registry = typeRegistry();
+      std::unique_lock<std::mutex> lock(registry.mutex);
+
+      std::vector<std::string> typeNames;
+      std::unordered_map<std::string, std::uint32_t> typeIndices;
+      auto typeIndex = [&](const std::string& name) {
+        auto it = typeIndices.find(name);
+        if (it != typeIndices.end())
+          return it->second;
+        typeNames.push_back(name);
+        return typeIndices[name] = static_cast<std::uint32_t>(typeNames.size() - 1);
+      };
+
+      // Design variable records and the contiguous parameter array
+      const size_t numDesignVariables = problem.numDesignVariables();
+      std::vector<DesignVariableRecord> records(numDesignVariables);
+      std::vector<double> parameters;
+      std::unordered_map<const DesignVariable*, std::uint64_t> designVariableIndices;
+      Eigen::MatrixXd value;
+      for (size_t i = 0; i < numDesignVariables; ++i) {
+        const DesignVariable* dv = problem.designVariable(i);
+        auto name = registry.designVariableNames.find(std::type_index(typeid(*dv)));
+        SM_ASSERT_TRUE(Exception, name != registry.designVariableNames.end(), "The design variable type " << typeid(*dv).name() << " is not registered for snapshots");
+        dv->getParameters(value);
+        DesignVariableRecord& r = records[i];
+        r.type = typeIndex(name->second);
+        r.rows = static_cast<std::int32_t>(value.rows());
+        r.cols = static_cast<std::int32_t>(value.cols());
+        r.active = dv->isActive();
+        r.marginalized = dv->isMarginalized();
+        r.reserved = 0;
+        r.parameterIndex = parameters.size();
+        r.scaling = dv->scaling();
+        parameters.insert(parameters.end(), value.data(), value.data() + value.size());
+        designVariableIndices[dv] = i;
+      }
+
+      const std::string tmpFileName = fileName + ".tmp";
+      {
+        std::ofstream out(tmpFileName.c_str(), std::ios::binary | std::ios::trunc);
+        SM_ASSERT_TRUE(Exception, out.good(), "Unable to open " << tmpFileName << " for writing");
+
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = Version;
+        header.byteOrderMark = kByteOrderMark;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        header.numDesignVariables = numDesignVariables;
+        header.designVariableOffset = out.tellp();
+        out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(DesignVariableRecord));
+
+        padTo(out, kParameterAlignment);
+        header.numParameters = parameters.size();
+        header.parameterOffset = out.tellp();
+        out.write(reinterpret_cast<const char*>(parameters.data()), parameters.size() * sizeof(double));
+
+        // Error terms: type, design variable indices, inverse covariance, M-estimator, type specific payload
+        header.numErrorTerms = problem.numErrorTerms();
+        header.errorTermOffset = out.tellp();
+        std::ostringstream payload;
+        for (size_t i = 0; i < problem.numErrorTerms(); ++i) {
+          const ErrorTerm* et = problem.errorTerm(i);
+          auto name = registry.errorTermNames.find(std::type_index(typeid(*et)));
+          SM_ASSERT_TRUE(Exception, name != registry.errorTermNames.end(), "The error term type " << typeid(*et).name() << " is not registered for snapshots");
+          snapshot::writeValue(out, typeIndex(name->second));
+          snapshot::writeValue(out, static_cast<std::uint32_t>(et->numDesignVariables()));
+          for (size_t j = 0; j < et->numDesignVariables(); ++j) {
+            auto index = designVariableIndices.find(et->designVariable(j));
+            SM_ASSERT_TRUE(Exception, index != designVariableIndices.end(), "Error term " << i << " uses a design variable which is not part of the problem");
+            snapshot::writeValue(out, index->second);
+          }
+          snapshot::writeMatrix(out, et->vsInvR());
+          writeMEstimator(et->mEstimatorPolicy(), out);
+
+          payload.str(std::string());
+          registry.errorTermTypes[name->second].writer(*et, payload);
+          const std::string data = payload.str();
+          snapshot::writeValue(out, static_cast<std::uint64_t>(data.size()));
+          out.write(data.data(), data.size());
+        }
+
+        header.numTypes = typeNames.size();
+        header.typeTableOffset = out.tellp();
+        for (const std::string& name : typeNames) {
+          snapshot::writeValue(out, static_cast<std::uint32_t>(name.size()));
+          out.write(name.data(), name.size());
+        }
+        header.fileSize = out.tellp();
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        SM_ASSERT_FALSE(Exception, out.fail(), "Error writing snapshot " << tmpFileName);
+      }
+      lock.unlock();
+
+      SM_ASSERT_EQ(Exception, std::rename(tmpFileName.c_str(), fileName.c_str()), 0, "Unable to move " << tmpFileName << " to " << fileName);
+    }
+
+    void ProblemSnapshot::load(const std::string& fileName, OptimizationProblem& problem)
+    {
+      MappedFile file(fileName);
+      SnapshotView view(file);
+
+      TypeRegistry& registry = typeRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+
+      std::vector<boost::shared_ptr<DesignVariable> > designVariables(view.header.numDesignVariables);
+      for (std::uint64_t i = 0; i < view.header.numDesignVariables; ++i) {
+        const DesignVariableRecord& r = view.designVariables[i];
+        const std::string& name = view.typeNames[r.type];
+        auto factory = registry.designVariableFactories.find(name);
+        SM_ASSERT_TRUE(Exception, factory != registry.designVariableFactories.end(), "The design variable type " << name << " is not registered for snapshots");
+        designVariables[i] = factory->second(view.parametersOf(i));
+      }
+
+      std::vector<boost::shared_ptr<ErrorTerm> > errorTerms(view.header.numErrorTerms);
+      MemoryStreamBuffer buffer(file.data() + view.header.errorTermOffset, file.data() + view.header.typeTableOffset);
+      std::istream in(&buffer);
+      std::vector<DesignVariable*> dvs;
+      Eigen::MatrixXd invR;
+      for (std::uint64_t i = 0; i < view.header.numErrorTerms; ++i) {
+        std::uint32_t type = 0, numDesignVariables = 0;
+        snapshot::readValue(in, type);
+        SM_ASSERT_LT(Exception, type, view.typeNames.size(), "Corrupt snapshot");
+        auto et = registry.errorTermTypes.find(view.typeNames[type]);
+        SM_ASSERT_TRUE(Exception, et != registry.errorTermTypes.end(), "The error term type " << view.typeNames[type] << " is not registered for snapshots");
+
+        snapshot::readValue(in, numDesignVariables);
+        dvs.resize(numDesignVariables);
+        for (DesignVariable*& dv : dvs) {
+          std::uint64_t index = 0;
+          snapshot::readValue(in, index);
+          SM_ASSERT_LT(Exception, index, designVariables.size(), "Corrupt snapshot");
+          dv = designVariables[index].get();
+        }
+        snapshot::readMatrix(in, invR);
+        boost::shared_ptr<MEstimator> mEstimator = readMEstimator(in);
+
+        std::uint64_t payloadSize = 0;
+        snapshot::readValue(in, payloadSize);
+        const std::streamoff payloadBegin = in.tellg();
+        SM_ASSERT_LE(Exception, view.header.errorTermOffset + payloadBegin + payloadSize, view.header.typeTableOffset, "Corrupt snapshot");
+        const char* payload = file.data() + view.header.errorTermOffset + payloadBegin;
+        MemoryStreamBuffer payloadBuffer(payload, payload + payloadSize);
+        std::istream payloadStream(&payloadBuffer);
+        errorTerms[i] = et->second.reader(payloadStream, dvs);
+        SM_ASSERT_TRUE(Exception, errorTerms[i].get() != nullptr, "The reader of " << et->first << " returned no error term");
+        errorTerms[i]->vsSetInvR(invR);
+        errorTerms[i]->setMEstimatorPolicy(mEstimator);
+        in.seekg(payloadSize, std::ios::cur);
+      }
+
+      // Error term constructors tend to activate their design variables, restore the flags afterwards
+      for (std::uint64_t i = 0; i < view.header.numDesignVariables; ++i) {
+        const DesignVariableRecord& r = view.designVariables[i];
+        designVariables[i]->setActive(r.active);
+        designVariables[i]->setMarginalized(r.marginalized);
+        designVariables[i]->setScaling(r.scaling);
+      }
+
+      problem.clear();
+      for (const boost::shared_ptr<DesignVariable>& dv : designVariables)
+        problem.addDesignVariable(dv);
+      for (const boost::shared_ptr<ErrorTerm>& et : errorTerms)
+        problem.addErrorTerm(et);
+    }
+
+    void ProblemSnapshot::loadParameters(const std::string& fileName, OptimizationProblem& problem)
+    {
+      MappedFile file(fileName);
+      SnapshotView view(file);
+      SM_ASSERT_EQ(Exception, view.header.numDesignVariables, problem.numDesignVariables(), "The snapshot does not match the structure of the problem");
+
+      for (std::uint64_t i = 0; i < view.header.numDesignVariables; ++i) {
+        const DesignVariableRecord& r = view.designVariables[i];
+        DesignVariable* dv = problem.designVariable(i);
+        const Eigen::MatrixXd value = view.parametersOf(i);
+        SM_ASSERT_EQ(Exception, dv->getParameters().size(), value.size(), "Design variable " << i << " does not match the snapshot");
+        dv->setParameters(value);
+        dv->setActive(r.active);
+        dv->setMarginalized(r.marginalized);
+        dv->setScaling(r.scaling);
+      }
+    }
+
+    callback::OptimizerCallback ProblemSnapshot::addCheckpointCallback(callback::Registry& registry,
+                                                                        const OptimizationProblem& problem,
+                                                                        const std::string& fileName,
+                                                                        std::size_t everyNIterations)
+    {
+      SM_ASSERT_GT(Exception, everyNIterations, 0u, "The checkpoint interval has to be positive");
+      boost::shared_ptr<std::size_t> iterations = boost::make_shared<std::size_t>(0);
+      const OptimizationProblem* p = &problem;
+      return registry.add({typeid(callback::event::ITERATION_END)}, [=]() {
+        if (++(*iterations) % everyNIterations == 0)
+          save(*p, fileName);
+      });
+    }
+
+  } // namespace backend
+} // namespace aslam
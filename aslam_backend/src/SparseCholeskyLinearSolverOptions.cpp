@@ -18,6 +18,8 @@
 
 #include "aslam/backend/SparseCholeskyLinearSolverOptions.h"
 
+#include <cholmod.h>
+
 namespace aslam {
   namespace backend {
 
@@ -25,16 +27,55 @@ namespace aslam {
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-      SparseCholeskyLinearSolverOptions::SparseCholeskyLinearSolverOptions() {}
+    SparseCholeskyLinearSolverOptions::SparseCholeskyLinearSolverOptions() :
+        ordering(FillReducingOrdering::AMD),
+        numOrderLast(0),
+        supernodal(CHOLMOD_AUTO),
+        supernodalSwitch(40.0),
+        numBlasThreads(0),
+        mixedPrecision(false),
+        maxRefinementIterations(10),
+        refinementTolerance(1e-10),
+        relinearizationThreshold(-1.0),
+        incremental(false),
+        incrementalLinearizationThreshold(1e-2),
+        incrementalMaxFillGrowth(0.5) {
+    }
       
     SparseCholeskyLinearSolverOptions::SparseCholeskyLinearSolverOptions(
-        const SparseCholeskyLinearSolverOptions& /* other */) {
+        const SparseCholeskyLinearSolverOptions& other) :
+        ordering(other.ordering),
+        orderLast(other.orderLast),
+        numOrderLast(other.numOrderLast),
+        supernodal(other.supernodal),
+        supernodalSwitch(other.supernodalSwitch),
+        numBlasThreads(other.numBlasThreads),
+        mixedPrecision(other.mixedPrecision),
+        maxRefinementIterations(other.maxRefinementIterations),
+        refinementTolerance(other.refinementTolerance),
+        relinearizationThreshold(other.relinearizationThreshold),
+        incremental(other.incremental),
+        incrementalLinearizationThreshold(other.incrementalLinearizationThreshold),
+        incrementalMaxFillGrowth(other.incrementalMaxFillGrowth) {
     }
 
     SparseCholeskyLinearSolverOptions&
     SparseCholeskyLinearSolverOptions::operator =
         (const SparseCholeskyLinearSolverOptions& other) {
       if (this != &other) {
+        ordering = other.ordering;
+        orderLast = other.orderLast;
+        numOrderLast = other.numOrderLast;
+        supernodal = other.supernodal;
+        supernodalSwitch = other.supernodalSwitch;
+        numBlasThreads = other.numBlasThreads;
+        mixedPrecision = other.mixedPrecision;
+        maxRefinementIterations = other.maxRefinementIterations;
+        refinementTolerance = other.refinementTolerance;
+        relinearizationThreshold = other.relinearizationThreshold;
+        incremental = other.incremental;
+        incrementalLinearizationThreshold = other.incrementalLinearizationThreshold;
+        incrementalMaxFillGrowth = other.incrementalMaxFillGrowth;
       }
       return *this;
     }
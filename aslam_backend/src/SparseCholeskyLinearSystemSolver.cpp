@@ -1,30 +1,76 @@
 #include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/DesignVariable.hpp>
 #include <sm/PropertyTree.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace aslam {
   namespace backend {
-    SparseCholeskyLinearSystemSolver::SparseCholeskyLinearSystemSolver(const SparseCholeskyLinearSolverOptions& options) : _factor(NULL), _options(options) {}
-  SparseCholeskyLinearSystemSolver::SparseCholeskyLinearSystemSolver(const sm::PropertyTree& /* config */) :
-        _factor(NULL) {
-      // NO OPTIONS CURRENTLY IMPLEMENTED
+    SparseCholeskyLinearSystemSolver::SparseCholeskyLinearSystemSolver(const SparseCholeskyLinearSolverOptions& options) : _factor(NULL), _singleFactor(NULL), _options(options) {}
+  SparseCholeskyLinearSystemSolver::SparseCholeskyLinearSystemSolver(const sm::PropertyTree& config) :
+        _factor(NULL), _singleFactor(NULL) {
+      SparseCholeskyLinearSolverOptions options;
+      options.ordering = fillReducingOrderingFromString(config.getString("ordering", "amd"));
+      options.numOrderLast = config.getInt("numOrderLast", options.numOrderLast);
+      const std::string factorization = config.getString("factorization", "auto");
+      if (factorization == "simplicial") {
+        options.supernodal = CHOLMOD_SIMPLICIAL;
+      } else if (factorization == "supernodal") {
+        options.supernodal = CHOLMOD_SUPERNODAL;
+      } else if (factorization != "auto") {
+        std::cout << "Unknown factorization type " << factorization << ". Try \"simplicial\", \"supernodal\" or \"auto\"\nDefaulting to auto.\n";
+      }
+      options.supernodalSwitch = config.getDouble("supernodalSwitch", options.supernodalSwitch);
+      options.numBlasThreads = config.getInt("numBlasThreads", options.numBlasThreads);
+      options.mixedPrecision = config.getBool("mixedPrecision", options.mixedPrecision);
+      options.maxRefinementIterations = config.getInt("maxRefinementIterations", options.maxRefinementIterations);
+      options.refinementTolerance = config.getDouble("refinementTolerance", options.refinementTolerance);
+      options.incremental = config.getBool("incremental", options.incremental);
+      options.incrementalLinearizationThreshold = config.getDouble("incrementalLinearizationThreshold", options.incrementalLinearizationThreshold);
+      options.incrementalMaxFillGrowth = config.getDouble("incrementalMaxFillGrowth", options.incrementalMaxFillGrowth);
+      _options = options;
       // USING C++11 would allow to do constructor delegation and more elegant code
     }
     SparseCholeskyLinearSystemSolver::~SparseCholeskyLinearSystemSolver() {
+      freeFactors();
+    }
+
+    void SparseCholeskyLinearSystemSolver::freeFactors()
+    {
       if (_factor) {
         _cholmod.free(_factor);
+        _factor = NULL;
+      }
+      if (_singleFactor) {
+        _cholmod.free(_singleFactor);
+        _singleFactor = NULL;
       }
     }
 
     void SparseCholeskyLinearSystemSolver::initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner)
     {
       _errorTerms = errors;
-      if (_factor) {
-        _cholmod.free(_factor);
-        _factor = NULL;
+      // The factors are kept, the next solve reuses their analysis if the pattern did not change
+      _checkAnalysis = true;
+      _mixedPrecisionStatistics = MixedPrecisionStatistics();
+      if (_options.mixedPrecision && !Cholmod<>::supportsSinglePrecision()) {
+        std::cout << "Single precision factorization needs CHOLMOD 5 or later. Factorizing in double precision\n";
       }
       // std::cout << "init structure\n";
       _useDiagonalConditioner = useDiagonalConditioner;
-      _jacobianBuilder.initMatrixStructure(dvs, errors);
+      // In incremental mode appended error terms keep the Jacobians of the existing ones
+      _jacobianBuilder.initMatrixStructure(dvs, errors, _options.incremental);
+      _dvs = dvs;
+      // In incremental mode the factor survives if the error terms were only appended to
+      if (_factorState.isValid) {
+        bool isAppended = _options.incremental && dvs == _factorState.dvs && useDiagonalConditioner == _factorState.useDiagonalConditioner &&
+            errors.size() >= _factorState.errorTerms.size() && std::equal(_factorState.errorTerms.begin(), _factorState.errorTerms.end(), errors.begin());
+        for (size_t i = 0; isAppended && i < dvs.size(); ++i) {
+          isAppended = dvs[i]->columnBase() == _factorState.columnBases[i];
+        }
+        _factorState.isValid = isAppended;
+      }
       CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
       if (_useDiagonalConditioner) {
         J_transpose.pushConstantDiagonalBlock(1.0);
@@ -40,9 +86,24 @@ namespace aslam {
     }
 
 
+    void SparseCholeskyLinearSystemSolver::setOrdering(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& /* errors */)
+    {
+      _orderingConstraints.clear();
+      if (_options.ordering != FillReducingOrdering::CONSTRAINED || dvs.empty())
+        return;
+      std::vector<int> dvConstraints;
+      computeOrderingConstraints(dvs, _options.orderLast, _options.numOrderLast, dvConstraints);
+      // The rows of J^T are the columns of the design variables.
+      _orderingConstraints.resize(dvs.back()->columnBase() + dvs.back()->minimalDimensions(), 0);
+      for (size_t i = 0; i < dvs.size(); ++i) {
+        std::fill_n(_orderingConstraints.begin() + dvs[i]->columnBase(), dvs[i]->minimalDimensions(), dvConstraints[i]);
+      }
+    }
+
     void SparseCholeskyLinearSystemSolver::buildSystem(size_t nThreads, bool useMEstimator)
     {
       //std::cout << "build system\n";
+      _jacobianBuilder.setRelinearizationThreshold(_options.relinearizationThreshold);
       _jacobianBuilder.buildSystem(nThreads, useMEstimator);
       CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
       J_transpose.rightMultiply(_e, _rhs);
@@ -58,18 +119,39 @@ namespace aslam {
       J_transpose.getView(&_cholmodLhs);
       _cholmod.view(_rhs, &_cholmodRhs);
       // std::cout << "solve system\n";
-      if (!_factor) {
-        // std::cout << "\tAnalyze system\n";
-        // Now do the symbolic analysis with cholmod.
-        _factor = _cholmod.analyze(&_cholmodLhs);
-        //  std::cout << "\tanalyze system complete\n";
-      }
-      // Now we can solve the system.
       outDx.resize(J_transpose.rows());
-      cholmod_dense* sol = _cholmod.solve(&_cholmodLhs, _factor, &_cholmodRhs);
+      bool refined = false;
+      cholmod_dense* sol = NULL;
+      if (updateFactor()) {
+        sol = _cholmod.solve(_factor, &_cholmodRhs);
+      } else {
+        // Updates change the pattern of the factor without a new initMatrixStructure()
+        if (_checkAnalysis || _options.incremental) {
+          if (!isAnalyzedFor(_cholmodLhs)) {
+            freeFactors();
+          }
+          _checkAnalysis = false;
+        }
+        refined = !_options.incremental && _options.mixedPrecision && solveMixedPrecision(outDx);
+        if (!refined) {
+          if (!_factor) {
+            // std::cout << "\tAnalyze system\n";
+            _factor = analyze(&_cholmodLhs);
+            //  std::cout << "\tanalyze system complete\n";
+          }
+          // Now we can solve the system.
+          sol = _cholmod.solve(&_cholmodLhs, _factor, &_cholmodRhs);
+          if (sol && _options.incremental) {
+            recordFactorization();
+          }
+        }
+      }
       if (_useDiagonalConditioner) {
         J_transpose.popDiagonalBlock();
       }
+      if (refined) {
+        return true;
+      }
       if (!sol) {
         std::cout << "Solution failed\n";
         return false;
@@ -92,6 +174,160 @@ namespace aslam {
       return true;
     }
 
+    cholmod_factor* SparseCholeskyLinearSystemSolver::analyze(cholmod_sparse* lhs)
+    {
+      // Now do the symbolic analysis with cholmod. The updates of the incremental mode need a simplicial factor.
+      _cholmod.setSupernodal(_options.incremental ? CHOLMOD_SIMPLICIAL : _options.supernodal, _options.supernodalSwitch);
+      if (_options.numBlasThreads > 0 && !Cholmod<>::setNumBlasThreads(_options.numBlasThreads)) {
+        std::cout << "Unable to set the number of BLAS threads\n";
+      }
+      ++_numSymbolicAnalyses;
+      const int* p = static_cast<const int*>(lhs->p);
+      const int* i = static_cast<const int*>(lhs->i);
+      _analyzedRows = lhs->nrow;
+      _analyzedColumnPointers.assign(p, p + lhs->ncol + 1);
+      _analyzedRowIndices.assign(i, i + p[lhs->ncol]);
+      _analyzedOrderingConstraints = _orderingConstraints;
+      _analyzedOptions = _options;
+      return _cholmod.analyze(lhs, _options.ordering, _orderingConstraints);
+    }
+
+    bool SparseCholeskyLinearSystemSolver::isAnalyzedFor(const cholmod_sparse& lhs) const
+    {
+      if (!_factor && !_singleFactor) {
+        return false;
+      }
+      if (_analyzedOptions.ordering != _options.ordering || _analyzedOptions.supernodal != _options.supernodal ||
+          _analyzedOptions.supernodalSwitch != _options.supernodalSwitch || _analyzedOrderingConstraints != _orderingConstraints) {
+        return false;
+      }
+      if (lhs.nrow != _analyzedRows || lhs.ncol + 1 != _analyzedColumnPointers.size()) {
+        return false;
+      }
+      const int* p = static_cast<const int*>(lhs.p);
+      const int* i = static_cast<const int*>(lhs.i);
+      return std::equal(_analyzedColumnPointers.begin(), _analyzedColumnPointers.end(), p) &&
+          static_cast<std::size_t>(p[lhs.ncol]) == _analyzedRowIndices.size() &&
+          std::equal(_analyzedRowIndices.begin(), _analyzedRowIndices.end(), i);
+    }
+
+    bool SparseCholeskyLinearSystemSolver::updateFactor()
+    {
+      if (!_options.incremental || !_factorState.isValid || !_factor) {
+        return false;
+      }
+      if (_useDiagonalConditioner && (_diagonalConditioner.size() != _factorState.diagonalConditioner.size() ||
+                                      _diagonalConditioner != _factorState.diagonalConditioner)) {
+        return false;
+      }
+      // The factor holds the Jacobians at the last factorization
+      for (size_t i = 0; i < _dvs.size(); ++i) {
+        if (_dvs[i]->numParameterSets() != _factorState.numParameterSets[i] ||
+            !(_dvs[i]->accumulatedUpdateNorm() - _factorState.accumulatedUpdateNorms[i] <= _options.incrementalLinearizationThreshold)) {
+          return false;
+        }
+      }
+      const std::size_t numRows = JRows();
+      if (numRows == _factorState.numRows) {
+        ++_incrementalStatistics.numReuses;
+        return true;
+      }
+      if (!_cholmod.update(&_cholmodLhs, _factorState.numRows, numRows, _factor)) {
+        // The factor may be partially updated
+        freeFactors();
+        _factorState.isValid = false;
+        return false;
+      }
+      ++_incrementalStatistics.numUpdates;
+      _incrementalStatistics.numRowsAdded += numRows - _factorState.numRows;
+      _factorState.numRows = numRows;
+      _factorState.errorTerms = _errorTerms;
+      // Refactorize in the next solve once the fill got out of hand
+      if (Cholmod<>::factorNonZeros(_factor) > (1.0 + _options.incrementalMaxFillGrowth) * _factorState.factorNonZeros) {
+        _factorState.isValid = false;
+      }
+      return true;
+    }
+
+    void SparseCholeskyLinearSystemSolver::recordFactorization()
+    {
+      ++_incrementalStatistics.numFactorizations;
+      _factorState.isValid = true;
+      _factorState.errorTerms = _errorTerms;
+      _factorState.numRows = JRows();
+      _factorState.dvs = _dvs;
+      _factorState.columnBases.resize(_dvs.size());
+      _factorState.accumulatedUpdateNorms.resize(_dvs.size());
+      _factorState.numParameterSets.resize(_dvs.size());
+      for (size_t i = 0; i < _dvs.size(); ++i) {
+        _factorState.columnBases[i] = _dvs[i]->columnBase();
+        _factorState.accumulatedUpdateNorms[i] = _dvs[i]->accumulatedUpdateNorm();
+        _factorState.numParameterSets[i] = _dvs[i]->numParameterSets();
+      }
+      _factorState.useDiagonalConditioner = _useDiagonalConditioner;
+      _factorState.diagonalConditioner = _useDiagonalConditioner ? _diagonalConditioner : Eigen::VectorXd();
+      _factorState.factorNonZeros = Cholmod<>::factorNonZeros(_factor);
+    }
+
+    bool SparseCholeskyLinearSystemSolver::solveMixedPrecision(Eigen::VectorXd& outDx)
+    {
+      if (!Cholmod<>::supportsSinglePrecision()) {
+        return false;
+      }
+      ++_mixedPrecisionStatistics.numSolves;
+      // The single precision copy halves the memory traffic of the factorization.
+      // J^T keeps the conditioner block pushed by solveSystem().
+      cholmod_sparse* singleLhs = _cholmod.copySingle(&_cholmodLhs);
+      bool converged = false;
+      if (singleLhs) {
+        if (!_singleFactor) {
+          _singleFactor = analyze(singleLhs);
+        }
+        if (_cholmod.factorize(singleLhs, _singleFactor)) {
+          converged = refine(outDx);
+        }
+        _cholmod.free(singleLhs);
+      }
+      if (!converged) {
+        ++_mixedPrecisionStatistics.numFallbacks;
+      }
+      return converged;
+    }
+
+    bool SparseCholeskyLinearSystemSolver::refine(Eigen::VectorXd& inOutDx)
+    {
+      const CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
+      if (!_cholmod.solveSingle(_singleFactor, _rhs, inOutDx)) {
+        return false;
+      }
+      const double rhsNorm = _rhs.norm();
+      double lastResidualNorm = std::numeric_limits<double>::infinity();
+      Eigen::VectorXd Jdx, residual, correction;
+      for (int i = 0; ; ++i) {
+        // residual = rhs - (J^T J + D^2) dx in double precision. The multiplications skip the conditioner block.
+        J_transpose.leftMultiply(inOutDx, Jdx);
+        J_transpose.rightMultiply(Jdx, residual);
+        residual = _rhs - residual;
+        if (_useDiagonalConditioner) {
+          residual -= _diagonalConditioner.cwiseAbs2().cwiseProduct(inOutDx);
+        }
+        const double residualNorm = residual.norm();
+        if (residualNorm <= _options.refinementTolerance * rhsNorm) {
+          return true;
+        }
+        // Give up if the single precision factor is too inaccurate to contract the residual (also catches NaNs)
+        if (i >= _options.maxRefinementIterations || !(residualNorm < 0.5 * lastResidualNorm)) {
+          return false;
+        }
+        lastResidualNorm = residualNorm;
+        if (!_cholmod.solveSingle(_singleFactor, residual, correction)) {
+          return false;
+        }
+        inOutDx += correction;
+        ++_mixedPrecisionStatistics.numRefinementSteps;
+      }
+    }
+
     const SparseCholeskyLinearSolverOptions&
     SparseCholeskyLinearSystemSolver::getOptions() const {
       return _options;
@@ -107,6 +343,25 @@ namespace aslam {
       _options = options;
     }
       
+    LinearSolverStatistics SparseCholeskyLinearSystemSolver::getStatistics() const {
+      LinearSolverStatistics statistics;
+      statistics.memoryInUse = _cholmod.getMemoryUsage();
+      statistics.peakMemoryUsage = _cholmod.getPeakMemoryUsage();
+      statistics.flops = _cholmod.getFlops();
+      statistics.factorNonZeros = _cholmod.getFactorNonZeros();
+      statistics.jacobianMemory = _jacobianBuilder.J_transpose().getMemoryUsage();
+      statistics.jacobianContainerMemory = _jacobianBuilder.getJacobianContainerMemoryUsage();
+      return statistics;
+    }
+
+    std::vector<int> SparseCholeskyLinearSystemSolver::getOrdering() const {
+      const cholmod_factor* factor = _factor ? _factor : _singleFactor;
+      if (!factor)
+        return std::vector<int>();
+      const int* perm = static_cast<const int*>(factor->Perm);
+      return std::vector<int>(perm, perm + factor->n);
+    }
+
     double SparseCholeskyLinearSystemSolver::rhsJtJrhs() {
         CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
         Eigen::VectorXd Jrhs;
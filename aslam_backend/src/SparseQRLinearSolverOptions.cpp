@@ -31,7 +31,10 @@ namespace aslam {
         colNorm(false),
         qrTol(SPQR_DEFAULT_TOL),
         normTol(1e-8),
-        verbose(false) {
+        qrOrdering(SPQR_ORDERING_BEST),
+        qrNumThreads(-1),
+        verbose(false),
+        qLess(false) {
     }
 
     SparseQRLinearSolverOptions::SparseQRLinearSolverOptions(
@@ -39,7 +42,10 @@ namespace aslam {
         colNorm(other.colNorm),
         qrTol(other.qrTol),
         normTol(other.normTol),
-        verbose(other.verbose) {
+        qrOrdering(other.qrOrdering),
+        qrNumThreads(other.qrNumThreads),
+        verbose(other.verbose),
+        qLess(other.qLess) {
     }
 
     SparseQRLinearSolverOptions& SparseQRLinearSolverOptions::operator =
@@ -48,7 +54,10 @@ namespace aslam {
         colNorm = other.colNorm;
         qrTol = other.qrTol;
         normTol = other.normTol;
+        qrOrdering = other.qrOrdering;
+        qrNumThreads = other.qrNumThreads;
         verbose = other.verbose;
+        qLess = other.qLess;
       }
       return *this;
     }
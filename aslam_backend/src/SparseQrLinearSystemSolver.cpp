@@ -5,35 +5,50 @@ namespace aslam {
   namespace backend {
     SparseQrLinearSystemSolver::SparseQrLinearSystemSolver(const SparseQRLinearSolverOptions& options) :
         _factor(NULL),
+        _J(NULL),
+        _qLessRank(-1),
+        _qLessTol(0.0),
         _options(options) {
     }
 
     SparseQrLinearSystemSolver::SparseQrLinearSystemSolver(const sm::PropertyTree& config) :
-        _factor(NULL) {
+        _factor(NULL),
+        _J(NULL),
+        _qLessRank(-1),
+        _qLessTol(0.0) {
       SparseQRLinearSolverOptions options;
       options.colNorm = config.getBool("colNorm", options.colNorm);
       options.qrTol = config.getDouble("qrTol", options.qrTol);
       options.normTol = config.getDouble("normTol", options.normTol);
+      options.qrOrdering = config.getInt("qrOrdering", options.qrOrdering);
+      options.qrNumThreads = config.getInt("qrNumThreads", options.qrNumThreads);
       options.verbose = config.getBool("verbose", options.verbose);
+      options.qLess = config.getBool("qLess", options.qLess);
       _options = options;
       // USING C++11 would allow to do constructor delegation and more elegant code
     }
 
     SparseQrLinearSystemSolver::~SparseQrLinearSystemSolver() {
+      freeFactorization();
+    }
+
+    void SparseQrLinearSystemSolver::freeFactorization() {
       if (_factor) {
         _cholmod.free(_factor);
         _factor = NULL;
       }
+      if (_J) {
+        _cholmod.free(_J);
+        _J = NULL;
+      }
+      _qLessRank = -1;
     }
 
 
   void SparseQrLinearSystemSolver::initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool /* useDiagonalConditioner */)
     {
       _errorTerms = errors;
-      if (_factor) {
-        _cholmod.free(_factor);
-        _factor = NULL;
-      }
+      freeFactorization();
       // should not be available or am i wrong?
       _useDiagonalConditioner = false; // useDiagonalConditioner;
       _jacobianBuilder.initMatrixStructure(dvs, errors);
@@ -70,16 +85,32 @@ namespace aslam {
       J_transpose.getView(&_cholmodLhs);
       _cholmod.view(_e, &_cholmodRhs);
       //std::cout << "solve system\n";
-      if (!_factor) {
-        //std::cout << "\tAnalyze system\n";
-        // Now do the symbolic analysis with cholmod.
-        _factor = _cholmod.analyzeQR(&_cholmodLhs);
-        //std::cout << "\tanalyze system complete\n";
-      }
-      // Now we can solve the system.
+      // SPQR factorizes J. Transposing into the same matrix every time saves an allocation per solve.
+      _J = _cholmod.transpose(&_cholmodLhs, _J);
+      _cholmod.setQrNumThreads(_options.qrNumThreads);
       outDx.resize(J_transpose.rows());
-      cholmod_dense* sol = _cholmod.solve(&_cholmodLhs, _factor, &_cholmodRhs,
-        _options.qrTol, _options.colNorm, _options.normTol);
+      cholmod_dense* sol = NULL;
+      if (_options.qLess) {
+        // The Householder vectors of a previous factorization are not needed anymore.
+        if (_factor) {
+          _cholmod.free(_factor);
+          _factor = NULL;
+        }
+        sol = _cholmod.solveQless(_J, &_cholmodRhs, _options.qrOrdering,
+          _options.qrTol, _options.colNorm, _options.normTol);
+        _qLessRank = _cholmod.getQrRank();
+        _qLessTol = _cholmod.getQrTol();
+      } else {
+        if (!_factor) {
+          //std::cout << "\tAnalyze system\n";
+          // Now do the symbolic analysis once, the numeric factorization reuses it.
+          _factor = _cholmod.analyzeQR(_J, _options.qrOrdering, false);
+          //std::cout << "\tanalyze system complete\n";
+        }
+        // Now we can solve the system.
+        sol = _cholmod.solveQR(_J, _factor, &_cholmodRhs,
+          _options.qrTol, _options.colNorm, _options.normTol);
+      }
       if (_useDiagonalConditioner) {
         J_transpose.popDiagonalBlock();
       }
@@ -102,7 +133,7 @@ namespace aslam {
       }
       _cholmod.free(sol);
       if (_options.verbose)
-        std::cout << "numerical rank: " << _factor->rank << std::endl;
+        std::cout << "numerical rank: " << getRank() << std::endl;
       // std::cout << "solve system complete\n";
       return true;
     }
@@ -128,21 +159,25 @@ namespace aslam {
     }
 
     SuiteSparse_long SparseQrLinearSystemSolver::getRank() const {
-      SM_ASSERT_FALSE(Exception, _factor == NULL,
+      if (_factor)
+        return _factor->rank;
+      SM_ASSERT_GE(Exception, _qLessRank, 0,
         "QR decomposition has not run yet");
-      return _factor->rank;
+      return _qLessRank;
     }
 
     double SparseQrLinearSystemSolver::getTol() const {
-      SM_ASSERT_FALSE(Exception, _factor == NULL,
+      if (_factor)
+        return _factor->tol;
+      SM_ASSERT_GE(Exception, _qLessRank, 0,
         "QR decomposition has not run yet");
-      return _factor->tol;
+      return _qLessTol;
     }
 
     std::vector<SuiteSparse_long>
         SparseQrLinearSystemSolver::getPermutationVector() const {
       SM_ASSERT_FALSE(Exception, _factor == NULL,
-        "QR decomposition has not run yet");
+        "QR decomposition has not run yet or ran Q-less");
       return std::vector<SuiteSparse_long>(_factor->Q1fill,
         _factor->Q1fill + _cholmodLhs.nrow);
     }
@@ -150,7 +185,7 @@ namespace aslam {
       Eigen::Matrix<SparseQrLinearSystemSolver::index_t, Eigen::Dynamic, 1> SparseQrLinearSystemSolver::getPermutationVectorEigen() const
       {
           SM_ASSERT_FALSE(Exception, _factor == NULL,
-                          "QR decomposition has not run yet");
+                          "QR decomposition has not run yet or ran Q-less");
           Eigen::Map< Eigen::Matrix<SparseQrLinearSystemSolver::index_t, Eigen::Dynamic, 1> > pv( _factor->Q1fill, _cholmodLhs.nrow );
           return pv;
       }
@@ -173,14 +208,27 @@ namespace aslam {
       return _cholmod.getMemoryUsage();
     }
 
+    LinearSolverStatistics SparseQrLinearSystemSolver::getStatistics() const {
+      LinearSolverStatistics statistics;
+      statistics.memoryInUse = _cholmod.getMemoryUsage();
+      statistics.peakMemoryUsage = _cholmod.getPeakMemoryUsage();
+      statistics.flops = _cholmod.getFlops();
+      statistics.jacobianMemory = _jacobianBuilder.J_transpose().getMemoryUsage();
+      statistics.jacobianContainerMemory = _jacobianBuilder.getJacobianContainerMemoryUsage();
+      return statistics;
+    }
+
     void SparseQrLinearSystemSolver::analyzeSystem() {
       CompressedColumnMatrix<SuiteSparse_long>& J_transpose =
         _jacobianBuilder.J_transpose();
       J_transpose.getView(&_cholmodLhs);
-      if (_factor == NULL)
-        _factor = _cholmod.analyzeQR(&_cholmodLhs);
-      SM_ASSERT_TRUE(Exception, _cholmod.factorize(&_cholmodLhs, _factor,
-        _options.qrTol, true), "QR decomposition failed");
+      _J = _cholmod.transpose(&_cholmodLhs, _J);
+      if (_factor == NULL) {
+        _cholmod.setQrNumThreads(_options.qrNumThreads);
+        _factor = _cholmod.analyzeQR(_J, _options.qrOrdering, false);
+      }
+      SM_ASSERT_TRUE(Exception, _cholmod.factorize(_J, _factor,
+        _options.qrTol), "QR decomposition failed");
     }
 
     double SparseQrLinearSystemSolver::rhsJtJrhs() {
@@ -31,6 +31,7 @@ namespace aslam {
             _J = J;
             _p_J = J;
             _isFirstIteration=true;
+            _speculationStatistics = SpeculationStatistics();
             optimizationStartingImplementation(J);
         }
             
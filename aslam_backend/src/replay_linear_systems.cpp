@@ -0,0 +1,99 @@
+// Replays linear systems recorded with aslam::backend::CapturingLinearSystemSolver
+// with all linear system solvers and trust region policies and prints timing and accuracy.
+//
+// usage: aslam_backend_replay_linear_systems <capture file> [max policy iterations] [threads]
+
+#include <aslam/backend/LinearSystemCapture.hpp>
+#include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/SparseQrLinearSystemSolver.hpp>
+#include <aslam/backend/BlockCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/DenseQrLinearSystemSolver.hpp>
+#include <aslam/backend/DenseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/GaussNewtonTrustRegionPolicy.hpp>
+#include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
+#include <aslam/backend/DogLegTrustRegionPolicy.hpp>
+#include <aslam/backend/LineSearchTrustRegionPolicy.hpp>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace aslam::backend;
+
+namespace {
+
+  void printSolverResults(const std::string& name, const std::vector<LinearSystemReplay::SolveResult>& results)
+  {
+    double buildTime = 0.0, solveTime = 0.0, maxResidual = 0.0, maxDifference = 0.0;
+    size_t failures = 0;
+    for (const LinearSystemReplay::SolveResult& r : results) {
+      buildTime += r.buildTime;
+      solveTime += r.solveTime;
+      failures += !r.success;
+      maxResidual = std::max(maxResidual, r.relativeResidual);
+      maxDifference = std::max(maxDifference, r.relativeDifference);
+    }
+    std::cout << std::left << std::setw(28) << name << std::right
+              << " solves: " << std::setw(6) << results.size()
+              << " failed: " << std::setw(4) << failures
+              << " build [s]: " << std::setw(10) << buildTime
+              << " solve [s]: " << std::setw(10) << solveTime
+              << " max rel. residual: " << std::setw(10) << maxResidual
+              << " max rel. diff: " << maxDifference << std::endl;
+  }
+
+  void printPolicyResults(const std::string& name, const std::vector<LinearSystemReplay::PolicyResult>& results)
+  {
+    double time = 0.0, reduction = 0.0;
+    size_t iterations = 0, failures = 0;
+    for (const LinearSystemReplay::PolicyResult& r : results) {
+      time += r.time;
+      iterations += r.numIterations;
+      failures += r.numFailedIterations;
+      if (r.initialCost > 0.0)
+        reduction += (r.initialCost - r.finalCost) / r.initialCost;
+    }
+    std::cout << std::left << std::setw(28) << name << std::right
+              << " systems: " << std::setw(6) << results.size()
+              << " iterations: " << std::setw(6) << iterations
+              << " failed: " << std::setw(4) << failures
+              << " time [s]: " << std::setw(10) << time
+              << " mean rel. cost reduction: " << (results.empty() ? 0.0 : reduction / results.size()) << std::endl;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <capture file> [max policy iterations = 5] [threads = 1]" << std::endl;
+    return 1;
+  }
+  const size_t maxIterations = argc > 2 ? std::atoi(argv[2]) : 5;
+  const size_t nThreads = argc > 3 ? std::atoi(argv[3]) : 1;
+
+  try {
+    LinearSystemReplay replay(argv[1]);
+    std::cout << "Replaying " << replay.numSystems() << " systems with " << replay.numSolves() << " recorded solves" << std::endl;
+
+    printSolverResults("sparse_cholesky", replay.replay(boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), nThreads));
+    printSolverResults("sparse_qr", replay.replay(boost::shared_ptr<LinearSystemSolver>(new SparseQrLinearSystemSolver()), nThreads));
+    printSolverResults("block_cholesky", replay.replay(boost::shared_ptr<LinearSystemSolver>(new BlockCholeskyLinearSystemSolver()), nThreads));
+    printSolverResults("dense_qr", replay.replay(boost::shared_ptr<LinearSystemSolver>(new DenseQrLinearSystemSolver()), nThreads));
+    printSolverResults("dense_cholesky", replay.replay(boost::shared_ptr<LinearSystemSolver>(new DenseCholeskyLinearSystemSolver()), nThreads));
+
+    GaussNewtonTrustRegionPolicy gaussNewton;
+    LevenbergMarquardtTrustRegionPolicy levenbergMarquardt;
+    DogLegTrustRegionPolicy dogLeg;
+    LineSearchTrustRegionPolicy lineSearch;
+    TrustRegionPolicy* policies[] = { &gaussNewton, &levenbergMarquardt, &dogLeg, &lineSearch };
+    for (TrustRegionPolicy* policy : policies) {
+      boost::shared_ptr<LinearSystemSolver> solver(new SparseCholeskyLinearSystemSolver());
+      printPolicyResults(policy->name() + " (" + solver->name() + ")", replay.replay(*policy, solver, maxIterations, nThreads));
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Replay failed: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <aslam/backend/util/MiniBatchSampler.hpp>
+#include <aslam/backend/util/ProblemManager.hpp>
+#include <aslam/Exceptions.hpp>
+
+#include <sm/assert_macros.hpp>
+
+#include <algorithm>
+
+namespace aslam {
+namespace backend {
+
+MiniBatchSampler::MiniBatchSampler(Sampling sampling, double uniformMixing)
+    : _sampling(sampling), _uniformMixing(uniformMixing)
+{
+  SM_ASSERT_GT_LE(aslam::InvalidArgumentException, uniformMixing, 0.0, 1.0, "The uniform distribution must keep a non-zero share");
+}
+
+void MiniBatchSampler::reset(std::size_t numErrorTerms)
+{
+  _numErrorTerms = numErrorTerms;
+  _importance.assign(_sampling == Sampling::IMPORTANCE ? numErrorTerms : 0, -1.0);
+}
+
+void MiniBatchSampler::sample(std::size_t batchSize, MiniBatch& outBatch)
+{
+  SM_ASSERT_GT(aslam::InvalidArgumentException, batchSize, 0u, "");
+  outBatch.clear();
+  if (_numErrorTerms == 0)
+    return;
+
+  const double N = static_cast<double>(_numErrorTerms);
+  const double n = static_cast<double>(batchSize);
+  _draws.clear();
+  _draws.reserve(batchSize);
+
+  // The importance distribution degenerates to the uniform one as long as no cost is known
+  double sumKnown = 0.0;
+  std::size_t numKnown = 0;
+  for (double c : _importance) {
+    if (c >= 0.0) {
+      sumKnown += c;
+      numKnown++;
+    }
+  }
+
+  if (_sampling == Sampling::UNIFORM || sumKnown <= 0.0) {
+    std::uniform_int_distribution<std::size_t> uniform(0, _numErrorTerms - 1);
+    for (std::size_t k = 0; k < batchSize; k++)
+      _draws.emplace_back(uniform(_rng), N / n);
+  } else {
+    const double mean = sumKnown / numKnown;
+    const double total = sumKnown + mean * (_numErrorTerms - numKnown);
+    _cumulative.resize(_numErrorTerms);
+    double cumulative = 0.0;
+    for (std::size_t i = 0; i < _numErrorTerms; i++) {
+      const double c = _importance[i] >= 0.0 ? _importance[i] : mean;
+      cumulative += (1.0 - _uniformMixing) * c / total + _uniformMixing / N;
+      _cumulative[i] = cumulative;
+    }
+    std::uniform_real_distribution<double> uniform(0.0, cumulative);
+    for (std::size_t k = 0; k < batchSize; k++) {
+      const std::size_t i = std::min<std::size_t>(std::upper_bound(_cumulative.begin(), _cumulative.end(), uniform(_rng)) - _cumulative.begin(),
+                                                  _numErrorTerms - 1);
+      const double p = _cumulative[i] - (i > 0 ? _cumulative[i - 1] : 0.0);
+      _draws.emplace_back(i, 1.0 / (n * p));
+    }
+  }
+
+  // Merge duplicates, the sorted indices also let the gradient evaluation walk the error terms in order
+  std::sort(_draws.begin(), _draws.end());
+  outBatch.errorTermIndices.reserve(_draws.size());
+  outBatch.weights.reserve(_draws.size());
+  for (const auto& draw : _draws) {
+    if (!outBatch.errorTermIndices.empty() && outBatch.errorTermIndices.back() == draw.first) {
+      outBatch.weights.back() += draw.second;
+    } else {
+      outBatch.errorTermIndices.push_back(draw.first);
+      outBatch.weights.push_back(draw.second);
+    }
+  }
+}
+
+void MiniBatchSampler::updateImportance(const MiniBatch& batch, const ProblemManager& problemManager)
+{
+  if (_sampling != Sampling::IMPORTANCE)
+    return;
+  SM_ASSERT_EQ(aslam::InvalidArgumentException, _importance.size(), problemManager.numErrorTerms(), "The sampler was reset for another problem");
+  for (std::size_t i : batch.errorTermIndices)
+    _importance[i] = problemManager.getCachedErrorTermCost(i);
+}
+
+} // namespace backend
+} // namespace aslam
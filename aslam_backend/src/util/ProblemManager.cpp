@@ -10,6 +10,8 @@
 
 #include <sm/logging.hpp>
 
+#include <cmath>
+
 namespace aslam {
 namespace backend {
 
@@ -111,6 +113,22 @@ void ProblemManager::checkProblemSetup() const
     SM_ASSERT_GT(Exception, _errorTermsS[i]->numDesignVariables(), 0, "Squared error term " << i << " has no design variable(s) attached.");
 }
 
+/**
+ * Compare the analytic Jacobians of a random subset of the squared error terms with central differences.
+ * Call k of this problem manager draws its subset with the seed options.seed + k, such that successive calls
+ * with the same options check different error terms.
+ * @param options The options of the check
+ * @return The report of the check, listing the worst offenders
+ */
+JacobianChecker::Report ProblemManager::checkJacobians(const JacobianCheckerOptions& options) const
+{
+  SM_ASSERT_TRUE(Exception, isInitialized(), "The problem has to be initialized before checking the Jacobians.");
+  JacobianCheckerOptions runOptions = options;
+  runOptions.seed += _numJacobianChecks++;
+  JacobianChecker checker(runOptions);
+  return checker.check(_errorTermsS);
+}
+
 /**
  * Computes the gradient of the scalar objective function
  * @param[out] outGrad The gradient
@@ -132,40 +150,64 @@ void ProblemManager::computeGradient(RowVectorType& outGrad, size_t nThreads, bo
     applyDesignVariableScaling(outGrad);
 }
 
+void ProblemManager::computeGradient(RowVectorType& outGrad, const MiniBatch& batch, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer)
+{
+  SM_ASSERT_GT(Exception, nThreads, 0, "");
+  SM_ASSERT_EQ(Exception, batch.errorTermIndices.size(), batch.weights.size(), "");
+  Timer t("ProblemManager: Compute mini-batch gradient", false);
+  std::vector<RowVectorType> gradients(nThreads, RowVectorType::Zero(1, _numOptParameters)); // compute gradients separately in different threads and add in the end
+  boost::function<void(size_t, size_t, size_t, RowVectorType&)> job(boost::bind(&ProblemManager::evaluateMiniBatchGradients, this, _1, _2, _3, _4, boost::cref(batch), useMEstimator, useDenseJacobianContainer));
+  util::runThreadedFunction(job, batch.size(), gradients);
+  // Add up the gradients
+  outGrad = gradients[0];
+  for (std::size_t i = 1; i<gradients.size(); i++)
+    outGrad += gradients[i];
+  if (applyDvScaling)
+    applyDesignVariableScaling(outGrad);
+}
+
+double ProblemManager::getCachedErrorTermCost(size_t i) const {
+  SM_ASSERT_LT_DBG(Exception, i, _numErrorTerms, "");
+  if (i < _errorTermsNS.size())
+    return std::fabs(_errorTermsNS[i]->getRawError());
+  return _errorTermsS[i - _errorTermsNS.size()]->getRawSquaredError();
+}
+
 void ProblemManager::applyDesignVariableScaling(RowVectorType& outGrad) const {
   for (const auto dv : _designVariables)
     outGrad.block(0, dv->columnBase(), outGrad.rows(), dv->minimalDimensions()) *= dv->scaling();
 }
 
 void ProblemManager::addGradientForErrorTerm(RowVectorType& J, ErrorTerm* e, bool useMEstimator, bool useDenseJacobianContainer) {
-  e->updateRawSquaredError();
-  ColumnVectorType ev;
-  e->getWeightedError(ev, useMEstimator);
-  ev *= 2.0;
-
   if (useDenseJacobianContainer) {
-    Eigen::MatrixXd J2 = Eigen::MatrixXd::Zero(e->dimension(), J.cols());
-    JacobianContainerDense<Eigen::MatrixXd&, Eigen::Dynamic> jc(J2);
-    e->getWeightedJacobians(jc, useMEstimator);
-    J += ev.transpose() * J2;
+    JacobianContainerDense<RowVectorType&, 1> jc(J);
+    addGradientForErrorTerm(jc, e, useMEstimator);
   } else {
-    JacobianContainerSparse<Eigen::Dynamic> jc(e->dimension());
-    e->getWeightedJacobians(jc, useMEstimator);
-    for (const auto& dvJacPair : jc) { // iterate over design variables of this error term
-      RowVectorType grad = ev.transpose()*dvJacPair.second;
-      J.block(0 /*e->rowBase()*/, dvJacPair.first->columnBase(), grad.rows(), grad.cols()) += grad;
-    }
+    JacobianContainerSparse<1> jc(1);
+    addGradientForErrorTerm(jc, J, e, useMEstimator);
   }
 }
 
-void ProblemManager::addGradientForErrorTerm(JacobianContainerSparse<1>& jc, RowVectorType& J, ScalarNonSquaredErrorTerm* e, bool useMEstimator) {
-  e->evaluateJacobians(jc, useMEstimator);
+void ProblemManager::addGradientForErrorTerm(JacobianContainerSparse<1>& jc, RowVectorType& J, ErrorTerm* e, bool useMEstimator, double scale) {
+  e->updateRawSquaredError();
+  e->addWeightedGradient(jc, useMEstimator, 2.0 * scale);
   for (const auto& dvJacPair : jc) // iterate over design variables of this error term
     J.block(0 /*e->rowBase()*/, dvJacPair.first->columnBase(), dvJacPair.second.rows(), dvJacPair.second.cols()) += dvJacPair.second;
 }
 
-void ProblemManager::addGradientForErrorTerm(JacobianContainerDense<RowVectorType&, 1>& jc, ScalarNonSquaredErrorTerm* e, bool useMEstimator) {
-  e->evaluateJacobians(jc, useMEstimator);
+void ProblemManager::addGradientForErrorTerm(JacobianContainerDense<RowVectorType&, 1>& jc, ErrorTerm* e, bool useMEstimator, double scale) {
+  e->updateRawSquaredError();
+  e->addWeightedGradient(jc, useMEstimator, 2.0 * scale);
+}
+
+void ProblemManager::addGradientForErrorTerm(JacobianContainerSparse<1>& jc, RowVectorType& J, ScalarNonSquaredErrorTerm* e, bool useMEstimator, double scale) {
+  e->addWeightedGradient(jc, useMEstimator, scale);
+  for (const auto& dvJacPair : jc) // iterate over design variables of this error term
+    J.block(0 /*e->rowBase()*/, dvJacPair.first->columnBase(), dvJacPair.second.rows(), dvJacPair.second.cols()) += dvJacPair.second;
+}
+
+void ProblemManager::addGradientForErrorTerm(JacobianContainerDense<RowVectorType&, 1>& jc, ScalarNonSquaredErrorTerm* e, bool useMEstimator, double scale) {
+  e->addWeightedGradient(jc, useMEstimator, scale);
 }
 
 
@@ -251,6 +293,7 @@ Eigen::VectorXd ProblemManager::getFlattenedDesignVariableParameters() const {
 void ProblemManager::sumErrorTerms(size_t /* threadId */, size_t startIdx, size_t endIdx, double& err) const {
   SM_ASSERT_LE_DBG(Exception, endIdx, _numErrorTerms, "");
   for (size_t i = startIdx; i < endIdx; ++i) { // iterate through error terms
+    checkCancelled();
     if (i < _errorTermsNS.size())
       err += _errorTermsNS[i]->evaluateError();
     else
@@ -272,29 +315,76 @@ void ProblemManager::evaluateGradients(size_t /* threadId */, size_t startIdx, s
 
   size_t cnt = startIdx;
 
-  // process non-squared error terms
+  // The gradients are accumulated directly into J (dense) or into a one-row container per error term (sparse)
   if (useDenseJacobianContainer)
   {
     JacobianContainerDense<RowVectorType&, 1> jc(J);
     for (; cnt < endIdx && cnt < _errorTermsNS.size(); ++cnt)
+    {
+      checkCancelled();
       addGradientForErrorTerm(jc, _errorTermsNS[cnt], useMEstimator);
+    }
+    for (; cnt < endIdx; ++cnt)
+    {
+      checkCancelled();
+      addGradientForErrorTerm(jc, _errorTermsS[cnt - _errorTermsNS.size()], useMEstimator);
+    }
   }
   else
   {
     JacobianContainerSparse<1> jc(1);
     for (; cnt < endIdx && cnt < _errorTermsNS.size(); ++cnt)
     {
+      checkCancelled();
       jc.clear();
       addGradientForErrorTerm(jc, J, _errorTermsNS[cnt], useMEstimator);
     }
+    for (; cnt < endIdx; ++cnt)
+    {
+      checkCancelled();
+      jc.clear();
+      addGradientForErrorTerm(jc, J, _errorTermsS[cnt - _errorTermsNS.size()], useMEstimator);
+    }
   }
 
-  // process squared error terms
-  for (; cnt < endIdx; ++cnt)
+}
+
+/**
+ * Evaluate the weighted gradients of a mini-batch
+ * @param startIdx First batch entry (including)
+ * @param endIdx Last batch entry (excluding)
+ * @param J The weighted gradient for the specified batch entries
+ * @param batch The error term indices and their weights
+ */
+void ProblemManager::evaluateMiniBatchGradients(size_t /* threadId */, size_t startIdx, size_t endIdx, RowVectorType& J, const MiniBatch& batch,
+                                                bool useMEstimator, bool useDenseJacobianContainer)
+{
+  SM_ASSERT_LE_DBG(Exception, endIdx, batch.size(), "");
+
+  JacobianContainerDense<RowVectorType&, 1> jcDense(J);
+  JacobianContainerSparse<1> jcSparse(1);
+  for (size_t k = startIdx; k < endIdx; ++k)
   {
-    addGradientForErrorTerm(J, _errorTermsS[cnt - _errorTermsNS.size()], useMEstimator, useDenseJacobianContainer);
+    checkCancelled();
+    const size_t i = batch.errorTermIndices[k];
+    SM_ASSERT_LT_DBG(Exception, i, _numErrorTerms, "");
+    const double w = batch.weights[k];
+    if (useDenseJacobianContainer)
+    {
+      if (i < _errorTermsNS.size())
+        addGradientForErrorTerm(jcDense, _errorTermsNS[i], useMEstimator, w);
+      else
+        addGradientForErrorTerm(jcDense, _errorTermsS[i - _errorTermsNS.size()], useMEstimator, w);
+    }
+    else
+    {
+      jcSparse.clear();
+      if (i < _errorTermsNS.size())
+        addGradientForErrorTerm(jcSparse, J, _errorTermsNS[i], useMEstimator, w);
+      else
+        addGradientForErrorTerm(jcSparse, J, _errorTermsS[i - _errorTermsNS.size()], useMEstimator, w);
+    }
   }
-
 }
 
 } // namespace backend
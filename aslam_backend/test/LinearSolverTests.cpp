@@ -1,10 +1,12 @@
 #include <sm/eigen/gtest.hpp>
 
+#include <algorithm>
 #include <numeric>
 
 #include <aslam/backend/test/SampleDvAndError.hpp>
 
 #include <aslam/backend/DenseQrLinearSystemSolver.hpp>
+#include <aslam/backend/DenseCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/SparseQrLinearSystemSolver.hpp>
 #include <aslam/backend/BlockCholeskyLinearSystemSolver.hpp>
@@ -91,6 +93,51 @@ TEST(LinearSolverTestSuite, testDenseQr)
 }
 */
 
+TEST(LinearSolverTestSuite, testDenseQrRedamping)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  try {
+    buildSystem(4, 20, dvs, errs);
+    DenseQrLinearSystemSolver solver;
+    solver.initMatrixStructure(dvs, errs, true);
+    solver.evaluateError(1, false);
+    solver.buildSystem(1, false);
+    const Eigen::MatrixXd J = solver.getJacobian();
+    const Eigen::VectorXd e = solver.e();
+    ASSERT_EQ(solver.JRows(), (size_t)J.rows());
+
+    Eigen::VectorXd dx;
+    for (double lambda : {0.0, 1e-3, 1.0, 1e2}) {
+      SCOPED_TRACE(testing::Message() << "lambda: " << lambda);
+      Eigen::VectorXd diag = Eigen::VectorXd::Random(J.cols()) * lambda;
+      solver.setConditioner(diag);
+      ASSERT_TRUE(solver.solveSystem(dx));
+      Eigen::MatrixXd H = J.transpose() * J;
+      H.diagonal() += diag.cwiseAbs2();
+      Eigen::VectorXd expected = H.ldlt().solve(J.transpose() * e);
+      sm::eigen::assertNear(expected, dx, 1e-8, SM_SOURCE_FILE_POS, "Damped solution");
+      ASSERT_EQ(J.rows(), solver.getJacobian().rows());
+    }
+
+    // Re-damping solves the system of the linearization point, also after evaluating the error elsewhere.
+    solver.setConstantConditioner(0.5);
+    Eigen::VectorXd dx0;
+    solver.solveSystem(dx0);
+    Eigen::VectorXd dv0 = Eigen::VectorXd::Ones(dvs[0]->minimalDimensions());
+    dvs[0]->update(dv0.data(), dv0.size());
+    solver.evaluateError(1, false);
+    solver.solveSystem(dx);
+    sm::eigen::assertNear(dx0, dx, 1e-12, SM_SOURCE_FILE_POS, "Solution after evaluating the error elsewhere");
+    dvs[0]->revertUpdate();
+    deleteSystem(dvs, errs);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+}
+
 TEST(LinearSolverTestSuite, testSparseCholesky)
 {
   using namespace aslam::backend;
@@ -114,6 +161,21 @@ TEST(LinearSolverTestSuite, testSparseCholesky)
   }
 }
 
+TEST(LinearSolverTestSuite, testDenseCholesky)
+{
+  using namespace aslam::backend;
+  const int D = 4;
+  const int E = 20;
+  for (int nThreads = 0; nThreads < 4; ++nThreads) {
+    for (bool useM : {false, true}) {
+      for (bool useDiag : {false, true}) {
+        SCOPED_TRACE(::testing::Message() << "Diagonal " << useDiag << ", M-estimator " << useM << " and " << nThreads << " threads");
+        compareSolvers<SparseCholeskyLinearSystemSolver, DenseCholeskyLinearSystemSolver>(D, E, useM, useDiag, nThreads);
+      }
+    }
+  }
+}
+
 TEST(LinearSolverTestSuite, testSparseQR)
 {
   using namespace aslam::backend;
@@ -164,3 +226,418 @@ TEST(LinearSolverTestSuite, testSparseQRAcceptConstantErrorTerms)
   EXPECT_ANY_THROW(solver.initMatrixStructure(dvs, errs, false));
   deleteSystem(dvs, errs);
 }
+
+/// Expects the columns with constraint 1 at the end of the permutation \p perm
+void expectConstrainedLast(const std::vector<int>& perm, const std::vector<int>& constraints)
+{
+  ASSERT_EQ(constraints.size(), perm.size());
+  const int numConstrained = std::accumulate(constraints.begin(), constraints.end(), 0);
+  ASSERT_LT(0, numConstrained);
+  for (int i = (int)perm.size() - numConstrained; i < (int)perm.size(); ++i) {
+    EXPECT_EQ(1, constraints[perm[i]]) << "Unconstrained column " << perm[i] << " at position " << i;
+  }
+}
+
+/// The constraint of every scalar column of the design variables \p dvs from the constraints of the design variables
+std::vector<int> columnConstraints(const std::vector<DesignVariable*>& dvs, const std::vector<int>& dvConstraints)
+{
+  std::vector<int> constraints;
+  for (size_t i = 0; i < dvs.size(); ++i)
+    constraints.insert(constraints.end(), dvs[i]->minimalDimensions(), dvConstraints[i]);
+  return constraints;
+}
+
+void testFillReducingOrderings(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errs)
+{
+  SparseCholeskyLinearSystemSolver reference;
+  reference.initMatrixStructure(dvs, errs, false);
+  reference.evaluateError(1, false);
+  reference.buildSystem(1, false);
+  Eigen::VectorXd dxReference;
+  ASSERT_TRUE(reference.solveSystem(dxReference));
+
+  // The sparse solver constrains the last two design variables, the block solver the first one.
+  std::vector<int> sparseConstraints, blockConstraints;
+  ASSERT_TRUE(computeOrderingConstraints(dvs, std::vector<const DesignVariable*>(), 2, sparseConstraints));
+  ASSERT_TRUE(computeOrderingConstraints(dvs, std::vector<const DesignVariable*>(1, dvs.front()), 0, blockConstraints));
+  sparseConstraints = columnConstraints(dvs, sparseConstraints);
+  blockConstraints = columnConstraints(dvs, blockConstraints);
+
+  const FillReducingOrdering orderings[] = { FillReducingOrdering::AMD, FillReducingOrdering::COLAMD,
+                                             FillReducingOrdering::CONSTRAINED, FillReducingOrdering::NESDIS };
+  for (FillReducingOrdering ordering : orderings) {
+    SCOPED_TRACE(::testing::Message() << "Ordering " << ordering);
+    SparseCholeskyLinearSolverOptions sparseOptions;
+    sparseOptions.ordering = ordering;
+    sparseOptions.numOrderLast = 2;
+    SparseCholeskyLinearSystemSolver sparse(sparseOptions);
+    sparse.initMatrixStructure(dvs, errs, false);
+    sparse.evaluateError(1, false);
+    sparse.buildSystem(1, false);
+    Eigen::VectorXd dx;
+    ASSERT_TRUE(sparse.solveSystem(dx));
+    ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-6, "Checking the sparse Cholesky solution");
+    if (ordering == FillReducingOrdering::CONSTRAINED) {
+      SCOPED_TRACE("Sparse Cholesky");
+      expectConstrainedLast(sparse.getOrdering(), sparseConstraints);
+    }
+
+    BlockCholeskyLinearSolverOptions blockOptions;
+    blockOptions.ordering = ordering;
+    blockOptions.orderLast.push_back(dvs.front());
+    BlockCholeskyLinearSystemSolver block("cholesky", blockOptions);
+    block.initMatrixStructure(dvs, errs, false);
+    block.evaluateError(1, false);
+    block.buildSystem(1, false);
+    ASSERT_TRUE(block.solveSystem(dx));
+    ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-6, "Checking the block Cholesky solution");
+    if (ordering == FillReducingOrdering::CONSTRAINED) {
+      SCOPED_TRACE("Block Cholesky");
+      expectConstrainedLast(block.getOrdering(), blockConstraints);
+    }
+  }
+
+  // The constrained rows of J^T have to be eliminated last.
+  CompressedColumnJacobianTransposeBuilder<int> builder;
+  builder.initMatrixStructure(dvs, errs);
+  builder.buildSystem(1, false);
+  cholmod_sparse Jt;
+  builder.J_transpose().getView(&Jt);
+  std::vector<int> dvConstraints;
+  std::vector<const DesignVariable*> orderLast(1, dvs[1]);
+  ASSERT_TRUE(computeOrderingConstraints(dvs, orderLast, 1, dvConstraints));
+  const std::vector<int> rowConstraints = columnConstraints(dvs, dvConstraints);
+  Cholmod<int> cholmod;
+  cholmod_factor* factor = cholmod.analyze(&Jt, FillReducingOrdering::CONSTRAINED, rowConstraints);
+  ASSERT_TRUE(factor != NULL);
+  const int* perm = reinterpret_cast<const int*>(factor->Perm);
+  const std::vector<int> permutation(perm, perm + factor->n);
+  cholmod.free(factor);
+  expectConstrainedLast(permutation, rowConstraints);
+}
+
+TEST(LinearSolverTestSuite, testFillReducingOrderings)
+{
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  buildSystem(8, 40, dvs, errs);
+  // The checks return on the first fatal failure, the system is deleted in any case.
+  try {
+    testFillReducingOrderings(dvs, errs);
+  } catch (const std::exception& e) {
+    ADD_FAILURE() << e.what();
+  }
+  deleteSystem(dvs, errs);
+}
+
+TEST(LinearSolverTestSuite, testSparseCholeskyFactorizationTypes)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  buildSystem(8, 40, dvs, errs);
+  try {
+    Eigen::VectorXd dxReference;
+    const int factorizations[] = { CHOLMOD_SIMPLICIAL, CHOLMOD_AUTO, CHOLMOD_SUPERNODAL };
+    for (int factorization : factorizations) {
+      SCOPED_TRACE(::testing::Message() << "Factorization " << factorization);
+      SparseCholeskyLinearSolverOptions options;
+      options.supernodal = factorization;
+      options.supernodalSwitch = 1.0;
+      SparseCholeskyLinearSystemSolver solver(options);
+      solver.initMatrixStructure(dvs, errs, true);
+      solver.setConstantConditioner(1e-3);
+      solver.evaluateError(1, false);
+      solver.buildSystem(1, false);
+      Eigen::VectorXd dx;
+      ASSERT_TRUE(solver.solveSystem(dx));
+      if (dxReference.size() == 0)
+        dxReference = dx;
+      ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-6, "Checking the solution");
+      const LinearSolverStatistics statistics = solver.getStatistics();
+      EXPECT_GT(statistics.peakMemoryUsage, 0u);
+      EXPECT_GE(statistics.peakMemoryUsage, statistics.memoryInUse);
+      EXPECT_GT(statistics.flops, 0.0);
+      EXPECT_GE(statistics.factorNonZeros, (double)dx.size());
+    }
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+  deleteSystem(dvs, errs);
+}
+
+TEST(LinearSolverTestSuite, testSparseCholeskyMixedPrecision)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  buildSystem(8, 40, dvs, errs);
+  try {
+    SparseCholeskyLinearSystemSolver reference;
+    reference.initMatrixStructure(dvs, errs, true);
+    reference.setConstantConditioner(1e-3);
+    reference.evaluateError(1, false);
+    reference.buildSystem(1, false);
+    Eigen::VectorXd dxReference;
+    ASSERT_TRUE(reference.solveSystem(dxReference));
+
+    SparseCholeskyLinearSolverOptions options;
+    options.mixedPrecision = true;
+    SparseCholeskyLinearSystemSolver solver(options);
+    solver.initMatrixStructure(dvs, errs, true);
+    solver.setConstantConditioner(1e-3);
+    solver.evaluateError(1, false);
+    solver.buildSystem(1, false);
+    Eigen::VectorXd dx;
+    ASSERT_TRUE(solver.solveSystem(dx));
+    ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-6, "Checking the refined solution");
+    if (Cholmod<>::supportsSinglePrecision()) {
+      EXPECT_EQ(1u, solver.getMixedPrecisionStatistics().numSolves);
+      EXPECT_EQ(0u, solver.getMixedPrecisionStatistics().numFallbacks);
+    } else {
+      EXPECT_EQ(0u, solver.getMixedPrecisionStatistics().numSolves);
+    }
+
+    // An unreachable tolerance falls back to the double precision factorization
+    solver.getOptions().refinementTolerance = 0.0;
+    solver.getOptions().maxRefinementIterations = 1;
+    ASSERT_TRUE(solver.solveSystem(dx));
+    ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-6, "Checking the fallback solution");
+    if (Cholmod<>::supportsSinglePrecision()) {
+      EXPECT_EQ(1u, solver.getMixedPrecisionStatistics().numFallbacks);
+    }
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+  deleteSystem(dvs, errs);
+}
+
+TEST(LinearSolverTestSuite, testSparseCholeskySelectiveRelinearization)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  buildSystem(8, 40, dvs, errs);
+  auto numDepending = [&errs](const DesignVariable* dv) {
+    return (std::size_t)std::count_if(errs.begin(), errs.end(), [dv](const ErrorTerm* e) {
+      return std::find(e->designVariables().begin(), e->designVariables().end(), dv) != e->designVariables().end();
+    });
+  };
+  try {
+    SparseCholeskyLinearSolverOptions options;
+    options.relinearizationThreshold = 0.1;
+    SparseCholeskyLinearSystemSolver solver(options);
+    solver.initMatrixStructure(dvs, errs, false);
+    auto build = [&solver](bool useM) {
+      solver.evaluateError(1, useM);
+      solver.buildSystem(2, useM);
+      return solver.getRelinearizationStatistics();
+    };
+    RelinearizationStatistics last = build(false);
+    EXPECT_EQ(errs.size(), last.numEvaluated);
+    EXPECT_EQ(0u, last.numSkipped);
+
+    auto expectBuild = [&](std::size_t numEvaluated, bool useM) {
+      const RelinearizationStatistics stats = build(useM);
+      EXPECT_EQ(numEvaluated, stats.numEvaluated - last.numEvaluated);
+      EXPECT_EQ(errs.size() - numEvaluated, stats.numSkipped - last.numSkipped);
+      last = stats;
+    };
+    // A small step is below the threshold
+    const Eigen::Vector2d small(0.05, -0.01), large(0.06, 0.0);
+    dvs[0]->update(small.data(), 2);
+    expectBuild(0, false);
+    // Together with the previous step it exceeds the threshold
+    dvs[0]->update(large.data(), 2);
+    expectBuild(numDepending(dvs[0]), false);
+    // Reverting moves it back by less than the threshold
+    dvs[0]->revertUpdate();
+    expectBuild(0, false);
+    // Reverting counts as a move, so a step back after it is noticed as well
+    const Eigen::Vector2d forth(0.06, 0.0), back(-0.06, 0.0);
+    dvs[2]->update(forth.data(), 2);
+    dvs[2]->update(forth.data(), 2);
+    expectBuild(numDepending(dvs[2]), false);
+    const double norm = dvs[2]->accumulatedUpdateNorm();
+    dvs[2]->revertUpdate();
+    EXPECT_DOUBLE_EQ(norm + 0.06, dvs[2]->accumulatedUpdateNorm());
+    dvs[2]->update(back.data(), 2);
+    expectBuild(numDepending(dvs[2]), false);
+    // Setting the value always counts as a move
+    dvs[1]->setParameters(dvs[1]->getParameters());
+    expectBuild(numDepending(dvs[1]), false);
+    // The M-estimator weights are part of the Jacobians
+    expectBuild(errs.size(), true);
+    expectBuild(0, true);
+
+    // The kept Jacobians give the same solution as a full build
+    SparseCholeskyLinearSystemSolver reference;
+    reference.initMatrixStructure(dvs, errs, false);
+    reference.evaluateError(1, true);
+    reference.buildSystem(1, true);
+    Eigen::VectorXd dxReference, dx;
+    ASSERT_TRUE(reference.solveSystem(dxReference));
+    ASSERT_TRUE(solver.solveSystem(dx));
+    ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-9, "Checking the solution with kept Jacobians");
+
+    // A negative threshold evaluates everything
+    solver.getOptions().relinearizationThreshold = -1.0;
+    expectBuild(errs.size(), true);
+    solver.initMatrixStructure(dvs, errs, false);
+    EXPECT_EQ(0u, solver.getRelinearizationStatistics().numEvaluated);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+  deleteSystem(dvs, errs);
+}
+
+TEST(LinearSolverTestSuite, testSparseCholeskyIncremental)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  buildSystem(8, 40, dvs, errs);
+  try {
+    auto solveFull = [&dvs](const std::vector<ErrorTerm*>& errors) {
+      SparseCholeskyLinearSystemSolver reference;
+      reference.initMatrixStructure(dvs, errors, false);
+      reference.evaluateError(1, false);
+      reference.buildSystem(1, false);
+      Eigen::VectorXd dx;
+      EXPECT_TRUE(reference.solveSystem(dx));
+      return dx;
+    };
+    SparseCholeskyLinearSolverOptions options;
+    options.incremental = true;
+    options.incrementalLinearizationThreshold = 0.1;
+    options.relinearizationThreshold = 0.1;
+    SparseCholeskyLinearSystemSolver solver(options);
+    auto solve = [&solver, &dvs](const std::vector<ErrorTerm*>& errors) {
+      solver.initMatrixStructure(dvs, errors, false);
+      solver.evaluateError(1, false);
+      solver.buildSystem(1, false);
+      Eigen::VectorXd dx;
+      EXPECT_TRUE(solver.solveSystem(dx));
+      return dx;
+    };
+
+    const std::vector<ErrorTerm*> first(errs.begin(), errs.begin() + 30);
+    ASSERT_DOUBLE_MX_EQ(solveFull(first), solve(first), 1e-8, "Checking the first factorization");
+    EXPECT_EQ(1u, solver.getIncrementalStatistics().numFactorizations);
+
+    // The appended error terms update the factor
+    ASSERT_DOUBLE_MX_EQ(solveFull(errs), solve(errs), 1e-8, "Checking the updated factor");
+    EXPECT_EQ(1u, solver.getIncrementalStatistics().numFactorizations);
+    EXPECT_EQ(1u, solver.getIncrementalStatistics().numUpdates);
+    std::size_t numAdded = 0;
+    for (std::size_t i = first.size(); i < errs.size(); ++i)
+      numAdded += errs[i]->dimension();
+    EXPECT_EQ(numAdded, solver.getIncrementalStatistics().numRowsAdded);
+    EXPECT_EQ(1u, solver.numSymbolicAnalyses());
+    // Only the Jacobians of the appended error terms were evaluated
+    EXPECT_EQ(errs.size() - first.size(), solver.getRelinearizationStatistics().numEvaluated);
+    EXPECT_EQ(first.size(), solver.getRelinearizationStatistics().numSkipped);
+
+    // Nothing new, the factor is reused
+    solve(errs);
+    EXPECT_EQ(1u, solver.getIncrementalStatistics().numReuses);
+
+    // A small step keeps the factor, a large one refactorizes
+    const Eigen::Vector2d small(0.05, 0.0), large(0.2, 0.0);
+    dvs[0]->update(small.data(), 2);
+    solve(errs);
+    EXPECT_EQ(2u, solver.getIncrementalStatistics().numReuses);
+    dvs[0]->update(large.data(), 2);
+    ASSERT_DOUBLE_MX_EQ(solveFull(errs), solve(errs), 1e-8, "Checking the refactorization");
+    EXPECT_EQ(2u, solver.getIncrementalStatistics().numFactorizations);
+    EXPECT_EQ(2u, solver.numSymbolicAnalyses());
+
+    // Error terms that are not appended to the factored ones need a new factorization
+    ASSERT_DOUBLE_MX_EQ(solveFull(first), solve(first), 1e-8, "Checking the removal of error terms");
+    EXPECT_EQ(3u, solver.getIncrementalStatistics().numFactorizations);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+  deleteSystem(dvs, errs);
+}
+
+TEST(LinearSolverTestSuite, testSparseQRQless)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  buildSystem(4, 20, dvs, errs);
+  try {
+    SparseCholeskyLinearSystemSolver reference;
+    reference.initMatrixStructure(dvs, errs, false);
+    reference.evaluateError(1, false);
+    reference.buildSystem(1, false);
+    Eigen::VectorXd dxReference;
+    ASSERT_TRUE(reference.solveSystem(dxReference));
+
+    for (bool qLess : {false, true}) {
+      SCOPED_TRACE(::testing::Message() << "Q-less " << qLess);
+      SparseQRLinearSolverOptions options;
+      options.qLess = qLess;
+      SparseQrLinearSystemSolver solver(options);
+      solver.initMatrixStructure(dvs, errs, false);
+      // The second solve reuses the symbolic analysis and the transposed Jacobian
+      for (int i = 0; i < 2; ++i) {
+        solver.evaluateError(1, false);
+        solver.buildSystem(1, false);
+        Eigen::VectorXd dx;
+        ASSERT_TRUE(solver.solveSystem(dx));
+        ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-6, "Checking the QR solution");
+        EXPECT_EQ((SparseQrLinearSystemSolver::index_t)solver.JCols(), solver.getRank());
+      }
+      if (qLess) {
+        EXPECT_ANY_THROW(solver.getPermutationVector());
+      }
+    }
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+  deleteSystem(dvs, errs);
+}
+
+TEST(LinearSolverTestSuite, testBlockCholeskyChunkedBuild)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  buildSystem(8, 40, dvs, errs);
+  try {
+    SparseCholeskyLinearSystemSolver reference;
+    reference.initMatrixStructure(dvs, errs, true);
+    reference.setConstantConditioner(1e-3);
+    reference.evaluateError(1, false);
+    reference.buildSystem(1, false);
+    Eigen::VectorXd dxReference;
+    ASSERT_TRUE(reference.solveSystem(dxReference));
+
+    BlockCholeskyLinearSolverOptions options;
+    options.chunkSize = 3;
+    BlockCholeskyLinearSystemSolver block("cholesky", options);
+    block.initMatrixStructure(dvs, errs, true);
+    block.setConstantConditioner(1e-3);
+    // Fewer threads after more threads must not pick up stale partial Hessians
+    for (size_t nThreads : {4u, 2u, 1u}) {
+      SCOPED_TRACE(::testing::Message() << nThreads << " threads");
+      block.evaluateError(nThreads, false);
+      block.buildSystem(nThreads, false);
+      ASSERT_DOUBLE_MX_EQ(reference.rhs(), block.rhs(), 1e-6, "Checking the right-hand side");
+      Eigen::VectorXd dx;
+      ASSERT_TRUE(block.solveSystem(dx));
+      ASSERT_DOUBLE_MX_EQ(dxReference, dx, 1e-6, "Checking the solution");
+    }
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+  deleteSystem(dvs, errs);
+}
@@ -80,3 +80,85 @@ TEST(ProbDataAssocPolicyTestSuite, callbackTest) {
     }
   }
 }
+
+TEST(ProbDataAssocPolicyTestSuite, flatGroupsThreadedTest) {
+  // Groups of 0 to 5 error terms, stored flat
+  std::vector<ProbDataAssocPolicy::ErrorTermPtr> error_terms;
+  std::vector<ProbDataAssocPolicy::ErrorTermPtr> reference_error_terms;
+  std::vector<std::size_t> group_offsets = {0};
+  ProbDataAssocPolicy::ErrorTermGroups reference_groups(
+      new std::vector<ProbDataAssocPolicy::ErrorTermGroup>);
+  for (int g = 0; g < 50; g++) {
+    reference_groups->push_back(
+        boost::make_shared<std::vector<ProbDataAssocPolicy::ErrorTermPtr>>());
+    for (int i = 0; i < g % 6; i++) {
+      const double error = 0.1 * (g + i);
+      ProbDataAssocPolicy::ErrorTermPtr err(new DummyError(error));
+      err->setMEstimatorPolicy(boost::make_shared<FixedWeightMEstimator>(1));
+      error_terms.push_back(err);
+      ProbDataAssocPolicy::ErrorTermPtr reference_err(new DummyError(error));
+      reference_err->setMEstimatorPolicy(
+          boost::make_shared<FixedWeightMEstimator>(1));
+      reference_groups->back()->push_back(reference_err);
+      reference_error_terms.push_back(reference_err);
+    }
+    group_offsets.push_back(error_terms.size());
+  }
+
+  ProbDataAssocPolicy reference_policy(reference_groups, 2);
+  reference_policy.callback();
+  ProbDataAssocPolicy policy(error_terms, group_offsets, 2, 4);
+  EXPECT_EQ(50u, policy.numGroups());
+  policy.callback();
+
+  ASSERT_EQ(reference_error_terms.size(), error_terms.size());
+  for (std::size_t i = 0; i < error_terms.size(); i++) {
+    EXPECT_DOUBLE_EQ(reference_error_terms[i]->getCurrentMEstimatorWeight(),
+                     error_terms[i]->getCurrentMEstimatorWeight());
+  }
+
+  // Offsets not covering all error terms are rejected
+  group_offsets.back()--;
+  EXPECT_ANY_THROW(ProbDataAssocPolicy(error_terms, group_offsets, 2));
+}
+
+TEST(ProbDataAssocPolicyTestSuite, groupsChangedAfterConstructionTest) {
+  ProbDataAssocPolicy::ErrorTermGroups error_groups(
+      new std::vector<ProbDataAssocPolicy::ErrorTermGroup>);
+  error_groups->push_back(
+      boost::make_shared<std::vector<ProbDataAssocPolicy::ErrorTermPtr>>());
+  for (int i = 0; i < 2; i++) {
+    ProbDataAssocPolicy::ErrorTermPtr err(new DummyError(1));
+    err->setMEstimatorPolicy(boost::make_shared<FixedWeightMEstimator>(1));
+    error_groups->back()->push_back(err);
+  }
+  ProbDataAssocPolicy policy(error_groups, 1);
+
+  // An error term added to a group and a replaced M-estimator are both used
+  ProbDataAssocPolicy::ErrorTermPtr added(new DummyError(1));
+  added->setMEstimatorPolicy(boost::make_shared<FixedWeightMEstimator>(1));
+  error_groups->back()->push_back(added);
+  error_groups->back()->front()->setMEstimatorPolicy(
+      boost::make_shared<FixedWeightMEstimator>(1));
+  policy.markGroupsChanged();
+  policy.callback();
+  for (ProbDataAssocPolicy::ErrorTermPtr error_term : *error_groups->back()) {
+    EXPECT_NEAR(-1.09861228866811, error_term->getCurrentMEstimatorWeight(),
+                1e-6);
+  }
+
+  // So is a new group
+  error_groups->push_back(
+      boost::make_shared<std::vector<ProbDataAssocPolicy::ErrorTermPtr>>(
+          1, ProbDataAssocPolicy::ErrorTermPtr(new DummyError(2))));
+  error_groups->back()->front()->setMEstimatorPolicy(
+      boost::make_shared<FixedWeightMEstimator>(1));
+  // The cached layout is kept until the change is marked
+  policy.callback();
+  EXPECT_EQ(1u, policy.numGroups());
+  policy.markGroupsChanged();
+  policy.callback();
+  EXPECT_EQ(2u, policy.numGroups());
+  EXPECT_NEAR(0, error_groups->back()->front()->getCurrentMEstimatorWeight(),
+              1e-6);
+}
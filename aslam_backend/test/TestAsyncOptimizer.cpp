@@ -0,0 +1,133 @@
+#include <sm/eigen/gtest.hpp>
+#include <aslam/backend/AsyncOptimizer.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/OptimizerBFGS.hpp>
+#include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
+#include <aslam/backend/test/SampleDvAndError.hpp>
+
+using namespace aslam::backend;
+
+namespace {
+  boost::shared_ptr<Optimizer2> buildOptimizer2(const boost::shared_ptr<OptimizationProblem>& problem)
+  {
+    Optimizer2Options options;
+    options.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+    options.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy());
+    options.maxIterations = 20;
+    options.verbose = false;
+    boost::shared_ptr<Optimizer2> optimizer(new Optimizer2(options));
+    optimizer->setProblem(problem);
+    return optimizer;
+  }
+
+  double totalError(OptimizationProblem& problem)
+  {
+    double error = 0.0;
+    for (size_t j = 0; j < problem.numErrorTerms(); ++j)
+      error += problem.errorTerm(j)->evaluateError();
+    return error;
+  }
+} // namespace
+
+TEST(AsyncOptimizerTestSuite, testFinishesLikeOptimize)
+{
+  try {
+    boost::shared_ptr<OptimizationProblem> baselineProblem = buildProblem(3, 4, 20);
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(3, 4, 20);
+    buildOptimizer2(baselineProblem)->optimize();
+
+    AsyncOptimizer runner(buildOptimizer2(problem));
+    EXPECT_FALSE(runner.getLatestSnapshot());
+    runner.start();
+    const AsyncOptimizer::Result result = runner.wait();
+    EXPECT_FALSE(runner.isRunning());
+    EXPECT_TRUE(result.outcome == AsyncOptimizer::Outcome::FINISHED);
+    EXPECT_FALSE(result.status.failure());
+    EXPECT_NEAR(totalError(*baselineProblem), totalError(*problem), 1e-8);
+
+    // The final state has been published
+    boost::shared_ptr<const AsyncOptimizer::Snapshot> snapshot = runner.getLatestSnapshot();
+    ASSERT_TRUE(snapshot != nullptr);
+    const std::vector<DesignVariable*>& dvs = runner.optimizer()->getDesignVariables();
+    ASSERT_EQ(dvs.size(), snapshot->parameters.size());
+    for (size_t i = 0; i < dvs.size(); ++i)
+      sm::eigen::assertEqual(dvs[i]->getParameters(), snapshot->parameters[i], SM_SOURCE_FILE_POS);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(AsyncOptimizerTestSuite, testDeadlineRestoresLastAcceptedState)
+{
+  try {
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(4, 4, 20);
+    boost::shared_ptr<OptimizerBFGS> optimizer(new OptimizerBFGS());
+    optimizer->setProblem(problem);
+
+    AsyncOptimizer runner(optimizer);
+    runner.start(1e-9);
+    const AsyncOptimizer::Result result = runner.wait();
+    EXPECT_TRUE(result.outcome == AsyncOptimizer::Outcome::DEADLINE_REACHED);
+
+    // No iteration finished, so the design variables are back at the initial state
+    boost::shared_ptr<const AsyncOptimizer::Snapshot> snapshot = runner.getLatestSnapshot();
+    ASSERT_TRUE(snapshot != nullptr);
+    EXPECT_EQ(0u, snapshot->numIterations);
+    const std::vector<DesignVariable*>& dvs = optimizer->getDesignVariables();
+    for (size_t i = 0; i < dvs.size(); ++i)
+      sm::eigen::assertEqual(dvs[i]->getParameters(), snapshot->parameters[i], SM_SOURCE_FILE_POS);
+
+    // Without a budget the same runner optimizes to the end
+    runner.start();
+    EXPECT_TRUE(runner.wait().outcome == AsyncOptimizer::Outcome::FINISHED);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(AsyncOptimizerTestSuite, testCancel)
+{
+  try {
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(5, 4, 20);
+    AsyncOptimizer runner(buildOptimizer2(problem));
+    runner.start();
+    runner.cancel();
+    const AsyncOptimizer::Result result = runner.wait();
+    // The optimization may have finished before it saw the request
+    EXPECT_TRUE(result.outcome == AsyncOptimizer::Outcome::CANCELLED || result.outcome == AsyncOptimizer::Outcome::FINISHED);
+
+    boost::shared_ptr<const AsyncOptimizer::Snapshot> snapshot = runner.getLatestSnapshot();
+    ASSERT_TRUE(snapshot != nullptr);
+    const std::vector<DesignVariable*>& dvs = runner.optimizer()->getDesignVariables();
+    for (size_t i = 0; i < dvs.size(); ++i)
+      sm::eigen::assertEqual(dvs[i]->getParameters(), snapshot->parameters[i], SM_SOURCE_FILE_POS);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(AsyncOptimizerTestSuite, testOptimizerIsDetachedAfterRun)
+{
+  try {
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(6, 4, 20);
+    boost::shared_ptr<Optimizer2> optimizer = buildOptimizer2(problem);
+    AsyncOptimizer runner(optimizer);
+    runner.start(1e-9);
+    EXPECT_TRUE(runner.wait().outcome == AsyncOptimizer::Outcome::DEADLINE_REACHED);
+
+    // Neither the callbacks nor the expired token of the run are left behind
+    EXPECT_EQ(0u, optimizer->callback().numCallbacks(typeid(callback::event::ITERATION_START)));
+    EXPECT_EQ(0u, optimizer->callback().numCallbacks(typeid(callback::event::ITERATION_END)));
+    EXPECT_TRUE(optimizer->getSolver<LinearSystemSolver>()->getCancellationToken() == nullptr);
+
+    // A direct optimization runs to the end and does not publish snapshots
+    boost::shared_ptr<const AsyncOptimizer::Snapshot> snapshot = runner.getLatestSnapshot();
+    optimizer->optimize();
+    EXPECT_FALSE(optimizer->getStatus().failure());
+    EXPECT_LT(0u, optimizer->getStatus().numIterations);
+    EXPECT_EQ(snapshot, runner.getLatestSnapshot());
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
@@ -0,0 +1,95 @@
+#include <sm/eigen/gtest.hpp>
+#include <aslam/backend/BatchOptimizer.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
+#include <aslam/backend/OptimizationProblem.hpp>
+#include <aslam/backend/test/SampleDvAndError.hpp>
+
+using namespace aslam::backend;
+
+namespace {
+  /// \brief Problems of two structures, interleaved
+  BatchOptimizer::Problems buildBatch() {
+    BatchOptimizer::Problems problems;
+    for (int seed = 1; seed <= 6; ++seed)
+      problems.push_back(buildProblem(seed, seed % 2 ? 4 : 5, 20));
+    return problems;
+  }
+
+  Optimizer2Options batchOptions() {
+    Optimizer2Options options;
+    options.maxIterations = 20;
+    options.convergenceDeltaX = 1e-9;
+    options.convergenceDeltaError = 1e-12;
+    return options;
+  }
+} // namespace
+
+TEST(BatchOptimizerTestSuite, testOptimizeBatch)
+{
+  try {
+    Optimizer2Options options = batchOptions();
+    options.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+    EXPECT_ANY_THROW(BatchOptimizer optimizer(options));
+    options.linearSystemSolver.reset();
+
+    BatchOptimizer optimizer(options, 3);
+    EXPECT_EQ(1u, optimizer.getOptions().numThreadsJacobian);
+    EXPECT_EQ(1u, optimizer.getOptions().numThreadsError);
+    EXPECT_TRUE(optimizer.optimize(BatchOptimizer::Problems()).empty());
+
+    BatchOptimizer::Problems problems = buildBatch();
+    const std::vector<OptimizerStatus> statuses = optimizer.optimize(problems);
+    ASSERT_EQ(problems.size(), statuses.size());
+
+    // Every problem has the result of optimizing it alone
+    BatchOptimizer::Problems reference = buildBatch();
+    for (std::size_t i = 0; i < problems.size(); ++i) {
+      Optimizer2Options referenceOptions = batchOptions();
+      referenceOptions.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+      referenceOptions.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy());
+      Optimizer2 referenceOptimizer(referenceOptions);
+      referenceOptimizer.setProblem(reference[i]);
+      referenceOptimizer.optimize();
+
+      EXPECT_TRUE(statuses[i].success()) << "problem " << i;
+      EXPECT_EQ(referenceOptimizer.getStatus().numIterations, statuses[i].numIterations) << "problem " << i;
+      EXPECT_NEAR(referenceOptimizer.getStatus().error, statuses[i].error, 1e-8) << "problem " << i;
+      ASSERT_EQ(reference[i]->numDesignVariables(), problems[i]->numDesignVariables());
+      for (std::size_t j = 0; j < problems[i]->numDesignVariables(); ++j) {
+        sm::eigen::assertNear(static_cast<Point2d*>(reference[i]->designVariable(j))->_v,
+                              static_cast<Point2d*>(problems[i]->designVariable(j))->_v, 1e-8, SM_SOURCE_FILE_POS);
+      }
+    }
+
+    // A missing problem is rejected before anything is optimized
+    problems.push_back(BatchOptimizer::Problems::value_type());
+    EXPECT_ANY_THROW(optimizer.optimize(problems));
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(BatchOptimizerTestSuite, testReuseSymbolicAnalysis)
+{
+  try {
+    boost::shared_ptr<SparseCholeskyLinearSystemSolver> solver(new SparseCholeskyLinearSystemSolver());
+    Optimizer2Options options = batchOptions();
+    options.linearSystemSolver = solver;
+    options.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy());
+    BatchOptimizer optimizer([options]() { return boost::shared_ptr<OptimizerProblemManagerBase>(new Optimizer2(options)); }, options, 1);
+
+    // The problems are grouped by structure, so the single worker analyzes each structure once
+    const std::vector<OptimizerStatus> statuses = optimizer.optimize(buildBatch());
+    for (const OptimizerStatus& status : statuses)
+      EXPECT_TRUE(status.success());
+    EXPECT_EQ(2u, solver->numSymbolicAnalyses());
+
+    // The last structure of the previous batch is not the first one of this batch
+    optimizer.optimize(buildBatch());
+    EXPECT_EQ(4u, solver->numSymbolicAnalyses());
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
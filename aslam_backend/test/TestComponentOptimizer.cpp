@@ -0,0 +1,132 @@
+#include <sm/eigen/gtest.hpp>
+#include <aslam/backend/ComponentOptimizer.hpp>
+#include <aslam/backend/ProblemDecomposition.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/OptimizationProblem.hpp>
+#include <aslam/backend/test/SampleDvAndError.hpp>
+
+using namespace aslam::backend;
+
+namespace {
+  /// \brief Two chains of points connected only through the inactive point p[4], p[5] has no error terms
+  struct TwoComponentProblem {
+    std::vector< boost::shared_ptr<Point2d> > p;
+    std::vector< boost::shared_ptr<ErrorTerm> > e;
+    boost::shared_ptr<OptimizationProblem> problem;
+
+    TwoComponentProblem() : problem(new OptimizationProblem) {
+      sm::random::seed(7);
+      for (int i = 0; i < 6; ++i) {
+        p.emplace_back(new Point2d(Eigen::Vector2d::Random()));
+        problem->addDesignVariable(p.back());
+      }
+      e.emplace_back(new LinearErr(p[0].get()));
+      e.emplace_back(new LinearErr2(p[0].get(), p[1].get()));
+      e.emplace_back(new LinearErr(p[2].get()));
+      e.emplace_back(new LinearErr(p[1].get()));
+      e.emplace_back(new LinearErr2(p[2].get(), p[3].get()));
+      e.emplace_back(new LinearErr(p[3].get()));
+      e.emplace_back(new LinearErr2(p[1].get(), p[4].get()));
+      e.emplace_back(new LinearErr2(p[3].get(), p[4].get()));
+      e.emplace_back(new LinearErr(p[4].get()));
+      for (auto& err : e)
+        problem->addErrorTerm(err);
+      for (auto& dv : p)
+        dv->setActive(true);
+      p[4]->setActive(false);
+    }
+
+    std::vector<Eigen::Vector2d> values() const {
+      std::vector<Eigen::Vector2d> v;
+      for (auto& dv : p)
+        v.push_back(dv->_v);
+      return v;
+    }
+
+    void setValues(const std::vector<Eigen::Vector2d>& v) {
+      for (std::size_t i = 0; i < p.size(); ++i)
+        p[i]->_v = p[i]->_p_v = v[i];
+    }
+  };
+} // namespace
+
+TEST(ComponentOptimizerTestSuite, testFindIndependentComponents)
+{
+  TwoComponentProblem pb;
+  auto components = findIndependentComponents(*pb.problem);
+  ASSERT_EQ(2u, components.size());
+
+  ASSERT_EQ(2u, components[0]->numDesignVariables());
+  EXPECT_EQ(pb.p[0].get(), components[0]->designVariable(0));
+  EXPECT_EQ(pb.p[1].get(), components[0]->designVariable(1));
+  ASSERT_EQ(4u, components[0]->numErrorTerms());
+  EXPECT_EQ(pb.e[0].get(), components[0]->errorTerm(0));
+  EXPECT_EQ(pb.e[1].get(), components[0]->errorTerm(1));
+  EXPECT_EQ(pb.e[3].get(), components[0]->errorTerm(2));
+  EXPECT_EQ(pb.e[6].get(), components[0]->errorTerm(3));
+
+  ASSERT_EQ(2u, components[1]->numDesignVariables());
+  EXPECT_EQ(pb.p[2].get(), components[1]->designVariable(0));
+  EXPECT_EQ(pb.p[3].get(), components[1]->designVariable(1));
+  EXPECT_EQ(4u, components[1]->numErrorTerms());
+
+  std::set<ErrorTerm*> errors;
+  components[0]->getErrors(pb.p[1].get(), errors);
+  EXPECT_EQ(3u, errors.size());
+
+  // The active point p[4] joins both chains
+  pb.p[4]->setActive(true);
+  components = findIndependentComponents(*pb.problem);
+  ASSERT_EQ(1u, components.size());
+  EXPECT_EQ(5u, components[0]->numDesignVariables());
+  EXPECT_EQ(9u, components[0]->numErrorTerms());
+}
+
+TEST(ComponentOptimizerTestSuite, testOptimizeComponents)
+{
+  try {
+    TwoComponentProblem pb;
+    const std::vector<Eigen::Vector2d> initial = pb.values();
+
+    Optimizer2Options options;
+    options.maxIterations = 20;
+    options.convergenceDeltaX = 1e-9;
+    options.convergenceDeltaError = 1e-12;
+    options.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+    EXPECT_ANY_THROW(ComponentOptimizer optimizer(options));
+    options.linearSystemSolver.reset();
+
+    // The reference result optimizes the whole problem at once, p[5] has no error terms and is left out
+    pb.p[5]->setActive(false);
+    Optimizer2 reference(options);
+    reference.setProblem(pb.problem);
+    reference.optimize();
+    const std::vector<Eigen::Vector2d> expected = pb.values();
+    pb.p[5]->setActive(true);
+
+    pb.setValues(initial);
+    ComponentOptimizer optimizer(options, 2);
+    optimizer.setProblem(pb.problem);
+    optimizer.optimize();
+    ASSERT_EQ(2u, optimizer.numComponents());
+    EXPECT_EQ(4u, optimizer.getDesignVariables().size());
+
+    const ComponentOptimizer::Status& status = optimizer.getStatus();
+    EXPECT_TRUE(status.success());
+    EXPECT_EQ(2u, status.numComponents);
+    EXPECT_EQ(2u, status.numComponentsConverged);
+    EXPECT_EQ(0u, status.numComponentsFailed);
+    // The error term on the inactive point p[4] alone is a constant that belongs to no component
+    EXPECT_NEAR(reference.getStatus().error, status.error + pb.e[8]->evaluateError(), 1e-6);
+    EXPECT_EQ(std::max(optimizer.componentOptimizer(0).getStatus().numIterations,
+                       optimizer.componentOptimizer(1).getStatus().numIterations), status.numIterations);
+
+    const std::vector<Eigen::Vector2d> actual = pb.values();
+    for (std::size_t i = 0; i < actual.size(); ++i)
+      sm::eigen::assertNear(expected[i], actual[i], 1e-6, SM_SOURCE_FILE_POS);
+    sm::eigen::assertEqual(initial[5], actual[5], SM_SOURCE_FILE_POS);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
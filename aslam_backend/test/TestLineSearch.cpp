@@ -97,9 +97,9 @@ TEST(LineSearchTestSuite, testLineSearch)
 
     const double derror0 = ls.computeErrorDerivative();
 
-    enum LineSearchMethod { WOLFE1, WOLFE2, WOLFE12 };
+    enum LineSearchMethod { WOLFE1, WOLFE2, WOLFE12, WOLFE1_SPECULATIVE };
 
-    for ( auto& method : {WOLFE1, WOLFE2, WOLFE12} ) {
+    for ( auto& method : {WOLFE1, WOLFE2, WOLFE12, WOLFE1_SPECULATIVE} ) {
 
       bool success = true;
       double error1;
@@ -124,6 +124,11 @@ TEST(LineSearchTestSuite, testLineSearch)
             case WOLFE12:
               success &= ls.lineSearchWolfe12();
               break;
+            case WOLFE1_SPECULATIVE:
+              ls.options().numSpeculativeSteps = 4;
+              success &= ls.lineSearchWolfe1();
+              ls.options().numSpeculativeSteps = 0;
+              break;
           }
 
           EXPECT_TRUE(success);
@@ -0,0 +1,40 @@
+#include <sm/eigen/gtest.hpp>
+#include <aslam/backend/Marginalizer.hpp>
+#include <aslam/backend/test/SampleDvAndError.hpp>
+
+using namespace aslam::backend;
+
+TEST(MarginalizerTestSuite, testSchurComplementMatchesDenseQr)
+{
+  try {
+    sm::random::seed(42);
+    std::vector<DesignVariable*> dvs;
+    std::vector<ErrorTerm*> errs;
+    buildSystem(6, 30, dvs, errs);
+    const int numToRemove = 2;
+    const size_t numTopRowsInCov = 3;
+
+    boost::shared_ptr<MarginalizationPriorErrorTerm> priorQr, priorSchur;
+    Eigen::MatrixXd covQr, covSchur;
+    std::vector<DesignVariable*> dvsInCovQr, dvsInCovSchur;
+    marginalize(dvs, errs, numToRemove, false, priorQr, covQr, dvsInCovQr, numTopRowsInCov, 1, MarginalizationMethod::DenseQr);
+    marginalize(dvs, errs, numToRemove, false, priorSchur, covSchur, dvsInCovSchur, numTopRowsInCov, 3, MarginalizationMethod::SchurComplement);
+
+    ASSERT_EQ(priorQr->numDesignVariables(), priorSchur->numDesignVariables());
+    ASSERT_EQ(dvsInCovQr, dvsInCovSchur);
+    // The square roots may differ by an orthogonal transformation, the information and the cost may not.
+    const Eigen::MatrixXd& Rqr = priorQr->R();
+    const Eigen::MatrixXd& Rschur = priorSchur->R();
+    sm::eigen::assertNear(Rqr.transpose() * Rqr, Rschur.transpose() * Rschur, 1e-8, SM_SOURCE_FILE_POS);
+    sm::eigen::assertNear(Rqr.transpose() * priorQr->d(), Rschur.transpose() * priorSchur->d(), 1e-8, SM_SOURCE_FILE_POS);
+    EXPECT_NEAR(priorQr->evaluateError(), priorSchur->evaluateError(), 1e-8);
+    sm::eigen::assertNear(covQr, covSchur, 1e-8, SM_SOURCE_FILE_POS);
+
+    for (size_t i = 0; i < errs.size(); ++i)
+      delete errs[i];
+    for (size_t i = 0; i < dvs.size(); ++i)
+      delete dvs[i];
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
@@ -2,6 +2,13 @@
 #include <aslam/backend/OptimizationProblem.hpp>
 #include <aslam/backend/DesignVariable.hpp>
 #include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/ProblemSnapshot.hpp>
+#include <aslam/backend/MarginalizationPriorErrorTerm.hpp>
+#include <aslam/backend/OptimizerCallbackManager.hpp>
+#include <aslam/backend/test/SampleDvAndError.hpp>
+#include <aslam/backend/test/TemporaryDirectory.hpp>
+#include <boost/make_shared.hpp>
+#include <fstream>
 
 using namespace aslam::backend;
 
@@ -193,3 +200,139 @@ TEST(OptimizationProblemTestSuite,  testAddRemoveErrorTerm1)
   ASSERT_EQ(1, (int)et2.count(&et21));
   ASSERT_EQ(1, (int)et2.count(&et22));
 }
+
+namespace {
+
+  using aslam::backend::test::TemporaryDirectory;
+
+  bool fileExists(const std::string& fileName)
+  {
+    return std::ifstream(fileName).good();
+  }
+
+  void registerSnapshotTypes()
+  {
+    using namespace aslam::backend::snapshot;
+    ProblemSnapshot::registerDesignVariable<Point2d>("Point2d", [](const Eigen::MatrixXd& value) {
+      return boost::shared_ptr<DesignVariable>(new Point2d(value));
+    });
+    ProblemSnapshot::registerErrorTerm<LinearErr>("LinearErr",
+      [](const LinearErr& e, std::ostream& out) { writeMatrix(out, e._p); writeMatrix(out, e._J); },
+      [](std::istream& in, const std::vector<DesignVariable*>& dvs) {
+        boost::shared_ptr<LinearErr> e(new LinearErr(static_cast<Point2d*>(dvs[0])));
+        readMatrix(in, e->_p);
+        readMatrix(in, e->_J);
+        return e;
+      });
+    ProblemSnapshot::registerErrorTerm<LinearErr2>("LinearErr2",
+      [](const LinearErr2& e, std::ostream& out) { writeMatrix(out, e._p); writeMatrix(out, e._J1); writeMatrix(out, e._J2); },
+      [](std::istream& in, const std::vector<DesignVariable*>& dvs) {
+        boost::shared_ptr<LinearErr2> e(new LinearErr2(static_cast<Point2d*>(dvs[0]), static_cast<Point2d*>(dvs[1])));
+        readMatrix(in, e->_p);
+        readMatrix(in, e->_J1);
+        readMatrix(in, e->_J2);
+        return e;
+      });
+    ProblemSnapshot::registerErrorTerm<LinearErr3>("LinearErr3",
+      [](const LinearErr3& e, std::ostream& out) { writeMatrix(out, e._p); writeMatrix(out, e._J1); writeMatrix(out, e._J2); writeMatrix(out, e._J3); },
+      [](std::istream& in, const std::vector<DesignVariable*>& dvs) {
+        boost::shared_ptr<LinearErr3> e(new LinearErr3(static_cast<Point2d*>(dvs[0]), static_cast<Point2d*>(dvs[1]), static_cast<Point2d*>(dvs[2])));
+        readMatrix(in, e->_p);
+        readMatrix(in, e->_J1);
+        readMatrix(in, e->_J2);
+        readMatrix(in, e->_J3);
+        return e;
+      });
+  }
+
+}
+
+TEST(OptimizationProblemTestSuite, testSnapshotRoundTrip)
+{
+  try {
+    registerSnapshotTypes();
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(7, 5, 12);
+    std::vector<DesignVariable*> priorDvs = { problem->designVariable(0), problem->designVariable(1) };
+    problem->addErrorTerm(boost::shared_ptr<ErrorTerm>(new MarginalizationPriorErrorTerm(priorDvs, Eigen::VectorXd::Random(3), Eigen::MatrixXd::Random(3, 4))));
+    problem->errorTerm(1)->setMEstimatorPolicy(boost::make_shared<CauchyMEstimator>(2.5));
+    problem->designVariable(2)->setActive(false);
+    problem->designVariable(3)->setScaling(0.5);
+
+    TemporaryDirectory directory;
+    const std::string fileName = directory.file("testSnapshotRoundTrip.snapshot");
+    problem->save(fileName);
+
+    OptimizationProblem loaded;
+    loaded.load(fileName);
+    ASSERT_EQ(problem->numDesignVariables(), loaded.numDesignVariables());
+    ASSERT_EQ(problem->numErrorTerms(), loaded.numErrorTerms());
+    for (size_t i = 0; i < problem->numDesignVariables(); ++i) {
+      EXPECT_TRUE(problem->designVariable(i)->getParameters() == loaded.designVariable(i)->getParameters());
+      EXPECT_EQ(problem->designVariable(i)->isActive(), loaded.designVariable(i)->isActive());
+      EXPECT_EQ(problem->designVariable(i)->scaling(), loaded.designVariable(i)->scaling());
+    }
+    for (size_t i = 0; i < problem->numErrorTerms(); ++i) {
+      ErrorTerm* expected = problem->errorTerm(i);
+      ErrorTerm* actual = loaded.errorTerm(i);
+      ASSERT_EQ(typeid(*expected), typeid(*actual));
+      EXPECT_NEAR(expected->evaluateError(), actual->evaluateError(), 1e-9);
+      EXPECT_EQ(expected->getMEstimatorName(), actual->getMEstimatorName());
+      sm::eigen::assertNear(expected->vsInvR(), actual->vsInvR(), 1e-9, SM_SOURCE_FILE_POS);
+    }
+
+    // Only restore the parameters into the already loaded problem
+    loaded.designVariable(4)->setParameters(Eigen::Vector2d::Zero());
+    loaded.loadParameters(fileName);
+    EXPECT_TRUE(problem->designVariable(4)->getParameters() == loaded.designVariable(4)->getParameters());
+
+    OptimizationProblem empty;
+    EXPECT_ANY_THROW(empty.loadParameters(fileName));
+  }
+  catch(const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(OptimizationProblemTestSuite, testCheckpointCallback)
+{
+  try {
+    registerSnapshotTypes();
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(3, 4, 8);
+    TemporaryDirectory directory;
+    const std::string fileName = directory.file("testCheckpointCallback.snapshot");
+
+    callback::Manager callbacks;
+    EXPECT_ANY_THROW(ProblemSnapshot::addCheckpointCallback(callbacks, *problem, fileName, 0));
+    callback::OptimizerCallback checkpoint = ProblemSnapshot::addCheckpointCallback(callbacks, *problem, fileName, 3);
+    EXPECT_EQ(1u, callbacks.numCallbacks(typeid(callback::event::ITERATION_END)));
+
+    // Only every third iteration end writes a checkpoint
+    callbacks.issueCallback(callback::event::ITERATION_START());
+    callbacks.issueCallback(callback::event::ITERATION_END());
+    callbacks.issueCallback(callback::event::ITERATION_END());
+    EXPECT_FALSE(fileExists(fileName));
+    const Eigen::MatrixXd checkpointed = problem->designVariable(0)->getParameters();
+    callbacks.issueCallback(callback::event::ITERATION_END());
+    ASSERT_TRUE(fileExists(fileName));
+
+    // The checkpoint holds the state at the third iteration
+    problem->designVariable(0)->setParameters(Eigen::Vector2d::Zero());
+    callbacks.issueCallback(callback::event::ITERATION_END());
+    callbacks.issueCallback(callback::event::ITERATION_END());
+    problem->loadParameters(fileName);
+    EXPECT_TRUE(checkpointed == problem->designVariable(0)->getParameters());
+
+    // The sixth iteration end overwrites it
+    problem->designVariable(0)->setParameters(Eigen::Vector2d::Zero());
+    callbacks.issueCallback(callback::event::ITERATION_END());
+    problem->designVariable(0)->setParameters(Eigen::Vector2d::Ones());
+    problem->loadParameters(fileName);
+    EXPECT_TRUE(Eigen::Vector2d::Zero() == problem->designVariable(0)->getParameters());
+
+    callbacks.remove(typeid(callback::event::ITERATION_END), checkpoint);
+    EXPECT_EQ(0u, callbacks.numCallbacks(typeid(callback::event::ITERATION_END)));
+  }
+  catch(const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
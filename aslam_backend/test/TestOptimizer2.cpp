@@ -8,10 +8,15 @@
 #include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/BlockCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/DenseQrLinearSystemSolver.hpp>
+#include <aslam/backend/DenseCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/LineSearchTrustRegionPolicy.hpp>
 #include <aslam/backend/SparseQrLinearSystemSolver.hpp>
+#include <aslam/backend/LinearSystemCapture.hpp>
+#include <aslam/backend/GaussNewtonTrustRegionPolicy.hpp>
+#include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <aslam/backend/test/ErrorTermTester.hpp>
+#include <aslam/backend/test/TemporaryDirectory.hpp>
 
 #include <aslam/backend/test/SampleDvAndError.hpp>
 
@@ -29,6 +34,7 @@ TEST(Optimizer2TestSuite, compareAllCombinationsOfSolversAndTrustRegionPolicies)
     solvers.emplace_back(new SparseCholeskyLinearSystemSolver());
     solvers.emplace_back(new SparseQrLinearSystemSolver());
     solvers.emplace_back(new DenseQrLinearSystemSolver());
+    solvers.emplace_back(new DenseCholeskyLinearSystemSolver());
 
     std::vector<boost::shared_ptr<TrustRegionPolicy>> policies;
     policies.emplace_back(new DogLegTrustRegionPolicy());
@@ -74,3 +80,213 @@ TEST(Optimizer2TestSuite, compareAllCombinationsOfSolversAndTrustRegionPolicies)
     FAIL() << e.what();
   }
 }
+
+template <typename Solver>
+void testSpeculativeLevenbergMarquardt()
+{
+  using namespace aslam::backend;
+  try {
+    boost::shared_ptr<OptimizationProblem> baselineProblem = buildProblem(2, 4, 20);
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(2, 4, 20);
+
+    Optimizer2Options options;
+    options.linearSystemSolver.reset(new Solver());
+    options.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy(10.0));
+    options.maxIterations = 50;
+    options.convergenceDeltaError = 1e-12;
+    options.convergenceDeltaX = 1e-12;
+    options.verbose = false;
+    Optimizer2 baseline(options);
+    baseline.setProblem(baselineProblem);
+    baseline.optimize();
+
+    boost::shared_ptr<LevenbergMarquardtTrustRegionPolicy> policy(new LevenbergMarquardtTrustRegionPolicy(10.0));
+    policy->setNumSpeculativeSteps(4);
+    options.linearSystemSolver.reset(new Solver());
+    options.trustRegionPolicy = policy;
+    Optimizer2 optimizer(options);
+    optimizer.setProblem(problem);
+    optimizer.optimize();
+
+    const LevenbergMarquardtTrustRegionPolicy::SpeculationStatistics& stats = policy->getSpeculationStatistics();
+    EXPECT_LT(0u, stats.numRounds);
+    // Only rounds in which the current damping got rejected try further dampings
+    EXPECT_LE(stats.numRounds, stats.numEvaluatedSteps);
+    EXPECT_LE(stats.numEvaluatedSteps, stats.numRounds + 3 * stats.numOtherStepChosen);
+    EXPECT_LE(stats.numPaidOff + stats.numAllRejected, stats.numRounds);
+    EXPECT_LE(stats.numPaidOff, stats.numOtherStepChosen);
+    // The cost of every proposed step is reused instead of evaluated again
+    EXPECT_EQ(1 + stats.numEvaluatedSteps, optimizer.getStatus().numErrorEvaluations);
+    // Both reach the minimum of the linear problem
+    double baselineError = 0.0, error = 0.0;
+    for (size_t j = 0; j < problem->numErrorTerms(); ++j) {
+      baselineError += baselineProblem->errorTerm(j)->evaluateError();
+      error += problem->errorTerm(j)->evaluateError();
+    }
+    EXPECT_NEAR(baselineError, error, 1e-6);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, speculativeLevenbergMarquardt)
+{
+  testSpeculativeLevenbergMarquardt<aslam::backend::SparseCholeskyLinearSystemSolver>();
+}
+
+// The QR solvers solve with the error vector of the linearization point, which must survive the speculative steps
+TEST(Optimizer2TestSuite, speculativeLevenbergMarquardtSparseQr)
+{
+  testSpeculativeLevenbergMarquardt<aslam::backend::SparseQrLinearSystemSolver>();
+}
+
+TEST(Optimizer2TestSuite, speculativeLevenbergMarquardtDenseQr)
+{
+  testSpeculativeLevenbergMarquardt<aslam::backend::DenseQrLinearSystemSolver>();
+}
+
+TEST(Optimizer2TestSuite, speculativeLineSearch)
+{
+  using namespace aslam::backend;
+  try {
+    boost::shared_ptr<OptimizationProblem> baselineProblem = buildProblem(2, 4, 20);
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(2, 4, 20);
+
+    Optimizer2Options options;
+    options.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+    options.trustRegionPolicy.reset(new LineSearchTrustRegionPolicy());
+    options.maxIterations = 20;
+    options.verbose = false;
+    Optimizer2 baseline(options);
+    baseline.setProblem(baselineProblem);
+    baseline.optimize();
+
+    boost::shared_ptr<LineSearchTrustRegionPolicy> policy(new LineSearchTrustRegionPolicy());
+    policy->setNumSpeculativeSteps(3);
+    options.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+    options.trustRegionPolicy = policy;
+    Optimizer2 optimizer(options);
+    optimizer.setProblem(problem);
+    optimizer.optimize();
+
+    const LineSearchTrustRegionPolicy::SpeculationStatistics& stats = policy->getSpeculationStatistics();
+    EXPECT_LT(0u, stats.numRounds);
+    // Only rounds in which the current scale got rejected try smaller ones
+    EXPECT_LE(stats.numRounds, stats.numEvaluatedSteps);
+    EXPECT_LE(stats.numEvaluatedSteps, stats.numRounds + 2 * stats.numOtherStepChosen);
+    EXPECT_LE(stats.numPaidOff + stats.numAllRejected, stats.numRounds);
+    EXPECT_LE(stats.numPaidOff, stats.numOtherStepChosen);
+    // The cost of every proposed step is reused instead of evaluated again
+    EXPECT_EQ(1 + stats.numEvaluatedSteps, optimizer.getStatus().numErrorEvaluations);
+    double baselineError = 0.0, error = 0.0;
+    for (size_t j = 0; j < problem->numErrorTerms(); ++j) {
+      baselineError += baselineProblem->errorTerm(j)->evaluateError();
+      error += problem->errorTerm(j)->evaluateError();
+    }
+    EXPECT_NEAR(baselineError, error, 1e-6);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, captureAndReplayLinearSystems)
+{
+  using namespace aslam::backend;
+  try {
+    aslam::backend::test::TemporaryDirectory directory;
+    const std::string fileName = directory.file("captureAndReplayLinearSystems.capture");
+    {
+      boost::shared_ptr<CapturingLinearSystemSolver> capture(new CapturingLinearSystemSolver(boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), fileName));
+      Optimizer2Options options;
+      options.linearSystemSolver = capture;
+      options.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy());
+      options.maxIterations = 5;
+      options.verbose = false;
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(buildProblem(3, 4, 20));
+      optimizer.optimize();
+      ASSERT_LT(0u, capture->numCapturedSystems());
+    }
+
+    LinearSystemReplay replay(fileName);
+    EXPECT_LT(0u, replay.numSystems());
+    std::vector<boost::shared_ptr<LinearSystemSolver>> solvers;
+    solvers.emplace_back(new SparseCholeskyLinearSystemSolver());
+    solvers.emplace_back(new BlockCholeskyLinearSystemSolver());
+    solvers.emplace_back(new DenseQrLinearSystemSolver());
+    for (const boost::shared_ptr<LinearSystemSolver>& solver : solvers) {
+      SCOPED_TRACE(solver->name());
+      std::vector<LinearSystemReplay::SolveResult> results = replay.replay(solver);
+      ASSERT_EQ(replay.numSolves(), results.size());
+      for (const LinearSystemReplay::SolveResult& r : results) {
+        EXPECT_TRUE(r.success);
+        EXPECT_LT(r.relativeResidual, 1e-6);
+        EXPECT_LT(r.relativeDifference, 1e-6);
+      }
+    }
+
+    // The linear model is minimized by a single Gauss-Newton step
+    GaussNewtonTrustRegionPolicy gaussNewton;
+    std::vector<LinearSystemReplay::PolicyResult> results = replay.replay(gaussNewton, boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), 1);
+    ASSERT_EQ(replay.numSystems(), results.size());
+    for (const LinearSystemReplay::PolicyResult& r : results) {
+      EXPECT_LE(r.finalCost, r.initialCost);
+      EXPECT_EQ(0u, r.numFailedIterations);
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, memoryStatistics)
+{
+  using namespace aslam::backend;
+  try {
+    std::vector<boost::shared_ptr<LinearSystemSolver>> solvers;
+    solvers.emplace_back(new SparseCholeskyLinearSystemSolver());
+    solvers.emplace_back(new SparseQrLinearSystemSolver());
+    solvers.emplace_back(new BlockCholeskyLinearSystemSolver());
+    solvers.emplace_back(new DenseCholeskyLinearSystemSolver());
+    solvers.emplace_back(new DenseQrLinearSystemSolver());
+    for (const boost::shared_ptr<LinearSystemSolver>& solver : solvers) {
+      SCOPED_TRACE(solver->name());
+      Optimizer2Options options;
+      options.linearSystemSolver = solver;
+      options.maxIterations = 3;
+      options.verbose = false;
+      Optimizer2 optimizer(options);
+      boost::shared_ptr<OptimizationProblem> problem = buildProblem(5, 4, 20);
+      const MemoryEstimate estimateWithBlockIndices = estimateMemoryUsage(*problem);
+      // The estimate only needs the problem structure, the block indices are assigned by the solver later
+      for (size_t i = 0; i < problem->numDesignVariables(); ++i)
+        problem->designVariable(i)->setBlockIndex(-1);
+      optimizer.setProblem(problem);
+      const MemoryEstimate estimate = optimizer.estimateMemoryUsage();
+      EXPECT_EQ(estimateWithBlockIndices.hessianBlocks, estimate.hessianBlocks);
+      EXPECT_EQ(estimateWithBlockIndices.hessianNonZeros, estimate.hessianNonZeros);
+      EXPECT_EQ(4u * 2u, estimate.jacobianCols);
+      EXPECT_LT(0u, estimate.jacobianRows);
+      EXPECT_LE(estimate.jacobianNonZeros, estimate.jacobianRows * estimate.jacobianCols);
+      EXPECT_LE(estimate.hessianNonZeros, estimate.jacobianCols * (estimate.jacobianCols + 1) / 2);
+      EXPECT_LT(0u, estimate.forSolver(solver->name()));
+      EXPECT_ANY_THROW(estimate.forSolver("no_solver"));
+
+      optimizer.optimize();
+      EXPECT_EQ(estimate.jacobianRows, optimizer.getTotalDimSquaredErrorTerms());
+      const MemoryStatistics& memory = optimizer.getStatus().memory;
+      EXPECT_EQ(estimate.errorTerms, memory.errorTerms.current);
+      EXPECT_LT(0u, memory.jacobian.current + memory.hessian.current);
+      EXPECT_LT(0u, memory.factor.current);
+      EXPECT_LE(memory.current(), memory.peak());
+      if (solver->name() == "dense_qr") {
+        EXPECT_EQ(estimate.jacobianRows * estimate.jacobianCols * sizeof(double), memory.jacobian.current);
+      }
+      if (solver->name() == "dense_cholesky") {
+        // The Hessian and the partial Hessians of the build threads
+        EXPECT_LT(estimate.jacobianCols * estimate.jacobianCols * sizeof(double), memory.hessian.current);
+      }
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
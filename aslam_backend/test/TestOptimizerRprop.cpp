@@ -1,5 +1,6 @@
 #include <sm/eigen/gtest.hpp>
 #include <aslam/backend/OptimizerRprop.hpp>
+#include <aslam/backend/util/ProblemManager.hpp>
 #include <aslam/backend/OptimizationProblem.hpp>
 #include <aslam/backend/ErrorTerm.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
@@ -150,3 +151,71 @@ TEST(OptimizerRpropTestSuite, testRpropSquaredErrorTerms)
   }
 }
 
+
+TEST(OptimizerRpropTestSuite, testRpropMiniBatch)
+{
+  try {
+    using namespace aslam::backend;
+    boost::shared_ptr<OptimizationProblem> problem_ptr(new OptimizationProblem);
+    OptimizationProblem& problem = *problem_ptr;
+    const int P = 2;
+    const int E = 20;
+    // Add some design variables.
+    std::vector< boost::shared_ptr<Point2d> > p2d;
+    for (int p = 0; p < P; ++p) {
+      boost::shared_ptr<Point2d> point(new Point2d(Eigen::Vector2d::Random())); // random initialization of design variable
+      p2d.push_back(point);
+      problem.addDesignVariable(point);
+      point->setBlockIndex(p);
+      point->setActive(true);
+    }
+
+    // make a deep copy
+    std::vector< boost::shared_ptr<Point2d> > p2d0;
+    for (auto& dv : p2d) p2d0.emplace_back(new Point2d(*dv));
+
+    // Add some error terms.
+    for (int p = 0; p < P; ++p) {
+      for (int e = 0; e < E; ++e) {
+        boost::shared_ptr<LinearErr> err(new LinearErr(p2d[p].get()));
+        problem.addErrorTerm(err);
+      }
+    }
+
+    OptimizerRprop::Options options;
+    options.maxIterations = 1000;
+    options.numThreadsJacobian = 4;
+    options.miniBatchSize = 8;
+    options.miniBatchGrowth = 1.05;
+    options.miniBatchUniformMixing = 0.0;
+    EXPECT_ANY_THROW(options.check());
+    options.miniBatchUniformMixing = 0.2;
+    options.miniBatchGrowth = 0.9;
+    EXPECT_ANY_THROW(options.check());
+    options.miniBatchGrowth = 1.05;
+    EXPECT_NO_THROW(options.check());
+
+    for (MiniBatchSampler::Sampling sampling : {MiniBatchSampler::Sampling::UNIFORM, MiniBatchSampler::Sampling::IMPORTANCE}) {
+      // Converging on the mini-batches alone is never trusted, the last gradient is the full one
+      options.miniBatchSampling = sampling;
+      OptimizerRprop optimizer(options);
+      optimizer.setProblem(problem_ptr);
+      optimizer.initialize();
+      for (std::size_t i=0; i<p2d.size(); i++) p2d[i]->_v = p2d0[i]->_v;
+      SCOPED_TRACE("");
+      optimizer.optimize();
+      auto ret = optimizer.getStatus();
+      EXPECT_TRUE(ret.success());
+      EXPECT_LT(ret.gradientNorm, 1e-3);
+      EXPECT_LT(ret.maxDeltaX, 1e-3);
+
+      RowVectorType gradient;
+      ProblemManager pm(problem_ptr);
+      pm.computeGradient(gradient, 1, false, false, true);
+      EXPECT_LT(gradient.norm(), 1e-3);
+    }
+
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
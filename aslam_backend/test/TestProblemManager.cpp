@@ -1,6 +1,8 @@
 #include <sm/eigen/gtest.hpp>
 #include <string>
 #include <bitset>
+#include <numeric>
+#include <set>
 #include <aslam/backend/util/ProblemManager.hpp>
 #include <aslam/backend/JacobianContainerDense.hpp>
 #include <aslam/backend/JacobianContainerSparse.hpp>
@@ -105,7 +107,7 @@ TEST(OptimizationProblemTestSuite, testProblemManager)
     RowVectorType grad_expected = RowVectorType::Zero(pm.numOptParameters());
     grad_expected.segment(0, 2) = grad0;
     pm.addGradientForErrorTerm(grad, &err0, useMEstimator, useDenseJacobianContainer);
-    sm::eigen::assertEqual(grad_expected, grad, SM_SOURCE_FILE_POS, optStr);
+    sm::eigen::assertNear(grad_expected, grad, 1e-12, SM_SOURCE_FILE_POS, optStr); // the products are associated differently
 
     // Full gradient should now contain all error terms
     grad.setZero();
@@ -113,6 +115,160 @@ TEST(OptimizationProblemTestSuite, testProblemManager)
     grad_expected.segment(0, 2) = grad0;
     grad_expected.segment(2, 2) = grad1 + grad2;
     pm.computeGradient(grad, 1, useMEstimator, applyDvScaling, useDenseJacobianContainer);
-    sm::eigen::assertEqual(grad_expected, grad, SM_SOURCE_FILE_POS, optStr);
+    sm::eigen::assertNear(grad_expected, grad, 1e-12, SM_SOURCE_FILE_POS, optStr);
+  }
+}
+
+TEST(OptimizationProblemTestSuite, testAddWeightedGradient)
+{
+  Point2d dv0(Eigen::Vector2d::Random());
+  Point2d dv1(Eigen::Vector2d::Random());
+  Point2d dv2(Eigen::Vector2d::Random());
+  std::vector<Point2d*> dvs = {&dv0, &dv1, &dv2};
+  for (size_t i = 0; i < dvs.size(); ++i) {
+    dvs[i]->setBlockIndex(i);
+    dvs[i]->setColumnBase(2*i);
+  }
+  LinearErr3 err(&dv0, &dv1, &dv2);
+  err.setMEstimatorPolicy(boost::shared_ptr<MEstimator>(new HuberMEstimator(0.1)));
+  err.updateRawSquaredError();
+
+  for (const bool useMEstimator : {false, true}) {
+    SCOPED_TRACE(testing::Message() << "useMEstimator: " << useMEstimator);
+
+    // Materialize the weighted Jacobians and contract them with the weighted error
+    JacobianContainerSparse<> jc(err.dimension());
+    err.getWeightedJacobians(jc, useMEstimator);
+    ColumnVectorType ev;
+    err.getWeightedError(ev, useMEstimator);
+    RowVectorType expected(6);
+    for (size_t i = 0; i < dvs.size(); ++i)
+      expected.segment(2*i, 2) = 3.0*ev.transpose()*jc.Jacobian(dvs[i]);
+
+    RowVectorType grad = RowVectorType::Zero(6);
+    JacobianContainerDense<RowVectorType&, 1> jcDense(grad);
+    err.addWeightedGradient(jcDense, useMEstimator, 3.0);
+    EXPECT_TRUE(jcDense.chainRuleEmpty());
+    sm::eigen::assertNear(expected, grad, 1e-12, SM_SOURCE_FILE_POS);
+
+    JacobianContainerSparse<1> jcSparse(1);
+    err.addWeightedGradient(jcSparse, useMEstimator, 3.0);
+    for (size_t i = 0; i < dvs.size(); ++i)
+      sm::eigen::assertNear(expected.segment(2*i, 2), jcSparse.Jacobian(dvs[i]), 1e-12, SM_SOURCE_FILE_POS);
+  }
+}
+
+namespace {
+  /// \brief A linear error term with a wrong sign in its Jacobian
+  class WrongJacobianErr : public LinearErr {
+  public:
+    WrongJacobianErr(Point2d* p2d) : LinearErr(p2d) {}
+    void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+      outJ.add(_p2d, _J);
+    }
+  };
+}
+
+TEST(OptimizationProblemTestSuite, testProblemManagerCheckJacobians)
+{
+  boost::shared_ptr<OptimizationProblem> problem = buildProblem(0, 10, 60);
+  ProblemManager pm(problem);
+
+  JacobianCheckerOptions options;
+  options.numThreads = 4;
+  JacobianChecker::Report report = pm.checkJacobians(options);
+  EXPECT_TRUE(report.passed()) << report;
+  EXPECT_EQ(60u, report.numErrorTerms);
+  EXPECT_EQ(60u, report.numChecked);
+  EXPECT_FALSE(report.timeBudgetExceeded);
+  ASSERT_EQ(options.numWorstOffenders, report.worstOffenders.size());
+  for (size_t i = 1; i < report.worstOffenders.size(); ++i)
+    EXPECT_GE(report.worstOffenders[i - 1].relativeError, report.worstOffenders[i].relativeError);
+
+  // Checking is free of side effects on the design variables
+  Eigen::MatrixXd p0;
+  pm.designVariable(0)->getParameters(p0);
+  options.sampleFraction = 0.5;
+  report = pm.checkJacobians(options);
+  EXPECT_EQ(30u, report.numSampled);
+  EXPECT_EQ(30u, report.numChecked);
+  Eigen::MatrixXd p1;
+  pm.designVariable(0)->getParameters(p1);
+  sm::eigen::assertEqual(p0, p1, SM_SOURCE_FILE_POS);
+
+  // Successive calls with the same options check different subsets
+  options.numWorstOffenders = 30;
+  std::set<size_t> firstSample, secondSample;
+  for (const JacobianChecker::Offender& o : pm.checkJacobians(options).worstOffenders)
+    firstSample.insert(o.errorTermIndex);
+  for (const JacobianChecker::Offender& o : pm.checkJacobians(options).worstOffenders)
+    secondSample.insert(o.errorTermIndex);
+  EXPECT_EQ(30u, firstSample.size());
+  EXPECT_EQ(30u, secondSample.size());
+  EXPECT_NE(firstSample, secondSample);
+
+  // A broken error term is found and reported first
+  Point2d dv(Eigen::Vector2d::Random());
+  WrongJacobianErr err(&dv);
+  problem->addDesignVariable(&dv, false);
+  problem->addErrorTerm(&err, false);
+  pm.initialize();
+  options.sampleFraction = 1.0;
+  options.numWorstOffenders = 3;
+  report = pm.checkJacobians(options);
+  EXPECT_FALSE(report.passed());
+  EXPECT_EQ(1u, report.numFailed);
+  ASSERT_EQ(3u, report.worstOffenders.size());
+  EXPECT_EQ(&err, report.worstOffenders[0].errorTerm);
+  EXPECT_EQ(60u, report.worstOffenders[0].errorTermIndex);
+  EXPECT_NEAR(2.0 * std::abs(report.worstOffenders[0].numerical), report.worstOffenders[0].absoluteError, 1e-6);
+}
+
+TEST(OptimizationProblemTestSuite, testMiniBatchGradient)
+{
+  boost::shared_ptr<OptimizationProblem> problem = buildProblem(1, 10, 60);
+  ProblemManager pm(problem);
+  const std::size_t N = pm.numErrorTerms();
+
+  for (const bool useDenseJacobianContainer : {false, true}) {
+    SCOPED_TRACE(testing::Message() << "useDenseJacobianContainer: " << useDenseJacobianContainer);
+    RowVectorType grad, gradBatch;
+    pm.computeGradient(grad, 4, false, false, useDenseJacobianContainer);
+
+    // A batch holding every error term once is the full gradient
+    MiniBatch batch;
+    for (std::size_t i = 0; i < N; ++i) {
+      batch.errorTermIndices.push_back(i);
+      batch.weights.push_back(1.0);
+    }
+    pm.computeGradient(gradBatch, batch, 4, false, false, useDenseJacobianContainer);
+    sm::eigen::assertNear(grad, gradBatch, 1e-12, SM_SOURCE_FILE_POS);
+
+    // Uniformly sampled batches are sorted, unique and sum up to N
+    MiniBatchSampler uniform(MiniBatchSampler::Sampling::UNIFORM);
+    uniform.reset(N);
+    uniform.seed(1);
+    uniform.sample(20, batch);
+    ASSERT_LE(batch.size(), 20u);
+    for (std::size_t k = 1; k < batch.size(); ++k)
+      EXPECT_LT(batch.errorTermIndices[k - 1], batch.errorTermIndices[k]);
+    EXPECT_NEAR(double(N), std::accumulate(batch.weights.begin(), batch.weights.end(), 0.0), 1e-9);
+
+    // Importance sampled batches are unbiased
+    MiniBatchSampler importance(MiniBatchSampler::Sampling::IMPORTANCE, 0.1);
+    importance.reset(N);
+    importance.seed(2);
+    batch.clear();
+    for (std::size_t i = 0; i < N; ++i)
+      batch.errorTermIndices.push_back(i);
+    importance.updateImportance(batch, pm);
+    RowVectorType mean = RowVectorType::Zero(pm.numOptParameters());
+    const int numBatches = 2000;
+    for (int b = 0; b < numBatches; ++b) {
+      importance.sample(30, batch);
+      pm.computeGradient(gradBatch, batch, 4, false, false, useDenseJacobianContainer);
+      mean += gradBatch / numBatches;
+    }
+    EXPECT_LT((mean - grad).norm(), 0.1 * grad.norm());
   }
 }
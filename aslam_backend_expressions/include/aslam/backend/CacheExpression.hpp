@@ -22,6 +22,7 @@
 #include <aslam/backend/JacobianContainerSparse.hpp>
 #include <aslam/backend/JacobianContainerPrescale.hpp>
 #include <aslam/backend/CacheInterface.hpp>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
 namespace backend {
@@ -47,6 +48,12 @@ class CacheExpressionNode : public CacheInterface, public ExpressionNode
  public:
   virtual ~CacheExpressionNode() { }
 
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override
+  {
+    const std::size_t bytes = expressionNodeMemoryUsage(*this, visited, _node);
+    return bytes ? bytes + _jc.getMemoryUsage() : 0;
+  }
+
  protected:
 
   typename ExpressionNode::value_t evaluateImplementation() const override
@@ -117,6 +124,12 @@ class CacheExpressionNode< GenericMatrixExpressionNode<IRows, ICols, TScalar>, D
  public:
   virtual ~CacheExpressionNode() { }
 
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override
+  {
+    const std::size_t bytes = expressionNodeMemoryUsage(*this, visited, _node);
+    return bytes ? bytes + _jc.getMemoryUsage() : 0;
+  }
+
  protected:
 
   void evaluateImplementation() const override
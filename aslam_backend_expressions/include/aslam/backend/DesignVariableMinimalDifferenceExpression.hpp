@@ -23,6 +23,10 @@ class DesignVariableMinimalDifferenceExpressionNode : public VectorExpressionNod
   DesignVariableMinimalDifferenceExpressionNode(DesignVariable & dv, const Eigen::MatrixXd & xHat) : _xHat(xHat), _dv(dv) {}
   virtual ~DesignVariableMinimalDifferenceExpressionNode() {}
 
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(*this, visited);
+  }
+
   virtual vector_t evaluateImplementation() const override {
     Eigen::VectorXd v;
     _dv.minimalDifference(_xHat, v);
@@ -3,13 +3,14 @@
 
 #include <aslam/backend/JacobianContainer.hpp>
 #include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ParameterArena.hpp>
 #include "VectorExpressionNode.hpp"
 #include "VectorExpression.hpp"
 
 namespace aslam {
   namespace backend {
     template<int D>
-    class DesignVariableVector : public DesignVariable, public VectorExpressionNode<D>
+    class DesignVariableVector : public DesignVariable, public VectorExpressionNode<D>, public ArenaParameters
     {
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -19,10 +20,15 @@ namespace aslam {
 
       DesignVariableVector(size_t dim = D);
       DesignVariableVector(const vector_t& v);
+      DesignVariableVector(const DesignVariableVector& other);
       ~DesignVariableVector() override;
-      const vector_t & value() const { return _v; }
+      vector_t value() const { return _v; }
+      /// \brief A read-only view of the current value, i.e. of the own storage or of the arena slot
+      Eigen::Map<const vector_t> valueMap() const { return Eigen::Map<const vector_t>(_v.data(), _v.size()); }
       int getSize() const override { return D != Eigen::Dynamic ? D : _v.size(); };
       VectorExpression<D> toExpression();
+
+      int numArenaParameters() const override { return getSize(); }
     protected:
       /// \brief Revert the last state update.
       void revertUpdateImplementation() override;
@@ -47,9 +53,13 @@ namespace aslam {
 	  /// Computes the minimal distance in tangent space between the current value of the DV and xHat and the jacobian
 	  void minimalDifferenceAndJacobianImplementation(const Eigen::MatrixXd& xHat, Eigen::VectorXd& outDifference, Eigen::MatrixXd& outJacobian) const override;
 
+      void relocateParameters(double* values, double* previousValues) override;
+
     private:
-      vector_t _v;
-      vector_t _p_v;
+      /// \brief Holds the current (first column) and the previous value while not in a ParameterArena
+      Eigen::Matrix<double, D, 2> _storage;
+      Eigen::Map<vector_t> _v;
+      Eigen::Map<vector_t> _p_v;
 
     };
 
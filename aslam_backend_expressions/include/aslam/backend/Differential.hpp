@@ -164,7 +164,7 @@ struct DifferentialCalculator<TDiff, 1> {
   typedef ComposedMatrixDifferential<domain_t, scalar_t, const matrix_t &> compose_result_t;
 
   inline static void addToJacobianByApplication(const TDiff & diff, JacobianContainer& jc, const DesignVariable* dv) {
-    jc.add(const_cast<DesignVariable *>(dv), calcJacobianByApplication(jc.rows(), dv->minimalDimensions(), diff));
+    jc.add(const_cast<DesignVariable *>(dv), calcJacobianByApplication(jc.expectedRows(), dv->minimalDimensions(), diff));
   }
 
   inline static compose_result_t compose(const TDiff & diff, const matrix_t & jacobian) {
@@ -34,6 +34,11 @@ namespace aslam {
 
       ~ErrorTermEuclidean() override;
 
+      /// \brief Bytes of the error term and the nodes of its expression
+      std::size_t getMemoryUsage() const override;
+      /// \brief Bytes of the error term and the nodes of its expression not in \p counted yet
+      std::size_t accountMemoryUsage(SharedMemorySet& counted) const override;
+
     protected:
       /// This is the interface required by ErrorTermFs<>
 
@@ -35,6 +35,7 @@ namespace aslam {
       EuclideanExpressionNodeMultiply(boost::shared_ptr<RotationExpressionNode> lhs, 
                                       boost::shared_ptr<EuclideanExpressionNode> rhs);
       ~EuclideanExpressionNodeMultiply() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       void accept(ExpressionNodeVisitor& visitor) override;
     private:
@@ -62,6 +63,7 @@ namespace aslam {
 
        EuclideanExpressionNodeMatrixMultiply(boost::shared_ptr<MatrixExpressionNode> lhs, boost::shared_ptr<EuclideanExpressionNode> rhs);
        ~EuclideanExpressionNodeMatrixMultiply() override;
+       std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
      private:
        Eigen::Vector3d evaluateImplementation() const override;
@@ -89,6 +91,7 @@ namespace aslam {
        EuclideanExpressionNodeCrossEuclidean(boost::shared_ptr<EuclideanExpressionNode> lhs,
            boost::shared_ptr<EuclideanExpressionNode> rhs);
        ~EuclideanExpressionNodeCrossEuclidean() override;
+       std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        void accept(ExpressionNodeVisitor& visitor) override;
      private:
@@ -113,6 +116,7 @@ namespace aslam {
         EuclideanExpressionNodeAddEuclidean(boost::shared_ptr<EuclideanExpressionNode> lhs,
             boost::shared_ptr<EuclideanExpressionNode> rhs);
         ~EuclideanExpressionNodeAddEuclidean() override;
+        std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
         void accept(ExpressionNodeVisitor& visitor) override;
       private:
@@ -137,6 +141,7 @@ namespace aslam {
        EuclideanExpressionNodeSubtractEuclidean(boost::shared_ptr<EuclideanExpressionNode> lhs,
            boost::shared_ptr<EuclideanExpressionNode> rhs);
        ~EuclideanExpressionNodeSubtractEuclidean() override;
+       std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
      private:
        Eigen::Vector3d evaluateImplementation() const override;
@@ -161,6 +166,7 @@ namespace aslam {
        EuclideanExpressionNodeSubtractVector(boost::shared_ptr<EuclideanExpressionNode> lhs,
               const Eigen::Vector3d & rhs);
        ~EuclideanExpressionNodeSubtractVector() override;
+       std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
      private:
        Eigen::Vector3d evaluateImplementation() const override;
@@ -185,6 +191,7 @@ namespace aslam {
 
         EuclideanExpressionNodeNegated(boost::shared_ptr<EuclideanExpressionNode> operand);
         ~EuclideanExpressionNodeNegated() override;
+        std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       private:
         Eigen::Vector3d evaluateImplementation() const override;
@@ -207,6 +214,7 @@ namespace aslam {
 
         EuclideanExpressionNodeScalarMultiply(boost::shared_ptr<EuclideanExpressionNode> p, boost::shared_ptr<ScalarExpressionNode> s);
         ~EuclideanExpressionNodeScalarMultiply() override;
+        std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       private:
         Eigen::Vector3d evaluateImplementation() const override;
@@ -224,6 +232,7 @@ namespace aslam {
 
         EuclideanExpressionNodeTranslation(boost::shared_ptr<TransformationExpressionNode> operand);
         ~EuclideanExpressionNodeTranslation() override;
+        std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       private:
         Eigen::Vector3d evaluateImplementation() const override;
@@ -241,6 +250,7 @@ namespace aslam {
 
         EuclideanExpressionNodeRotationParameters(boost::shared_ptr<RotationExpressionNode> operand, sm::kinematics::RotationalKinematics::Ptr rk);
         ~EuclideanExpressionNodeRotationParameters() override;
+        std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       private:
         Eigen::Vector3d evaluateImplementation() const override;
@@ -259,6 +269,7 @@ namespace aslam {
 
         EuclideanExpressionNodeFromHomogeneous(boost::shared_ptr<HomogeneousExpressionNode> root);
         ~EuclideanExpressionNodeFromHomogeneous() override;
+        std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       private:
         Eigen::Vector3d evaluateImplementation() const override;
@@ -282,6 +293,7 @@ namespace aslam {
        EuclideanExpressionNodeElementwiseMultiplyEuclidean(boost::shared_ptr<EuclideanExpressionNode> lhs,
            boost::shared_ptr<EuclideanExpressionNode> rhs);
        ~EuclideanExpressionNodeElementwiseMultiplyEuclidean() override;
+       std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
      private:
        Eigen::Vector3d evaluateImplementation() const override;
@@ -4,17 +4,19 @@
 #include "EuclideanExpressionNode.hpp"
 #include "EuclideanExpression.hpp"
 #include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ParameterArena.hpp>
 
 
 namespace aslam {
   namespace backend {
   class HomogeneousExpression;
   
-    class EuclideanPoint : public EuclideanExpressionNode, public DesignVariable
+    class EuclideanPoint : public EuclideanExpressionNode, public DesignVariable, public ArenaParameters
     {
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
       EuclideanPoint(const Eigen::Vector3d & p);
+      EuclideanPoint(const EuclideanPoint & other);
       ~EuclideanPoint() override;
 
       /// \brief Revert the last state update.
@@ -31,8 +33,14 @@ namespace aslam {
 
       void set(const Eigen::Vector3d & p){ _p = p; _p_p = _p; }
 
-      const Eigen::Vector3d & getValue() const { return _p; }
-      const Eigen::Vector3d & toEuclidean() const { return getValue() ; }
+      Eigen::Vector3d getValue() const { return _p; }
+      Eigen::Vector3d toEuclidean() const { return getValue() ; }
+      /// \brief A read-only view of the current value, i.e. of the own storage or of the arena slot
+      Eigen::Map<const Eigen::Vector3d> getValueMap() const { return Eigen::Map<const Eigen::Vector3d>(_p.data()); }
+
+      int numArenaParameters() const override { return 3; }
+    protected:
+      void relocateParameters(double* values, double* previousValues) override;
     private:
       Eigen::Vector3d evaluateImplementation() const override;
 
@@ -52,11 +60,14 @@ namespace aslam {
       /// Computes the minimal distance in tangent space between the current value of the DV and xHat and the jacobian
       void minimalDifferenceAndJacobianImplementation(const Eigen::MatrixXd& xHat, Eigen::VectorXd& outDifference, Eigen::MatrixXd& outJacobian) const override;
 
+      /// \brief Holds the current (first column) and the previous value while not in a ParameterArena
+      Eigen::Matrix<double, 3, 2> _storage;
+
       /// \brief The current value of the design variable.
-      Eigen::Vector3d _p;
+      Eigen::Map<Eigen::Vector3d> _p;
 
       /// \brief The previous version of the design variable.
-      Eigen::Vector3d _p_p;
+      Eigen::Map<Eigen::Vector3d> _p_p;
     };
     
   } // namespace backend
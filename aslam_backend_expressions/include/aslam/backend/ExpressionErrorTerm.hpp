@@ -87,6 +87,16 @@ struct ExpressionToEigenVectorTraits<ScalarExpression>{
     return (Eigen::Matrix<double, 1, 1>() << error).finished();
   }
 };
+
+/// \brief Bytes of the nodes of \p expression, zero for expression types without a memory walk
+template <typename TExpression>
+auto expressionMemoryUsage(const TExpression & expression, ExpressionNodeSet & visited, int) -> decltype(expression.getMemoryUsage(visited)) {
+  return expression.getMemoryUsage(visited);
+}
+template <typename TExpression>
+std::size_t expressionMemoryUsage(const TExpression & /* expression */, ExpressionNodeSet & /* visited */, long) {
+  return 0;
+}
 }
 
 template<typename TExpression, int IDimension = internal::ExpressionDimensionTraits<TExpression>::Dimension>
@@ -125,6 +135,17 @@ class ExpressionErrorTerm : public aslam::backend::ErrorTermFs<IDimension> {
     return _expression;
   }
 
+  /// \brief Bytes of the error term and the nodes of its expression
+  std::size_t getMemoryUsage() const override {
+    SharedMemorySet counted;
+    return accountMemoryUsage(counted);
+  }
+
+  /// \brief Bytes of the error term and the nodes of its expression not in \p counted yet
+  std::size_t accountMemoryUsage(SharedMemorySet& counted) const override {
+    return parent_t::getMemoryUsage() + sizeof(self_t) - sizeof(parent_t) + internal::expressionMemoryUsage(_expression, counted, 0);
+  }
+
   using parent_t::setInvR;
   using parent_t::setSqrtInvR;
  private:
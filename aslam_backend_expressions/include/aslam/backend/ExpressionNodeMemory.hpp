@@ -0,0 +1,36 @@
+#ifndef ASLAM_BACKEND_EXPRESSION_NODE_MEMORY_HPP
+#define ASLAM_BACKEND_EXPRESSION_NODE_MEMORY_HPP
+
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+#include <aslam/backend/SharedMemorySet.hpp>
+
+namespace aslam {
+  namespace backend {
+
+    /// \brief The expression nodes counted so far by a memory walk. Expressions share sub-expressions, every node is counted once.
+    ///        Error terms pass their SharedMemorySet, so nodes shared between error terms are counted once as well.
+    typedef SharedMemorySet ExpressionNodeSet;
+
+    namespace internal {
+      inline std::size_t childrenMemoryUsage(ExpressionNodeSet& /* visited */) { return 0; }
+
+      template <typename Child, typename ... Children>
+      std::size_t childrenMemoryUsage(ExpressionNodeSet& visited, const boost::shared_ptr<Child>& child, const Children& ... children) {
+        return (child ? child->getMemoryUsage(visited) : 0) + childrenMemoryUsage(visited, children...);
+      }
+    }
+
+    /// \brief Bytes of \p node and of its operands \p children (shared pointers to nodes), 0 if \p node was counted before.
+    ///        The getMemoryUsage() of the expression nodes is implemented with this.
+    template <typename Node, typename ... Children>
+    std::size_t expressionNodeMemoryUsage(const Node& node, ExpressionNodeSet& visited, const Children& ... children) {
+      if (!visited.insert(&node).second)
+        return 0;
+      return sizeof(Node) + internal::childrenMemoryUsage(visited, children...);
+    }
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_EXPRESSION_NODE_MEMORY_HPP */
@@ -0,0 +1,376 @@
+#ifndef ASLAM_BACKEND_FUSED_EXPRESSION_HPP
+#define ASLAM_BACKEND_FUSED_EXPRESSION_HPP
+
+#include <Eigen/Core>
+#include <sm/kinematics/rotations.hpp>
+
+#include <aslam/backend/JacobianContainer.hpp>
+#include <aslam/backend/EuclideanPoint.hpp>
+#include <aslam/backend/RotationQuaternion.hpp>
+
+namespace aslam {
+namespace backend {
+
+/**
+ * Statically typed expressions for rigid body operations.
+ *
+ * The runtime expressions (EuclideanExpression, RotationExpression, TransformationExpression) are trees of heap
+ * allocated nodes evaluated through virtual calls. The expressions in this namespace are plain values whose type
+ * encodes the whole tree, e.g. inverse(C_a) * (C_b * p) is a RotatedPoint<InverseRotation<RotationLeaf>,
+ * RotatedPoint<RotationLeaf, EuclideanLeaf>>. The compiler therefore sees the complete value and Jacobian
+ * computation and inlines it into one kernel with fixed size 3x3 chain rule products.
+ *
+ * Every node implements
+ *  - update(): computes the values of its children and then its own (cached) value,
+ *  - value(): the value computed by the last update(),
+ *  - addJacobians(jc, chain): adds chain * d(value)/d(design variables) to jc, using the values of the last update(),
+ *  - getDesignVariables(dvs).
+ * evaluate() and evaluateJacobians() run update() first, so they can be called in any order.
+ *
+ * Euclidean expressions have Dimension = 3 and work with ExpressionErrorTerm / toErrorTerm() like the runtime ones.
+ * The Jacobian conventions match the runtime nodes, rotations are perturbed as in RotationQuaternion.
+ */
+namespace fused {
+
+/// \brief CRTP base class of all fused expressions with value type \p Value
+template <typename Derived, typename Value>
+class ExpressionBase {
+ public:
+  typedef Value value_t;
+
+  const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+  /// \brief evaluate the expression
+  value_t evaluate() const {
+    derived().update();
+    return derived().value();
+  }
+
+  /// \brief evaluate the Jacobians with respect to the design variables
+  void evaluateJacobians(JacobianContainer& outJacobians) const {
+    derived().update();
+    derived().addJacobians(outJacobians, Eigen::Matrix3d::Identity());
+  }
+
+  /// \brief evaluate the Jacobians with respect to the design variables, applying the chain rule \p applyChainRule first
+  template <typename DERIVED>
+  void evaluateJacobians(JacobianContainer& outJacobians, const Eigen::MatrixBase<DERIVED>& applyChainRule) const {
+    evaluateJacobians(outJacobians.apply(applyChainRule));
+  }
+};
+
+/// \brief base class of the expressions evaluating to a rotation matrix
+template <typename Derived>
+class RotationBase : public ExpressionBase<Derived, Eigen::Matrix3d> {
+ public:
+  Eigen::Matrix3d toRotationMatrix() const { return this->evaluate(); }
+};
+
+/// \brief base class of the expressions evaluating to a Euclidean point
+template <typename Derived>
+class EuclideanBase : public ExpressionBase<Derived, Eigen::Vector3d> {
+ public:
+  enum { Dimension = 3 };
+  Eigen::Vector3d toEuclidean() const { return this->evaluate(); }
+};
+
+/// \brief a RotationQuaternion design variable
+class RotationLeaf : public RotationBase<RotationLeaf> {
+ public:
+  explicit RotationLeaf(RotationQuaternion* dv) : _dv(dv) { }
+
+  void update() const { _C = _dv->toRotationMatrix(); }
+  const Eigen::Matrix3d& value() const { return _C; }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const { jc.add(_dv, chain); }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const { designVariables.insert(_dv); }
+
+ private:
+  RotationQuaternion* _dv;
+  mutable Eigen::Matrix3d _C;
+};
+
+/// \brief a EuclideanPoint design variable
+class EuclideanLeaf : public EuclideanBase<EuclideanLeaf> {
+ public:
+  explicit EuclideanLeaf(EuclideanPoint* dv) : _dv(dv) { }
+
+  void update() const { }
+  Eigen::Map<const Eigen::Vector3d> value() const { return _dv->getValueMap(); }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const { jc.add(_dv, chain); }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const { designVariables.insert(_dv); }
+
+ private:
+  EuclideanPoint* _dv;
+};
+
+/// \brief a constant Euclidean point
+class EuclideanConstant : public EuclideanBase<EuclideanConstant> {
+ public:
+  explicit EuclideanConstant(const Eigen::Vector3d& p) : _p(p) { }
+
+  void update() const { }
+  const Eigen::Vector3d& value() const { return _p; }
+  void addJacobians(JacobianContainer& /* jc */, const Eigen::Matrix3d& /* chain */) const { }
+  void getDesignVariables(DesignVariable::set_t& /* designVariables */) const { }
+
+ private:
+  Eigen::Vector3d _p;
+};
+
+/// \brief C_lhs * C_rhs
+template <typename Lhs, typename Rhs>
+class ComposedRotation : public RotationBase<ComposedRotation<Lhs, Rhs> > {
+ public:
+  ComposedRotation(const Lhs& lhs, const Rhs& rhs) : _lhs(lhs), _rhs(rhs) { }
+
+  void update() const {
+    _lhs.update();
+    _rhs.update();
+    _C = _lhs.value() * _rhs.value();
+  }
+  const Eigen::Matrix3d& value() const { return _C; }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const {
+    _lhs.addJacobians(jc, chain);
+    _rhs.addJacobians(jc, chain * _lhs.value());
+  }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const {
+    _lhs.getDesignVariables(designVariables);
+    _rhs.getDesignVariables(designVariables);
+  }
+
+ private:
+  Lhs _lhs;
+  Rhs _rhs;
+  mutable Eigen::Matrix3d _C;
+};
+
+/// \brief C^T
+template <typename Rotation>
+class InverseRotation : public RotationBase<InverseRotation<Rotation> > {
+ public:
+  explicit InverseRotation(const Rotation& rotation) : _rotation(rotation) { }
+
+  void update() const {
+    _rotation.update();
+    _C = _rotation.value().transpose();
+  }
+  const Eigen::Matrix3d& value() const { return _C; }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const {
+    _rotation.addJacobians(jc, -chain * _C);
+  }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const {
+    _rotation.getDesignVariables(designVariables);
+  }
+
+ private:
+  Rotation _rotation;
+  mutable Eigen::Matrix3d _C;
+};
+
+/// \brief C * p
+template <typename Rotation, typename Point>
+class RotatedPoint : public EuclideanBase<RotatedPoint<Rotation, Point> > {
+ public:
+  RotatedPoint(const Rotation& rotation, const Point& point) : _rotation(rotation), _point(point) { }
+
+  void update() const {
+    _rotation.update();
+    _point.update();
+    _p = _rotation.value() * _point.value();
+  }
+  const Eigen::Vector3d& value() const { return _p; }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const {
+    _rotation.addJacobians(jc, chain * sm::kinematics::crossMx(_p));
+    _point.addJacobians(jc, chain * _rotation.value());
+  }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const {
+    _rotation.getDesignVariables(designVariables);
+    _point.getDesignVariables(designVariables);
+  }
+
+ private:
+  Rotation _rotation;
+  Point _point;
+  mutable Eigen::Vector3d _p;
+};
+
+/// \brief p_lhs + p_rhs
+template <typename Lhs, typename Rhs>
+class EuclideanSum : public EuclideanBase<EuclideanSum<Lhs, Rhs> > {
+ public:
+  EuclideanSum(const Lhs& lhs, const Rhs& rhs) : _lhs(lhs), _rhs(rhs) { }
+
+  void update() const {
+    _lhs.update();
+    _rhs.update();
+    _p = _lhs.value() + _rhs.value();
+  }
+  const Eigen::Vector3d& value() const { return _p; }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const {
+    _lhs.addJacobians(jc, chain);
+    _rhs.addJacobians(jc, chain);
+  }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const {
+    _lhs.getDesignVariables(designVariables);
+    _rhs.getDesignVariables(designVariables);
+  }
+
+ private:
+  Lhs _lhs;
+  Rhs _rhs;
+  mutable Eigen::Vector3d _p;
+};
+
+/// \brief p_lhs - p_rhs
+template <typename Lhs, typename Rhs>
+class EuclideanDifference : public EuclideanBase<EuclideanDifference<Lhs, Rhs> > {
+ public:
+  EuclideanDifference(const Lhs& lhs, const Rhs& rhs) : _lhs(lhs), _rhs(rhs) { }
+
+  void update() const {
+    _lhs.update();
+    _rhs.update();
+    _p = _lhs.value() - _rhs.value();
+  }
+  const Eigen::Vector3d& value() const { return _p; }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const {
+    _lhs.addJacobians(jc, chain);
+    _rhs.addJacobians(jc, -chain);
+  }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const {
+    _lhs.getDesignVariables(designVariables);
+    _rhs.getDesignVariables(designVariables);
+  }
+
+ private:
+  Lhs _lhs;
+  Rhs _rhs;
+  mutable Eigen::Vector3d _p;
+};
+
+/// \brief -p
+template <typename Point>
+class EuclideanNegation : public EuclideanBase<EuclideanNegation<Point> > {
+ public:
+  explicit EuclideanNegation(const Point& point) : _point(point) { }
+
+  void update() const {
+    _point.update();
+    _p = -_point.value();
+  }
+  const Eigen::Vector3d& value() const { return _p; }
+  void addJacobians(JacobianContainer& jc, const Eigen::Matrix3d& chain) const {
+    _point.addJacobians(jc, -chain);
+  }
+  void getDesignVariables(DesignVariable::set_t& designVariables) const {
+    _point.getDesignVariables(designVariables);
+  }
+
+ private:
+  Point _point;
+  mutable Eigen::Vector3d _p;
+};
+
+/**
+ * \brief a rigid body transformation p -> C * p + t made of a rotation and a translation expression.
+ *
+ * Transformations are not nodes themselves: applying, composing or inverting one builds rotation and Euclidean
+ * nodes, e.g. T * p is the node C * p + t.
+ */
+template <typename Rotation, typename Translation>
+class Transformation {
+ public:
+  Transformation(const Rotation& rotation, const Translation& translation) : _rotation(rotation), _translation(translation) { }
+
+  const Rotation& rotation() const { return _rotation; }
+  const Translation& translation() const { return _translation; }
+
+  void getDesignVariables(DesignVariable::set_t& designVariables) const {
+    _rotation.getDesignVariables(designVariables);
+    _translation.getDesignVariables(designVariables);
+  }
+
+ private:
+  Rotation _rotation;
+  Translation _translation;
+};
+
+inline RotationLeaf rotation(RotationQuaternion* dv) {
+  return RotationLeaf(dv);
+}
+
+inline EuclideanLeaf point(EuclideanPoint* dv) {
+  return EuclideanLeaf(dv);
+}
+
+inline EuclideanConstant constant(const Eigen::Vector3d& p) {
+  return EuclideanConstant(p);
+}
+
+template <typename Rotation, typename Translation>
+inline Transformation<Rotation, Translation> transformation(const RotationBase<Rotation>& C, const EuclideanBase<Translation>& t) {
+  return Transformation<Rotation, Translation>(C.derived(), t.derived());
+}
+
+template <typename Lhs, typename Rhs>
+inline ComposedRotation<Lhs, Rhs> operator*(const RotationBase<Lhs>& lhs, const RotationBase<Rhs>& rhs) {
+  return ComposedRotation<Lhs, Rhs>(lhs.derived(), rhs.derived());
+}
+
+template <typename Rotation>
+inline InverseRotation<Rotation> inverse(const RotationBase<Rotation>& C) {
+  return InverseRotation<Rotation>(C.derived());
+}
+
+template <typename Rotation, typename Point>
+inline RotatedPoint<Rotation, Point> operator*(const RotationBase<Rotation>& C, const EuclideanBase<Point>& p) {
+  return RotatedPoint<Rotation, Point>(C.derived(), p.derived());
+}
+
+template <typename Lhs, typename Rhs>
+inline EuclideanSum<Lhs, Rhs> operator+(const EuclideanBase<Lhs>& lhs, const EuclideanBase<Rhs>& rhs) {
+  return EuclideanSum<Lhs, Rhs>(lhs.derived(), rhs.derived());
+}
+
+template <typename Lhs, typename Rhs>
+inline EuclideanDifference<Lhs, Rhs> operator-(const EuclideanBase<Lhs>& lhs, const EuclideanBase<Rhs>& rhs) {
+  return EuclideanDifference<Lhs, Rhs>(lhs.derived(), rhs.derived());
+}
+
+template <typename Lhs>
+inline EuclideanDifference<Lhs, EuclideanConstant> operator-(const EuclideanBase<Lhs>& lhs, const Eigen::Vector3d& rhs) {
+  return EuclideanDifference<Lhs, EuclideanConstant>(lhs.derived(), EuclideanConstant(rhs));
+}
+
+template <typename Point>
+inline EuclideanNegation<Point> operator-(const EuclideanBase<Point>& p) {
+  return EuclideanNegation<Point>(p.derived());
+}
+
+/// \brief T * p = C * p + t
+template <typename Rotation, typename Translation, typename Point>
+inline EuclideanSum<RotatedPoint<Rotation, Point>, Translation> operator*(const Transformation<Rotation, Translation>& T, const EuclideanBase<Point>& p) {
+  return EuclideanSum<RotatedPoint<Rotation, Point>, Translation>(T.rotation() * p, T.translation());
+}
+
+/// \brief T_lhs * T_rhs = (C_lhs * C_rhs, C_lhs * t_rhs + t_lhs)
+template <typename R1, typename T1, typename R2, typename T2>
+inline Transformation<ComposedRotation<R1, R2>, EuclideanSum<RotatedPoint<R1, T2>, T1> >
+operator*(const Transformation<R1, T1>& lhs, const Transformation<R2, T2>& rhs) {
+  return Transformation<ComposedRotation<R1, R2>, EuclideanSum<RotatedPoint<R1, T2>, T1> >(
+      lhs.rotation() * rhs.rotation(), lhs * rhs.translation());
+}
+
+/// \brief T^-1 = (C^T, -C^T * t)
+template <typename Rotation, typename Translation>
+inline Transformation<InverseRotation<Rotation>, EuclideanNegation<RotatedPoint<InverseRotation<Rotation>, Translation> > >
+inverse(const Transformation<Rotation, Translation>& T) {
+  return Transformation<InverseRotation<Rotation>, EuclideanNegation<RotatedPoint<InverseRotation<Rotation>, Translation> > >(
+      inverse(T.rotation()), -(inverse(T.rotation()) * T.translation()));
+}
+
+} // namespace fused
+} // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_FUSED_EXPRESSION_HPP */
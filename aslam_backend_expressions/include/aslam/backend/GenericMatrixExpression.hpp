@@ -119,6 +119,8 @@ class GenericMatrixExpression {
   void evaluateJacobians(JacobianContainer & outJacobians, const differential_t & diff) const;
 
   void getDesignVariables(DesignVariable::set_t & designVariables) const;
+  /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
 
   ScalarExpression toScalarExpression() const;
   template <int RowIndex, int ColIndex>
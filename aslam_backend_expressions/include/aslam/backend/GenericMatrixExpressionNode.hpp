@@ -2,6 +2,7 @@
 #define ASLAM_BACKEND_GENERIC_MATRIX_EXPRESSION_NODE_HPP
 #include <aslam/backend/JacobianContainer.hpp>
 #include <aslam/backend/Differential.hpp>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
 namespace backend {
@@ -67,6 +68,11 @@ class GenericMatrixExpressionNode {
   void getDesignVariables(DesignVariable::set_t & designVariables) const {
     return getDesignVariablesImplementation(designVariables);
   }
+
+  /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+  ///        problem and count zero, like nodes that don't implement it.
+  virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
+
   bool isConstant() const {
     return isConstantImplementation();
   }
@@ -98,6 +104,9 @@ class ConstantGenericMatrixExpressionNode : public GenericMatrixExpressionNode<I
   ConstantGenericMatrixExpressionNode(int rows = IRows, int cols = ICols)
       : base_t(rows, cols, false) {
   }
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(*this, visited);
+  }
  protected:
   virtual bool isConstantImplementation() const {
     return true;
@@ -5,6 +5,7 @@
 #include <boost/shared_ptr.hpp>
 #include <aslam/backend/JacobianContainer.hpp>
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 
 namespace aslam {
@@ -38,6 +39,8 @@ namespace aslam {
       void evaluateJacobians(JacobianContainer & outJacobians) const;
       void evaluateJacobians(JacobianContainer & outJacobians, const Eigen::MatrixXd & applyChainRule) const;
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
+      /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
 
       const SharedNodePointer & root() { return _root; }
 
@@ -5,6 +5,7 @@
 #include <Eigen/Core>
 #include <aslam/backend/JacobianContainer.hpp>
 #include <aslam/backend/VectorExpressionNode.hpp>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
 namespace backend {
@@ -35,6 +36,10 @@ class GenericScalarExpressionNode {
   }
 
   void getDesignVariables(DesignVariable::set_t & designVariables) const { getDesignVariablesImplementation(designVariables); }
+
+  /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+  ///        problem and count zero, like nodes that don't implement it.
+  virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
  protected:
   // These functions must be implemented by child classes.
   virtual Scalar evaluateImplementation() const = 0;
@@ -6,6 +6,7 @@
 #include "EuclideanExpression.hpp"
 #include <aslam/backend/JacobianContainer.hpp>
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
   namespace backend {
@@ -38,6 +39,8 @@ namespace aslam {
       }
 
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
+      /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
       boost::shared_ptr<HomogeneousExpressionNode> root() { return _root; }
 
     private:
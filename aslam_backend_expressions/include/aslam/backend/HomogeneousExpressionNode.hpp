@@ -5,6 +5,7 @@
 #include "TransformationExpressionNode.hpp"
 #include <boost/shared_ptr.hpp>
 #include <Eigen/Core>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 #include "EuclideanExpression.hpp"
 
 
@@ -37,6 +38,10 @@ namespace aslam {
       }
 
       virtual void getDesignVariables(DesignVariable::set_t & designVariables) const;
+
+      /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+      ///        problem and count zero, like nodes that don't implement it.
+      virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
     protected:        
       // These functions must be implemented by child classes.
       virtual Eigen::Vector4d toHomogeneousImplementation() const = 0;
@@ -60,6 +65,7 @@ namespace aslam {
       HomogeneousExpressionNodeMultiply(boost::shared_ptr<TransformationExpressionNode> lhs, 
 				     boost::shared_ptr<HomogeneousExpressionNode> rhs);
       ~HomogeneousExpressionNodeMultiply() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
     private:
       Eigen::Vector4d toHomogeneousImplementation() const override;
@@ -80,6 +86,7 @@ namespace aslam {
 
       HomogeneousExpressionNodeConstant(const Eigen::Vector4d & p);
       ~HomogeneousExpressionNodeConstant() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
         void set(const Eigen::Vector4d & p){ _p = p; }
     private:
@@ -97,6 +104,7 @@ namespace aslam {
 
       HomogeneousExpressionNodeEuclidean( boost::shared_ptr<EuclideanExpressionNode> p);
       ~HomogeneousExpressionNodeEuclidean() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
     private:
       Eigen::Vector4d toHomogeneousImplementation() const override;
@@ -5,15 +5,17 @@
 #include "HomogeneousExpression.hpp"
 
 #include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ParameterArena.hpp>
 
 namespace aslam {
   namespace backend {
     
-    class HomogeneousPoint : public HomogeneousExpressionNode, public DesignVariable
+    class HomogeneousPoint : public HomogeneousExpressionNode, public DesignVariable, public ArenaParameters
     {
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
       HomogeneousPoint(const Eigen::Vector4d & p);
+      HomogeneousPoint(const HomogeneousPoint & other);
       ~HomogeneousPoint() override;
 
       /// \brief Revert the last state update.
@@ -26,6 +28,10 @@ namespace aslam {
       int minimalDimensionsImplementation() const override;
 
       HomogeneousExpression toExpression();
+
+      int numArenaParameters() const override { return 4; }
+    protected:
+      void relocateParameters(double* values, double* previousValues) override;
     private:
       Eigen::Vector4d toHomogeneousImplementation() const override;
 
@@ -46,11 +52,14 @@ namespace aslam {
       void minimalDifferenceAndJacobianImplementation(const Eigen::MatrixXd& xHat, Eigen::VectorXd& outDifference, Eigen::MatrixXd& outJacobian) const override;
 
     private:
+      /// \brief Holds the current (first column) and the previous value while not in a ParameterArena
+      Eigen::Matrix<double, 4, 2> _storage;
+
       /// \brief The current value of the design variable.
-      Eigen::Vector4d _p;
+      Eigen::Map<Eigen::Vector4d> _p;
 
       /// \brief The previous version of the design variable.
-      Eigen::Vector4d _p_p;
+      Eigen::Map<Eigen::Vector4d> _p_p;
 
 
     };
@@ -8,6 +8,7 @@
 #include "EuclideanExpression.hpp"
 #include "TransformationExpression.hpp"
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
   namespace backend {
@@ -33,6 +34,8 @@ namespace aslam {
       EuclideanExpression operator*(const EuclideanExpression & p) const;
 
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
+      /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
 
       boost::shared_ptr<MatrixExpressionNode> root() { return _root; }
     private:
@@ -4,6 +4,7 @@
 #include <aslam/backend/JacobianContainer.hpp>
 #include <boost/shared_ptr.hpp>
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
 namespace backend {
@@ -25,6 +26,10 @@ class MatrixExpressionNode {
   void evaluateJacobians(JacobianContainer & outJacobians, const Eigen::MatrixXd & applyChainRule) const;
 
   void getDesignVariables(DesignVariable::set_t & designVariables) const;
+
+  /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+  ///        problem and count zero, like nodes that don't implement it.
+  virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
  protected:
   // These functions must be implemented by child classes.
   virtual Eigen::Matrix3d evaluateImplementation() const = 0;
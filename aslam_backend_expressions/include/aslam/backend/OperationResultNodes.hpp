@@ -3,6 +3,7 @@
 
 #include <aslam/backend/DesignVariable.hpp>
 #include <aslam/backend/Differential.hpp>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
 namespace backend {
@@ -37,6 +38,10 @@ class UnaryOperationResultNodeBase : public TResult::node_t {
 
   virtual ~UnaryOperationResultNodeBase() {}
 
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(static_cast<const TDerived&>(*this), visited, _operand);
+  }
+
   inline apply_diff_return_t applyDiff(const typename operand_node_traits_t::tangent_vector_t & /* tangent_vector */) const {
     throw std::runtime_error("This method must be shadowed or not used!");
   }
@@ -124,6 +129,10 @@ class BinaryOperationResultNode : public TResult::node_t {
   virtual ~BinaryOperationResultNode() {
   }
 
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(static_cast<const TDerived&>(*this), visited, _lhs, _rhs);
+  }
+
   typedef TLhs lhs_t;
   typedef TRhs rhs_t;
   typedef typename TLhs::node_t lhs_node_t;
@@ -8,6 +8,7 @@
 #include "EuclideanExpression.hpp"
 #include "TransformationExpression.hpp"
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 #include <sm/kinematics/RotationalKinematics.hpp>
 
 namespace aslam {
@@ -55,6 +56,8 @@ namespace aslam {
       TransformationExpression toTransformationExpression() const;
 
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
+      /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
 
       boost::shared_ptr<RotationExpressionNode> root() const { return _root; }
       bool isEmpty() const { return !static_cast<bool>(_root); }
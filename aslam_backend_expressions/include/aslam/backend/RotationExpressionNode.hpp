@@ -6,6 +6,7 @@
 #include <sm/kinematics/quaternion_algebra.hpp>
 #include <boost/shared_ptr.hpp>
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 #include <aslam/backend/TransformationExpressionNode.hpp>
 
 namespace aslam {
@@ -53,6 +54,10 @@ namespace aslam {
 
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
 
+      /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+      ///        problem and count zero, like nodes that don't implement it.
+      virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
+
       virtual void accept(ExpressionNodeVisitor& visitor);  //TODO make pure and complete nodes
     protected:        
       // These functions must be implemented by child classes.
@@ -74,6 +79,7 @@ namespace aslam {
 
       ConstantRotationExpressionNode(const Eigen::Matrix3d & C);
       ~ConstantRotationExpressionNode() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
     private:
       Eigen::Matrix3d toRotationMatrixImplementation() const override;
@@ -97,6 +103,7 @@ namespace aslam {
       RotationExpressionNodeMultiply(boost::shared_ptr<RotationExpressionNode> lhs, 
 				     boost::shared_ptr<RotationExpressionNode> rhs);
       ~RotationExpressionNodeMultiply() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
     private:
       Eigen::Matrix3d toRotationMatrixImplementation() const override;
@@ -122,6 +129,7 @@ namespace aslam {
       RotationExpressionNodeInverse(boost::shared_ptr<RotationExpressionNode> dvRotation);
 
       ~RotationExpressionNodeInverse() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
     private:
       Eigen::Matrix3d toRotationMatrixImplementation() const override;
@@ -138,6 +146,7 @@ namespace aslam {
       RotationExpressionNodeTransformation(boost::shared_ptr<TransformationExpressionNode> dvRotation);
 
       ~RotationExpressionNodeTransformation() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
     private:
       Eigen::Matrix3d toRotationMatrixImplementation() const override;
@@ -4,13 +4,14 @@
 
 #include <Eigen/Core>
 #include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/ParameterArena.hpp>
 #include "RotationExpression.hpp"
 #include "RotationExpressionNode.hpp"
 
 namespace aslam {
   namespace backend {
 
-    class RotationQuaternion : public RotationExpressionNode, public DesignVariable
+    class RotationQuaternion : public RotationExpressionNode, public DesignVariable, public ArenaParameters
     {
     public:
         EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -19,6 +20,8 @@ namespace aslam {
       /// Constructs a rotation quaternion expression from a rotation matrix
       RotationQuaternion(const Eigen::Matrix3d& C);
 
+      RotationQuaternion(const RotationQuaternion& other);
+
       ~RotationQuaternion() override;
 
       /// \brief Revert the last state update.
@@ -36,12 +39,19 @@ namespace aslam {
 
       RotationExpression toExpression();
 
-      const Eigen::Vector4d & getQuaternion(){ return _q; }
+      Eigen::Vector4d getQuaternion() const { return _q; }
+      /// \brief A read-only view of the current quaternion, i.e. of the own storage or of the arena slot
+      Eigen::Map<const Eigen::Vector4d> getQuaternionMap() const { return Eigen::Map<const Eigen::Vector4d>(_q.data()); }
 
       void set(const Eigen::Vector4d & q) {
         _q = q; _p_q = q;
         _C = sm::kinematics::quat2r(q);
       }
+
+      int numArenaParameters() const override { return 4; }
+    protected:
+      void relocateParameters(double* values, double* previousValues) override;
+      void arenaParametersChanged() override;
     private:
       Eigen::Matrix3d toRotationMatrixImplementation() const override;
       void evaluateJacobiansImplementation(JacobianContainer & outJacobians) const override;
@@ -53,8 +63,10 @@ namespace aslam {
       /// Sets the content of the design variable
       void setParametersImplementation(const Eigen::MatrixXd& value) override;
 
-      Eigen::Vector4d _q;
-      Eigen::Vector4d _p_q;
+      /// \brief Holds the current (first column) and the previous quaternion while not in a ParameterArena
+      Eigen::Matrix<double, 4, 2> _storage;
+      Eigen::Map<Eigen::Vector4d> _q;
+      Eigen::Map<Eigen::Vector4d> _p_q;
       Eigen::Matrix3d _C;
 
     };
@@ -21,6 +21,7 @@ namespace aslam {
         SM_ASSERT_GE_LT(std::runtime_error, axis, 0, 3, "The axis index must be in {0, 1, 2}");
       }
       ~RotationScalarExpressionNode() override{}
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
     private:
       Eigen::Matrix3d toRotationMatrixImplementation() const override;
@@ -6,6 +6,7 @@
 #include <aslam/backend/JacobianContainer.hpp>
 #include <aslam/backend/Differential.hpp>
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
   namespace backend {
@@ -38,6 +39,8 @@ namespace aslam {
       void evaluateJacobians(JacobianContainer & outJacobians) const;
       void evaluateJacobians(JacobianContainer & outJacobians, const Eigen::MatrixXd & applyChainRule) const;
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
+      /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
 
       boost::shared_ptr<ScalarExpressionNode> root() const { return _root; }
       bool isEmpty() const { return false; }  //TODO feature: support empty scalar expression
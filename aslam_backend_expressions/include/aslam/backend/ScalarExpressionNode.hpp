@@ -5,6 +5,7 @@
 #include <boost/shared_ptr.hpp>
 #include <Eigen/Core>
 #include <aslam/backend/VectorExpressionNode.hpp>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
   namespace backend {
@@ -42,6 +43,10 @@ namespace aslam {
 
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
 
+      /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+      ///        problem and count zero, like nodes that don't implement it.
+      virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
+
       virtual void accept(ExpressionNodeVisitor& visitor);  //TODO make pure and complete nodes
     protected:
       // These functions must be implemented by child classes.
@@ -57,6 +62,7 @@ namespace aslam {
           ScalarExpressionNodeMultiply(boost::shared_ptr<ScalarExpressionNode> lhs,
                                        boost::shared_ptr<ScalarExpressionNode> rhs);
           ~ScalarExpressionNodeMultiply() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
           void accept(ExpressionNodeVisitor& visitor) override;
       protected:
@@ -75,6 +81,7 @@ namespace aslam {
           ScalarExpressionNodeDivide(boost::shared_ptr<ScalarExpressionNode> lhs,
                                        boost::shared_ptr<ScalarExpressionNode> rhs);
           ~ScalarExpressionNodeDivide() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
           void accept(ExpressionNodeVisitor& visitor) override;
       protected:
           // These functions must be implemented by child classes.
@@ -92,6 +99,7 @@ namespace aslam {
       public:
           ScalarExpressionNodeNegated(boost::shared_ptr<ScalarExpressionNode> rhs);
           ~ScalarExpressionNodeNegated() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
           void accept(ExpressionNodeVisitor& visitor) override;
        protected:
           // These functions must be implemented by child classes.
@@ -109,6 +117,7 @@ namespace aslam {
                                   boost::shared_ptr<ScalarExpressionNode> rhs,
                                   double multiplyRhs = 1.0);
           ~ScalarExpressionNodeAdd() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
           void accept(ExpressionNodeVisitor& visitor) override;
        protected:
           // These functions must be implemented by child classes.
@@ -127,6 +136,7 @@ namespace aslam {
       public:
           ScalarExpressionNodeConstant(double s);
           ~ScalarExpressionNodeConstant() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
           void accept(ExpressionNodeVisitor& visitor) override;
       protected:
           // These functions must be implemented by child classes.
@@ -142,6 +152,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeSqrt(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeSqrt() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -157,6 +168,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeLog(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeLog() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -172,6 +184,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeExp(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeExp() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -187,6 +200,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeAtan(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeAtan() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -202,6 +216,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeTanh(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeTanh() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -217,6 +232,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeAtan2(boost::shared_ptr<ScalarExpressionNode> lhs, boost::shared_ptr<ScalarExpressionNode> rhs);
           ~ScalarExpressionNodeAtan2() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -233,6 +249,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeAcos(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeAcos() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -248,6 +265,7 @@ namespace aslam {
        public:
           ScalarExpressionNodeAcosSquared(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeAcosSquared() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -264,6 +282,7 @@ namespace aslam {
           ScalarExpressionNodeInverseSigmoid(boost::shared_ptr<ScalarExpressionNode> lhs, const double height, const double scale, const double shift);
           ScalarExpressionNodeInverseSigmoid(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeInverseSigmoid() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -284,6 +303,7 @@ namespace aslam {
 
           ScalarExpressionNodePower(boost::shared_ptr<ScalarExpressionNode> lhs, const int k);
           ~ScalarExpressionNodePower() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -301,6 +321,7 @@ namespace aslam {
        public:
           ScalarExpressionPiecewiseExpression(boost::shared_ptr<ScalarExpressionNode> e1, boost::shared_ptr<ScalarExpressionNode> e2, std::function<bool()> useFirst);
           ~ScalarExpressionPiecewiseExpression() override;
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
        protected:
           // These functions must be implemented by child classes.
@@ -321,6 +342,7 @@ namespace aslam {
             static_assert (ComponentIndex < VectorSize, "component index must be smaller than the vectors size");
           }
           ~ScalarExpressionNodeFromVectorExpression() override{}
+          std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override { return expressionNodeMemoryUsage(*this, visited, _lhs); }
 
        protected:
           // These functions must be implemented by child classes.
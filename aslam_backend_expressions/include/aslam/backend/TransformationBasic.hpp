@@ -14,6 +14,7 @@ namespace aslam {
     public:
       TransformationBasic(RotationExpression C_0_1, EuclideanExpression t_0_1_0);
       ~TransformationBasic() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       TransformationExpression toExpression();
 
@@ -9,6 +9,7 @@
 #include "HomogeneousExpression.hpp"
 #include "TransformationExpression.hpp"
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
   namespace backend {
@@ -50,6 +51,8 @@ namespace aslam {
       TransformationExpression inverse() const;
 
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
+      /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
 
       boost::shared_ptr<TransformationExpressionNode> root(){ return _root; }
 
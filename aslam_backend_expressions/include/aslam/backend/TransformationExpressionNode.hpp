@@ -5,6 +5,7 @@
 #include <aslam/backend/JacobianContainer.hpp>
 #include <boost/shared_ptr.hpp>
 #include <set>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
   namespace backend {
@@ -29,6 +30,10 @@ namespace aslam {
       }
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
 
+      /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+      ///        problem and count zero, like nodes that don't implement it.
+      virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
+
       virtual void accept(ExpressionNodeVisitor& visitor); //TODO make pure and complete nodes
     protected:
       // These functions must be implemented by child classes.
@@ -57,6 +62,7 @@ namespace aslam {
                                            boost::shared_ptr<TransformationExpressionNode> rhs);
 
       ~TransformationExpressionNodeMultiply() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       void accept(ExpressionNodeVisitor& visitor) override;
     private:
@@ -85,6 +91,7 @@ namespace aslam {
       TransformationExpressionNodeInverse(boost::shared_ptr<TransformationExpressionNode> dvTransformation);
 
       ~TransformationExpressionNodeInverse() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       void accept(ExpressionNodeVisitor& visitor) override;
     private:
@@ -110,6 +117,7 @@ namespace aslam {
 
       TransformationExpressionNodeConstant(const Eigen::Matrix4d & T);
       ~TransformationExpressionNodeConstant() override;
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
 
       void accept(ExpressionNodeVisitor& visitor) override;
     private:
@@ -23,6 +23,7 @@ class Vector2RotationQuaternionExpressionAdapter : public RotationExpressionNode
   }
 
   ~Vector2RotationQuaternionExpressionAdapter() override;
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override;
  protected:
   Vector2RotationQuaternionExpressionAdapter(const VectorExpression<4> & vectorExpression);
   Eigen::Matrix3d toRotationMatrixImplementation() const override;
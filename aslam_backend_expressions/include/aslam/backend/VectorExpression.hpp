@@ -5,6 +5,7 @@
 #include <boost/shared_ptr.hpp>
 #include <sm/boost/null_deleter.hpp>
 #include "VectorExpressionNode.hpp"
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 #include <aslam/backend/ScalarExpression.hpp>
 #include <aslam/backend/ScalarExpressionNode.hpp>
 
@@ -35,6 +36,8 @@ namespace aslam {
       }
 
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
+      /// \brief Bytes of the nodes of this expression that are not in \p visited yet, see ExpressionNodeSet
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const;
 
       ScalarExpression toScalarExpression() const;
       template <int ColumnIndex>
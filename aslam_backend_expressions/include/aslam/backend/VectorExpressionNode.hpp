@@ -3,6 +3,7 @@
 #include <aslam/backend/JacobianContainer.hpp>
 #include <aslam/backend/Differential.hpp>
 #include <aslam/backend/ExpressionNodeVisitor.hpp>
+#include <aslam/backend/ExpressionNodeMemory.hpp>
 
 namespace aslam {
   namespace backend {
@@ -30,6 +31,10 @@ namespace aslam {
       void evaluateJacobians(JacobianContainer & outJacobians, const differential_t & chainRuleDifferentail) const;
       void getDesignVariables(DesignVariable::set_t & designVariables) const;
 
+      /// \brief Bytes of this node and the nodes below it that are not in \p visited yet. Design variables belong to the
+      ///        problem and count zero, like nodes that don't implement it.
+      virtual std::size_t getMemoryUsage(ExpressionNodeSet& /* visited */) const { return 0; }
+
       virtual int getSize() const { assert(D != Eigen::Dynamic); return D; }
 
       virtual void accept(ExpressionNodeVisitor& visitor) { visitor.visit("V", this); }; //TODO make pure and complete nodes
@@ -58,6 +63,7 @@ namespace aslam {
 
       ~ConstantVectorExpressionNode() override = default;
       int getSize() const override { return value.rows(); }
+      std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override { return expressionNodeMemoryUsage(*this, visited); }
 
       void accept(ExpressionNodeVisitor& visitor) override;
      private:
@@ -81,7 +81,7 @@ namespace aslam {
     template<int D>
     void DesignVariableMappedVector<D>::evaluateJacobiansImplementation(JacobianContainer & outJacobians) const
     {
-      SM_ASSERT_EQ_DBG(Exception, outJacobians.rows(), D, "The Jacobian container dimension doesn't match the state. Are you missing a chain rule?");
+      SM_ASSERT_EQ_DBG(Exception, outJacobians.expectedRows(), D, "The Jacobian container dimension doesn't match the state. Are you missing a chain rule?");
       outJacobians.add(const_cast< DesignVariableMappedVector<D>* >(this));
     }
 
@@ -4,15 +4,26 @@ namespace aslam {
 
     template<int D>
     DesignVariableVector<D>::DesignVariableVector(const size_t dim)
+        : _storage(Eigen::Matrix<double, D, 2>::Zero(dim, 2)), _v(_storage.col(0).data(), dim), _p_v(_storage.col(1).data(), dim)
     {
       SM_ASSERT_GE(aslam::InvalidArgumentException, dim, 0, "For dynamically sized DesignVariableVector you must provide a initial dimension on construction");
-      _v.setZero(dim);
-      _p_v.setZero(dim);
     }
 
     template<int D>
-    DesignVariableVector<D>::DesignVariableVector(const vector_t& v) : _v(v), _p_v(v)
+    DesignVariableVector<D>::DesignVariableVector(const vector_t& v)
+        : _storage(v.size(), 2), _v(_storage.col(0).data(), v.size()), _p_v(_storage.col(1).data(), v.size())
     {
+      _v = v;
+      _p_v = v;
+    }
+
+    template<int D>
+    DesignVariableVector<D>::DesignVariableVector(const DesignVariableVector& other)
+        : DesignVariable(other), VectorExpressionNode<D>(other), ArenaParameters(other),
+          _storage(other.getSize(), 2), _v(_storage.col(0).data(), other.getSize()), _p_v(_storage.col(1).data(), other.getSize())
+    {
+      _v = other._v;
+      _p_v = other._p_v;
     }
 
     template<int D>
@@ -99,6 +110,13 @@ namespace aslam {
     	outJacobian.setIdentity(getSize(),getSize());
     }
 
+    template<int D>
+    void DesignVariableVector<D>::relocateParameters(double* values, double* previousValues)
+    {
+      relocateMap(_v, values ? values : _storage.col(0).data());
+      relocateMap(_p_v, previousValues ? previousValues : _storage.col(1).data());
+    }
+
   } // namespace backend
 } // namespace aslam
 
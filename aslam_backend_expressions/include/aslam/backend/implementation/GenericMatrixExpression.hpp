@@ -86,6 +86,12 @@ void _CLASS::getDesignVariables(DesignVariable::set_t & designVariables) const
   return _root->getDesignVariables(designVariables);
 }
 
+_TEMPLATE
+std::size_t _CLASS::getMemoryUsage(ExpressionNodeSet& visited) const
+{
+  return _root ? _root->getMemoryUsage(visited) : 0;
+}
+
 _TEMPLATE
 template<int RowIndex, int ColIndex>
 ScalarExpression _CLASS::toScalarExpression() const {
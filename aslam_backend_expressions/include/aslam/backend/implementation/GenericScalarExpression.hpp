@@ -26,6 +26,10 @@ void GenericScalarExpression<Scalar_>::getDesignVariables(DesignVariable::set_t
   if(empty()) return;
   _root->getDesignVariables(designVariables);
 }
+template<typename Scalar_>
+std::size_t GenericScalarExpression<Scalar_>::getMemoryUsage(ExpressionNodeSet& visited) const {
+  return empty() ? 0 : _root->getMemoryUsage(visited);
+}
 
 namespace internal {
 template<typename Scalar_, typename NodeType_>
@@ -35,6 +39,9 @@ class GSEUnRes : public GenericScalarExpressionNode<Scalar_> {
   typedef boost::shared_ptr<NodeType_> SharedNodePointer;
   GSEUnRes(SharedNodePointer lhs) : _lhs(lhs) {}
   virtual ~GSEUnRes() {}
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(*this, visited, _lhs);
+  }
  protected:
   void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const {
     this->_lhs->getDesignVariables(designVariables);
@@ -50,6 +57,9 @@ class GSEBinRes : public GenericScalarExpressionNode<Scalar_> {
 
   GSEBinRes(SharedNodePointer lhs, SharedNodePointer rhs) : _lhs(lhs), _rhs(rhs) {}
   virtual ~GSEBinRes() {}
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+  }
  protected:
   void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const {
     this->_lhs->getDesignVariables(designVariables);
@@ -88,6 +98,9 @@ class GenericScalarExpressionNodeConstant : public GenericScalarExpressionNode<S
   typedef Scalar_ Scalar;
   GenericScalarExpressionNodeConstant(Scalar s) : _s(s) {}
   virtual ~GenericScalarExpressionNodeConstant() {}
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(*this, visited);
+  }
  protected:
   virtual Scalar evaluateImplementation() const override { return _s; }
   virtual void evaluateJacobiansImplementation(JacobianContainer & /* outJacobians */) const override {}
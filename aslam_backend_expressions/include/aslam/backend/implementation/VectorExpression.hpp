@@ -52,6 +52,12 @@ namespace aslam {
         _root->getDesignVariables(designVariables);
     }
 
+    template<int D>
+    std::size_t VectorExpression<D>::getMemoryUsage(ExpressionNodeSet& visited) const
+    {
+      return isEmpty() ? 0 : _root->getMemoryUsage(visited);
+    }
+
     template<int D>
     template<int ComponentIndex>
     ScalarExpression VectorExpression<D>::toScalarExpression() const
@@ -62,5 +62,16 @@ namespace aslam {
      _t.evaluateJacobians(_jacobians);
   }
 
+  std::size_t ErrorTermEuclidean::getMemoryUsage() const
+  {
+    SharedMemorySet counted;
+    return accountMemoryUsage(counted);
+  }
+
+  std::size_t ErrorTermEuclidean::accountMemoryUsage(SharedMemorySet& counted) const
+  {
+    return ErrorTermFs<3>::getMemoryUsage() + sizeof(ErrorTermEuclidean) - sizeof(ErrorTermFs<3>) + _t.getMemoryUsage(counted);
+  }
+
   } // namespace backend
 } // namespace aslam
@@ -80,5 +80,16 @@ namespace aslam {
     _T.evaluateJacobians(_jacobians, J);
   }
 
+  std::size_t ErrorTermTransformation::getMemoryUsage() const
+  {
+    SharedMemorySet counted;
+    return accountMemoryUsage(counted);
+  }
+
+  std::size_t ErrorTermTransformation::accountMemoryUsage(SharedMemorySet& counted) const
+  {
+    return ErrorTermFs<6>::getMemoryUsage() + sizeof(ErrorTermTransformation) - sizeof(ErrorTermFs<6>) + _T.getMemoryUsage(counted);
+  }
+
   } // namespace vc
 } // namespace aslam
@@ -363,6 +363,54 @@ namespace aslam {
     void EuclideanExpressionNodeAddEuclidean::accept(ExpressionNodeVisitor& visitor) {
       visitor.visit("+", this, _lhs, _rhs);
     }
+
+    std::size_t EuclideanExpressionNodeMultiply::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+    }
+
+    std::size_t EuclideanExpressionNodeMatrixMultiply::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+    }
+
+    std::size_t EuclideanExpressionNodeCrossEuclidean::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+    }
+
+    std::size_t EuclideanExpressionNodeAddEuclidean::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+    }
+
+    std::size_t EuclideanExpressionNodeSubtractEuclidean::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+    }
+
+    std::size_t EuclideanExpressionNodeSubtractVector::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _lhs);
+    }
+
+    std::size_t EuclideanExpressionNodeNegated::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _operand);
+    }
+
+    std::size_t EuclideanExpressionNodeScalarMultiply::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _p, _s);
+    }
+
+    std::size_t EuclideanExpressionNodeTranslation::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _operand);
+    }
+
+    std::size_t EuclideanExpressionNodeRotationParameters::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _operand);
+    }
+
+    std::size_t EuclideanExpressionNodeFromHomogeneous::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _root);
+    }
+
+    std::size_t EuclideanExpressionNodeElementwiseMultiplyEuclidean::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+    }
   } // namespace backend
 }  // namespace aslam
 
@@ -4,9 +4,17 @@
 namespace aslam {
   namespace backend {
     EuclideanPoint::EuclideanPoint(const Eigen::Vector3d & p) :
-      _p(p), _p_p(p)
+      _p(_storage.col(0).data()), _p_p(_storage.col(1).data())
     {
-
+      _p = p;
+      _p_p = p;
+    }
+    EuclideanPoint::EuclideanPoint(const EuclideanPoint & other) :
+      EuclideanExpressionNode(other), DesignVariable(other), ArenaParameters(other),
+      _p(_storage.col(0).data()), _p_p(_storage.col(1).data())
+    {
+      _p = other._p;
+      _p_p = other._p_p;
     }
     EuclideanPoint::~EuclideanPoint()
     {
@@ -84,5 +92,11 @@ namespace aslam {
      outJacobian = Eigen::Matrix3d::Identity();
     }
 
+    void EuclideanPoint::relocateParameters(double* values, double* previousValues)
+    {
+      relocateMap(_p, values ? values : _storage.col(0).data());
+      relocateMap(_p_p, previousValues ? previousValues : _storage.col(1).data());
+    }
+
   } // namespace backend
 } // namespace aslam
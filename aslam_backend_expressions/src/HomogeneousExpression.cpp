@@ -59,6 +59,11 @@ namespace aslam {
       _root->getDesignVariables(designVariables);
     }
 
+    std::size_t HomogeneousExpression::getMemoryUsage(ExpressionNodeSet& visited) const
+    {
+      return _root ? _root->getMemoryUsage(visited) : 0;
+    }
+
 
   
   } // namespace backend
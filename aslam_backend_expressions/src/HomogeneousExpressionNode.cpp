@@ -107,7 +107,16 @@ namespace aslam {
     return _p->getDesignVariables(designVariables);
   }
 
+  std::size_t HomogeneousExpressionNodeMultiply::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+  }
 
+  std::size_t HomogeneousExpressionNodeConstant::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited);
+  }
 
+  std::size_t HomogeneousExpressionNodeEuclidean::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _p);
+  }
   } // namespace backend
 } // namespace aslam
@@ -5,11 +5,18 @@
 namespace aslam {
   namespace backend {
     HomogeneousPoint::HomogeneousPoint(const Eigen::Vector4d & p) :
-      _p(p), _p_p(p)
+      _p(_storage.col(0).data()), _p_p(_storage.col(1).data())
     {
       double recipPnorm = 1.0/p.norm();
-      _p *= recipPnorm;
-      _p_p *= recipPnorm;
+      _p = p * recipPnorm;
+      _p_p = _p;
+    }
+    HomogeneousPoint::HomogeneousPoint(const HomogeneousPoint & other) :
+      HomogeneousExpressionNode(other), DesignVariable(other), ArenaParameters(other),
+      _p(_storage.col(0).data()), _p_p(_storage.col(1).data())
+    {
+      _p = other._p;
+      _p_p = other._p_p;
     }
     HomogeneousPoint::~HomogeneousPoint()
     {
@@ -83,5 +90,11 @@ namespace aslam {
      outJacobian = sm::kinematics::quatLogJacobian(evalPoint)*sm::kinematics::quatJacobian(evalPoint);
     }
 
+    void HomogeneousPoint::relocateParameters(double* values, double* previousValues)
+    {
+      relocateMap(_p, values ? values : _storage.col(0).data());
+      relocateMap(_p_p, previousValues ? previousValues : _storage.col(1).data());
+    }
+
   } // namespace backend
 } // namespace aslam
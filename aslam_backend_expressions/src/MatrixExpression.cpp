@@ -37,5 +37,9 @@ void MatrixExpression::getDesignVariables(DesignVariable::set_t & designVariable
   return _root->getDesignVariables(designVariables);
 }
 
+std::size_t MatrixExpression::getMemoryUsage(ExpressionNodeSet& visited) const {
+  return _root ? _root->getMemoryUsage(visited) : 0;
+}
+
 }  // namespace backend
 }  // namespace aslam
@@ -92,6 +92,11 @@ namespace aslam {
         _root->getDesignVariables(designVariables);
     }
 
+    std::size_t RotationExpression::getMemoryUsage(ExpressionNodeSet& visited) const
+    {
+      return _root ? _root->getMemoryUsage(visited) : 0;
+    }
+
     EuclideanExpression RotationExpression::toParameters(sm::kinematics::RotationalKinematics::Ptr rk) const {
       assert(!isEmpty());
       boost::shared_ptr<EuclideanExpressionNode> een( new EuclideanExpressionNodeRotationParameters(_root, rk));
@@ -130,6 +130,22 @@ namespace aslam {
 
 
   
+
+  std::size_t ConstantRotationExpressionNode::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited);
+  }
+
+  std::size_t RotationExpressionNodeMultiply::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+  }
+
+  std::size_t RotationExpressionNodeInverse::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _dvRotation);
+  }
+
+  std::size_t RotationExpressionNodeTransformation::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _transformation);
+  }
   } // namespace backend
 }  // namespace aslam
 
@@ -7,12 +7,27 @@
 namespace aslam {
   namespace backend {
 
-    RotationQuaternion::RotationQuaternion(const Eigen::Vector4d & q) : _q(q), _p_q(q), _C(sm::kinematics::quat2r(q)) {}
+    RotationQuaternion::RotationQuaternion(const Eigen::Vector4d & q) :
+        _q(_storage.col(0).data()), _p_q(_storage.col(1).data()), _C(sm::kinematics::quat2r(q)) {
+      _q = q;
+      _p_q = q;
+    }
 
     RotationQuaternion::RotationQuaternion(const Eigen::Matrix3d& C) :
-        _q(sm::kinematics::r2quat(C)),
-        _p_q(sm::kinematics::r2quat(C)),
+        _q(_storage.col(0).data()),
+        _p_q(_storage.col(1).data()),
         _C(C) {
+      _q = sm::kinematics::r2quat(C);
+      _p_q = _q;
+    }
+
+    RotationQuaternion::RotationQuaternion(const RotationQuaternion& other) :
+        RotationExpressionNode(other), DesignVariable(other), ArenaParameters(other),
+        _q(_storage.col(0).data()),
+        _p_q(_storage.col(1).data()),
+        _C(other._C) {
+      _q = other._q;
+      _p_q = other._p_q;
     }
 
     RotationQuaternion::~RotationQuaternion(){}
@@ -88,6 +103,17 @@ namespace aslam {
      outJacobian = sm::kinematics::quatLogJacobian2(evalPoint)*sm::kinematics::quatJacobian(evalPoint); //???
     }
 
+    void RotationQuaternion::relocateParameters(double* values, double* previousValues)
+    {
+      relocateMap(_q, values ? values : _storage.col(0).data());
+      relocateMap(_p_q, previousValues ? previousValues : _storage.col(1).data());
+    }
+
+    void RotationQuaternion::arenaParametersChanged()
+    {
+      _C = sm::kinematics::quat2r(_q);
+    }
+
   } // namespace backend
 } // namespace aslam
 
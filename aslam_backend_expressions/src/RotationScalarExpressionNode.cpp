@@ -38,5 +38,9 @@ namespace backend {
     {
       _s->getDesignVariables(designVariables);
     }
+
+    std::size_t RotationScalarExpressionNode::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _s);
+    }
 }
 }
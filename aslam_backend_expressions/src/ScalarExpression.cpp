@@ -18,6 +18,9 @@ class ScalarExpressionNodeNamedConstant : public ScalarExpressionNodeConstant
 {
  public:
   ScalarExpressionNodeNamedConstant(const char *name, double s) : ScalarExpressionNodeConstant(s), _name(name){}
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(*this, visited);
+  }
   void accept(ExpressionNodeVisitor& visitor) override {
     visitor.visit(_name.c_str(), this);
   }
@@ -58,6 +61,10 @@ void ScalarExpression::getDesignVariables(DesignVariable::set_t & designVariable
   _root->getDesignVariables(designVariables);
 }
 
+std::size_t ScalarExpression::getMemoryUsage(ExpressionNodeSet& visited) const {
+  return _root ? _root->getMemoryUsage(visited) : 0;
+}
+
 ScalarExpression ScalarExpression::operator+(const ScalarExpression & s) const {
   boost::shared_ptr<ScalarExpressionNode> newRoot(new ScalarExpressionNodeAdd(_root, s._root));
   return ScalarExpression(newRoot);
@@ -120,6 +127,9 @@ class UnaryScalarExpressionNode : public ScalarExpressionNode
 {
  protected:
   UnaryScalarExpressionNode(boost::shared_ptr<ScalarExpressionNode> arg) : _arg(arg) {}
+  std::size_t getMemoryUsage(ExpressionNodeSet& visited) const override {
+    return expressionNodeMemoryUsage(*this, visited, _arg);
+  }
   void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override {
     _arg->getDesignVariables(designVariables);
   }
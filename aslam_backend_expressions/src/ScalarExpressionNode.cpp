@@ -313,6 +313,70 @@ namespace aslam {
         void ScalarExpressionNodeConstant::accept(ExpressionNodeVisitor& visitor) {
           visitor.visit("#", this);
         }
+
+        std::size_t ScalarExpressionNodeMultiply::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+        }
+
+        std::size_t ScalarExpressionNodeDivide::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+        }
+
+        std::size_t ScalarExpressionNodeNegated::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _rhs);
+        }
+
+        std::size_t ScalarExpressionNodeAdd::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+        }
+
+        std::size_t ScalarExpressionNodeConstant::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited);
+        }
+
+        std::size_t ScalarExpressionNodeSqrt::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodeLog::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodeExp::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodeAtan::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodeTanh::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodeAtan2::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+        }
+
+        std::size_t ScalarExpressionNodeAcos::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodeAcosSquared::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodeInverseSigmoid::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionNodePower::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _lhs);
+        }
+
+        std::size_t ScalarExpressionPiecewiseExpression::getMemoryUsage(ExpressionNodeSet& visited) const {
+          return expressionNodeMemoryUsage(*this, visited, _e1, _e2);
+        }
     } // namespace backend
 }  // namespace aslam
 
@@ -80,6 +80,9 @@ namespace aslam {
       visitor.visit("TB", this, _rotation, _translation);
     }
 
+    std::size_t TransformationBasic::getMemoryUsage(ExpressionNodeSet& visited) const {
+      return expressionNodeMemoryUsage(*this, visited, _rotation, _translation);
+    }
   } // namespace backend
 }  // namespace aslam
 
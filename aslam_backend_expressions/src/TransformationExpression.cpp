@@ -46,6 +46,11 @@ namespace aslam {
         _root->getDesignVariables(designVariables);
     }
 
+    std::size_t TransformationExpression::getMemoryUsage(ExpressionNodeSet& visited) const
+    {
+      return _root ? _root->getMemoryUsage(visited) : 0;
+    }
+
 
     Eigen::Matrix4d TransformationExpression::toTransformationMatrix() const
     {
@@ -118,5 +118,16 @@ namespace aslam {
     visitor.visit("#", this);
   }
 
+  std::size_t TransformationExpressionNodeMultiply::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _lhs, _rhs);
+  }
+
+  std::size_t TransformationExpressionNodeInverse::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _dvTransformation);
+  }
+
+  std::size_t TransformationExpressionNodeConstant::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited);
+  }
   } // namespace backend
 }  // namespace aslam
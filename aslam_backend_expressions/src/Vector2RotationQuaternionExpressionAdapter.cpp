@@ -36,6 +36,10 @@ namespace backend {
   {
     _root->getDesignVariables(designVariables);
   }
+
+  std::size_t Vector2RotationQuaternionExpressionAdapter::getMemoryUsage(ExpressionNodeSet& visited) const {
+    return expressionNodeMemoryUsage(*this, visited, _root);
+  }
 } // namespace backend
 
 } /* namespace aslam */
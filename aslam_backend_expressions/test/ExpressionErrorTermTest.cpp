@@ -3,6 +3,7 @@
 #include <aslam/backend/test/ErrorTermTester.hpp>
 #include <aslam/backend/ScalarExpression.hpp>
 #include <aslam/backend/Scalar.hpp>
+#include <aslam/backend/MemoryStatistics.hpp>
 
 TEST(ExpressionErrorTermSuite, testScalarToErrorTerm) {
   try {
@@ -44,3 +45,41 @@ TEST(ExpressionErrorTermSuite, testScalarToErrorTerm) {
     FAIL()<< e.what();
   }
 }
+
+TEST(ExpressionErrorTermSuite, testMemoryUsageCountsSharedNodesOnce) {
+  try {
+    using namespace aslam::backend;
+
+    Scalar s(1.0);
+    ScalarExpression twice = ScalarExpression(&s) * 2;
+    ScalarExpression sum = twice + twice;
+
+    // the design variable is owned by the problem and not counted
+    ExpressionNodeSet visited;
+    EXPECT_EQ(0u, ScalarExpression(&s).getMemoryUsage(visited));
+
+    const std::size_t twiceBytes = twice.getMemoryUsage(visited);
+    EXPECT_GT(twiceBytes, 0u);
+    EXPECT_EQ(0u, twice.getMemoryUsage(visited));
+
+    // the shared operand twice is counted once
+    ExpressionNodeSet sumVisited;
+    const std::size_t sumBytes = sum.getMemoryUsage(sumVisited);
+    EXPECT_GT(sumBytes, twiceBytes);
+    EXPECT_EQ(sumBytes - twiceBytes, sum.getMemoryUsage(visited));
+
+    auto error = toErrorTerm(sum);
+    EXPECT_EQ(sizeof(*error) + sumBytes, error->getMemoryUsage() - error->ErrorTermFs<1>::getMemoryUsage() + sizeof(ErrorTermFs<1>));
+
+    // Error terms sharing the node twice count it once if they are accounted together
+    auto twiceError = toErrorTerm(twice);
+    SharedMemorySet counted;
+    const std::size_t together = error->accountMemoryUsage(counted) + twiceError->accountMemoryUsage(counted);
+    EXPECT_EQ(error->getMemoryUsage() + twiceError->getMemoryUsage(), together + twiceBytes);
+    std::vector<DesignVariable*> dvs(1, &s);
+    std::vector<ErrorTerm*> errors = { error.get(), twiceError.get() };
+    EXPECT_EQ(together, estimateMemoryUsage(dvs, errors).errorTerms);
+  } catch (const std::exception & e) {
+    FAIL()<< e.what();
+  }
+}
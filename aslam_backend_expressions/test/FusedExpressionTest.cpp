@@ -0,0 +1,92 @@
+#include <sm/eigen/gtest.hpp>
+#include <sm/kinematics/quaternion_algebra.hpp>
+#include <aslam/backend/FusedExpression.hpp>
+#include <aslam/backend/EuclideanExpression.hpp>
+#include <aslam/backend/RotationExpression.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <aslam/backend/ExpressionErrorTerm.hpp>
+#include <aslam/backend/test/ExpressionTests.hpp>
+#include <aslam/backend/test/ErrorTermTester.hpp>
+
+using namespace aslam::backend;
+using namespace sm::kinematics;
+
+namespace {
+  /// \brief check the value and the Jacobian of a fused expression against the runtime expression computing the same
+  template <typename TFused>
+  void compareWithRuntime(const TFused& fusedExpression, const EuclideanExpression& runtimeExpression, int numDesignVariables) {
+    sm::eigen::assertNear(runtimeExpression.toEuclidean(), fusedExpression.evaluate(), 1e-12, SM_SOURCE_FILE_POS, "Testing the value");
+    Eigen::MatrixXd J = evaluateJacobian(fusedExpression, numDesignVariables);
+    Eigen::MatrixXd Jruntime = evaluateJacobian(runtimeExpression, numDesignVariables);
+    sm::eigen::assertNear(Jruntime, J, 1e-12, SM_SOURCE_FILE_POS, "Testing the Jacobian");
+  }
+} // namespace
+
+TEST(FusedExpressionTestSuite, testRotations)
+{
+  try {
+    RotationQuaternion qa(quatRandom()), qb(quatRandom());
+    EuclideanPoint point(Eigen::Vector3d::Random());
+    const Eigen::Vector3d measurement = Eigen::Vector3d::Random();
+
+    auto expression = fused::inverse(fused::rotation(&qa)) * (fused::rotation(&qb) * fused::point(&point)) - measurement;
+    EuclideanExpression runtime = qa.toExpression().inverse() * (qb.toExpression() * point.toExpression()) - measurement;
+
+    SCOPED_TRACE("");
+    compareWithRuntime(expression, runtime, 3);
+    testExpression(expression, 3);
+
+    auto composed = (fused::rotation(&qa) * fused::rotation(&qb)) * -fused::point(&point);
+    EuclideanExpression runtimeComposed = (qa.toExpression() * qb.toExpression()) * (-point.toExpression());
+    compareWithRuntime(composed, runtimeComposed, 3);
+    testExpression(composed, 3);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(FusedExpressionTestSuite, testTransformations)
+{
+  try {
+    RotationQuaternion qa(quatRandom()), qb(quatRandom());
+    EuclideanPoint ta(Eigen::Vector3d::Random()), tb(Eigen::Vector3d::Random());
+    EuclideanPoint point(Eigen::Vector3d::Random());
+
+    auto Ta = fused::transformation(fused::rotation(&qa), fused::point(&ta));
+    auto Tb = fused::transformation(fused::rotation(&qb), fused::point(&tb));
+    auto expression = (fused::inverse(Ta) * Tb) * fused::point(&point);
+
+    TransformationExpression runtimeTa(qa.toExpression(), ta.toExpression());
+    TransformationExpression runtimeTb(qb.toExpression(), tb.toExpression());
+    EuclideanExpression runtime = (runtimeTa.inverse() * runtimeTb) * point.toExpression();
+
+    SCOPED_TRACE("");
+    compareWithRuntime(expression, runtime, 5);
+    testExpression(expression, 5);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(FusedExpressionTestSuite, testErrorTerm)
+{
+  try {
+    RotationQuaternion q(quatRandom());
+    EuclideanPoint t(Eigen::Vector3d::Random());
+    EuclideanPoint point(Eigen::Vector3d::Random());
+    const Eigen::Vector3d measurement = Eigen::Vector3d::Random();
+
+    auto T = fused::transformation(fused::rotation(&q), fused::point(&t));
+    auto error = toErrorTerm(T * fused::point(&point) - measurement, Eigen::Matrix3d::Identity() * 4.0);
+    EXPECT_EQ(3u, error->numDesignVariables());
+
+    auto runtimeError = toErrorTerm(TransformationExpression(q.toExpression(), t.toExpression()) * point.toExpression() - measurement,
+                                    Eigen::Matrix3d::Identity() * 4.0);
+    EXPECT_NEAR(runtimeError->evaluateError(), error->evaluateError(), 1e-12);
+
+    SCOPED_TRACE("");
+    testErrorTerm(error, 1e-5);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
@@ -0,0 +1,134 @@
+#include <sm/eigen/gtest.hpp>
+#include <sm/kinematics/quaternion_algebra.hpp>
+
+#include <aslam/backend/ParameterArena.hpp>
+#include <aslam/backend/EuclideanPoint.hpp>
+#include <aslam/backend/HomogeneousPoint.hpp>
+#include <aslam/backend/RotationQuaternion.hpp>
+#include <aslam/backend/DesignVariableVector.hpp>
+#include <aslam/backend/Scalar.hpp>
+
+#include <memory>
+
+using namespace aslam::backend;
+
+TEST(ParameterArenaTestSuite, testContiguousParameters)
+{
+  try {
+    const Eigen::Vector3d p0 = Eigen::Vector3d::Random();
+    const Eigen::Vector4d q0 = sm::kinematics::quatRandom();
+    const Eigen::Vector2d v0 = Eigen::Vector2d::Random();
+    const Eigen::VectorXd d0 = Eigen::VectorXd::Random(5);
+    EuclideanPoint point(p0);
+    RotationQuaternion rotation(q0);
+    DesignVariableVector<2> vector(v0);
+    DesignVariableVector<Eigen::Dynamic> dynamicVector(d0);
+    point.setBlockIndex(2);
+    rotation.setBlockIndex(0);
+    vector.setBlockIndex(1);
+
+    // Unsupported design variables are rejected
+    Scalar scalar(1.0);
+    ParameterArena rejecting;
+    EXPECT_ANY_THROW(rejecting.assign({ &point, &scalar }));
+    EXPECT_ANY_THROW(rejecting.assign({ &point, &point }));
+    EXPECT_EQ(nullptr, point.arena());
+
+    {
+      ParameterArena arena({ &dynamicVector, &point, &vector, &rotation });
+      EXPECT_ANY_THROW(ParameterArena other({ &point }));
+
+      // Ordered by block index, the design variable without one follows
+      ASSERT_EQ(4u, arena.numDesignVariables());
+      EXPECT_EQ(&rotation, arena.designVariable(0));
+      EXPECT_EQ(&vector, arena.designVariable(1));
+      EXPECT_EQ(&point, arena.designVariable(2));
+      EXPECT_EQ(&dynamicVector, arena.designVariable(3));
+      EXPECT_EQ(0u, arena.offset(0));
+      EXPECT_EQ(4u, arena.offset(1));
+      EXPECT_EQ(6u, arena.offset(2));
+      EXPECT_EQ(9u, arena.offset(3));
+      EXPECT_EQ(14u, arena.size());
+      EXPECT_EQ(&arena, point.arena());
+
+      // The values move into the arena unchanged
+      sm::eigen::assertEqual(q0, arena.values().segment<4>(0), SM_SOURCE_FILE_POS);
+      sm::eigen::assertEqual(v0, arena.values().segment<2>(4), SM_SOURCE_FILE_POS);
+      sm::eigen::assertEqual(p0, arena.values().segment<3>(6), SM_SOURCE_FILE_POS);
+      sm::eigen::assertEqual(d0, arena.values().segment(9, 5), SM_SOURCE_FILE_POS);
+      sm::eigen::assertEqual(p0, point.toEuclidean(), SM_SOURCE_FILE_POS);
+
+      // The getters return copies, the map accessors views of the arena
+      EXPECT_EQ(arena.values().data() + 6, point.getValueMap().data());
+      EXPECT_EQ(arena.values().data() + 0, rotation.getQuaternionMap().data());
+      EXPECT_EQ(arena.values().data() + 4, vector.valueMap().data());
+      const Eigen::Vector3d value = point.getValue();
+
+      // Updates and reverts work on the arena
+      const double dp[3] = { 0.5, -1.0, 2.0 };
+      point.update(dp, 3);
+      sm::eigen::assertEqual(Eigen::Vector3d(p0 + Eigen::Vector3d(dp)), arena.values().segment<3>(6), SM_SOURCE_FILE_POS);
+      sm::eigen::assertEqual(p0, value, SM_SOURCE_FILE_POS);
+      sm::eigen::assertEqual(Eigen::Vector3d(p0 + Eigen::Vector3d(dp)), point.getValueMap(), SM_SOURCE_FILE_POS);
+      sm::eigen::assertEqual(p0, arena.previousValues().segment<3>(6), SM_SOURCE_FILE_POS);
+      point.revertUpdate();
+      sm::eigen::assertEqual(p0, point.toEuclidean(), SM_SOURCE_FILE_POS);
+
+      // Writes through the arena reach the design variables
+      Eigen::VectorXd snapshot;
+      arena.snapshot(snapshot);
+      const std::size_t numParameterSets = point.numParameterSets();
+      const Eigen::Vector4d q1 = sm::kinematics::quatRandom();
+      arena.mutableValues().segment<4>(0) = q1;
+      arena.mutableValues().segment<3>(6).setZero();
+      arena.valuesChanged();
+      EXPECT_EQ(numParameterSets + 1, point.numParameterSets());
+      sm::eigen::assertEqual(Eigen::Vector3d::Zero(), point.toEuclidean(), SM_SOURCE_FILE_POS);
+      sm::eigen::assertNear(sm::kinematics::quat2r(q1), rotation.toRotationMatrix(), 1e-12, SM_SOURCE_FILE_POS);
+
+      arena.restore(snapshot);
+      sm::eigen::assertEqual(p0, point.toEuclidean(), SM_SOURCE_FILE_POS);
+      sm::eigen::assertNear(sm::kinematics::quat2r(q0), rotation.toRotationMatrix(), 1e-12, SM_SOURCE_FILE_POS);
+      EXPECT_ANY_THROW(arena.restore(Eigen::VectorXd::Zero(3)));
+
+      // Copies do not share the parameters
+      EuclideanPoint copy(point);
+      EXPECT_EQ(nullptr, copy.arena());
+      copy.update(dp, 3);
+      sm::eigen::assertEqual(p0, point.toEuclidean(), SM_SOURCE_FILE_POS);
+
+      vector.update(dp, 2);
+    }
+
+    // The values move back on destruction of the arena
+    EXPECT_EQ(nullptr, point.arena());
+    sm::eigen::assertEqual(p0, point.toEuclidean(), SM_SOURCE_FILE_POS);
+    sm::eigen::assertEqual(d0, dynamicVector.value(), SM_SOURCE_FILE_POS);
+    sm::eigen::assertEqual(Eigen::Vector2d(v0 + Eigen::Vector2d(0.5, -1.0)), vector.value(), SM_SOURCE_FILE_POS);
+    vector.revertUpdate();
+    sm::eigen::assertEqual(v0, vector.value(), SM_SOURCE_FILE_POS);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(ParameterArenaTestSuite, testDestroyedDesignVariable)
+{
+  try {
+    std::unique_ptr<HomogeneousPoint> point(new HomogeneousPoint(Eigen::Vector4d(1.0, 0.0, 0.0, 1.0)));
+    EuclideanPoint other(Eigen::Vector3d::Ones());
+    ParameterArena arena({ point.get(), &other });
+    point.reset();
+
+    EXPECT_EQ(nullptr, arena.designVariable(0));
+    EXPECT_EQ(&other, arena.designVariable(1));
+    arena.mutableValues().segment<3>(4).setZero();
+    arena.valuesChanged();
+    sm::eigen::assertEqual(Eigen::Vector3d::Zero(), other.toEuclidean(), SM_SOURCE_FILE_POS);
+    arena.clear();
+    EXPECT_EQ(0u, arena.numDesignVariables());
+    sm::eigen::assertEqual(Eigen::Vector3d::Zero(), other.toEuclidean(), SM_SOURCE_FILE_POS);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
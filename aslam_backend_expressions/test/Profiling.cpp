@@ -26,6 +26,9 @@
 #include <aslam/backend/DesignVariableVector.hpp>
 #include <aslam/backend/VectorExpressionToGenericMatrixTraits.hpp>
 #include <aslam/backend/CacheExpression.hpp>
+#include <aslam/backend/FusedExpression.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <sm/kinematics/quaternion_algebra.hpp>
 
 
 using namespace std;
@@ -49,7 +52,7 @@ int main(int argc, char** argv)
     bool useCaching = false, noUpdateDv = false;
     bool noDense = false, noSparse = false, noScalar = false,
          noMatrix = false, noError = false, noJacobian = false,
-         noCached = false, noNonCached = false;
+         noCached = false, noNonCached = false, noRigid = false;
 
     namespace po = boost::program_options;
     po::options_description desc("local_planner options");
@@ -71,6 +74,7 @@ int main(int argc, char** argv)
       ("no-cached", po::bool_switch(&noCached), "Don't profile cached expressions")
       ("no-noncached", po::bool_switch(&noNonCached), "Don't profile non-cached expressions")
       ("no-update-dv", po::bool_switch(&noUpdateDv), "Don't update the design variables after each call")
+      ("no-rigid", po::bool_switch(&noRigid), "Don't profile runtime vs. fused rigid body expressions")
     ;
     po::variables_map vm;
     po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
@@ -236,6 +240,59 @@ int main(int argc, char** argv)
       }
     } // GenericMatrixExpression
 
+    // ************************************* //
+    //    Rigid body: runtime vs. fused      //
+    // ************************************* //
+    if (!noRigid) {
+      RotationQuaternion q(sm::kinematics::quatRandom());
+      EuclideanPoint t(Eigen::Vector3d::Random());
+      EuclideanPoint p(Eigen::Vector3d::Random());
+      std::vector<DesignVariable*> dvs = {&q, &t, &p};
+      int columnBase = 0;
+      for (size_t i = 0; i < dvs.size(); ++i) {
+        dvs[i]->setActive(true);
+        dvs[i]->setBlockIndex(i);
+        dvs[i]->setColumnBase(columnBase);
+        columnBase += dvs[i]->minimalDimensions();
+      }
+      const Eigen::Vector3d m = Eigen::Vector3d::Random();
+      const EuclideanExpression expr = TransformationExpression(q.toExpression(), t.toExpression()).inverse() * p.toExpression() - m;
+      const auto fexpr = fused::inverse(fused::transformation(fused::rotation(&q), fused::point(&t))) * fused::point(&p) - m;
+
+      Eigen::MatrixXd J = Eigen::MatrixXd::Zero(3, columnBase);
+      JacobianContainerDense<Eigen::MatrixXd&, 3> jcDense(J);
+      const double dx[3] = {1e-3, 1e-3, 1e-3};
+
+      if (!noError) {
+        sm::timing::Timer timer("Rigid body -- Runtime: Error", false);
+        for (size_t i=0; i<nIterations; ++i) {
+          expr.evaluate();
+          if (!noUpdateDv && i % updateDvEach == 0) p.update(dx, 3);
+        }
+      }
+      if (!noError) {
+        sm::timing::Timer timer("Rigid body -- Fused: Error", false);
+        for (size_t i=0; i<nIterations; ++i) {
+          fexpr.evaluate();
+          if (!noUpdateDv && i % updateDvEach == 0) p.update(dx, 3);
+        }
+      }
+      if (!noJacobian && !noDense) {
+        sm::timing::Timer timer("Rigid body -- Runtime/Dense: Jacobian", false);
+        for (size_t i=0; i<nIterations; ++i) {
+          evaluateJacobian(expr, jcDense);
+          if (!noUpdateDv && i % updateDvEach == 0) p.update(dx, 3);
+        }
+      }
+      if (!noJacobian && !noDense) {
+        sm::timing::Timer timer("Rigid body -- Fused/Dense: Jacobian", false);
+        for (size_t i=0; i<nIterations; ++i) {
+          evaluateJacobian(fexpr, jcDense);
+          if (!noUpdateDv && i % updateDvEach == 0) p.update(dx, 3);
+        }
+      }
+    } // Rigid body
+
     sm::timing::Timing::print(cout, sm::timing::SortType::SORT_BY_TOTAL);
 
   }
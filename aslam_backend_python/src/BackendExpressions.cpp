@@ -49,7 +49,7 @@ void exportDesignVariableVector()
   std::stringstream str;
   str << "DesignVariableVector" << D;
   class_< DesignVariableVector<D>, boost::shared_ptr< DesignVariableVector<D> >, bases< DesignVariable> >(str.str().c_str(), no_init)
-    .def("value", &DesignVariableVector<D>::value, return_value_policy<copy_const_reference>())
+    .def("value", &DesignVariableVector<D>::value)
     .def("toExpression", &DesignVariableVector<D>::toExpression)
     ;
 }
@@ -158,7 +158,7 @@ void exportBackendExpressions()
   class_<EuclideanPoint, boost::shared_ptr<EuclideanPoint>, bases<DesignVariable> >("EuclideanPointDv", init<const Eigen::Vector3d>())
       .def("toExpression", &EuclideanPoint::toExpression)
       .def("toHomogeneousExpression", &EuclideanPoint::toHomogeneousExpression)
-      .def("toEuclidean", &EuclideanPoint::toEuclidean, return_value_policy<copy_const_reference>())
+      .def("toEuclidean", &EuclideanPoint::toEuclidean)
       .def("getDesignVariables", &getDesignVariables<EuclideanPoint>)
       .def("set", &EuclideanPoint::set)
      ;
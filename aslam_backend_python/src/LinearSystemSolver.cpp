@@ -5,6 +5,7 @@
 #include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/SparseQrLinearSystemSolver.hpp>
 #include <aslam/backend/DenseQrLinearSystemSolver.hpp>
+#include <aslam/backend/DenseCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/OptimizerCallbackManager.hpp>
 
 
@@ -78,6 +79,7 @@ void exportLinearSystemSolver()
 
 
     class_<DenseQrLinearSystemSolver, boost::shared_ptr<DenseQrLinearSystemSolver>, bases<LinearSystemSolver> >("DenseQrLinearSystemSolver", init<>());
+    class_<DenseCholeskyLinearSystemSolver, boost::shared_ptr<DenseCholeskyLinearSystemSolver>, bases<LinearSystemSolver> >("DenseCholeskyLinearSystemSolver", init<>());
     class_<BlockCholeskyLinearSystemSolver, boost::shared_ptr<BlockCholeskyLinearSystemSolver>, bases<LinearSystemSolver> >("BlockCholeskyLinearSystemSolver", init<>());
     class_<SparseCholeskyLinearSystemSolver, boost::shared_ptr<SparseCholeskyLinearSystemSolver>, bases<LinearSystemSolver> >("SparseCholeskyLinearSystemSolver", init<>());
     class_<SparseQrLinearSystemSolver, boost::shared_ptr<SparseQrLinearSystemSolver>, bases<LinearSystemSolver> >("SparseQrLinearSystemSolver", init<>())
@@ -4,6 +4,7 @@
 #include <aslam/backend/OptimizerCallbackManager.hpp>
 #include <aslam/backend/Optimizer.hpp>
 #include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/MemoryStatistics.hpp>
 #include <aslam/backend/OptimizerRprop.hpp>
 #include <aslam/backend/OptimizerBFGS.hpp>
 #include <aslam/backend/ScalarNonSquaredErrorTerm.hpp>
@@ -25,6 +26,11 @@ Eigen::VectorXd rhs(const aslam::backend::Optimizer * o)
 	return o->rhs();
 }
 
+aslam::backend::MemoryStatistics memoryStatistics(const aslam::backend::Optimizer2 * o)
+{
+	return o->getStatus().memory;
+}
+
 template <typename T>
 std::string toString(const T& t) {
   std::ostringstream os;
@@ -179,6 +185,13 @@ void exportOptimizer()
 
 
         .def("printTiming", &Optimizer2::printTiming)
+
+        /// \brief Memory held by the parts of the optimization
+        .def("printMemoryUsage", &Optimizer2::printMemoryUsage)
+        .def("memoryStatistics", &memoryStatistics)
+
+        /// \brief Estimate the memory needed from the problem structure, before anything is allocated
+        .def("estimateMemoryUsage", &Optimizer2::estimateMemoryUsage)
         .def("computeHessian", &Optimizer2::computeHessian)
    
         ;
@@ -216,6 +229,39 @@ void exportOptimizer()
         .def("__str__", &toString<OptimizerStatus>)
         ;
 
+    class_<MemoryUsage>("MemoryUsage")
+        .def_readonly("current", &MemoryUsage::current)
+        .def_readonly("peak", &MemoryUsage::peak)
+        ;
+
+    class_<MemoryStatistics>("MemoryStatistics")
+        .def_readonly("errorTerms", &MemoryStatistics::errorTerms)
+        .def_readonly("jacobianContainers", &MemoryStatistics::jacobianContainers)
+        .def_readonly("jacobian", &MemoryStatistics::jacobian)
+        .def_readonly("hessian", &MemoryStatistics::hessian)
+        .def_readonly("factor", &MemoryStatistics::factor)
+        .def("current", &MemoryStatistics::current)
+        .def("peak", &MemoryStatistics::peak)
+        .def("__str__", &toString<MemoryStatistics>)
+        ;
+
+    class_<MemoryEstimate>("MemoryEstimate")
+        .def_readonly("jacobianRows", &MemoryEstimate::jacobianRows)
+        .def_readonly("jacobianCols", &MemoryEstimate::jacobianCols)
+        .def_readonly("jacobianNonZeros", &MemoryEstimate::jacobianNonZeros)
+        .def_readonly("hessianNonZeros", &MemoryEstimate::hessianNonZeros)
+        .def_readonly("hessianBlocks", &MemoryEstimate::hessianBlocks)
+        .def_readonly("errorTerms", &MemoryEstimate::errorTerms)
+        .def_readonly("jacobianContainers", &MemoryEstimate::jacobianContainers)
+        .def("sparseCholesky", &MemoryEstimate::sparseCholesky)
+        .def("sparseQr", &MemoryEstimate::sparseQr)
+        .def("blockCholesky", &MemoryEstimate::blockCholesky)
+        .def("denseCholesky", &MemoryEstimate::denseCholesky)
+        .def("denseQr", &MemoryEstimate::denseQr)
+        .def("forSolver", &MemoryEstimate::forSolver)
+        .def("__str__", &toString<MemoryEstimate>)
+        ;
+
     class_<OptimizerBase, boost::shared_ptr<OptimizerBase>, boost::noncopyable >("OptimizerBase", no_init)
 
         .def("setProblem", pure_virtual(&OptimizerBase::setProblem),
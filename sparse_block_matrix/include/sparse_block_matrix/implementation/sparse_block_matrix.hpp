@@ -237,7 +237,7 @@ typename SparseBlockMatrix<MatrixType>::Scalar SparseBlockMatrix<MatrixType>::op
 
 template<class MatrixType>
 template<class MatrixTransposedType>
-bool SparseBlockMatrix<MatrixType>::transpose(SparseBlockMatrix<MatrixTransposedType>*& dest) const {
+bool SparseBlockMatrix<MatrixType>::transpose(SparseBlockMatrix<MatrixTransposedType>*& dest, int numThreads) const {
   if (!dest) {
     dest = new SparseBlockMatrix<MatrixTransposedType>(&_colBlockIndices[0], &_rowBlockIndices[0], _colBlockIndices.size(), _rowBlockIndices.size());
   } else {
@@ -257,13 +257,25 @@ bool SparseBlockMatrix<MatrixType>::transpose(SparseBlockMatrix<MatrixTransposed
     }
   }
 
+  // the rows of column r of dest are the block columns holding a block in row r, in ascending order
+  std::vector<std::vector<int> > destRows(_rowBlockIndices.size());
   for (size_t i = 0; i < _blockCols.size(); i++) {
-    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); it++) {
-      typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* s = it->second;
-      typename SparseBlockMatrix<MatrixTransposedType>::SparseMatrixBlock* d = dest->block(i, it->first, true);
-      *d = s->transpose();
-    }
+    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); it++)
+      destRows[it->first].push_back(i);
   }
+  std::vector<size_t> weights(destRows.size());
+  for (size_t r = 0; r < destRows.size(); r++)
+    weights[r] = destRows[r].size();
+
+  parallelForColumns(weights, numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t r = begin; r < end; r++) {
+      for (int c : destRows[r]) {
+        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* s = _blockCols[c].find(r)->second;
+        typename SparseBlockMatrix<MatrixTransposedType>::SparseMatrixBlock* d = dest->block(c, r, true);
+        *d = s->transpose();
+      }
+    }
+  });
   return true;
 }
 
@@ -278,7 +290,7 @@ SparseBlockMatrix<typename SparseBlockMatrix<MatrixType>::TransposedMatrixType>
 
 
 template<class MatrixType>
-bool SparseBlockMatrix<MatrixType>::add(SparseBlockMatrix*& dest) const {
+bool SparseBlockMatrix<MatrixType>::add(SparseBlockMatrix*& dest, int numThreads) const {
   if (!dest) {
     dest = new SparseBlockMatrix(&_rowBlockIndices[0], &_colBlockIndices[0], _rowBlockIndices.size(), _colBlockIndices.size());
   } else {
@@ -297,53 +309,109 @@ bool SparseBlockMatrix<MatrixType>::add(SparseBlockMatrix*& dest) const {
         return false;
     }
   }
-  for (size_t i = 0; i < _blockCols.size(); i++) {
-    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); it++) {
-      typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* s = it->second;
-      typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* d = dest->block(it->first, i, true);
-      (*d) += *s;
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); it++) {
+        typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* s = it->second;
+        typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* d = dest->block(it->first, i, true);
+        (*d) += *s;
+      }
     }
-  }
+  });
   return true;
 }
 
+namespace detail {
+  //! the number of block products per column of A * M
+  template<class MatrixType, class MatrixFactorType>
+  std::vector<size_t> productsPerColumn(const SparseBlockMatrix<MatrixType>& A, const SparseBlockMatrix<MatrixFactorType>& M) {
+    std::vector<size_t> products(M.blockCols().size(), 0);
+    for (size_t j = 0; j < M.blockCols().size(); j++) {
+      for (typename SparseBlockMatrix<MatrixFactorType>::IntBlockMap::const_iterator it = M.blockCols()[j].begin(); it != M.blockCols()[j].end(); it++)
+        products[j] += A.blockCols()[it->first].size();
+    }
+    return products;
+  }
+}
+
 template<class MatrixType>
 template<class MatrixResultType, class MatrixFactorType>
-bool SparseBlockMatrix<MatrixType>::multiply(SparseBlockMatrix<MatrixResultType>*& dest, const SparseBlockMatrix<MatrixFactorType> * M) const {
+bool SparseBlockMatrix<MatrixType>::multiply(SparseBlockMatrix<MatrixResultType>*& dest, const SparseBlockMatrix<MatrixFactorType> * M, int numThreads) const {
   // sanity check
-  if (_colBlockIndices.size() != M->_rowBlockIndices.size())
+  if (_colBlockIndices != M->_rowBlockIndices)
     return false;
-  for (size_t i = 0; i < _colBlockIndices.size(); i++) {
-    if (_colBlockIndices[i] != M->_rowBlockIndices[i])
-      return false;
-  }
   if (!dest) {
     dest = new SparseBlockMatrix<MatrixResultType>(&_rowBlockIndices[0], &(M->_colBlockIndices[0]), _rowBlockIndices.size(), M->_colBlockIndices.size());
   }
-  if (!dest->_hasStorage)
+  return multiplySymbolic(*dest, *M, numThreads) && multiplyNumeric(*dest, *M, numThreads);
+}
+
+template<class MatrixType>
+template<class MatrixResultType, class MatrixFactorType>
+bool SparseBlockMatrix<MatrixType>::multiplySymbolic(SparseBlockMatrix<MatrixResultType>& dest, const SparseBlockMatrix<MatrixFactorType>& M, int numThreads) const {
+  if (_colBlockIndices != M._rowBlockIndices || dest._rowBlockIndices != _rowBlockIndices || dest._colBlockIndices != M._colBlockIndices)
+    return false;
+  if (!dest._hasStorage)
     return false;
-  for (size_t i = 0; i < M->_blockCols.size(); i++) {
-    for (typename SparseBlockMatrix<MatrixFactorType>::IntBlockMap::const_iterator it = M->_blockCols[i].begin(); it != M->_blockCols[i].end(); it++) {
-      // look for a non-zero block in a row of column it
-      int colM = i;
-      const typename SparseBlockMatrix<MatrixFactorType>::SparseMatrixBlock *b = it->second;
-      typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator rbt = _blockCols[it->first].begin();
-      while (rbt != _blockCols[it->first].end()) {
-        //int colA=it->first;
-        int rowA = rbt->first;
-        typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock *a = rbt->second;
-        typename SparseBlockMatrix<MatrixResultType>::SparseMatrixBlock *c = dest->block(rowA, colM, true);
-        assert(c->rows() == a->rows());
-        assert(c->cols() == b->cols());
-        assert(a->cols() == b->rows());
-        rbt++;
-        (*c) += (*a) * (*b);
+  parallelForColumns(detail::productsPerColumn(*this, M), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    // marks the block rows already found in the current column
+    std::vector<char> isRowSet(_rowBlockIndices.size(), 0);
+    std::vector<int> rows;
+    for (size_t j = begin; j < end; j++) {
+      rows.clear();
+      for (typename SparseBlockMatrix<MatrixFactorType>::IntBlockMap::const_iterator it = M._blockCols[j].begin(); it != M._blockCols[j].end(); it++) {
+        for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator rbt = _blockCols[it->first].begin(); rbt != _blockCols[it->first].end(); rbt++) {
+          if (!isRowSet[rbt->first]) {
+            isRowSet[rbt->first] = 1;
+            rows.push_back(rbt->first);
+          }
+        }
+      }
+      std::sort(rows.begin(), rows.end());
+      for (int r : rows) {
+        dest.block(r, j, true);
+        isRowSet[r] = 0;
       }
     }
-  }
+  });
   return true;
 }
 
+template<class MatrixType>
+template<class MatrixResultType, class MatrixFactorType>
+bool SparseBlockMatrix<MatrixType>::multiplyNumeric(SparseBlockMatrix<MatrixResultType>& dest, const SparseBlockMatrix<MatrixFactorType>& M, int numThreads) const {
+  if (_colBlockIndices != M._rowBlockIndices || dest._rowBlockIndices != _rowBlockIndices || dest._colBlockIndices != M._colBlockIndices)
+    return false;
+  std::atomic<bool> complete(true);
+  parallelForColumns(detail::productsPerColumn(*this, M), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    // the blocks of the current column of dest by block row, to avoid a map lookup per product
+    std::vector<typename SparseBlockMatrix<MatrixResultType>::SparseMatrixBlock*> destBlocks(_rowBlockIndices.size(), nullptr);
+    for (size_t j = begin; j < end; j++) {
+      const typename SparseBlockMatrix<MatrixResultType>::IntBlockMap& destCol = dest._blockCols[j];
+      for (typename SparseBlockMatrix<MatrixResultType>::IntBlockMap::const_iterator ct = destCol.begin(); ct != destCol.end(); ct++)
+        destBlocks[ct->first] = ct->second;
+      for (typename SparseBlockMatrix<MatrixFactorType>::IntBlockMap::const_iterator it = M._blockCols[j].begin(); it != M._blockCols[j].end(); it++) {
+        const typename SparseBlockMatrix<MatrixFactorType>::SparseMatrixBlock *b = it->second;
+        for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator rbt = _blockCols[it->first].begin(); rbt != _blockCols[it->first].end(); rbt++) {
+          const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock *a = rbt->second;
+          typename SparseBlockMatrix<MatrixResultType>::SparseMatrixBlock *c = destBlocks[rbt->first];
+          if (!c) {
+            complete = false;
+            continue;
+          }
+          assert(c->rows() == a->rows());
+          assert(c->cols() == b->cols());
+          assert(a->cols() == b->rows());
+          (*c) += (*a) * (*b);
+        }
+      }
+      for (typename SparseBlockMatrix<MatrixResultType>::IntBlockMap::const_iterator ct = destCol.begin(); ct != destCol.end(); ct++)
+        destBlocks[ct->first] = nullptr;
+    }
+  });
+  return complete;
+}
+
 template<class MatrixType>
 template<class MatrixFactorType>
 SparseBlockMatrix<Eigen::MatrixXd> SparseBlockMatrix<MatrixType>::operator*(const SparseBlockMatrix<MatrixFactorType> & M) const {
@@ -443,46 +511,60 @@ inline void atxpy(const MatrixXd& A, const VectorXd& x, int xoff, VectorXd& y, i
 
 // a eigen input and output version: (Matrix * Vector)
 template<class MatrixType>
-void SparseBlockMatrix<MatrixType>::multiply(VectorXd * dest, const VectorXd & src) const {
+void SparseBlockMatrix<MatrixType>::multiply(VectorXd * dest, const VectorXd & src, int numThreads) const {
 
   // Dimension CHECK:
   assert(cols() == src.rows());
   assert(rows() == dest->rows());
   dest->setZero();
 
-  for (size_t i = 0; i < _blockCols.size(); i++) {
-    int srcOffset = i ? _colBlockIndices[i - 1] : 0;
+  // the columns of different threads write to the same rows, all but the first thread accumulate separately
+  std::vector<VectorXd> threadDest(numThreads > 1 ? numThreads - 1 : 0);
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t thread, size_t begin, size_t end) {
+    VectorXd& y = thread ? threadDest[thread - 1] : *dest;
+    if (thread)
+      y.setZero(rows());
+    for (size_t i = begin; i < end; i++) {
+      int srcOffset = i ? _colBlockIndices[i - 1] : 0;
 
-    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
-      const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = it->second;
-      int destOffset = it->first ? _rowBlockIndices[it->first - 1] : 0;
-      // destVec += *a * srcVec (according to the sub-vector parts)
-      axpy(*a, src, srcOffset, *dest, destOffset);
+      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = it->second;
+        int destOffset = it->first ? _rowBlockIndices[it->first - 1] : 0;
+        // destVec += *a * srcVec (according to the sub-vector parts)
+        axpy(*a, src, srcOffset, y, destOffset);
+      }
     }
+  });
+  for (const VectorXd& y : threadDest) {
+    if (y.size())
+      *dest += y;
   }
 }
 
 template<class MatrixType>
-void SparseBlockMatrix<MatrixType>::rightMultiply(VectorXd * dest, const VectorXd & src) const {
+void SparseBlockMatrix<MatrixType>::rightMultiply(VectorXd * dest, const VectorXd & src, int numThreads) const {
 
   // Dimension CHECK:
   assert(rows() == src.cols() || rows() == src.rows());
   assert(cols() == dest->rows() || cols() == dest->cols());
   dest->setZero();
 
-  for (int i = 0; i < static_cast<int>(_blockCols.size()); i++) {
-    int destOffset = colBaseOfBlock(i);
-    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
-      const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = it->second;
-      int srcOffset = rowBaseOfBlock(it->first);
-      // destVec += *a.transpose() * srcVec (according to the sub-vector parts)
-      atxpy(*a, src, srcOffset, *dest, destOffset);
+  // every column writes its own segment of dest
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      int destOffset = colBaseOfBlock(i);
+      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = it->second;
+        int srcOffset = rowBaseOfBlock(it->first);
+        // destVec += *a.transpose() * srcVec (according to the sub-vector parts)
+        atxpy(*a, src, srcOffset, *dest, destOffset);
+      }
     }
-  }
+  });
 }
 
 template<class MatrixType>
-void SparseBlockMatrix<MatrixType>::rightMultiply(double*& dest, const double* src) const {
+void SparseBlockMatrix<MatrixType>::rightMultiply(double*& dest, const double* src, int numThreads) const {
   int destSize = cols();
 
   if (!dest) {
@@ -494,18 +576,17 @@ void SparseBlockMatrix<MatrixType>::rightMultiply(double*& dest, const double* s
   Map<VectorXd> destVec(dest, destSize);
   Map<const VectorXd> srcVec(src, rows());
 
-# ifdef G2O_OPENMP
-# pragma omp parallel for default (shared)
-# endif
-  for (int i = 0; i < static_cast<int>(_blockCols.size()); i++) {
-    int destOffset = colBaseOfBlock(i);
-    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
-      const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = it->second;
-      int srcOffset = rowBaseOfBlock(it->first);
-      // destVec += *a.transpose() * srcVec (according to the sub-vector parts)
-      atxpy(*a, srcVec, srcOffset, destVec, destOffset);
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      int destOffset = colBaseOfBlock(i);
+      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = it->second;
+        int srcOffset = rowBaseOfBlock(it->first);
+        // destVec += *a.transpose() * srcVec (according to the sub-vector parts)
+        atxpy(*a, srcVec, srcOffset, destVec, destOffset);
+      }
     }
-  }
+  });
 }
 
 template<class MatrixType>
@@ -612,7 +693,7 @@ std::ostream& operator <<(std::ostream& os, const SparseBlockMatrix<MatrixType>&
 }
 
 template<class MatrixType>
-bool SparseBlockMatrix<MatrixType>::symmPermutation(SparseBlockMatrix<MatrixType>*& dest, const int* pinv, bool upperTriangle) const {
+bool SparseBlockMatrix<MatrixType>::symmPermutation(SparseBlockMatrix<MatrixType>*& dest, const int* pinv, bool upperTriangle, int numThreads) const {
   // compute the permuted version of the new row/column layout
   size_t n = _rowBlockIndices.size();
   // computed the block sizes
@@ -645,133 +726,224 @@ bool SparseBlockMatrix<MatrixType>::symmPermutation(SparseBlockMatrix<MatrixType
     }
     dest->clear();
   }
-  // now ready to permute the columns
+  // the rows of every column of dest and the inverse permutation, to let every column of dest
+  // collect its blocks from the source
+  std::vector<int> p(n);
+  std::vector<std::vector<int> > destRows(n);
   for (size_t i = 0; i < n; i++) {
-    //cerr << PVAR(i) <<  " ";
     int pi = pinv[i];
+    p[pi] = i;
     for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); it++) {
       int pj = pinv[it->first];
+      if (!upperTriangle || pj <= pi)
+        destRows[pi].push_back(pj);
+      else
+        destRows[pj].push_back(pi);
+    }
+  }
+  std::vector<size_t> weights(n);
+  for (size_t i = 0; i < n; i++)
+    weights[i] = destRows[i].size();
 
-      const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* s = it->second;
-
-      typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = 0;
-      if (!upperTriangle || pj <= pi) {
-        b = dest->block(pj, pi, true);
-        assert(b->cols() == s->cols());
-        assert(b->rows() == s->rows());
-        *b = *s;
-      } else {
-        b = dest->block(pi, pj, true);
-        assert(b);
-        assert(b->rows() == s->cols());
-        assert(b->cols() == s->rows());
-        *b = s->transpose();
+  // now ready to permute the columns
+  parallelForColumns(weights, numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t pi = begin; pi < end; pi++) {
+      std::vector<int>& rows = destRows[pi];
+      std::sort(rows.begin(), rows.end());
+      rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+      for (int pj : rows) {
+        typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = dest->block(pj, pi, true);
+        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* s = block(p[pj], p[pi]);
+        if (s) {
+          assert(b->cols() == s->cols());
+          assert(b->rows() == s->rows());
+          *b = *s;
+        } else {
+          s = block(p[pi], p[pj]);
+          assert(s);
+          assert(b->rows() == s->cols());
+          assert(b->cols() == s->rows());
+          *b = s->transpose();
+        }
       }
     }
-    //cerr << endl;
-    // within each row,
-  }
+  });
   return true;
 }
 
 template<class MatrixType>
-template<typename IntType>
-IntType SparseBlockMatrix<MatrixType>::fillCCS(double* Cx, bool upperTriangle) const {
-  double* CxStart = Cx;
+std::vector<size_t> SparseBlockMatrix<MatrixType>::blocksPerColumn() const {
+  std::vector<size_t> blocks(_blockCols.size());
+  for (size_t i = 0; i < _blockCols.size(); ++i)
+    blocks[i] = _blockCols[i].size();
+  return blocks;
+}
+
+template<class MatrixType>
+size_t SparseBlockMatrix<MatrixType>::ccsColumnNonZeros(size_t i, bool upperTriangle) const {
+  size_t cstart = i ? _colBlockIndices[i - 1] : 0;
+  size_t csize = colsOfBlock(i);
+  size_t nz = 0;
+  for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+    size_t rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
+    if (upperTriangle && rstart == cstart)
+      nz += csize * (csize + 1) / 2;
+    else
+      nz += rowsOfBlock(it->first) * csize;
+  }
+  return nz;
+}
+
+template<class MatrixType>
+std::vector<std::vector<std::pair<int, const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock*> > > SparseBlockMatrix<MatrixType>::upperRowBlocks() const {
+  std::vector<std::vector<std::pair<int, const SparseMatrixBlock*> > > rowBlocks(_rowBlockIndices.size());
   for (size_t i = 0; i < _blockCols.size(); ++i) {
-    int cstart = i ? _colBlockIndices[i - 1] : 0;
-    int csize = colsOfBlock(i);
-    for (int c = 0; c < csize; c++) {
-      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
-        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
-        int rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
+    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+      if (it->first <= static_cast<int>(i))
+        rowBlocks[it->first].push_back(std::make_pair(static_cast<int>(i), it->second));
+    }
+  }
+  return rowBlocks;
+}
 
-        int elemsToCopy = b->rows();
-        if (upperTriangle && rstart == cstart)
-          elemsToCopy = c + 1;
-        memcpy(Cx, b->data() + c * b->rows(), elemsToCopy * sizeof(double));
-        Cx += elemsToCopy;
+template<class MatrixType>
+size_t SparseBlockMatrix<MatrixType>::upperTriangleCCSColumnNonZeros(size_t i, const std::vector<std::pair<int, const SparseMatrixBlock*> >& rowBlocks) const {
+  size_t csize = colsOfBlock(i);
+  // the upper triangle part of the columns
+  size_t nz = ccsColumnNonZeros(i, true);
+  // and the transposed part below the diagonal
+  for (const std::pair<int, const SparseMatrixBlock*>& rb : rowBlocks) {
+    if (rb.first == static_cast<int>(i))
+      nz += csize * (csize - 1) / 2;
+    else
+      nz += colsOfBlock(rb.first) * csize;
+  }
+  return nz;
+}
+
+template<class MatrixType>
+template<typename ColumnNonZeros>
+std::vector<size_t> SparseBlockMatrix<MatrixType>::ccsColumnOffsets(int numThreads, const ColumnNonZeros& columnNonZeros) const {
+  std::vector<size_t> offsets(_blockCols.size() + 1, 0);
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+      offsets[i + 1] = columnNonZeros(i);
+  });
+  for (size_t i = 0; i < _blockCols.size(); ++i)
+    offsets[i + 1] += offsets[i];
+  return offsets;
+}
 
+template<class MatrixType>
+template<typename IntType>
+IntType SparseBlockMatrix<MatrixType>::fillCCS(double* Cx, bool upperTriangle, int numThreads) const {
+  const std::vector<size_t> offsets = ccsColumnOffsets(numThreads, [&](size_t i) { return ccsColumnNonZeros(i, upperTriangle); });
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      double* colCx = Cx + offsets[i];
+      int cstart = i ? _colBlockIndices[i - 1] : 0;
+      int csize = colsOfBlock(i);
+      for (int c = 0; c < csize; c++) {
+        for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+          const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
+          int rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
+
+          int elemsToCopy = b->rows();
+          if (upperTriangle && rstart == cstart)
+            elemsToCopy = c + 1;
+          memcpy(colCx, b->data() + c * b->rows(), elemsToCopy * sizeof(double));
+          colCx += elemsToCopy;
+
+        }
       }
     }
-  }
-  return Cx - CxStart;
+  });
+  return offsets.back();
 }
 
 template<class MatrixType>
 template<typename IntType>
 // template<typename IntType>
-IntType SparseBlockMatrix<MatrixType>::fillCCS(IntType* Cp, IntType* Ci, double* Cx, bool upperTriangle) const {
-  IntType nz = 0;
-  for (size_t i = 0; i < _blockCols.size(); ++i) {
-    IntType cstart = i ? _colBlockIndices[i - 1] : 0;
-    IntType csize = colsOfBlock(i);
-    for (IntType c = 0; c < csize; c++) {
-      *Cp = nz;
-      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
-        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
-        IntType rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
-
-        int elemsToCopy = b->rows();
-        if (upperTriangle && rstart == cstart)
-          elemsToCopy = c + 1;
-        for (int r = 0; r < elemsToCopy; ++r) {
-          *Cx++ = (*b)(r, c);
-          *Ci++ = rstart++;
-          ++nz;
+IntType SparseBlockMatrix<MatrixType>::fillCCS(IntType* Cp, IntType* Ci, double* Cx, bool upperTriangle, int numThreads) const {
+  const std::vector<size_t> offsets = ccsColumnOffsets(numThreads, [&](size_t i) { return ccsColumnNonZeros(i, upperTriangle); });
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      IntType nz = offsets[i];
+      IntType* colCp = Cp + colBaseOfBlock(i);
+      IntType* colCi = Ci + offsets[i];
+      double* colCx = Cx + offsets[i];
+      IntType cstart = i ? _colBlockIndices[i - 1] : 0;
+      IntType csize = colsOfBlock(i);
+      for (IntType c = 0; c < csize; c++) {
+        *colCp = nz;
+        for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+          const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
+          IntType rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
+
+          int elemsToCopy = b->rows();
+          if (upperTriangle && rstart == cstart)
+            elemsToCopy = c + 1;
+          for (int r = 0; r < elemsToCopy; ++r) {
+            *colCx++ = (*b)(r, c);
+            *colCi++ = rstart++;
+            ++nz;
+          }
         }
+        ++colCp;
       }
-      ++Cp;
     }
-  }
-  *Cp = nz;
+  });
+  const IntType nz = offsets.back();
+  Cp[cols()] = nz;
   return nz;
 }
 
 template<class MatrixType>
 template<typename IntType>
-IntType SparseBlockMatrix<MatrixType>::fillUpperTriangleCCS(IntType* Cp, IntType* Ci, double* Cx) const {
-  IntType nz = 0;  // row length
+IntType SparseBlockMatrix<MatrixType>::fillUpperTriangleCCS(IntType* Cp, IntType* Ci, double* Cx, int numThreads) const {
+  // the blocks of every block row right of the diagonal, instead of looking up every block of the row
+  const std::vector<std::vector<std::pair<int, const SparseMatrixBlock*> > > rowBlocks = upperRowBlocks();
+  const std::vector<size_t> offsets = ccsColumnOffsets(numThreads, [&](size_t i) { return upperTriangleCCSColumnNonZeros(i, rowBlocks[i]); });
   // loop all the column Blocks
-  for (size_t i = 0; i < _blockCols.size(); ++i) {
-    //  std::cout << "i:" << i << std::endl;
-    // set column start and column size:
-    IntType cstart = i ? _colBlockIndices[i - 1] : 0;
-    IntType csize = colsOfBlock(i);  // number of columns in the current block
-    // loop the columns in the Block
-    for (IntType c = 0; c < csize; c++) {
-      //  std::cout << "c:" << c << std::endl;
-      // set the column start pointer to nz
-      *Cp = nz;
-      IntType rstart = 0;
-      // add the elements down to the diagonal:
-      // use the row block iterator:
-      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
-        // the row Block:
-        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
-        // row block index
-        rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
-
-        // number of rows of the Block to copy
-        int elemsToCopy = b->rows();
-        // if the Block sits on the diagonal
-        if (rstart == cstart)
-          elemsToCopy = c + 1;  // do not copy the symmetric parts
-        for (int r = 0; r < elemsToCopy; ++r) {
-          //    std::cout << "r:" << r << std::endl;
-          *Cx++ = (*b)(r, c);
-          *Ci++ = rstart++;  // set the row index
-          ++nz;  // increment the elements in this column
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      IntType nz = offsets[i];  // row length
+      IntType* colCp = Cp + colBaseOfBlock(i);
+      IntType* colCi = Ci + offsets[i];
+      double* colCx = Cx + offsets[i];
+      // set column start and column size:
+      IntType cstart = i ? _colBlockIndices[i - 1] : 0;
+      IntType csize = colsOfBlock(i);  // number of columns in the current block
+      // loop the columns in the Block
+      for (IntType c = 0; c < csize; c++) {
+        // set the column start pointer to nz
+        *colCp = nz;
+        IntType rstart = 0;
+        // add the elements down to the diagonal:
+        // use the row block iterator:
+        for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+          // the row Block:
+          const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
+          // row block index
+          rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
+
+          // number of rows of the Block to copy
+          int elemsToCopy = b->rows();
+          // if the Block sits on the diagonal
+          if (rstart == cstart)
+            elemsToCopy = c + 1;  // do not copy the symmetric parts
+          for (int r = 0; r < elemsToCopy; ++r) {
+            *colCx++ = (*b)(r, c);
+            *colCi++ = rstart++;  // set the row index
+            ++nz;  // increment the elements in this column
+          }
         }
-      }
 
-      // this gave as the upper triangle part of the column
-      // continue with the row Block at the diagonal:
-      for (size_t cBlock = i; cBlock < _blockCols.size(); ++cBlock) {
-        // get the block:
-        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = block(i, cBlock);
-        // if block allocated:
-        if (b != 0) {
+        // this gave as the upper triangle part of the column
+        // continue with the row Block at the diagonal:
+        for (const std::pair<int, const SparseMatrixBlock*>& rb : rowBlocks[i]) {
+          const size_t cBlock = rb.first;
+          const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = rb.second;
           rstart = cBlock ? _colBlockIndices[cBlock - 1] : 0;
           // loop the columns of the block:
           int ci = 0;
@@ -779,81 +951,74 @@ IntType SparseBlockMatrix<MatrixType>::fillUpperTriangleCCS(IntType* Cp, IntType
             ci = c + 1;
             rstart += c + 1;
           }
-          // rstart++;
           for (; ci < colsOfBlock(cBlock); ++ci)  // do NOT copy diagonal elements
               {
             // add the elements to the CCS:
-            *Cx++ = (*b)(c, ci);  // set transposed value
-            *Ci++ = rstart++;  // set current row and step to next one
+            *colCx++ = (*b)(c, ci);  // set transposed value
+            *colCi++ = rstart++;  // set current row and step to next one
             ++nz;
           }
         }
+        ++colCp;
       }
-      ++Cp;
     }
-  }
-  *Cp = nz;
+  });
+  const IntType nz = offsets.back();
+  Cp[cols()] = nz;
   return nz;
 }
 
 template<class MatrixType>
 template<typename IntType>
-IntType SparseBlockMatrix<MatrixType>::fillUpperTriangleCCS(double* Cx) const {
-  double *CxStart = Cx;
+IntType SparseBlockMatrix<MatrixType>::fillUpperTriangleCCS(double* Cx, int numThreads) const {
+  const std::vector<std::vector<std::pair<int, const SparseMatrixBlock*> > > rowBlocks = upperRowBlocks();
+  const std::vector<size_t> offsets = ccsColumnOffsets(numThreads, [&](size_t i) { return upperTriangleCCSColumnNonZeros(i, rowBlocks[i]); });
   // loop all the column Blocks
-  for (size_t i = 0; i < _blockCols.size(); ++i) {
-    //  std::cout << "i:" << i << std::endl;
-    // set column start and column size:
-    IntType cstart = i ? _colBlockIndices[i - 1] : 0;
-    IntType csize = colsOfBlock(i);  // number of columns in the current block
-    // loop the columns in the Block
-    for (IntType c = 0; c < csize; c++) {
-      //  std::cout << "c:" << c << std::endl;
-      // set the column start pointer to nz
-      IntType rstart = 0;
-      // add the elements down to the diagonal:
-      // use the row block iterator:
-      for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
-        // the row Block:
-        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
-        // row block index
-        rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
-
-        // number of rows of the Block to copy
-        int elemsToCopy = b->rows();
-        // if the Block sits on the diagonal
-        if (rstart == cstart)
-          elemsToCopy = c + 1;  // do not copy the symmetric parts
-        memcpy(Cx, b->data() + c * b->rows(), elemsToCopy * sizeof(double));
-        Cx += elemsToCopy;
-      }
+  parallelForColumns(blocksPerColumn(), numThreads, [&](size_t /* thread */, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      double* colCx = Cx + offsets[i];
+      // set column start and column size:
+      IntType cstart = i ? _colBlockIndices[i - 1] : 0;
+      IntType csize = colsOfBlock(i);  // number of columns in the current block
+      // loop the columns in the Block
+      for (IntType c = 0; c < csize; c++) {
+        IntType rstart = 0;
+        // add the elements down to the diagonal:
+        // use the row block iterator:
+        for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+          // the row Block:
+          const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = it->second;
+          // row block index
+          rstart = it->first ? _rowBlockIndices[it->first - 1] : 0;
+
+          // number of rows of the Block to copy
+          int elemsToCopy = b->rows();
+          // if the Block sits on the diagonal
+          if (rstart == cstart)
+            elemsToCopy = c + 1;  // do not copy the symmetric parts
+          memcpy(colCx, b->data() + c * b->rows(), elemsToCopy * sizeof(double));
+          colCx += elemsToCopy;
+        }
 
-      // this gave as the upper triangle part of the column
-      // continue with the row Block at the diagonal:
-      for (size_t cBlock = i; cBlock < _blockCols.size(); ++cBlock) {
-        // get the block:
-        const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = block(i, cBlock);
-        // if block allocated:
-        if (b != 0) {
-          rstart = cBlock ? _colBlockIndices[cBlock - 1] : 0;
+        // this gave as the upper triangle part of the column
+        // continue with the row Block at the diagonal:
+        for (const std::pair<int, const SparseMatrixBlock*>& rb : rowBlocks[i]) {
+          const size_t cBlock = rb.first;
+          const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* b = rb.second;
           // loop the columns of the block:
           int ci = 0;
-          if (i == cBlock) {
+          if (i == cBlock)
             ci = c + 1;
-            rstart += c + 1;
-          }
-          // rstart++;
           for (; ci < colsOfBlock(cBlock); ++ci)  // do NOT copy diagonal elements
               {
             // add the elements to the CCS:
-            *Cx++ = (*b)(c, ci);  // set transposed value
+            *colCx++ = (*b)(c, ci);  // set transposed value
           }
-
         }
       }
     }
-  }
-  return Cx - CxStart;
+  });
+  return offsets.back();
 }
 
 template<class MatrixType>
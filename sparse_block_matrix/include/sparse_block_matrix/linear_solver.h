@@ -64,6 +64,18 @@ class LinearSolver
       (void) A;
       return false;
     }
+
+    /**
+     * Bytes currently held by the solver, e.g. for the factor.
+     * @returns 0 if not tracked.
+     */
+    virtual size_t memoryInUse() const { return 0; }
+
+    /**
+     * Largest number of bytes held by the solver so far.
+     * @returns 0 if not tracked.
+     */
+    virtual size_t peakMemoryUsage() const { return 0; }
 };
 
 } // end namespace
@@ -34,6 +34,7 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
     LinearSolverCholmod() : LinearSolver<MatrixType>()
     {
       _blockOrdering = false;
+      _ordering = CHOLMOD_AMD;
       _cholmodSparse = new CholmodExt<int>();
       _cholmodFactor = 0;
       cholmod_start(&_cholmodCommon);
@@ -67,6 +68,10 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
       return true;
     }
 
+    size_t memoryInUse() const override { return _cholmodCommon.memory_inuse; }
+
+    size_t peakMemoryUsage() const override { return _cholmodCommon.memory_usage; }
+
     bool solve(const SparseBlockMatrix<MatrixType>& A, double* x, double* b) override
     {
              
@@ -205,23 +210,49 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
     bool blockOrdering() const { return _blockOrdering;}
     void setBlockOrdering(bool blockOrdering) { _blockOrdering = blockOrdering;}
 
+    //! the cholmod ordering method (CHOLMOD_AMD, CHOLMOD_COLAMD or CHOLMOD_NESDIS) used for the scalar ordering
+    int ordering() const { return _ordering;}
+    void setOrdering(int ordering) { _ordering = ordering;}
+
+    //! constraint set of every block column for a constrained (CAMD) block ordering. Blocks of set k are eliminated before the blocks of set k+1.
+    //! An empty vector disables the constrained ordering.
+    const std::vector<int>& blockConstraints() const { return _blockConstraints;}
+    void setBlockConstraints(const std::vector<int>& blockConstraints) { _blockConstraints = blockConstraints;}
+
+    //! the fill-reducing permutation of the scalar columns of the current factor, empty if there is none
+    std::vector<int> permutation() const
+    {
+      if (! _cholmodFactor)
+        return std::vector<int>();
+      const int* p = (const int*)_cholmodFactor->Perm;
+      return std::vector<int>(p, p + _cholmodFactor->n);
+    }
+
   protected:
     // temp used for cholesky with cholmod
     cholmod_common _cholmodCommon;
     CholmodExt<int>* _cholmodSparse;
     cholmod_factor* _cholmodFactor;
     bool _blockOrdering;
+    int _ordering;
+    std::vector<int> _blockConstraints;
     MatrixStructure _matrixStructure;
     VectorXi _scalarPermutation, _blockPermutation;
 
     void computeSymbolicDecomposition(const SparseBlockMatrix<MatrixType>& A)
     {
       // double t = get_time();
-      if (! _blockOrdering) {
+      if (! _blockOrdering && _blockConstraints.empty()) {
         // setup ordering strategy
         _cholmodCommon.nmethods = 1;
-        _cholmodCommon.method[0].ordering = CHOLMOD_AMD; //CHOLMOD_COLAMD
+        _cholmodCommon.method[0].ordering = _ordering;
         _cholmodFactor = cholmod_analyze(_cholmodSparse, &_cholmodCommon); // symbolic factorization
+        if (! _cholmodFactor && _cholmodCommon.status == CHOLMOD_NOT_INSTALLED) {
+          // nested dissection requires cholmod to be compiled with METIS
+          _cholmodCommon.status = CHOLMOD_OK;
+          _cholmodCommon.method[0].ordering = CHOLMOD_AMD;
+          _cholmodFactor = cholmod_analyze(_cholmodSparse, &_cholmodCommon);
+        }
       } else {
 
         A.fillBlockStructure(_matrixStructure);
@@ -247,7 +278,13 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
         auxCholmodSparse.dtype = CHOLMOD_DOUBLE;
         auxCholmodSparse.sorted = 1;
         auxCholmodSparse.packed = 1;
-        int amdStatus = cholmod_amd(&auxCholmodSparse, NULL, 0, _blockPermutation.data(), &_cholmodCommon);
+        int amdStatus;
+        if (_blockConstraints.empty()) {
+          amdStatus = cholmod_amd(&auxCholmodSparse, NULL, 0, _blockPermutation.data(), &_cholmodCommon);
+        } else {
+          assert((int)_blockConstraints.size() == _matrixStructure.n && "One constraint set per block column is required");
+          amdStatus = cholmod_camd(&auxCholmodSparse, NULL, 0, const_cast<int*>(_blockConstraints.data()), _blockPermutation.data(), &_cholmodCommon);
+        }
         if (! amdStatus) {
           return;
         }
@@ -270,7 +307,10 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
         // apply the ordering
         _cholmodCommon.nmethods = 1 ;
         _cholmodCommon.method[0].ordering = CHOLMOD_GIVEN;
+        // postordering the elimination tree may move constrained blocks away from the end
+        _cholmodCommon.postorder = _blockConstraints.empty();
         _cholmodFactor = cholmod_analyze_p(_cholmodSparse, _scalarPermutation.data(), NULL, 0, &_cholmodCommon);
+        _cholmodCommon.postorder = 1;
 
       }
       //if (globalStats)
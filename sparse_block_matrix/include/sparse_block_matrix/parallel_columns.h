@@ -0,0 +1,67 @@
+#ifndef __SPARSE_BLOCK_MATRIX_PARALLEL_COLUMNS__
+#define __SPARSE_BLOCK_MATRIX_PARALLEL_COLUMNS__
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <vector>
+
+namespace sparse_block_matrix {
+
+/**
+ * Runs job(thread, begin, end) on numThreads contiguous ranges of the columns (0 .. columnWeights.size() - 1).
+ * The ranges are chosen such that the sums of the weights, e.g. the number of blocks per column, are about
+ * equal. Every column gets a weight of at least one so that empty columns are spread as well. With less than
+ * two threads or columns the job runs in the calling thread. The first exception thrown by a job is rethrown
+ * after all jobs finished.
+ */
+template <typename Job>
+void parallelForColumns(const std::vector<std::size_t>& columnWeights, int numThreads, const Job& job) {
+  const std::size_t numColumns = columnWeights.size();
+  if (numColumns == 0)
+    return;
+  if (numThreads <= 1 || numColumns == 1) {
+    job(0, 0, numColumns);
+    return;
+  }
+  const std::size_t nThreads = std::min(static_cast<std::size_t>(numThreads), numColumns);
+
+  std::size_t totalWeight = 0;
+  for (std::size_t w : columnWeights)
+    totalWeight += w + 1;
+
+  // Split where the running sum of the weights passes the next multiple of totalWeight / nThreads
+  std::vector<std::size_t> indices(nThreads + 1, numColumns);
+  indices[0] = 0;
+  std::size_t weight = 0;
+  std::size_t t = 1;
+  for (std::size_t c = 0; c < numColumns && t < nThreads; ++c) {
+    weight += columnWeights[c] + 1;
+    if (weight * nThreads >= t * totalWeight)
+      indices[t++] = c + 1;
+  }
+
+  std::vector<std::future<void> > jobs;
+  jobs.reserve(nThreads);
+  for (std::size_t i = 0; i < nThreads; ++i) {
+    if (indices[i] < indices[i + 1])
+      jobs.push_back(std::async(std::launch::async, [&job, &indices, i]() { job(i, indices[i], indices[i + 1]); }));
+  }
+  // wait for all jobs before rethrowing, they access the caller's data
+  for (std::future<void>& j : jobs)
+    j.wait();
+  for (std::future<void>& j : jobs)
+    j.get();
+}
+
+/**
+ * Same as above with all columns weighted equally.
+ */
+template <typename Job>
+void parallelForColumns(std::size_t numColumns, int numThreads, const Job& job) {
+  parallelForColumns(std::vector<std::size_t>(numColumns, 0), numThreads, job);
+}
+
+}  // end namespace
+
+#endif
@@ -17,6 +17,8 @@
 #ifndef __SPARSE_BLOCK_MATRIX__
 #define __SPARSE_BLOCK_MATRIX__
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <vector>
 #include <fstream>
@@ -28,6 +30,7 @@
 #include <sm/assert_macros.hpp>
 #include <boost/algorithm/minmax.hpp>
 #include "sparse_helper.h"
+#include "parallel_columns.h"
 
 namespace sparse_block_matrix {
   using namespace Eigen;
@@ -46,6 +49,10 @@ namespace sparse_block_matrix {
  * template argument.  If this is not the case, and you have different
  * block sizes than you have to use a dynamic-block matrix (default
  * template argument).  
+ *
+ * The kernels taking a numThreads argument partition the work by block
+ * columns, such that every thread writes to columns of its own. They run
+ * serially in the calling thread for numThreads <= 1.
  */
 template <class MatrixType = MatrixXd >
 class SparseBlockMatrix {
@@ -164,16 +171,33 @@ class SparseBlockMatrix {
 
   //! transposes a block matrix, The transposed type should match the argument false on failure
   template <class MatrixTransposedType>
-  bool transpose(SparseBlockMatrix<MatrixTransposedType>*& dest) const;
+  bool transpose(SparseBlockMatrix<MatrixTransposedType>*& dest, int numThreads = 1) const;
   //! return transposed sparse matrix
   inline SparseBlockMatrix<TransposedMatrixType> transpose() const;
 
   //! adds the current matrix to the destination
-  bool add(SparseBlockMatrix<MatrixType>*& dest) const ;
+  bool add(SparseBlockMatrix<MatrixType>*& dest, int numThreads = 1) const ;
+
+  //! dest += (*this) *  M, see multiplySymbolic() and multiplyNumeric()
+  template <class MatrixResultType, class MatrixFactorType>
+  bool multiply(SparseBlockMatrix<MatrixResultType> *& dest, const SparseBlockMatrix<MatrixFactorType>* M, int numThreads = 1) const;
+
+  /**
+   * allocates the blocks of (*this) * M missing in dest, initialized to zero. Existing blocks are kept.
+   * Products with a fixed structure, e.g. Schur complements in an iterative solver, can run the symbolic
+   * pass once and only call multiplyNumeric() afterwards.
+   * @returns false if the block layouts don't match
+   */
+  template <class MatrixResultType, class MatrixFactorType>
+  bool multiplySymbolic(SparseBlockMatrix<MatrixResultType>& dest, const SparseBlockMatrix<MatrixFactorType>& M, int numThreads = 1) const;
 
-  //! dest = (*this) *  M
+  /**
+   * dest += (*this) * M, without allocating blocks. Call dest.clear() first for dest = (*this) * M.
+   * @returns false if the block layouts don't match or dest misses a block of the product. The products
+   * with a block in dest are added in the latter case.
+   */
   template <class MatrixResultType, class MatrixFactorType>
-  bool multiply(SparseBlockMatrix<MatrixResultType> *& dest, const SparseBlockMatrix<MatrixFactorType>* M) const;
+  bool multiplyNumeric(SparseBlockMatrix<MatrixResultType>& dest, const SparseBlockMatrix<MatrixFactorType>& M, int numThreads = 1) const;
   //multiply via operator
   template <class MatrixFactorType>
   inline SparseBlockMatrix<Eigen::MatrixXd> operator * (const SparseBlockMatrix<MatrixFactorType> & M) const;
@@ -181,13 +205,13 @@ class SparseBlockMatrix {
   //! dest = (*this) *  src // returns dense
   void multiply(double*& dest, const double* src) const;
 
-  //! dest = (*this) * src (Eigen::Vector) // returns dense
-  void multiply(Eigen::VectorXd * dest, const Eigen::VectorXd &src) const;
+  //! dest = (*this) * src (Eigen::Vector) // returns dense. The threads accumulate into vectors of their own which are summed up.
+  void multiply(Eigen::VectorXd * dest, const Eigen::VectorXd &src, int numThreads = 1) const;
 
-  void rightMultiply(VectorXd * dest, const VectorXd & src) const;
+  void rightMultiply(VectorXd * dest, const VectorXd & src, int numThreads = 1) const;
 
   //! dest = M * (*this)
-  void rightMultiply(double*& dest, const double* src) const;
+  void rightMultiply(double*& dest, const double* src, int numThreads = 1) const;
 
   //! *this *= a
   void scale( double a);
@@ -199,27 +223,28 @@ class SparseBlockMatrix {
   /**
    * writes in dest a block permutaton specified by pinv.
    * @param pinv: array such that new_block[i] = old_block[pinv[i]]
+   * With onlyUpper, a block of dest with both a source block and a transposed source block is copied from the former.
    */
-  bool symmPermutation(SparseBlockMatrix<MatrixType>*& dest, const int* pinv, bool onlyUpper=false) const;
+  bool symmPermutation(SparseBlockMatrix<MatrixType>*& dest, const int* pinv, bool onlyUpper=false, int numThreads = 1) const;
 
   /**
    * fill the CCS arrays of a matrix, arrays have to be allocated beforehand
    */
 
   template<typename IntType>
-  IntType fillCCS(IntType* Cp, IntType* Ci, double* Cx, bool upperTriangle = false) const;
+  IntType fillCCS(IntType* Cp, IntType* Ci, double* Cx, bool upperTriangle = false, int numThreads = 1) const;
 
   // creates a full matrix given an upper triangle sparse block matrix
   template<typename IntType>
-  IntType fillUpperTriangleCCS(IntType* Cp, IntType* Ci, double* Cx) const;
+  IntType fillUpperTriangleCCS(IntType* Cp, IntType* Ci, double* Cx, int numThreads = 1) const;
   template<typename IntType>
-  IntType fillUpperTriangleCCS(double* Cx) const;
+  IntType fillUpperTriangleCCS(double* Cx, int numThreads = 1) const;
   /**
    * fill the CCS arrays of a matrix, arrays have to be allocated beforehand. This function only writes
    * the values and assumes that column and row structures have already been written.
    */
   template<typename IntType>
-  IntType fillCCS(double* Cx, bool upperTriangle = false) const;
+  IntType fillCCS(double* Cx, bool upperTriangle = false, int numThreads = 1) const;
 
   //! exports the non zero blocks in the structure matrix ms
   void fillBlockStructure(MatrixStructure& ms) const;
@@ -246,6 +271,22 @@ class SparseBlockMatrix {
   inline SparseBlockMatrix & eval() { return *this; }
 
  protected:
+  //! the number of blocks per block column, to balance the work of the threads
+  std::vector<size_t> blocksPerColumn() const;
+
+  //! the scalar non-zeros of block column i in the layout of fillCCS()
+  size_t ccsColumnNonZeros(size_t i, bool upperTriangle) const;
+
+  //! the blocks right of the diagonal per block row, (block column, block), as used by fillUpperTriangleCCS()
+  std::vector<std::vector<std::pair<int, const SparseMatrixBlock*> > > upperRowBlocks() const;
+
+  //! the scalar non-zeros of block column i in the layout of fillUpperTriangleCCS()
+  size_t upperTriangleCCSColumnNonZeros(size_t i, const std::vector<std::pair<int, const SparseMatrixBlock*> >& rowBlocks) const;
+
+  //! the offset of every block column in the CCS arrays, computed in parallel
+  template<typename ColumnNonZeros>
+  std::vector<size_t> ccsColumnOffsets(int numThreads, const ColumnNonZeros& columnNonZeros) const;
+
   std::vector<int> _rowBlockIndices; ///< vector of the indices of the blocks along the rows.
   std::vector<int> _colBlockIndices; ///< vector of the indices of the blocks along the cols
   //! array of maps of blocks. The index of the array represent a block column of the matrix
@@ -396,6 +396,168 @@ TEST(sparse_block_matrixTestSuite, testMatrixMatrixMultiplication) {
     FAIL() << e.what();
   }
 }
+
+TEST(sparse_block_matrixTestSuite, testMatrixMatrixMultiplicationSymbolicAndNumeric) {
+
+  using namespace Eigen;
+  using namespace sparse_block_matrix;
+  VectorXi rows(4);
+  rows << 2, 4, 14, 15;
+  VectorXi cols(3);
+  cols << 3, 5, 7;
+
+  sparse_block_matrix::SparseBlockMatrix<MatrixXd> M1 = buildRandomMatrix<MatrixXd>(rows, cols, 0.5);
+  sparse_block_matrix::SparseBlockMatrix<MatrixXd> M2 = buildRandomMatrix<MatrixXd>(cols, rows, 0.5);
+  const Eigen::MatrixXd product = M1.toDense() * M2.toDense();
+
+  try{
+    for (int numThreads : {1, 3}) {
+      SCOPED_TRACE(numThreads);
+      sparse_block_matrix::SparseBlockMatrix<MatrixXd> P(rows, rows);
+      // the numeric pass needs the structure
+      if (M1.nonZeroBlocks() && M2.nonZeroBlocks()) {
+        EXPECT_FALSE(M1.multiplyNumeric(P, M2, numThreads));
+      }
+      P.clear(true);
+      ASSERT_TRUE(M1.multiplySymbolic(P, M2, numThreads));
+      EXPECT_TRUE(M1.multiplyNumeric(P, M2, numThreads));
+      sm::eigen::assertNear(P.toDense(), product, 1e-6, SM_SOURCE_FILE_POS);
+
+      // the structure is reused
+      const size_t blocks = P.nonZeroBlocks();
+      P.clear();
+      ASSERT_TRUE(M1.multiplySymbolic(P, M2, numThreads));
+      EXPECT_EQ(blocks, P.nonZeroBlocks());
+      EXPECT_TRUE(M1.multiplyNumeric(P, M2, numThreads));
+      sm::eigen::assertNear(P.toDense(), product, 1e-6, SM_SOURCE_FILE_POS);
+
+      sparse_block_matrix::SparseBlockMatrix<MatrixXd>* Q = NULL;
+      ASSERT_TRUE(M1.multiply(Q, &M2, numThreads));
+      sm::eigen::assertNear(Q->toDense(), product, 1e-6, SM_SOURCE_FILE_POS);
+      delete Q;
+
+      // incompatible layouts
+      sparse_block_matrix::SparseBlockMatrix<MatrixXd> R(rows, cols);
+      EXPECT_FALSE(M1.multiplySymbolic(R, M2, numThreads));
+      EXPECT_FALSE(M1.multiplySymbolic(R, M1, numThreads));
+    }
+  }catch(const std::exception & e)
+  {
+    FAIL() << e.what();
+  }
+}
+
+TEST(sparse_block_matrixTestSuite, testParallelKernels) {
+
+  using namespace Eigen;
+  using namespace sparse_block_matrix;
+  VectorXi rows(7);
+  rows << 2, 4, 7, 8, 11, 14, 15;
+  VectorXi cols(6);
+  cols << 3, 5, 6, 7, 10, 12;
+
+  sparse_block_matrix::SparseBlockMatrix<MatrixXd> M = buildRandomMatrix<MatrixXd>(rows, cols, 0.5);
+  sparse_block_matrix::SparseBlockMatrix<MatrixXd> N = buildRandomMatrix<MatrixXd>(rows, cols, 0.5);
+  const Eigen::MatrixXd Md = M.toDense();
+
+  // a symmetric matrix with the upper triangle stored
+  sparse_block_matrix::SparseBlockMatrix<MatrixXd> S = buildRandomMatrix<MatrixXd>(rows, rows, 0.5);
+  for (int c = 0; c < S.bCols(); c++) {
+    S.block(c, c, true)->setRandom();
+    for (int r = c + 1; r < S.bRows(); r++) {
+      if (S.block(r, c)) {
+        *S.block(c, r, true) = S.block(r, c)->transpose();
+        delete S.block(r, c);
+        S.blockCols()[c].erase(r);
+      }
+    }
+    *S.block(c, c) = (*S.block(c, c) + S.block(c, c)->transpose()).eval();
+  }
+  const Eigen::MatrixXd Su = S.toDense();
+  const Eigen::MatrixXd Sd = Su + Su.transpose() - Eigen::MatrixXd(Su.diagonal().asDiagonal());
+
+  try{
+    for (int numThreads : {1, 2, 4, 20}) {
+      SCOPED_TRACE(numThreads);
+
+      sparse_block_matrix::SparseBlockMatrix<MatrixXd>* T = NULL;
+      ASSERT_TRUE(M.transpose(T, numThreads));
+      sm::eigen::assertEqual(T->toDense(), Md.transpose().eval(), SM_SOURCE_FILE_POS);
+      delete T;
+
+      sparse_block_matrix::SparseBlockMatrix<MatrixXd>* A = N.clone();
+      ASSERT_TRUE(M.add(A, numThreads));
+      sm::eigen::assertNear(A->toDense(), (Md + N.toDense()).eval(), 1e-12, SM_SOURCE_FILE_POS);
+      delete A;
+
+      VectorXd x = VectorXd::Random(M.cols());
+      VectorXd y(M.rows());
+      M.multiply(&y, x, numThreads);
+      sm::eigen::assertNear(y, (Md * x).eval(), 1e-10, SM_SOURCE_FILE_POS);
+
+      VectorXd z = VectorXd::Random(M.rows());
+      VectorXd w(M.cols());
+      M.rightMultiply(&w, z, numThreads);
+      sm::eigen::assertNear(w, (Md.transpose() * z).eval(), 1e-10, SM_SOURCE_FILE_POS);
+      double* wp = NULL;
+      M.rightMultiply(wp, &z[0], numThreads);
+      sm::eigen::assertNear(Eigen::Map<VectorXd>(wp, M.cols()), w, 1e-10, SM_SOURCE_FILE_POS);
+      delete[] wp;
+
+      // reverse the block order
+      std::vector<int> pinv(S.bCols());
+      for (int i = 0; i < S.bCols(); i++)
+        pinv[i] = S.bCols() - 1 - i;
+      std::vector<int> scalarP;
+      for (int i = S.bCols() - 1; i >= 0; i--)
+        for (int k = 0; k < S.colsOfBlock(i); k++)
+          scalarP.push_back(S.colBaseOfBlock(i) + k);
+      Eigen::MatrixXd Sp(Sd.rows(), Sd.cols());
+      for (int r = 0; r < Sd.rows(); r++)
+        for (int c = 0; c < Sd.cols(); c++)
+          Sp(r, c) = Sd(scalarP[r], scalarP[c]);
+      sparse_block_matrix::SparseBlockMatrix<MatrixXd>* P = NULL;
+      ASSERT_TRUE(S.symmPermutation(P, &pinv[0], true, numThreads));
+      const Eigen::MatrixXd Pu = P->toDense();
+      sm::eigen::assertEqual(Eigen::MatrixXd(Pu.triangularView<Eigen::Upper>()), Eigen::MatrixXd(Sp.triangularView<Eigen::Upper>()), SM_SOURCE_FILE_POS);
+      delete P;
+
+      // compressed columns of the full matrix and of the upper triangle
+      std::vector<int> Cp(M.cols() + 1), Ci(M.nonZeros());
+      std::vector<double> Cx(M.nonZeros()), Cx2(M.nonZeros());
+      ASSERT_EQ(static_cast<int>(M.nonZeros()), M.fillCCS(&Cp[0], &Ci[0], &Cx[0], false, numThreads));
+      ASSERT_EQ(static_cast<int>(M.nonZeros()), M.fillCCS<int>(&Cx2[0], false, numThreads));
+      EXPECT_TRUE(Cx == Cx2);
+      Eigen::MatrixXd D = Eigen::MatrixXd::Zero(M.rows(), M.cols());
+      for (int c = 0; c < M.cols(); c++)
+        for (int k = Cp[c]; k < Cp[c + 1]; k++)
+          D(Ci[k], c) = Cx[k];
+      sm::eigen::assertEqual(D, Md, SM_SOURCE_FILE_POS);
+
+      std::vector<long> Sp_(S.cols() + 1), Si(Sd.size());
+      std::vector<double> Sx(Sd.size()), Sx2(Sd.size());
+      const long nz = S.fillUpperTriangleCCS(&Sp_[0], &Si[0], &Sx[0], numThreads);
+      ASSERT_EQ(nz, S.fillUpperTriangleCCS<long>(&Sx2[0], numThreads));
+      EXPECT_TRUE(std::equal(Sx.begin(), Sx.begin() + nz, Sx2.begin()));
+      Eigen::MatrixXd E = Eigen::MatrixXd::Zero(S.rows(), S.cols());
+      for (int c = 0; c < S.cols(); c++)
+        for (long k = Sp_[c]; k < Sp_[c + 1]; k++)
+          E(Si[k], c) = Sx[k];
+      sm::eigen::assertEqual(E, Sd, SM_SOURCE_FILE_POS);
+
+      const int nzUpper = S.fillCCS(&Sp_[0], &Si[0], &Sx[0], true, numThreads);
+      Eigen::MatrixXd U = Eigen::MatrixXd::Zero(S.rows(), S.cols());
+      for (int c = 0; c < S.cols(); c++)
+        for (long k = Sp_[c]; k < Sp_[c + 1]; k++)
+          U(Si[k], c) = Sx[k];
+      EXPECT_EQ(nzUpper, Sp_[S.cols()]);
+      sm::eigen::assertEqual(U, Su, SM_SOURCE_FILE_POS);
+    }
+  }catch(const std::exception & e)
+  {
+    FAIL() << e.what();
+  }
+}
 // //! adds the current matrix to the destination
 // bool add(SparseBlockMatrix<MatrixType>*& dest) const ;
 